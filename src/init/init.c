@@ -20,30 +20,126 @@
 #define _GNU_SOURCE
 #include <errno.h>
 #include <fcntl.h>
+#include <poll.h>
+#include <sched.h>
 #include <signal.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <sys/ioctl.h>
+#include <sys/mman.h>
 #include <sys/mount.h>
+#include <sys/resource.h>
 #include <sys/stat.h>
+#include <sys/syscall.h>
 #include <sys/wait.h>
 #include <termios.h>
+#include <time.h>
 #include <unistd.h>
 
 #define CMDLINE_PATH "/proc/cmdline"
 #define ENTRYPOINT_KEY "kerf.entrypoint="
 #define CONSOLE_KEY "console="
+#define MOUNTS_KEY "kerf.mounts="
+#define SCHED_KEY "kerf.sched="
+#define CPUS_KEY "kerf.cpus="
+#define MLOCKALL_KEY "kerf.mlockall="
+#define PREFAULT_KEY "kerf.prefault="
+#define SERVICE_KEY "kerf.svc.%d="
+#define RESTART_KEY "kerf.restart="
+#define STATUS_KEY "kerf.status="
 #define MAX_CMDLINE_LEN 4096
 #define MAX_ENTRYPOINT_LEN 4096
 #define MAX_CONSOLE_LEN 64
 #define MAX_ARGS 64
+#define MAX_PREFAULT_LEN 1024
+#define MAX_SERVICES 8
 
-static volatile pid_t child_pid = -1;
-static volatile int child_exited = 0;
-static volatile int child_exit_status = 0;
+/* Restart backoff doubles from MIN to MAX, and resets after a long run */
+#define BACKOFF_MIN_MS 100
+#define BACKOFF_MAX_MS 30000
+#define BACKOFF_RESET_MS 10000
+
+/* Status record heartbeat period, so the host can tell init is alive */
+#define HEARTBEAT_MS 1000
+
+#define STATUS_MAGIC 0x7366726b     /* "krfs" */
+#define STATUS_VERSION 1
+
+enum service_state {
+    SVC_BOOTING = 1,
+    SVC_RUNNING,
+    SVC_EXITED,
+    SVC_RESTARTING,
+};
+
+/*
+ * Host-visible status record at kerf.status=<phys>, a page of the daxfs
+ * image the host reads back through its own mount (kerf/health.py). The
+ * writer makes seq odd while updating, so the host retries torn reads.
+ */
+struct status_service {
+    uint32_t state;
+    int32_t exit_status;
+    uint32_t pid;
+    uint32_t restarts;
+};
+
+struct status_record {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t seq;
+    uint32_t nr_services;
+    uint64_t boot_tsc;
+    uint64_t update_tsc;
+    uint64_t heartbeats;
+    uint64_t reserved;
+    struct status_service services[MAX_SERVICES];
+};
+
+enum restart_policy {
+    RESTART_NEVER,
+    RESTART_ON_FAILURE,
+    RESTART_ALWAYS,
+};
+
+/*
+ * A supervised entrypoint: kerf.entrypoint= alone, or kerf.svc.0= up to
+ * kerf.svc.7= in supervisor mode. The SIGCHLD handler only sets the
+ * volatile fields; the main loop logs exits and schedules restarts.
+ */
+struct service {
+    int id;                     /* N of kerf.svc.N= */
+    char command[MAX_ENTRYPOINT_LEN];
+    char *argv[MAX_ARGS];
+    volatile pid_t pid;
+    volatile int exited;
+    volatile int exit_status;
+    uint64_t started_ms;
+    int restart_pending;
+    uint64_t restart_at_ms;
+    unsigned int backoff_ms;
+    unsigned int restarts;
+};
+
+/* Filesystems selectable with kerf.mounts=, e.g. kerf.mounts=proc,dev */
+#define MOUNT_PROC      (1 << 0)
+#define MOUNT_SYS       (1 << 1)
+#define MOUNT_DEV       (1 << 2)
+#define MOUNT_DEVPTS    (1 << 3)
+#define MOUNT_ALL       (MOUNT_PROC | MOUNT_SYS | MOUNT_DEV | MOUNT_DEVPTS)
+
+static struct service services[MAX_SERVICES];
+static int nr_services;
+static int supervisor_mode;
+static enum restart_policy restart_policy;
+static volatile uint64_t child_exit_tsc = 0;
+static volatile sig_atomic_t stopping = 0;
+static sigset_t orig_sigmask;
+static volatile struct status_record *status_rec;
 static char console_device[MAX_CONSOLE_LEN];
+static char cmdline[MAX_CMDLINE_LEN];
 
 static void log_msg(const char *msg)
 {
@@ -70,15 +166,23 @@ static inline uint64_t rdtsc(void)
     return ((uint64_t)hi << 32) | lo;
 }
 
-static void log_starting(void)
+/*
+ * Boot timeline record, parsed on the host by `kerf show --timing`.
+ * The format is "kerf-init: timing phase=<name> tsc=<cycles>".
+ */
+static void log_timing_at(const char *phase, uint64_t tsc)
 {
     char buf[64];
-    uint64_t tsc = rdtsc();
 
-    snprintf(buf, sizeof(buf), "starting at TSC %lu", tsc);
+    snprintf(buf, sizeof(buf), "timing phase=%s tsc=%lu", phase, tsc);
     log_msg(buf);
 }
 
+static void log_timing(const char *phase)
+{
+    log_timing_at(phase, rdtsc());
+}
+
 static int do_mount(const char *source, const char *target,
                     const char *fstype, unsigned long flags)
 {
@@ -102,37 +206,44 @@ static int do_mkdir(const char *path, mode_t mode)
     return 0;
 }
 
-static int mount_filesystems(void)
+static int mount_proc(void)
 {
-    if (do_mount("proc", "/proc", "proc", MS_NOSUID | MS_NODEV | MS_NOEXEC) < 0)
-        return -1;
+    return do_mount("proc", "/proc", "proc", MS_NOSUID | MS_NODEV | MS_NOEXEC);
+}
 
-    if (do_mount("sysfs", "/sys", "sysfs", MS_NOSUID | MS_NODEV | MS_NOEXEC) < 0)
+/* /proc is mounted before the cmdline can be read, see main() */
+static int mount_filesystems(unsigned int mounts)
+{
+    if ((mounts & MOUNT_SYS) &&
+        do_mount("sysfs", "/sys", "sysfs", MS_NOSUID | MS_NODEV | MS_NOEXEC) < 0)
         return -1;
 
     /* Mount devtmpfs to populate /dev with kernel device nodes */
-    if (do_mount("devtmpfs", "/dev", "devtmpfs", MS_NOSUID) < 0)
+    if ((mounts & MOUNT_DEV) &&
+        do_mount("devtmpfs", "/dev", "devtmpfs", MS_NOSUID) < 0)
         return -1;
 
-    if (do_mkdir("/dev/pts", 0755) < 0)
-        return -1;
+    if (mounts & MOUNT_DEVPTS) {
+        if (do_mkdir("/dev/pts", 0755) < 0)
+            return -1;
 
-    if (do_mount("devpts", "/dev/pts", "devpts", MS_NOSUID | MS_NOEXEC) < 0)
-        return -1;
+        if (do_mount("devpts", "/dev/pts", "devpts", MS_NOSUID | MS_NOEXEC) < 0)
+            return -1;
+    }
 
     return 0;
 }
 
-static int read_entrypoint(char *buf, size_t bufsize)
+/* Read /proc/cmdline once; every kerf.* key is parsed from this copy */
+static int read_cmdline(char *buf, size_t bufsize)
 {
-    char cmdline[MAX_CMDLINE_LEN];
     int fd = open(CMDLINE_PATH, O_RDONLY);
     if (fd < 0) {
         log_error("open " CMDLINE_PATH);
         return -1;
     }
 
-    ssize_t n = read(fd, cmdline, sizeof(cmdline) - 1);
+    ssize_t n = read(fd, buf, bufsize - 1);
     close(fd);
 
     if (n < 0) {
@@ -140,25 +251,35 @@ static int read_entrypoint(char *buf, size_t bufsize)
         return -1;
     }
 
-    cmdline[n] = '\0';
+    buf[n] = '\0';
+    return 0;
+}
 
-    /* Find kerf.entrypoint= in cmdline */
-    char *start = strstr(cmdline, ENTRYPOINT_KEY);
-    if (!start) {
-        log_msg("kerf.entrypoint= not found in cmdline");
+/*
+ * Read a possibly quoted key value, such as kerf.entrypoint="/bin/sh -c x".
+ * Returns 0 on success, -1 if the key is absent and -2 if it is malformed.
+ */
+static int read_command(const char *cmdline, const char *key,
+                        char *buf, size_t bufsize)
+{
+    char msg[128];
+    int key_len = (int)strlen(key) - 1;  /* without the '=' */
+
+    const char *start = strstr(cmdline, key);
+    if (!start)
         return -1;
-    }
 
-    start += strlen(ENTRYPOINT_KEY);
+    start += strlen(key);
 
-    char *end;
+    const char *end;
     if (*start == '"') {
         /* Quoted value: find closing quote */
         start++;  /* Skip opening quote */
         end = strchr(start, '"');
         if (!end) {
-            log_msg("unterminated quote in kerf.entrypoint");
-            return -1;
+            snprintf(msg, sizeof(msg), "unterminated quote in %.*s", key_len, key);
+            log_msg(msg);
+            return -2;
         }
     } else {
         /* Unquoted value: find space or end of string */
@@ -169,13 +290,15 @@ static int read_entrypoint(char *buf, size_t bufsize)
 
     size_t len = end - start;
     if (len == 0) {
-        log_msg("empty kerf.entrypoint value");
-        return -1;
+        snprintf(msg, sizeof(msg), "empty %.*s value", key_len, key);
+        log_msg(msg);
+        return -2;
     }
 
     if (len >= bufsize) {
-        log_msg("kerf.entrypoint value too long");
-        return -1;
+        snprintf(msg, sizeof(msg), "%.*s value too long", key_len, key);
+        log_msg(msg);
+        return -2;
     }
 
     memcpy(buf, start, len);
@@ -184,30 +307,17 @@ static int read_entrypoint(char *buf, size_t bufsize)
     return 0;
 }
 
-static int read_console(char *buf, size_t bufsize)
+static int read_console(const char *cmdline, char *buf, size_t bufsize)
 {
-    char cmdline[MAX_CMDLINE_LEN];
-    int fd = open(CMDLINE_PATH, O_RDONLY);
-    if (fd < 0)
-        return -1;
-
-    ssize_t n = read(fd, cmdline, sizeof(cmdline) - 1);
-    close(fd);
-
-    if (n < 0)
-        return -1;
-
-    cmdline[n] = '\0';
-
     /* Find console= in cmdline */
-    char *start = strstr(cmdline, CONSOLE_KEY);
+    const char *start = strstr(cmdline, CONSOLE_KEY);
     if (!start)
         return -1;
 
     start += strlen(CONSOLE_KEY);
 
     /* Find the end of the value (space, comma, or end of string) */
-    char *end = start;
+    const char *end = start;
     while (*end && *end != ' ' && *end != ',' && *end != '\n')
         end++;
 
@@ -224,7 +334,261 @@ static int read_console(char *buf, size_t bufsize)
     return 0;
 }
 
-static void setup_console(const char *tty)
+/* Unquoted value of a key, up to the next space; NULL if absent */
+static const char *cmdline_value(const char *cmdline, const char *key,
+                                 size_t *len)
+{
+    const char *p = strstr(cmdline, key);
+    if (!p)
+        return NULL;
+
+    p += strlen(key);
+    *len = strcspn(p, " \n");
+    return p;
+}
+
+/*
+ * Parse kerf.mounts=, a comma-separated subset of proc,sys,dev,devpts.
+ * Without the key everything is mounted, as before it existed. devpts
+ * implies dev, and proc is always mounted since the cmdline lives there.
+ */
+static unsigned int read_mounts(const char *cmdline)
+{
+    static const struct {
+        const char *name;
+        unsigned int mask;
+    } names[] = {
+        { "proc",   MOUNT_PROC },
+        { "sys",    MOUNT_SYS },
+        { "dev",    MOUNT_DEV },
+        { "devpts", MOUNT_DEV | MOUNT_DEVPTS },
+        { "none",   0 },
+    };
+    unsigned int mounts = MOUNT_PROC;
+    size_t value_len;
+
+    const char *p = cmdline_value(cmdline, MOUNTS_KEY, &value_len);
+    if (!p)
+        return MOUNT_ALL;
+
+    const char *end = p + value_len;
+    while (p < end) {
+        size_t len = strcspn(p, ", \n");
+        size_t i;
+
+        for (i = 0; i < sizeof(names) / sizeof(names[0]); i++) {
+            if (strlen(names[i].name) == len &&
+                memcmp(names[i].name, p, len) == 0)
+                break;
+        }
+
+        if (i < sizeof(names) / sizeof(names[0])) {
+            mounts |= names[i].mask;
+        } else if (len) {
+            char msg[128];
+            snprintf(msg, sizeof(msg), "ignoring unknown kerf.mounts entry '%.*s'",
+                     (int)(len > 64 ? 64 : len), p);
+            log_msg(msg);
+        }
+
+        p += len;
+        if (*p == ',')
+            p++;
+    }
+
+    return mounts;
+}
+
+/* Parse a cpu list such as "0-3,6" into set; returns -1 if malformed */
+static int parse_cpus(const char *p, size_t len, cpu_set_t *set)
+{
+    const char *end = p + len;
+
+    CPU_ZERO(set);
+    while (p < end) {
+        char *next;
+        unsigned long first = strtoul(p, &next, 10);
+        unsigned long last = first;
+
+        if (next == p)
+            return -1;
+        if (*next == '-') {
+            p = next + 1;
+            last = strtoul(p, &next, 10);
+            if (next == p || last < first)
+                return -1;
+        }
+        if (next > end || last >= CPU_SETSIZE)
+            return -1;
+
+        for (unsigned long cpu = first; cpu <= last; cpu++)
+            CPU_SET(cpu, set);
+
+        p = next;
+        if (p < end && *p++ != ',')
+            return -1;
+    }
+
+    return CPU_COUNT(set) ? 0 : -1;
+}
+
+/* Parse kerf.sched=<policy>[:<priority>], e.g. kerf.sched=fifo:50 */
+static int read_sched(const char *cmdline, int *policy,
+                      struct sched_param *param)
+{
+    static const struct {
+        const char *name;
+        int policy;
+    } names[] = {
+        { "other", SCHED_OTHER },
+        { "batch", SCHED_BATCH },
+        { "idle",  SCHED_IDLE },
+        { "fifo",  SCHED_FIFO },
+        { "rr",    SCHED_RR },
+    };
+    size_t len;
+    const char *p = cmdline_value(cmdline, SCHED_KEY, &len);
+
+    if (!p)
+        return -1;
+
+    size_t name_len = strcspn(p, ": \n");
+    for (size_t i = 0; i < sizeof(names) / sizeof(names[0]); i++) {
+        if (strlen(names[i].name) != name_len ||
+            memcmp(names[i].name, p, name_len) != 0)
+            continue;
+
+        *policy = names[i].policy;
+        memset(param, 0, sizeof(*param));
+        if (*policy == SCHED_FIFO || *policy == SCHED_RR)
+            param->sched_priority = 1;
+        if (p[name_len] == ':')
+            param->sched_priority = atoi(p + name_len + 1);
+        return 0;
+    }
+
+    log_msg("ignoring unknown kerf.sched policy");
+    return -1;
+}
+
+/*
+ * Affinity and scheduling policy are applied in the child right before
+ * execv and survive it, so the entrypoint starts on its CPUs and class.
+ */
+static void apply_affinity(const char *cmdline)
+{
+    size_t len;
+    cpu_set_t set;
+    const char *p = cmdline_value(cmdline, CPUS_KEY, &len);
+
+    if (!p)
+        return;
+
+    if (parse_cpus(p, len, &set) < 0) {
+        log_msg("ignoring malformed kerf.cpus");
+        return;
+    }
+
+    if (sched_setaffinity(0, sizeof(set), &set) < 0)
+        log_error("sched_setaffinity");
+}
+
+static void apply_sched(const char *cmdline)
+{
+    int policy;
+    struct sched_param param;
+
+    if (read_sched(cmdline, &policy, &param) < 0)
+        return;
+
+    /* musl's sched_setscheduler() is a stub returning ENOSYS */
+    if (syscall(SYS_sched_setscheduler, 0, policy, &param) < 0)
+        log_error("sched_setscheduler");
+}
+
+static int read_mlockall(const char *cmdline)
+{
+    size_t len;
+    const char *p = cmdline_value(cmdline, MLOCKALL_KEY, &len);
+
+    return p && len == 1 && *p == '1';
+}
+
+/*
+ * Memory locks do not survive execve, so kerf.mlockall=1 lifts
+ * RLIMIT_MEMLOCK for the entrypoint to lock itself, and locks init
+ * along with the prefaulted mappings it keeps below.
+ */
+static void apply_mlockall(void)
+{
+    struct rlimit rl = { RLIM_INFINITY, RLIM_INFINITY };
+
+    if (setrlimit(RLIMIT_MEMLOCK, &rl) < 0)
+        log_error("setrlimit RLIMIT_MEMLOCK");
+
+    if (mlockall(MCL_CURRENT | MCL_FUTURE) < 0)
+        log_error("mlockall");
+}
+
+static void prefault_file(const char *path, int keep)
+{
+    struct stat st;
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+
+    if (fd < 0) {
+        log_error(path);
+        return;
+    }
+
+    if (fstat(fd, &st) < 0 || !S_ISREG(st.st_mode) || st.st_size == 0) {
+        close(fd);
+        return;
+    }
+
+    void *addr = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE | MAP_POPULATE,
+                      fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED) {
+        log_error(path);
+        return;
+    }
+
+    madvise(addr, st.st_size, MADV_WILLNEED);
+    if (!keep)
+        munmap(addr, st.st_size);
+}
+
+/*
+ * Fault in kerf.prefault=<path>[,<path>...] before the entrypoint runs,
+ * so its first request does not stall on daxfs mapping faults. With
+ * mlockall the mappings stay in init, locked.
+ */
+static int prefault_files(const char *cmdline, int keep)
+{
+    char paths[MAX_PREFAULT_LEN];
+    size_t len;
+    const char *p = cmdline_value(cmdline, PREFAULT_KEY, &len);
+
+    if (!p)
+        return 0;
+
+    if (len >= sizeof(paths)) {
+        log_msg("kerf.prefault value too long");
+        return 0;
+    }
+
+    memcpy(paths, p, len);
+    paths[len] = '\0';
+
+    char *save;
+    for (char *path = strtok_r(paths, ",", &save); path;
+         path = strtok_r(NULL, ",", &save))
+        prefault_file(path, keep);
+
+    return 1;
+}
+
+static void setup_console(const char *tty, int ctty)
 {
     int fd;
     struct termios term;
@@ -239,8 +603,9 @@ static void setup_console(const char *tty)
         return;
     }
 
-    /* Make it the controlling terminal */
-    ioctl(fd, TIOCSCTTY, 1);
+    /* Make it the controlling terminal of the first service only */
+    if (ctty)
+        ioctl(fd, TIOCSCTTY, 1);
 
     /* Set up termios */
     if (tcgetattr(fd, &term) == 0) {
@@ -304,6 +669,273 @@ static int parse_args(char *cmdline, char **argv, int max_args)
     return argc;
 }
 
+/*
+ * kerf.restart=always|on-failure|never; supervisor mode restarts
+ * always by default, a lone kerf.entrypoint= never does.
+ */
+static enum restart_policy read_restart(const char *cmdline,
+                                        enum restart_policy def)
+{
+    size_t len;
+    const char *p = cmdline_value(cmdline, RESTART_KEY, &len);
+
+    if (!p)
+        return def;
+    if (len == 6 && memcmp(p, "always", 6) == 0)
+        return RESTART_ALWAYS;
+    if (len == 10 && memcmp(p, "on-failure", 10) == 0)
+        return RESTART_ON_FAILURE;
+    if (len == 5 && memcmp(p, "never", 5) == 0)
+        return RESTART_NEVER;
+
+    log_msg("ignoring unknown kerf.restart policy");
+    return def;
+}
+
+static int add_service(int id, const char *command)
+{
+    struct service *svc = &services[nr_services];
+
+    svc->id = id;
+    snprintf(svc->command, sizeof(svc->command), "%s", command);
+    if (parse_args(svc->command, svc->argv, MAX_ARGS) == 0) {
+        log_msg("no entrypoint arguments");
+        return -1;
+    }
+
+    svc->pid = -1;
+    svc->backoff_ms = BACKOFF_MIN_MS;
+    nr_services++;
+    return 0;
+}
+
+/* Collect kerf.svc.N= services, or fall back to kerf.entrypoint= */
+static int read_services(const char *cmdline)
+{
+    char command[MAX_ENTRYPOINT_LEN];
+    char key[32];
+    int ret;
+
+    for (int i = 0; i < MAX_SERVICES; i++) {
+        snprintf(key, sizeof(key), SERVICE_KEY, i);
+        ret = read_command(cmdline, key, command, sizeof(command));
+        if (ret == -1)
+            continue;
+        if (ret < 0 || add_service(i, command) < 0)
+            return -1;
+    }
+
+    if (nr_services) {
+        supervisor_mode = 1;
+        restart_policy = read_restart(cmdline, RESTART_ALWAYS);
+        return 0;
+    }
+
+    ret = read_command(cmdline, ENTRYPOINT_KEY, command, sizeof(command));
+    if (ret == -1)
+        log_msg("kerf.entrypoint= not found in cmdline");
+    if (ret < 0)
+        return -1;
+
+    {
+        char msg[256];
+        snprintf(msg, sizeof(msg), "entrypoint: '%.200s'", command);
+        log_msg(msg);
+    }
+
+    restart_policy = read_restart(cmdline, RESTART_NEVER);
+    return add_service(0, command);
+}
+
+static uint64_t now_ms(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+static void service_name(const struct service *svc, char *buf, size_t bufsize)
+{
+    if (supervisor_mode)
+        snprintf(buf, bufsize, "service %d", svc->id);
+    else
+        snprintf(buf, bufsize, "child");
+}
+
+/* Map the status record through /dev/mem; without it, run unreported */
+static void open_status(const char *cmdline, uint64_t boot_tsc)
+{
+    size_t len;
+    const char *p = cmdline_value(cmdline, STATUS_KEY, &len);
+
+    if (!p)
+        return;
+
+    uint64_t addr = strtoull(p, NULL, 0);
+    uint64_t page = addr & ~(uint64_t)(sysconf(_SC_PAGESIZE) - 1);
+
+    if (addr - page + sizeof(*status_rec) > (uint64_t)sysconf(_SC_PAGESIZE)) {
+        log_msg("kerf.status record crosses a page");
+        return;
+    }
+
+    int fd = open("/dev/mem", O_RDWR | O_SYNC | O_CLOEXEC);
+    if (fd < 0) {
+        log_error("/dev/mem");
+        return;
+    }
+
+    void *map = mmap(NULL, sysconf(_SC_PAGESIZE), PROT_READ | PROT_WRITE,
+                     MAP_SHARED, fd, page);
+    close(fd);
+    if (map == MAP_FAILED) {
+        log_error("mmap kerf.status");
+        return;
+    }
+
+    status_rec = (volatile struct status_record *)((char *)map + (addr - page));
+
+    status_rec->seq |= 1;
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    status_rec->magic = STATUS_MAGIC;
+    status_rec->version = STATUS_VERSION;
+    status_rec->nr_services = nr_services;
+    status_rec->boot_tsc = boot_tsc;
+    status_rec->heartbeats = 0;
+    for (int i = 0; i < MAX_SERVICES; i++) {
+        status_rec->services[i].state = i < nr_services ? SVC_BOOTING : 0;
+        status_rec->services[i].exit_status = 0;
+        status_rec->services[i].pid = 0;
+        status_rec->services[i].restarts = 0;
+    }
+    status_rec->update_tsc = rdtsc();
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    status_rec->seq++;
+}
+
+static void status_begin(void)
+{
+    status_rec->seq++;
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+static void status_end(void)
+{
+    status_rec->update_tsc = rdtsc();
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    status_rec->seq++;
+}
+
+static void report_service(int idx, enum service_state state)
+{
+    const struct service *svc = &services[idx];
+
+    if (!status_rec)
+        return;
+
+    status_begin();
+    status_rec->services[idx].state = state;
+    status_rec->services[idx].exit_status = svc->exit_status;
+    status_rec->services[idx].pid = svc->pid > 0 ? (uint32_t)svc->pid : 0;
+    status_rec->services[idx].restarts = svc->restarts;
+    status_end();
+}
+
+static void report_heartbeat(void)
+{
+    if (!status_rec)
+        return;
+
+    status_begin();
+    status_rec->heartbeats++;
+    status_end();
+}
+
+static int start_service(int idx)
+{
+    struct service *svc = &services[idx];
+    /* Only the first launch of the first service is on the boot timeline */
+    int first_boot = idx == 0 && svc->restarts == 0;
+
+    {
+        char msg[512];
+        int off = snprintf(msg, sizeof(msg), "executing:");
+        for (int i = 0; svc->argv[i] && off < (int)sizeof(msg) - 1; i++)
+            off += snprintf(msg + off, sizeof(msg) - off, " %s", svc->argv[i]);
+        log_msg(msg);
+    }
+
+    svc->started_ms = now_ms();
+
+    pid_t pid = fork();
+    if (pid < 0) {
+        log_error("fork");
+        return -1;
+    }
+
+    if (pid == 0) {
+        /* Child process: SIGCHLD is blocked in init, not in services */
+        sigprocmask(SIG_SETMASK, &orig_sigmask, NULL);
+
+        if (console_device[0] != '\0') {
+            setup_console(console_device, idx == 0);
+            if (first_boot)
+                log_timing("console");
+        }
+
+        apply_affinity(cmdline);
+        apply_sched(cmdline);
+
+        if (first_boot)
+            log_timing("exec");
+        execv(svc->argv[0], svc->argv);
+        log_error("execv");
+        _exit(127);
+    }
+
+    svc->pid = pid;
+    svc->restart_pending = 0;
+    report_service(idx, SVC_RUNNING);
+    return 0;
+}
+
+/* Log an exit and decide whether, and when, the service comes back */
+static void handle_exit(int idx, uint64_t now)
+{
+    struct service *svc = &services[idx];
+    int status = svc->exit_status;
+    char name[32];
+    char msg[128];
+
+    svc->exited = 0;
+    svc->pid = -1;
+    service_name(svc, name, sizeof(name));
+
+    snprintf(msg, sizeof(msg), "%s exited with status %d", name, status);
+    log_msg(msg);
+
+    if (stopping || restart_policy == RESTART_NEVER ||
+        (restart_policy == RESTART_ON_FAILURE && status == 0)) {
+        report_service(idx, SVC_EXITED);
+        return;
+    }
+
+    if (now - svc->started_ms >= BACKOFF_RESET_MS)
+        svc->backoff_ms = BACKOFF_MIN_MS;
+
+    svc->restart_pending = 1;
+    svc->restart_at_ms = now + svc->backoff_ms;
+    snprintf(msg, sizeof(msg), "restarting %s in %u ms", name, svc->backoff_ms);
+    log_msg(msg);
+
+    svc->backoff_ms *= 2;
+    if (svc->backoff_ms > BACKOFF_MAX_MS)
+        svc->backoff_ms = BACKOFF_MAX_MS;
+    svc->restarts++;
+    report_service(idx, SVC_RESTARTING);
+}
+
 static void sigchld_handler(int sig)
 {
     (void)sig;
@@ -311,27 +943,39 @@ static void sigchld_handler(int sig)
     pid_t pid;
 
     while ((pid = waitpid(-1, &status, WNOHANG)) > 0) {
-        if (pid == child_pid) {
-            child_exited = 1;
+        for (int i = 0; i < nr_services; i++) {
+            if (services[i].pid != pid)
+                continue;
+
+            if (!child_exit_tsc)
+                child_exit_tsc = rdtsc();
             if (WIFEXITED(status)) {
-                child_exit_status = WEXITSTATUS(status);
+                services[i].exit_status = WEXITSTATUS(status);
             } else if (WIFSIGNALED(status)) {
-                child_exit_status = 128 + WTERMSIG(status);
+                services[i].exit_status = 128 + WTERMSIG(status);
             }
+            services[i].exited = 1;
+            break;
         }
     }
 }
 
 static void forward_signal(int sig)
 {
-    if (child_pid > 0) {
-        kill(child_pid, sig);
+    /* Services told to terminate stay down */
+    if (sig != SIGHUP)
+        stopping = 1;
+
+    for (int i = 0; i < nr_services; i++) {
+        if (services[i].pid > 0)
+            kill(services[i].pid, sig);
     }
 }
 
 static void setup_signals(void)
 {
     struct sigaction sa;
+    sigset_t chld;
 
     /* Handle SIGCHLD to reap zombies */
     memset(&sa, 0, sizeof(sa));
@@ -339,12 +983,76 @@ static void setup_signals(void)
     sa.sa_flags = SA_RESTART | SA_NOCLDSTOP;
     sigaction(SIGCHLD, &sa, NULL);
 
-    /* Forward termination signals to child */
+    /* Forward termination signals to the services */
     sa.sa_handler = forward_signal;
     sa.sa_flags = SA_RESTART;
     sigaction(SIGTERM, &sa, NULL);
     sigaction(SIGINT, &sa, NULL);
     sigaction(SIGHUP, &sa, NULL);
+
+    /* SIGCHLD is only taken inside ppoll(), so no exit is missed */
+    sigemptyset(&chld);
+    sigaddset(&chld, SIGCHLD);
+    sigprocmask(SIG_BLOCK, &chld, &orig_sigmask);
+}
+
+/*
+ * PID 1 must never exit or the kernel will panic. Keep reaping, log
+ * exits, and restart services when their backoff expires.
+ */
+static void supervise(void)
+{
+    int first_exit = 1;
+    uint64_t heartbeat_at = now_ms() + HEARTBEAT_MS;
+
+    for (;;) {
+        uint64_t now = now_ms();
+        uint64_t next = 0;
+        int pending = 0;
+
+        if (status_rec) {
+            if (heartbeat_at <= now) {
+                report_heartbeat();
+                heartbeat_at = now + HEARTBEAT_MS;
+            }
+            next = heartbeat_at;
+            pending = 1;
+        }
+
+        for (int i = 0; i < nr_services; i++) {
+            struct service *svc = &services[i];
+
+            if (svc->exited) {
+                /* Stamped in the SIGCHLD handler, not when we got here */
+                if (first_exit) {
+                    log_timing_at("child_exit", child_exit_tsc);
+                    first_exit = 0;
+                }
+                handle_exit(i, now);
+            }
+
+            if (!svc->restart_pending)
+                continue;
+            if (stopping) {
+                svc->restart_pending = 0;
+                continue;
+            }
+            if (svc->restart_at_ms <= now && start_service(i) < 0)
+                svc->restart_at_ms = now + svc->backoff_ms;
+            if (svc->restart_pending && (!pending || svc->restart_at_ms < next)) {
+                next = svc->restart_at_ms;
+                pending = 1;
+            }
+        }
+
+        struct timespec timeout;
+        if (pending) {
+            uint64_t wait_ms = next > now ? next - now : 0;
+            timeout.tv_sec = wait_ms / 1000;
+            timeout.tv_nsec = (wait_ms % 1000) * 1000000;
+        }
+        ppoll(NULL, 0, pending ? &timeout : NULL, &orig_sigmask);
+    }
 }
 
 int main(int argc, char *argv[])
@@ -352,29 +1060,22 @@ int main(int argc, char *argv[])
     (void)argc;
     (void)argv;
 
-    char entrypoint[MAX_ENTRYPOINT_LEN];
-    char *ep_argv[MAX_ARGS];
+    uint64_t boot_tsc = rdtsc();
 
-    log_starting();
+    log_timing_at("start", boot_tsc);
 
-    if (mount_filesystems() < 0) {
-        log_msg("failed to mount filesystems");
+    if (mount_proc() < 0 || read_cmdline(cmdline, sizeof(cmdline)) < 0) {
+        log_msg("failed to read cmdline");
         return 1;
     }
 
-    if (read_entrypoint(entrypoint, sizeof(entrypoint)) < 0) {
+    if (read_services(cmdline) < 0) {
         log_msg("failed to read entrypoint");
         return 1;
     }
 
-    {
-        char msg[256];
-        snprintf(msg, sizeof(msg), "entrypoint: '%.200s'", entrypoint);
-        log_msg(msg);
-    }
-
     /* Read console device (optional) */
-    if (read_console(console_device, sizeof(console_device)) == 0) {
+    if (read_console(cmdline, console_device, sizeof(console_device)) == 0) {
         char msg[128];
         snprintf(msg, sizeof(msg), "console: %s", console_device);
         log_msg(msg);
@@ -382,53 +1083,41 @@ int main(int argc, char *argv[])
         console_device[0] = '\0';
     }
 
-    int ep_argc = parse_args(entrypoint, ep_argv, MAX_ARGS);
-    if (ep_argc == 0) {
-        log_msg("no entrypoint arguments");
-        return 1;
-    }
+    unsigned int mounts = read_mounts(cmdline);
 
-    {
-        char msg[512];
-        int off = snprintf(msg, sizeof(msg), "executing:");
-        for (int i = 0; i < ep_argc && off < (int)sizeof(msg) - 1; i++)
-            off += snprintf(msg + off, sizeof(msg) - off, " %s", ep_argv[i]);
-        log_msg(msg);
-    }
+    /* The console node and /dev/mem come from devtmpfs */
+    if (console_device[0] != '\0' || strstr(cmdline, STATUS_KEY))
+        mounts |= MOUNT_DEV;
 
-    setup_signals();
+    log_timing("cmdline");
 
-    child_pid = fork();
-    if (child_pid < 0) {
-        log_error("fork");
+    if (mount_filesystems(mounts) < 0) {
+        log_msg("failed to mount filesystems");
         return 1;
     }
 
-    if (child_pid == 0) {
-        /* Child process */
-        if (console_device[0] != '\0')
-            setup_console(console_device);
+    log_timing("mounted");
 
-        execv(ep_argv[0], ep_argv);
-        log_error("execv");
-        _exit(127);
-    }
+    open_status(cmdline, boot_tsc);
 
-    /* Parent process - stay as PID 1 forever.
-     * PID 1 must never exit or the kernel will panic.
-     * Keep reaping zombies and waiting for signals.
-     */
-    for (;;) {
-        pause();
-        if (child_exited) {
-            char msg[64];
-            snprintf(msg, sizeof(msg), "child exited with status %d",
-                     child_exit_status);
-            log_msg(msg);
-            child_exited = 0;  /* Reset for any future children */
+    int mlock = read_mlockall(cmdline);
+    if (mlock)
+        apply_mlockall();
+
+    if (prefault_files(cmdline, mlock))
+        log_timing("prefault");
+
+    setup_signals();
+
+    for (int i = 0; i < nr_services; i++) {
+        if (start_service(i) < 0) {
+            services[i].restart_pending = 1;
+            services[i].restart_at_ms = now_ms() + BACKOFF_MIN_MS;
         }
     }
 
+    supervise();
+
     /* Never reached */
     return 0;
 }
@@ -0,0 +1,746 @@
+/*
+ * Copyright 2026 Multikernel Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Native daxfs image writer.
+ *
+ * Emits the same on-disk layout as DaxfsBuilder in kerf/daxfs/mkdaxfs.py:
+ *
+ *   block 0         superblock
+ *   inode table     64-byte inodes, ino N at (N - 1) * 64
+ *   string table    NUL-terminated names, packed
+ *   data            one block-aligned extent per regular file / symlink
+ *
+ * Entries are numbered in pre-order, each directory's children sorted by
+ * name, exactly as the Python builder does. With --huge-align, extents of
+ * files at least --huge-threshold bytes long are aligned to the largest
+ * hugepage size they fill and placed after the 4K-aligned ones.
+ *
+ * Usage:
+ * Layout options, accepted in every mode:
+ *   --huge-align <bytes>      2097152 or 1073741824
+ *   --huge-threshold <bytes>  default 2097152
+ * Write options:
+ *   --threads <n>             threads filling data extents, default 1
+ *
+ *   mkdaxfs --print-size <dir>
+ *       Print the required image size in bytes.
+ *   mkdaxfs --dmabuf-fd <fd> --size <bytes> [--zeroed] <dir>
+ *       Write the image into an already allocated dma-buf.
+ *   mkdaxfs --dmabuf-stdin [--zeroed] <dir>
+ *       Print the required size, then receive the dma-buf over stdin, a
+ *       unix socket: one message holding the allocated size in decimal,
+ *       with the fd as SCM_RIGHTS. kerf allocates in between, so the tree
+ *       is walked once. EOF instead of a message exits without writing.
+ *   mkdaxfs --output <file> [--size <bytes>] <dir>
+ *       Write the image into a regular file.
+ *
+ * In write modes the number of file data bytes copied is printed on stdout.
+ */
+
+#define _GNU_SOURCE
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define DAXFS_MAGIC 0x64646178
+#define DAXFS_VERSION 1
+#define DAXFS_BLOCK_SIZE 4096
+#define DAXFS_INODE_SIZE 64
+#define DAXFS_ROOT_INO 1
+#define DAXFS_COPY_CHUNK (4 * 1024 * 1024)
+
+#define DAXFS_HUGE_2M (2ULL << 20)
+#define DAXFS_HUGE_1G (1ULL << 30)
+
+#define DAXFS_FLAG_HUGE_ALIGNED (1U << 0)
+#define DAXFS_FLAG_ALIGN_SHIFT 8
+
+struct daxfs_super {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t flags;
+    uint32_t block_size;
+    uint64_t total_size;
+    uint64_t inode_offset;
+    uint32_t inode_count;
+    uint32_t root_ino;
+    uint64_t strtab_offset;
+    uint64_t strtab_size;
+    uint64_t data_offset;
+} __attribute__((packed));
+
+struct daxfs_inode {
+    uint32_t ino;
+    uint32_t mode;
+    uint32_t uid;
+    uint32_t gid;
+    uint64_t size;
+    uint64_t data_offset;
+    uint32_t name_offset;
+    uint32_t name_len;
+    uint32_t parent_ino;
+    uint32_t nlink;
+    uint32_t first_child;
+    uint32_t next_sibling;
+    uint8_t reserved[8];
+} __attribute__((packed));
+
+_Static_assert(sizeof(struct daxfs_super) == 64, "superblock layout");
+_Static_assert(sizeof(struct daxfs_inode) == DAXFS_INODE_SIZE, "inode layout");
+
+struct entry {
+    char *path;         /* relative to the source dir, "" for root */
+    const char *name;   /* points into path */
+    struct stat st;
+    uint32_t parent_ino;
+    uint32_t first_child;
+    uint32_t next_sibling;
+    uint64_t data_offset;
+    uint64_t align;
+    uint32_t name_offset;
+    uint32_t nlink;     /* links within the image, not the host's st_nlink */
+};
+
+struct range {
+    uint64_t start;
+    uint64_t end;
+};
+
+static struct entry *entries;
+static size_t nr_entries, max_entries;
+static uint64_t strtab_size;
+static uint64_t data_size;
+static int src_dirfd = -1;
+
+static uint64_t huge_align;
+static uint64_t huge_threshold = DAXFS_HUGE_2M;
+static uint64_t huge_padding;
+static struct range *padding_ranges;
+static size_t nr_padding_ranges;
+
+/* Extent filling, shared by the worker threads */
+struct fill_job {
+    uint8_t *mem;
+    int dmabuf_fd;
+    int zeroed;
+    size_t *order;      /* indices of entries with data, largest first */
+    size_t nr_order;
+    size_t next;        /* next index into order, taken atomically */
+    int kernel_copy;    /* cleared once the dma-buf rejects copy_file_range() */
+    uint64_t bytes_written;
+};
+
+static void die(const char *msg)
+{
+    fprintf(stderr, "mkdaxfs: %s: %s\n", msg, strerror(errno));
+    exit(1);
+}
+
+static uint64_t align_up(uint64_t v, uint64_t a)
+{
+    return (v + a - 1) & ~(a - 1);
+}
+
+static int has_data(mode_t mode)
+{
+    return S_ISREG(mode) || S_ISLNK(mode);
+}
+
+static uint32_t add_entry(char *path, const struct stat *st, uint32_t parent_ino)
+{
+    struct entry *e;
+    const char *slash;
+
+    if (nr_entries == max_entries) {
+        max_entries = max_entries ? max_entries * 2 : 1024;
+        entries = realloc(entries, max_entries * sizeof(*entries));
+        if (!entries)
+            die("realloc");
+    }
+
+    e = &entries[nr_entries++];
+    memset(e, 0, sizeof(*e));
+    e->path = path;
+    slash = strrchr(path, '/');
+    e->name = slash ? slash + 1 : path;
+    e->st = *st;
+    e->parent_ino = parent_ino;
+
+    strtab_size += strlen(e->name) + 1;
+    if (has_data(st->st_mode))
+        data_size += align_up(st->st_size, DAXFS_BLOCK_SIZE);
+
+    return nr_entries;  /* inode numbers start at 1 */
+}
+
+static int cmp_names(const void *a, const void *b)
+{
+    return strcmp(*(char * const *)a, *(char * const *)b);
+}
+
+static void scan_dir(const char *relpath, uint32_t dir_ino)
+{
+    DIR *dir;
+    struct dirent *de;
+    char **names = NULL;
+    size_t n = 0, cap = 0;
+    uint32_t tail = 0;
+    int fd;
+
+    fd = openat(src_dirfd, *relpath ? relpath : ".",
+                O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd < 0) {
+        if (errno == EACCES || errno == EPERM)
+            return;
+        die(relpath);
+    }
+
+    dir = fdopendir(fd);
+    if (!dir)
+        die("fdopendir");
+
+    while ((de = readdir(dir)) != NULL) {
+        if (!strcmp(de->d_name, ".") || !strcmp(de->d_name, ".."))
+            continue;
+        if (n == cap) {
+            cap = cap ? cap * 2 : 64;
+            names = realloc(names, cap * sizeof(*names));
+            if (!names)
+                die("realloc");
+        }
+        names[n] = strdup(de->d_name);
+        if (!names[n])
+            die("strdup");
+        n++;
+    }
+    closedir(dir);
+
+    qsort(names, n, sizeof(*names), cmp_names);
+
+    for (size_t i = 0; i < n; i++) {
+        struct stat st;
+        char *path;
+        uint32_t ino;
+
+        if (*relpath) {
+            if (asprintf(&path, "%s/%s", relpath, names[i]) < 0)
+                die("asprintf");
+            free(names[i]);
+        } else {
+            path = names[i];
+        }
+
+        if (fstatat(src_dirfd, path, &st, AT_SYMLINK_NOFOLLOW) < 0) {
+            if (errno == EACCES || errno == EPERM || errno == ENOENT) {
+                free(path);
+                continue;
+            }
+            die(path);
+        }
+
+        ino = add_entry(path, &st, dir_ino);
+
+        /* Link in directory order, keeping a tail pointer */
+        if (tail)
+            entries[tail - 1].next_sibling = ino;
+        else
+            entries[dir_ino - 1].first_child = ino;
+        tail = ino;
+
+        if (S_ISDIR(st.st_mode))
+            scan_dir(path, ino);
+    }
+
+    free(names);
+}
+
+static void scan(const char *src)
+{
+    struct stat st;
+    char *root = strdup("");
+
+    src_dirfd = open(src, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (src_dirfd < 0)
+        die(src);
+    if (fstat(src_dirfd, &st) < 0)
+        die(src);
+    if (!root)
+        die("strdup");
+
+    add_entry(root, &st, 0);
+    scan_dir("", DAXFS_ROOT_INO);
+}
+
+static int cmp_inodes(const void *a, const void *b)
+{
+    const struct stat *x = &entries[*(const size_t *)a].st;
+    const struct stat *y = &entries[*(const size_t *)b].st;
+
+    if (x->st_dev != y->st_dev)
+        return x->st_dev < y->st_dev ? -1 : 1;
+    if (x->st_ino != y->st_ino)
+        return x->st_ino < y->st_ino ? -1 : 1;
+    return 0;
+}
+
+/*
+ * Count links within the scanned tree. The host's st_nlink also counts
+ * links outside it (hard-linked rootfs clones of kerf's image cache), and
+ * identical trees must produce identical images.
+ */
+static void count_links(void)
+{
+    size_t *order, n = 0;
+
+    order = malloc(nr_entries * sizeof(*order));
+    if (!order && nr_entries)
+        die("malloc");
+
+    for (size_t i = 0; i < nr_entries; i++) {
+        if (S_ISDIR(entries[i].st.st_mode))
+            entries[i].nlink = 2;
+        else
+            order[n++] = i;
+    }
+    for (size_t i = 1; i < nr_entries; i++) {
+        if (S_ISDIR(entries[i].st.st_mode))
+            entries[entries[i].parent_ino - 1].nlink++;
+    }
+
+    qsort(order, n, sizeof(*order), cmp_inodes);
+    for (size_t i = 0, j; i < n; i = j) {
+        for (j = i + 1; j < n && !cmp_inodes(&order[i], &order[j]); j++)
+            ;
+        for (size_t k = i; k < j; k++)
+            entries[order[k]].nlink = j - i;
+    }
+    free(order);
+}
+
+static uint64_t inode_offset(void)
+{
+    return DAXFS_BLOCK_SIZE;
+}
+
+static uint64_t strtab_offset(void)
+{
+    return inode_offset() + nr_entries * DAXFS_INODE_SIZE;
+}
+
+static uint64_t data_offset(void)
+{
+    return align_up(strtab_offset() + strtab_size, DAXFS_BLOCK_SIZE);
+}
+
+static uint64_t total_size(void)
+{
+    return data_offset() + data_size + huge_padding;
+}
+
+static uint64_t extent_alignment(uint64_t size)
+{
+    if (!huge_align || size < huge_threshold)
+        return DAXFS_BLOCK_SIZE;
+    if (huge_align >= DAXFS_HUGE_1G && size >= DAXFS_HUGE_1G)
+        return DAXFS_HUGE_1G;
+    return DAXFS_HUGE_2M;
+}
+
+static void calculate_offsets(void)
+{
+    static const uint64_t huge_sizes[] = { DAXFS_HUGE_1G, DAXFS_HUGE_2M };
+    uint64_t off = data_offset();
+    uint32_t str_off = 0;
+
+    for (size_t i = 0; i < nr_entries; i++) {
+        struct entry *e = &entries[i];
+
+        e->name_offset = str_off;
+        str_off += strlen(e->name) + 1;
+
+        if (!has_data(e->st.st_mode))
+            continue;
+        e->align = extent_alignment(e->st.st_size);
+        if (e->align == DAXFS_BLOCK_SIZE) {
+            e->data_offset = off;
+            off += align_up(e->st.st_size, DAXFS_BLOCK_SIZE);
+        }
+    }
+
+    /* Largest alignment first, in pre-order within each size */
+    for (size_t k = 0; k < sizeof(huge_sizes) / sizeof(huge_sizes[0]); k++) {
+        for (size_t i = 0; i < nr_entries; i++) {
+            struct entry *e = &entries[i];
+            uint64_t aligned;
+
+            if (!has_data(e->st.st_mode) || e->align != huge_sizes[k])
+                continue;
+
+            aligned = align_up(off, e->align);
+            if (aligned > off) {
+                padding_ranges = realloc(padding_ranges,
+                                         (nr_padding_ranges + 1) * sizeof(*padding_ranges));
+                if (!padding_ranges)
+                    die("realloc");
+                padding_ranges[nr_padding_ranges++] = (struct range){ off, aligned };
+                huge_padding += aligned - off;
+            }
+            e->data_offset = aligned;
+            off = aligned + align_up(e->st.st_size, DAXFS_BLOCK_SIZE);
+        }
+    }
+}
+
+static uint32_t superblock_flags(void)
+{
+    if (!huge_align)
+        return 0;
+    return DAXFS_FLAG_HUGE_ALIGNED |
+           ((uint32_t)__builtin_ctzll(huge_align) << DAXFS_FLAG_ALIGN_SHIFT);
+}
+
+/* Copy a regular file's data, clamped to the size seen at scan time */
+static uint64_t copy_file(struct entry *e, uint8_t *mem, int dmabuf_fd,
+                          int *kernel_copy)
+{
+    uint64_t size = e->st.st_size;
+    uint64_t copied = 0;
+    int fd;
+
+    fd = openat(src_dirfd, e->path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        if (errno == EACCES || errno == EPERM || errno == ENOENT || errno == EISDIR)
+            return 0;
+        die(e->path);
+    }
+
+    if (dmabuf_fd >= 0 && __atomic_load_n(kernel_copy, __ATOMIC_RELAXED)) {
+        while (copied < size) {
+            loff_t in_off = copied;
+            loff_t out_off = e->data_offset + copied;
+            size_t len = size - copied < DAXFS_COPY_CHUNK ? size - copied : DAXFS_COPY_CHUNK;
+            ssize_t n = copy_file_range(fd, &in_off, dmabuf_fd, &out_off, len, 0);
+
+            if (n < 0) {
+                if (errno == EXDEV || errno == EINVAL || errno == EOPNOTSUPP ||
+                    errno == ENOSYS || errno == EBADF) {
+                    /* Not supported by this dma-buf; don't retry later files */
+                    __atomic_store_n(kernel_copy, 0, __ATOMIC_RELAXED);
+                    break;
+                }
+                die(e->path);
+            }
+            if (n == 0)
+                goto out;
+            copied += n;
+        }
+    }
+
+    while (copied < size) {
+        size_t len = size - copied < DAXFS_COPY_CHUNK ? size - copied : DAXFS_COPY_CHUNK;
+        ssize_t n = pread(fd, mem + e->data_offset + copied, len, copied);
+
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            die(e->path);
+        }
+        if (n == 0)
+            break;
+        copied += n;
+    }
+
+out:
+    close(fd);
+    return copied;
+}
+
+static uint64_t copy_symlink(struct entry *e, uint8_t *mem)
+{
+    ssize_t n = readlinkat(src_dirfd, e->path, (char *)mem + e->data_offset,
+                           e->st.st_size);
+
+    return n < 0 ? 0 : (uint64_t)n;
+}
+
+static int cmp_extent_sizes(const void *a, const void *b)
+{
+    off_t x = entries[*(const size_t *)a].st.st_size;
+    off_t y = entries[*(const size_t *)b].st.st_size;
+
+    return x < y ? 1 : x > y ? -1 : 0;
+}
+
+/* Extents are disjoint, so workers fill them in any order */
+static void *fill_extents(void *arg)
+{
+    struct fill_job *job = arg;
+    size_t i;
+
+    while ((i = __atomic_fetch_add(&job->next, 1, __ATOMIC_RELAXED)) < job->nr_order) {
+        struct entry *e = &entries[job->order[i]];
+        uint64_t written;
+
+        if (S_ISREG(e->st.st_mode))
+            written = copy_file(e, job->mem, job->dmabuf_fd, &job->kernel_copy);
+        else
+            written = copy_symlink(e, job->mem);
+        __atomic_fetch_add(&job->bytes_written, written, __ATOMIC_RELAXED);
+
+        if (!job->zeroed)
+            memset(job->mem + e->data_offset + written, 0,
+                   align_up(e->st.st_size, DAXFS_BLOCK_SIZE) - written);
+    }
+    return NULL;
+}
+
+static uint64_t write_image(uint8_t *mem, uint64_t mem_size, int dmabuf_fd, int zeroed,
+                            unsigned int threads)
+{
+    struct daxfs_super sb = {
+        .magic = DAXFS_MAGIC,
+        .version = DAXFS_VERSION,
+        .flags = superblock_flags(),
+        .block_size = DAXFS_BLOCK_SIZE,
+        .total_size = total_size(),
+        .inode_offset = inode_offset(),
+        .inode_count = nr_entries,
+        .root_ino = DAXFS_ROOT_INO,
+        .strtab_offset = strtab_offset(),
+        .strtab_size = strtab_size,
+        .data_offset = data_offset(),
+    };
+    uint8_t *inodes = mem + sb.inode_offset;
+    char *strtab = (char *)mem + sb.strtab_offset;
+    struct fill_job job = {
+        .mem = mem, .dmabuf_fd = dmabuf_fd, .zeroed = zeroed, .kernel_copy = 1,
+    };
+    pthread_t *workers;
+
+    memcpy(mem, &sb, sizeof(sb));
+    if (!zeroed) {
+        memset(mem + sizeof(sb), 0, sb.inode_offset - sizeof(sb));
+        memset(mem + sb.strtab_offset + sb.strtab_size, 0,
+               sb.data_offset - sb.strtab_offset - sb.strtab_size);
+        for (size_t i = 0; i < nr_padding_ranges; i++)
+            memset(mem + padding_ranges[i].start, 0,
+                   padding_ranges[i].end - padding_ranges[i].start);
+        memset(mem + sb.total_size, 0, mem_size - sb.total_size);
+    }
+
+    for (size_t i = 0; i < nr_entries; i++) {
+        struct entry *e = &entries[i];
+        struct daxfs_inode inode = {
+            .ino = i + 1,
+            .mode = e->st.st_mode,
+            .uid = e->st.st_uid,
+            .gid = e->st.st_gid,
+            .size = e->st.st_size,
+            .data_offset = e->data_offset,
+            .name_offset = e->name_offset,
+            .name_len = strlen(e->name),
+            .parent_ino = e->parent_ino,
+            .nlink = e->nlink,
+            .first_child = e->first_child,
+            .next_sibling = e->next_sibling,
+        };
+
+        memcpy(inodes + i * DAXFS_INODE_SIZE, &inode, sizeof(inode));
+        memcpy(strtab + e->name_offset, e->name, inode.name_len + 1);
+    }
+
+    job.order = malloc(nr_entries * sizeof(*job.order));
+    if (!job.order)
+        die("malloc");
+    for (size_t i = 0; i < nr_entries; i++) {
+        if (has_data(entries[i].st.st_mode) && entries[i].st.st_size)
+            job.order[job.nr_order++] = i;
+    }
+    /* Largest first keeps the workers evenly loaded */
+    qsort(job.order, job.nr_order, sizeof(*job.order), cmp_extent_sizes);
+
+    if (threads > job.nr_order)
+        threads = job.nr_order;
+    if (threads <= 1) {
+        fill_extents(&job);
+    } else {
+        workers = calloc(threads, sizeof(*workers));
+        if (!workers)
+            die("calloc");
+        for (unsigned int t = 0; t < threads; t++) {
+            errno = pthread_create(&workers[t], NULL, fill_extents, &job);
+            if (errno)
+                die("pthread_create");
+        }
+        for (unsigned int t = 0; t < threads; t++)
+            pthread_join(workers[t], NULL);
+        free(workers);
+    }
+    free(job.order);
+
+    return job.bytes_written;
+}
+
+/* Receive the allocated size and dma-buf fd; return 0 if the caller hung up */
+static int receive_dmabuf(int sock, uint64_t *mem_size, int *dmabuf_fd)
+{
+    char buf[32] = "";
+    char control[CMSG_SPACE(sizeof(int))];
+    struct iovec iov = { .iov_base = buf, .iov_len = sizeof(buf) - 1 };
+    struct msghdr msg = {
+        .msg_iov = &iov,
+        .msg_iovlen = 1,
+        .msg_control = control,
+        .msg_controllen = sizeof(control),
+    };
+    struct cmsghdr *cmsg;
+    ssize_t n;
+
+    do {
+        n = recvmsg(sock, &msg, MSG_CMSG_CLOEXEC);
+    } while (n < 0 && errno == EINTR);
+    if (n < 0)
+        die("recvmsg");
+    if (n == 0)
+        return 0;
+
+    cmsg = CMSG_FIRSTHDR(&msg);
+    if (!cmsg || cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_RIGHTS ||
+        cmsg->cmsg_len != CMSG_LEN(sizeof(int))) {
+        fprintf(stderr, "mkdaxfs: no dma-buf fd received\n");
+        exit(1);
+    }
+    memcpy(dmabuf_fd, CMSG_DATA(cmsg), sizeof(int));
+    *mem_size = strtoull(buf, NULL, 10);
+    return 1;
+}
+
+static void usage(void)
+{
+    fprintf(stderr,
+            "usage: mkdaxfs [layout options] --print-size <dir>\n"
+            "       mkdaxfs [options] --dmabuf-fd <fd> --size <bytes> [--zeroed] <dir>\n"
+            "       mkdaxfs [options] --dmabuf-stdin [--zeroed] <dir>\n"
+            "       mkdaxfs [options] --output <file> [--size <bytes>] <dir>\n"
+            "layout options: --huge-align <bytes> --huge-threshold <bytes>\n"
+            "write options: --threads <n>\n");
+    exit(2);
+}
+
+int main(int argc, char *argv[])
+{
+    const char *output = NULL;
+    const char *src = NULL;
+    int print_size = 0;
+    int dmabuf_stdin = 0;
+    int dmabuf_fd = -1;
+    unsigned int threads = 1;
+    int zeroed = 0;
+    uint64_t mem_size = 0;
+    uint64_t required;
+    uint8_t *mem;
+    int fd;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--print-size")) {
+            print_size = 1;
+        } else if (!strcmp(argv[i], "--dmabuf-stdin")) {
+            dmabuf_stdin = 1;
+        } else if (!strcmp(argv[i], "--threads") && i + 1 < argc) {
+            threads = strtoul(argv[++i], NULL, 0);
+        } else if (!strcmp(argv[i], "--zeroed")) {
+            zeroed = 1;
+        } else if (!strcmp(argv[i], "--dmabuf-fd") && i + 1 < argc) {
+            dmabuf_fd = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--size") && i + 1 < argc) {
+            mem_size = strtoull(argv[++i], NULL, 0);
+        } else if (!strcmp(argv[i], "--huge-align") && i + 1 < argc) {
+            huge_align = strtoull(argv[++i], NULL, 0);
+        } else if (!strcmp(argv[i], "--huge-threshold") && i + 1 < argc) {
+            huge_threshold = strtoull(argv[++i], NULL, 0);
+        } else if (!strcmp(argv[i], "--output") && i + 1 < argc) {
+            output = argv[++i];
+        } else if (argv[i][0] != '-' && !src) {
+            src = argv[i];
+        } else {
+            usage();
+        }
+    }
+
+    if (!src || (print_size + dmabuf_stdin + (dmabuf_fd >= 0) + (output != NULL)) != 1)
+        usage();
+    if (!threads)
+        usage();
+    if (huge_align && huge_align != DAXFS_HUGE_2M && huge_align != DAXFS_HUGE_1G)
+        usage();
+
+    scan(src);
+    count_links();
+    calculate_offsets();
+    required = total_size();
+
+    if (print_size || dmabuf_stdin) {
+        printf("%llu\n", (unsigned long long)required);
+        if (print_size)
+            return 0;
+        if (fflush(stdout) == EOF)
+            die("stdout");
+        if (!receive_dmabuf(STDIN_FILENO, &mem_size, &dmabuf_fd))
+            return 0;
+    }
+
+    if (!mem_size)
+        mem_size = required;
+    if (mem_size < required) {
+        fprintf(stderr, "mkdaxfs: required size %llu exceeds allocated size %llu\n",
+                (unsigned long long)required, (unsigned long long)mem_size);
+        return 1;
+    }
+
+    if (output) {
+        fd = open(output, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd < 0)
+            die(output);
+        /* A freshly extended file reads as zeroes */
+        if (ftruncate(fd, mem_size) < 0)
+            die("ftruncate");
+        zeroed = 1;
+    } else {
+        fd = dmabuf_fd;
+    }
+
+    mem = mmap(NULL, mem_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mem == MAP_FAILED)
+        die("mmap");
+
+    printf("%llu\n",
+           (unsigned long long)write_image(mem, mem_size, output ? -1 : fd, zeroed, threads));
+
+    if (munmap(mem, mem_size) < 0)
+        die("munmap");
+    if (output && close(fd) < 0)
+        die(output);
+
+    return 0;
+}
@@ -19,33 +19,44 @@ A comprehensive multikernel management system designed to orchestrate
 and manage multiple kernel instances on a single host.
 """
 
+import importlib
+
 __version__ = "0.1.0"
 __author__ = "Cong Wang"
 
-# Export main runtime components for easy access
-from .runtime import DeviceTreeManager
-from .baseline import BaselineManager
-from .dtc.overlay import OverlayGenerator
-from .models import InstanceState
-from .exceptions import (
-    KerfError,
-    ValidationError,
-    ParseError,
-    ResourceConflictError,
-    ResourceExhaustionError,
-    InvalidReferenceError,
-    KernelInterfaceError,
-    ResourceError,
-)
-from .resources import (
-    get_available_cpus,
-    get_allocated_cpus,
-    get_allocated_memory_regions,
-    find_available_memory_base,
-    validate_cpu_allocation,
-    validate_memory_allocation,
-    find_next_instance_id,
-)
+# Main runtime components, imported on first use so that light entry points
+# (the kerfd client) do not pay for the device tree stack
+_EXPORTS = {
+    "DeviceTreeManager": "runtime",
+    "BaselineManager": "baseline",
+    "OverlayGenerator": "dtc.overlay",
+    "InstanceState": "models",
+    "KerfError": "exceptions",
+    "ValidationError": "exceptions",
+    "ParseError": "exceptions",
+    "ResourceConflictError": "exceptions",
+    "ResourceExhaustionError": "exceptions",
+    "InvalidReferenceError": "exceptions",
+    "KernelInterfaceError": "exceptions",
+    "ResourceError": "exceptions",
+    "get_available_cpus": "resources",
+    "get_allocated_cpus": "resources",
+    "get_allocated_memory_regions": "resources",
+    "find_available_memory_base": "resources",
+    "validate_cpu_allocation": "resources",
+    "validate_memory_allocation": "resources",
+    "find_next_instance_id": "resources",
+}
+
+
+def __getattr__(name):
+    module = _EXPORTS.get(name)
+    if module is None:
+        raise AttributeError(f"module {__name__!r} has no attribute {name!r}")
+    value = getattr(importlib.import_module(f".{module}", __name__), name)
+    globals()[name] = value
+    return value
+
 
 __all__ = [
     # Core classes
@@ -0,0 +1,518 @@
+# Copyright 2026 Multikernel Technologies, Inc.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""
+Benchmark kerf's load and lifecycle paths.
+
+`kerf bench` repeats the stages that decide how fast instances come up,
+timed with the same StageTimer stages the commands print with --stats or
+--verbose, and writes per-stage percentiles as JSON:
+
+- daxfs: DaxfsBuilder scan, tree, layout and image write over synthetic
+  rootfs trees of each file count
+- extract: unpacking and stacking synthetic OCI layers, one sample per layer
+- overlay: validating and generating the overlay that creates one more
+  instance, on example hardware trees already holding N instances
+- dtb: generating and parsing those trees' root DTB in the standard and
+  the compact encoding, with the size of each
+- kexec: kexec_file_load of a loaded instance's recorded kernel, and with
+  --boot the TSC latency from the reboot syscall to kerf-init's exec
+
+Synthetic inputs are generated from --seed, so runs with the same options
+measure the same work. Only kexec touches the kernel.
+"""
+
+import copy
+import json
+import mmap
+import os
+import platform
+import random
+import shutil
+import sys
+import tarfile
+import tempfile
+import time
+from pathlib import Path
+from typing import Dict, List, Optional, Sequence, Tuple
+
+import click
+
+from .. import __version__
+from ..create.main import parse_memory_spec
+from ..daxfs.mkdaxfs import DAXFS_DEFAULT_THREADS, DaxfsBuilder, DaxfsError
+from ..docker.image import DockerError, _apply_layer_dir, _extract_layer
+from ..dtc.extractor import InstanceExtractor
+from ..dtc.parser import DeviceTreeParser
+from ..exceptions import KerfError
+from ..load.record import read_load_record
+from ..models import GlobalDeviceTree, Instance, InstanceResources, InstanceState
+from ..runtime import DeviceTreeManager
+from ..timing import StageTimer, load_boot_timing, record_exec_tsc, summarize_stages, tsc_khz
+from ..utils import get_instance_id_from_name, get_instance_status
+
+BENCHES = ("daxfs", "extract", "overlay", "dtb", "kexec")
+
+EXAMPLES_DIR = Path(__file__).resolve().parents[3] / "examples"
+DEFAULT_DTS = ("high_performance.dts", "numa_topology.dts")
+
+# Synthetic trees keep directories to a realistic size
+FILES_PER_DIR = 256
+
+# Memory given to each instance of the overlay benchmark's trees
+OVERLAY_INSTANCE_MEMORY = 64 * 1024**2
+
+BOOT_POLL_INTERVAL = 0.01
+
+
+class BenchError(Exception):
+    """Exception raised when a benchmark cannot run."""
+
+
+def synth_rootfs(root: Path, files: int, file_size: int, rng: random.Random,
+                 first: int = 0) -> None:
+    """Fill root with files of file_size random bytes, numbered from first."""
+    root.mkdir(parents=True, exist_ok=True)
+    for i in range(first, first + files):
+        directory = root / f"d{i // FILES_PER_DIR:04d}"
+        directory.mkdir(exist_ok=True)
+        (directory / f"f{i:06d}").write_bytes(rng.randbytes(file_size))
+
+
+def synth_layers(workdir: Path, layers: int, files: int, file_size: int,
+                 rng: random.Random) -> List[Path]:
+    """
+    Write gzipped layer tarballs, lowest first.
+
+    Each layer replaces half the files of the one below and adds as many
+    new ones, so stacking exercises both merging and replacing.
+    """
+    paths = []
+    for i in range(layers):
+        staging = workdir / f"layer{i}"
+        synth_rootfs(staging, files, file_size, rng, first=i * files // 2)
+        path = workdir / f"layer{i}.tar.gz"
+        with tarfile.open(path, "w:gz") as tar:
+            tar.add(staging, arcname=".")
+        shutil.rmtree(staging)
+        paths.append(path)
+    return paths
+
+
+def bench_daxfs(workdir: Path, file_counts: Sequence[int], file_size: int, rounds: int,
+                seed: int = 0, threads: int = DAXFS_DEFAULT_THREADS) -> Dict[str, Dict]:
+    """Build and write a daxfs image of a synthetic rootfs per file count."""
+    results = {}
+    for files in file_counts:
+        root = workdir / f"rootfs-{files}"
+        synth_rootfs(root, files, file_size, random.Random(seed))
+        timers = []
+        for _ in range(rounds):
+            timer = StageTimer()
+            builder = DaxfsBuilder(str(root))
+            builder.build(timer)
+            size = builder.calculate_total_size()
+            with timer.stage("write"):
+                # Anonymous memory stands in for the dma-buf; it starts zeroed
+                mem = mmap.mmap(-1, size)
+                try:
+                    builder.write_image(mem, size, zeroed=True, threads=threads)
+                finally:
+                    mem.close()
+            timers.append(timer)
+        shutil.rmtree(root)
+        results[f"{files}x{file_size}"] = summarize_stages(timers)
+    return results
+
+
+def bench_extract(workdir: Path, layers: int, files: int, file_size: int, rounds: int,
+                  seed: int = 0) -> Dict[str, Dict]:
+    """Unpack and stack synthetic layers into a rootfs, as extract_image() does."""
+    layer_paths = synth_layers(workdir, layers, files, file_size, random.Random(seed))
+    timers = []
+    for r in range(rounds):
+        round_dir = workdir / f"extract-{r}"
+        dest = round_dir / "rootfs"
+        dest.mkdir(parents=True)
+        for i, layer in enumerate(layer_paths):
+            timer = StageTimer()
+            staging = round_dir / f"layer{i}"
+            with timer.stage("extract"):
+                _extract_layer(layer, staging)
+            with timer.stage("apply"):
+                _apply_layer_dir(staging, dest)
+            timers.append(timer)
+        shutil.rmtree(round_dir)
+    for layer in layer_paths:
+        layer.unlink()
+    return {f"{layers}x{files}x{file_size}": summarize_stages(timers)}
+
+
+def _bench_instance(tree: GlobalDeviceTree, index: int) -> Instance:
+    """The index-th instance of an overlay benchmark tree: one CPU, fixed memory."""
+    cpus = sorted(tree.hardware.cpus.available)
+    memory = tree.hardware.memory
+    if index >= len(cpus) or (index + 1) * OVERLAY_INSTANCE_MEMORY > memory.memory_pool_bytes:
+        raise BenchError(f"the hardware only has room for {index} benchmark instances")
+    return Instance(
+        name=f"bench-{index + 1}",
+        id=index + 1,
+        resources=InstanceResources(
+            cpus=[cpus[index]],
+            memory_base=memory.memory_pool_base + index * OVERLAY_INSTANCE_MEMORY,
+            memory_bytes=OVERLAY_INSTANCE_MEMORY,
+            devices=[],
+        ),
+    )
+
+
+def bench_overlay(dts_paths: Sequence[str], instance_counts: Sequence[int], rounds: int,
+                  verbose: bool = False) -> Dict[str, Dict]:
+    """
+    Time the in-process part of apply_operation() creating one more instance.
+
+    The copy stage is the deepcopy every operation makes of the current
+    tree; validate and generate are DeviceTreeManager.build_overlay().
+    """
+    # Only the validator and overlay generator are used, not the kernel
+    manager = DeviceTreeManager()
+    results = {}
+    for dts in dts_paths:
+        with open(dts, "r", encoding="utf-8") as f:
+            tree = DeviceTreeParser().parse_dts(f.read())
+        tree.instances = {}
+        for count in instance_counts:
+            try:
+                current = copy.deepcopy(tree)
+                for i in range(count):
+                    instance = _bench_instance(tree, i)
+                    current.instances[instance.name] = instance
+                new = _bench_instance(tree, count)
+            except BenchError as e:
+                if verbose:
+                    click.echo(f"  Skipping {count} instances on {dts}: {e}", err=True)
+                continue
+
+            timers = []
+            for _ in range(rounds):
+                timer = StageTimer()
+                with timer.stage("copy"):
+                    modified = copy.deepcopy(current)
+                modified.instances[new.name] = new
+                manager.build_overlay(current, modified, timer)
+                timers.append(timer)
+            results[f"{Path(dts).stem}/{count}"] = summarize_stages(timers)
+    return results
+
+
+def bench_dtb(dts_paths: Sequence[str], instance_counts: Sequence[int], rounds: int,
+              verbose: bool = False) -> Dict[str, Dict]:
+    """
+    Time generating and parsing the root DTB of the overlay benchmark's trees.
+
+    Each tree is written by InstanceExtractor in both encodings and read
+    back with DeviceTreeParser, as every kerf command reads the root tree.
+    """
+    results = {}
+    for dts in dts_paths:
+        with open(dts, "r", encoding="utf-8") as f:
+            tree = DeviceTreeParser().parse_dts(f.read())
+        tree.instances = {}
+        for count in instance_counts:
+            try:
+                current = copy.deepcopy(tree)
+                for i in range(count):
+                    instance = _bench_instance(tree, i)
+                    current.instances[instance.name] = instance
+            except BenchError as e:
+                if verbose:
+                    click.echo(f"  Skipping {count} instances on {dts}: {e}", err=True)
+                continue
+
+            for encoding, extractor in (("standard", InstanceExtractor()),
+                                        ("compact", InstanceExtractor(compact=True))):
+                timers = []
+                for _ in range(rounds):
+                    timer = StageTimer()
+                    with timer.stage("generate"):
+                        dtb = bytes(extractor.generate_global_dtb(current))
+                    with timer.stage("parse"):
+                        DeviceTreeParser().parse_dtb_from_bytes(dtb)
+                    timers.append(timer)
+                results[f"{Path(dts).stem}/{count}/{encoding}"] = {
+                    "bytes": len(dtb), **summarize_stages(timers)
+                }
+    return results
+
+
+def _wait_for_status(instance_name: str, done, timeout: float) -> None:
+    """Poll the instance status until done(status) holds."""
+    deadline = time.monotonic() + timeout
+    while not done((get_instance_status(instance_name) or "").lower()):
+        if time.monotonic() > deadline:
+            raise BenchError(f"Instance '{instance_name}' did not change state in {timeout}s")
+        time.sleep(BOOT_POLL_INTERVAL)
+
+
+def _boot_once(instance_name: str, instance_id: int, khz: float, timeout: float) -> float:
+    """Boot the instance, wait for kerf-init's exec, halt it; return seconds to the exec."""
+    # pylint: disable=import-outside-toplevel
+    import rdtsc
+
+    from ..exec.main import boot_multikernel
+    from ..kill.main import halt_multikernel
+
+    tsc = rdtsc.get_cycles()
+    boot_multikernel(instance_id)
+    try:
+        record_exec_tsc(instance_name, tsc)
+        deadline = time.monotonic() + timeout
+        while True:
+            timing = load_boot_timing(instance_name) or {}
+            exec_tsc = (timing.get("phases") or {}).get("exec")
+            if timing.get("exec_tsc") == tsc and exec_tsc is not None:
+                return (exec_tsc - tsc) / khz / 1000
+            if time.monotonic() > deadline:
+                raise BenchError(
+                    f"Instance '{instance_name}' did not report reaching its entrypoint in "
+                    f"{timeout}s; is 'kerf console --capture' running?"
+                )
+            time.sleep(BOOT_POLL_INTERVAL)
+    finally:
+        halt_multikernel(instance_id, force=True)
+        _wait_for_status(instance_name, lambda s: s != InstanceState.ACTIVE.value, timeout)
+
+
+def bench_kexec(instance_name: str, rounds: int, boot: bool = False,
+                boot_timeout: float = 10.0) -> Dict[str, Dict]:
+    """
+    Reload an instance's recorded kernel and command line each round.
+
+    The instance must be loaded by `kerf load` and not running. Its daxfs
+    root stays mounted throughout, and it is left loaded as it was found.
+    """
+    # pylint: disable=import-outside-toplevel
+    from ..load.main import kexec_file_load, kexec_flags
+    from ..unload.main import KEXEC_FILE_UNLOAD, KEXEC_MK_ID, KEXEC_MULTIKERNEL, kexec_file_unload
+
+    record = read_load_record(instance_name)
+    if record is None or record.boot_cmdline is None:
+        raise BenchError(
+            f"Instance '{instance_name}' has no recorded load; load it with 'kerf load' first"
+        )
+    instance_id = get_instance_id_from_name(instance_name)
+    if instance_id is None:
+        raise BenchError(f"Instance '{instance_name}' not found")
+
+    def loaded(status: str) -> bool:
+        return status == InstanceState.LOADED.value
+
+    if not loaded((get_instance_status(instance_name) or "").lower()):
+        raise BenchError(f"Instance '{instance_name}' must be loaded and not running")
+
+    load_flags = kexec_flags(instance_id, bool(record.initrd))
+    unload_flags = KEXEC_FILE_UNLOAD | KEXEC_MULTIKERNEL | KEXEC_MK_ID(instance_id)
+    khz = tsc_khz() if boot else 0.0
+
+    # kexec_file_load reads the images from the start each time
+    kernel_fd = os.open(record.kernel, os.O_RDONLY)
+    initrd_fd = -1
+    timers = []
+    try:
+        if record.initrd:
+            initrd_fd = os.open(record.initrd, os.O_RDONLY)
+        for _ in range(rounds):
+            timer = StageTimer()
+            # A halted instance may have dropped its kernel already
+            if loaded((get_instance_status(instance_name) or "").lower()):
+                with timer.stage("kexec_file_unload"):
+                    kexec_file_unload(unload_flags)
+            with timer.stage("kexec_file_load"):
+                kexec_file_load(kernel_fd, initrd_fd, record.boot_cmdline, load_flags)
+            if boot:
+                timer.stages["kexec_to_entrypoint"] = _boot_once(
+                    instance_name, instance_id, khz, boot_timeout
+                )
+            timers.append(timer)
+        if not loaded((get_instance_status(instance_name) or "").lower()):
+            kexec_file_load(kernel_fd, initrd_fd, record.boot_cmdline, load_flags)
+    finally:
+        os.close(kernel_fd)
+        if initrd_fd >= 0:
+            os.close(initrd_fd)
+    return {instance_name: summarize_stages(timers)}
+
+
+def _parse_counts(ctx, param, value):  # pylint: disable=unused-argument
+    """Parse a comma-separated list of non-negative counts."""
+    try:
+        counts = [int(c) for c in value.split(",") if c.strip()]
+    except ValueError:
+        counts = []
+    if not counts or min(counts) < 0:
+        raise click.BadParameter("expected a comma-separated list of counts, e.g. 1,16,64")
+    return counts
+
+
+def _parse_size(ctx, param, value):  # pylint: disable=unused-argument
+    try:
+        return parse_memory_spec(value)
+    except ValueError as e:
+        raise click.BadParameter(str(e)) from e
+
+
+def _default_dts() -> List[str]:
+    return [str(EXAMPLES_DIR / name) for name in DEFAULT_DTS if (EXAMPLES_DIR / name).exists()]
+
+
+def _host() -> Dict:
+    """What the numbers were measured on."""
+    return {
+        "machine": platform.machine(),
+        "kernel": platform.release(),
+        "cpus": os.cpu_count(),
+        "python": platform.python_version(),
+        "kerf": __version__,
+    }
+
+
+@click.command(name="bench")
+@click.option(
+    "--only", "benches", multiple=True, type=click.Choice(BENCHES),
+    help="Run only this benchmark (repeatable; default: all, kexec with --instance)",
+)
+@click.option("--rounds", "-n", type=click.IntRange(min=1), default=5,
+              help="Rounds of each benchmark (default: 5)")
+@click.option("--files", "file_counts", default="100,1000,10000", callback=_parse_counts,
+              help="File counts of the synthetic rootfs trees (default: 100,1000,10000)")
+@click.option("--file-size", default="4KB", callback=_parse_size,
+              help="Size of each synthetic file (default: 4KB)")
+@click.option("--layers", type=click.IntRange(min=1), default=3,
+              help="Synthetic image layers to extract (default: 3)")
+@click.option("--layer-files", type=click.IntRange(min=1), default=1000,
+              help="Files in each synthetic layer (default: 1000)")
+@click.option(
+    "--dts", "dts_paths", multiple=True, type=click.Path(exists=True, dir_okay=False),
+    help="Hardware DTS for the overlay and dtb benchmarks (repeatable; default: "
+         "examples/high_performance.dts and examples/numa_topology.dts)",
+)
+@click.option("--instances", "instance_counts", default="1,16,64", callback=_parse_counts,
+              help="Instances in the overlay and dtb trees (default: 1,16,64)")
+@click.option("--instance", "instance_name",
+              help="Loaded instance whose kernel the kexec benchmark reloads")
+@click.option("--boot", is_flag=True,
+              help="Also boot and halt --instance each round, timing kexec to entrypoint")
+@click.option("--boot-timeout", type=float, default=10.0,
+              help="Seconds to wait for each boot and halt (default: 10)")
+@click.option("--seed", type=int, default=0, help="Seed of the synthetic inputs (default: 0)")
+@click.option("--workdir", type=click.Path(file_okay=False),
+              help="Directory for the synthetic inputs (default: a temporary directory)")
+@click.option("--output", "-o", type=click.Path(dir_okay=False),
+              help="Write the JSON report to this file instead of stdout")
+@click.option("--verbose", "-v", is_flag=True, help="Report progress on stderr")
+def bench(  # pylint: disable=too-many-arguments,too-many-positional-arguments,too-many-locals
+    benches: Tuple[str, ...],
+    rounds: int,
+    file_counts: List[int],
+    file_size: int,
+    layers: int,
+    layer_files: int,
+    dts_paths: Tuple[str, ...],
+    instance_counts: List[int],
+    instance_name: Optional[str],
+    boot: bool,
+    boot_timeout: float,
+    seed: int,
+    workdir: Optional[str],
+    output: Optional[str],
+    verbose: bool,
+):
+    """
+    Benchmark image builds, layer extraction, overlays, DTBs and kexec.
+
+    Writes a JSON report with the min, p50, p90, p99, max and mean of each
+    stage in milliseconds, along with the options and host it was measured
+    with. The daxfs, extract and overlay benchmarks use synthetic inputs
+    and need no multikernel support; dtb also reports each tree's size in
+    bytes. The kexec benchmark reloads the
+    kernel of --instance, which must be loaded by `kerf load` and not
+    running; --boot needs `kerf console --capture` to collect kerf-init's
+    timing records.
+
+    Examples:
+
+        kerf bench -o bench.json
+        kerf bench --only=overlay --instances=1,64,256 --dts=system.dts
+        kerf bench --only=kexec --instance=web-1 --boot --rounds=20
+    """
+    selected = list(benches) or [b for b in BENCHES if b != "kexec" or instance_name]
+    if "kexec" in selected and not instance_name:
+        click.echo("Error: The kexec benchmark needs --instance", err=True)
+        sys.exit(2)
+    if boot and "kexec" not in selected:
+        click.echo("Error: --boot only applies to the kexec benchmark", err=True)
+        sys.exit(2)
+    dts_paths = list(dts_paths) or _default_dts()
+    if ("overlay" in selected or "dtb" in selected) and not dts_paths:
+        click.echo(f"Error: No hardware DTS given and none found in {EXAMPLES_DIR}", err=True)
+        sys.exit(2)
+
+    results: Dict[str, Dict] = {}
+    try:
+        with tempfile.TemporaryDirectory(prefix="kerf-bench-", dir=workdir) as tmp:
+            for name in selected:
+                if verbose:
+                    click.echo(f"Running {name} benchmark...", err=True)
+                if name == "daxfs":
+                    results[name] = bench_daxfs(Path(tmp), file_counts, file_size, rounds, seed)
+                elif name == "extract":
+                    results[name] = bench_extract(
+                        Path(tmp), layers, layer_files, file_size, rounds, seed
+                    )
+                elif name == "overlay":
+                    results[name] = bench_overlay(dts_paths, instance_counts, rounds, verbose)
+                elif name == "dtb":
+                    results[name] = bench_dtb(dts_paths, instance_counts, rounds, verbose)
+                else:
+                    results[name] = bench_kexec(instance_name, rounds, boot, boot_timeout)
+    except KeyboardInterrupt:
+        click.echo("\nBenchmark cancelled", err=True)
+        sys.exit(130)
+    except (BenchError, KerfError, DaxfsError, DockerError, OSError) as e:
+        click.echo(f"Error: {e}", err=True)
+        sys.exit(1)
+
+    report = {
+        "unit": "ms",
+        "host": _host(),
+        "config": {
+            "rounds": rounds,
+            "seed": seed,
+            "files": file_counts,
+            "file_size": file_size,
+            "layers": layers,
+            "layer_files": layer_files,
+            "dts": [Path(p).name for p in dts_paths],
+            "instances": instance_counts,
+            "instance": instance_name,
+            "boot": boot,
+        },
+        "results": results,
+    }
+    text = json.dumps(report, indent=2)
+    if output:
+        with open(output, "w", encoding="utf-8") as f:
+            f.write(text + "\n")
+    else:
+        click.echo(text)
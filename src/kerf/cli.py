@@ -27,6 +27,10 @@ from .unload.main import unload
 from .delete.main import delete
 from .show.main import show
 from .console.main import console
+from .logs.main import logs
+from .run.main import run
+from .clone.main import clone
+from .bench.main import bench
 
 
 @click.group()
@@ -50,6 +54,10 @@ main.add_command(unload)
 main.add_command(delete)
 main.add_command(show)
 main.add_command(console)
+main.add_command(logs)
+main.add_command(run)
+main.add_command(clone)
+main.add_command(bench)
 
 
 if __name__ == "__main__":
@@ -0,0 +1,186 @@
+# Copyright 2026 Multikernel Technologies, Inc.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""
+Clone a loaded instance into a new one.
+
+The clone gets its own CPUs and memory through `kerf create`, then the
+template's kernel, initrd and command line are loaded into it as
+recorded by `kerf load`. Its root is the template's daxfs image, shared
+read-only: the template's daxfs mount keeps that dma-buf pinned, so no
+rootfs is extracted, built or written. Only the network parameters (and
+the entrypoint, if overridden) are generated anew.
+"""
+
+import dataclasses
+import sys
+from pathlib import Path
+from typing import Optional
+
+import click
+
+from ..create.main import create
+from ..daxfs import DaxfsImage, daxfs_region_pinned
+from ..delete.main import delete
+from ..exceptions import KernelInterfaceError, ParseError
+from ..exec.main import exec_cmd
+from ..load.main import boot_cmdline, build_ip_param, kexec_flags, load_kernel
+from ..load.record import LoadRecord, read_load_record, write_load_record
+from ..runtime import DeviceTreeManager
+from ..timing import StageTimer
+from ..utils import get_instance_id_from_name
+
+
+def clone_cmdline(
+    record: LoadRecord, entrypoint: Optional[str] = None, ip_param: Optional[str] = None
+) -> str:
+    """The template's command line with a new entrypoint and network configuration."""
+    daxfs_image = None
+    if record.daxfs_phys_addr is not None:
+        # Shared: the status page stays with the template
+        daxfs_image = DaxfsImage(
+            phys_addr=record.daxfs_phys_addr, size=record.daxfs_size, shared=True
+        )
+    return boot_cmdline(
+        record.cmdline, daxfs_image, entrypoint or record.entrypoint, record.init_params,
+        ip_param, record.console_device,
+    )
+
+
+@click.command(name="clone")
+@click.pass_context
+@click.argument("template")
+@click.argument("name")
+@click.option("--id", "instance_id", type=int, help="Instance ID (1-511, auto-assigned if omitted)")
+@click.option("--cpu-count", type=int, help="CPUs to allocate (default: as many as the template)")
+@click.option("--memory", "-m", help="Memory allocation (default: as much as the template)")
+@click.option("--entrypoint", help="Run this instead of the template's entrypoint")
+@click.option("--ip", "ip_addr", help="IP address for the clone (or 'dhcp')")
+@click.option("--gateway", help="Default gateway IP address")
+@click.option("--netmask", default="255.255.255.0", help="Network mask (default: 255.255.255.0)")
+@click.option("--nic", help="Network interface name (e.g., eth0)")
+@click.option("--hostname", help="Hostname for the clone")
+@click.option("--exec", "boot", is_flag=True, help="Boot the clone once it is loaded")
+@click.option("--verbose", "-v", is_flag=True, help="Verbose output")
+def clone(  # pylint: disable=too-many-arguments,too-many-positional-arguments
+    ctx: click.Context,
+    template: str,
+    name: str,
+    instance_id: Optional[int],
+    cpu_count: Optional[int],
+    memory: Optional[str],
+    entrypoint: Optional[str],
+    ip_addr: Optional[str],
+    gateway: Optional[str],
+    netmask: str,
+    nic: Optional[str],
+    hostname: Optional[str],
+    boot: bool,
+    verbose: bool,
+):
+    """
+    Create an instance that boots the same kernel and rootfs as TEMPLATE.
+
+    TEMPLATE must have been loaded by `kerf load` and still be loaded.
+    The clone gets fresh CPUs and memory, with the template's CPU count,
+    memory size and placement policy unless overridden, no devices, and
+    the template's daxfs image as a shared read-only root. Network
+    settings are not copied: pass --ip and friends for the clone's own.
+
+    A clone has no kerf-init status page of its own, so `kerf show` does
+    not report its service health.
+
+    Examples:
+
+        kerf clone web-1 web-2 --ip=10.0.0.12 --gateway=10.0.0.1 --nic=eth0 --exec
+        kerf clone worker worker-big --cpu-count=8 --memory=8GB
+    """
+    record = read_load_record(template)
+    if record is None:
+        click.echo(f"Error: Instance '{template}' has no recorded load", err=True)
+        click.echo(f"Load it with 'kerf load {template}' before cloning it", err=True)
+        sys.exit(1)
+    if record.daxfs_phys_addr is not None and not daxfs_region_pinned(
+        record.daxfs_phys_addr, record.daxfs_size
+    ):
+        click.echo(f"Error: The daxfs image of '{template}' is no longer mounted", err=True)
+        sys.exit(1)
+
+    try:
+        source = DeviceTreeManager().read_baseline().instances.get(template)
+    except (KernelInterfaceError, ParseError) as e:
+        click.echo(f"Error: {e}", err=True)
+        sys.exit(1)
+    if source is None:
+        click.echo(f"Error: Instance '{template}' not found", err=True)
+        sys.exit(1)
+
+    resources = source.resources
+    ctx.invoke(
+        create,
+        name=name,
+        instance_id=instance_id,
+        cpu_count=cpu_count or len(resources.cpus),
+        cpu_affinity=resources.cpu_affinity or "compact",
+        numa_nodes=",".join(map(str, resources.numa_nodes)) if resources.numa_nodes else None,
+        memory_policy=resources.memory_policy,
+        memory=memory or str(resources.memory_bytes),
+        verbose=verbose,
+    )
+
+    try:
+        new_id = get_instance_id_from_name(name)
+        if new_id is None:
+            click.echo(f"Error: Created instance '{name}' has no ID", err=True)
+            sys.exit(1)
+
+        ip_param = build_ip_param(ip_addr, gateway, netmask, hostname, nic)
+        cmdline_str = clone_cmdline(record, entrypoint, ip_param)
+        if verbose:
+            click.echo(f"Kernel image: {record.kernel}")
+            click.echo(f"Command line: {cmdline_str if cmdline_str else '(empty)'}")
+
+        debug = ctx.obj.get("debug", False) if ctx and ctx.obj else False
+        load_kernel(
+            name, Path(record.kernel), Path(record.initrd) if record.initrd else None,
+            cmdline_str, kexec_flags(new_id, bool(record.initrd)), StageTimer(),
+            debug=debug, verbose=verbose,
+        )
+    except SystemExit as e:
+        if e.code:
+            click.echo(f"Removing instance '{name}' after the failed load", err=True)
+            try:
+                ctx.invoke(delete, name=name, verbose=verbose)
+            except SystemExit:
+                pass
+        raise
+
+    try:
+        write_load_record(
+            name,
+            dataclasses.replace(
+                record, entrypoint=entrypoint or record.entrypoint, boot_cmdline=cmdline_str
+            ),
+        )
+    except OSError as e:
+        if verbose:
+            click.echo(f"Warning: Could not record the load for kerf clone: {e}", err=True)
+
+    shared = ""
+    if record.daxfs_phys_addr is not None:
+        shared = f" sharing its daxfs image at phys=0x{record.daxfs_phys_addr:x}"
+    click.echo(f"✓ Cloned '{template}' into '{name}'{shared}")
+
+    if boot:
+        ctx.invoke(exec_cmd, name=name, verbose=verbose)
@@ -0,0 +1,200 @@
+# Copyright 2026 Multikernel Technologies, Inc.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""
+Non-interactive console capture, for `kerf console --capture`.
+
+One process holds a mktty connection per instance and appends everything
+it reads to that instance's ring file under KERF_CONSOLE_DIR, where
+`kerf logs` and log shippers read it. Instances are rescanned every few
+seconds: new ones are attached, and a console that closes (the instance
+stopped or was removed) is reattached on a later scan, appending to the
+same ring. Started before `kerf exec`, it keeps the boot output.
+
+kerf-init timing records seen on a console are recorded as `kerf console`
+does.
+"""
+
+import os
+import select
+import signal
+import time
+from pathlib import Path
+from typing import Callable, Dict, Iterable, Optional
+
+import click
+
+from ..timing import InitTimingScanner, record_init_timing
+from ..utils import get_instance_id_from_name
+from .main import CONSOLE_CHUNK, MKTTY_DEVICE, connect_console
+from .ring import RingError, RingWriter
+
+KERF_CONSOLE_DIR = "/var/lib/kerf/console"
+INSTANCES_DIR = "/sys/fs/multikernel/instances"
+
+CAPTURE_DEFAULT_RING_SIZE = 1024 * 1024
+CAPTURE_RESCAN_SECONDS = 2.0
+
+
+def console_ring_path(instance_name: str) -> Path:
+    """Ring file holding an instance's captured console output."""
+    return Path(KERF_CONSOLE_DIR) / f"{instance_name}.ring"
+
+
+class _Connection:
+    __slots__ = ("name", "fd", "ring", "timing")
+
+    def __init__(self, name: str, fd: int, ring: RingWriter):
+        self.name = name
+        self.fd = fd
+        self.ring = ring
+        self.timing = InitTimingScanner()
+
+
+class ConsoleCapture:
+    """
+    Copies instance consoles into ring files.
+
+    Args:
+        names: Instances to capture; None captures every instance
+        ring_size: Capacity of each ring file in bytes
+        connect: Opens a console connection for an instance ID
+    """
+
+    def __init__(
+        self,
+        names: Optional[Iterable[str]] = None,
+        ring_size: int = CAPTURE_DEFAULT_RING_SIZE,
+        connect: Callable[[int], int] = connect_console,
+    ):
+        self.names = set(names) if names is not None else None
+        self.ring_size = ring_size
+        self.connect = connect
+        self.connections: Dict[int, _Connection] = {}
+        self.rings: Dict[str, RingWriter] = {}
+        self._poller = select.epoll()
+
+    def _instances(self) -> Dict[str, int]:
+        found = {}
+        instances_dir = Path(INSTANCES_DIR)
+        if instances_dir.exists():
+            for inst_dir in instances_dir.iterdir():
+                name = inst_dir.name
+                if name.startswith(".") or (self.names is not None and name not in self.names):
+                    continue
+                instance_id = get_instance_id_from_name(name)
+                if instance_id is not None:
+                    found[name] = instance_id
+        return found
+
+    def scan(self) -> None:
+        """Attach to instances without a connection; drop rings of removed ones."""
+        instances = self._instances()
+        attached = {conn.name for conn in self.connections.values()}
+        for name, instance_id in sorted(instances.items()):
+            if name in attached:
+                continue
+            try:
+                fd = self.connect(instance_id)
+            except OSError:
+                # Not connectable yet; try again next scan
+                continue
+            ring = self.rings.get(name)
+            if ring is None:
+                try:
+                    ring = RingWriter(str(console_ring_path(name)), self.ring_size)
+                except (OSError, RingError):
+                    os.close(fd)
+                    continue
+                self.rings[name] = ring
+            self.connections[fd] = _Connection(name, fd, ring)
+            self._poller.register(fd, select.EPOLLIN)
+
+        for name in list(self.rings):
+            if name not in instances and name not in attached:
+                self.rings.pop(name).close()
+
+    def _drop(self, conn: _Connection) -> None:
+        self._poller.unregister(conn.fd)
+        os.close(conn.fd)
+        del self.connections[conn.fd]
+
+    def pump(self, timeout: float) -> None:
+        """Copy whatever the consoles have into their rings, waiting up to timeout."""
+        for fd, _ in self._poller.poll(timeout):
+            conn = self.connections[fd]
+            try:
+                data = os.read(fd, CONSOLE_CHUNK)
+            except OSError:
+                data = b""
+            if not data:
+                self._drop(conn)
+                continue
+            conn.ring.write(data)
+            if "exec" not in conn.timing.records and conn.timing.feed(data):
+                try:
+                    record_init_timing(conn.name, conn.timing.records)
+                except OSError:
+                    pass
+
+    def run(self, stop: Callable[[], bool] = lambda: False,
+            rescan: float = CAPTURE_RESCAN_SECONDS) -> None:
+        """Capture until stop() returns True, rescanning instances every rescan seconds."""
+        next_scan = 0.0
+        while not stop():
+            now = time.monotonic()
+            if now >= next_scan:
+                self.scan()
+                next_scan = now + rescan
+            self.pump(max(0.0, next_scan - time.monotonic()))
+
+    def close(self) -> None:
+        """Close every console connection and ring."""
+        for conn in list(self.connections.values()):
+            self._drop(conn)
+        for ring in self.rings.values():
+            ring.close()
+        self.rings.clear()
+        self._poller.close()
+
+
+def run_capture(names: Optional[Iterable[str]], ring_size: int, verbose: bool = False) -> int:
+    """
+    Capture consoles until SIGTERM or SIGINT.
+
+    Returns:
+        0 on a clean stop, 1 if the mktty device is missing
+    """
+    if not Path(MKTTY_DEVICE).exists():
+        click.echo(f"Error: Console device {MKTTY_DEVICE} not found", err=True)
+        click.echo("Make sure the mktty kernel module is loaded", err=True)
+        return 1
+
+    stopping = []
+
+    def stop_handler(signum, frame):  # pylint: disable=unused-argument
+        stopping.append(signum)
+
+    previous = {sig: signal.signal(sig, stop_handler) for sig in (signal.SIGTERM, signal.SIGINT)}
+    capture = ConsoleCapture(names, ring_size)
+    if verbose:
+        target = ", ".join(sorted(capture.names)) if capture.names else "all instances"
+        click.echo(f"Capturing consoles of {target} into {KERF_CONSOLE_DIR}")
+    try:
+        capture.run(stop=lambda: bool(stopping))
+    finally:
+        capture.close()
+        for sig, handler in previous.items():
+            signal.signal(sig, handler)
+    return 0
@@ -16,8 +16,11 @@
 Console attachment subcommand implementation for mktty device.
 """
 
+import errno
 import os
+import re
 import select
+import stat
 import sys
 import termios
 import tty
@@ -27,14 +30,165 @@ from typing import Optional
 import click
 
 from ..models import InstanceState
+from ..timing import InitTimingScanner, record_init_timing
 from ..utils import get_instance_id_from_name, get_instance_name_from_id, get_instance_status
 
 
 MKTTY_DEVICE = "/dev/mktty"
 CTRL_CLOSE_BRACKET = 0x1D  # Ctrl+]
+DETACH_KEY = ord(".")
 
+# Bytes moved per read, write or splice in either direction
+CONSOLE_CHUNK = 64 * 1024
 
-def run_console(instance_id: int, instance_name: str, verbose: bool = False) -> int:  # pylint: disable=unused-argument
+_NEWLINE = re.compile(rb"\r?\n")
+
+
+class DetachScanner:
+    """
+    Finds the Ctrl+] . detach sequence in chunks read from stdin.
+
+    A Ctrl+] is held back until the next byte shows whether it starts the
+    sequence; if that byte is in the next chunk, it is carried over. A held
+    Ctrl+] followed by anything but . is forwarded.
+    """
+
+    def __init__(self):
+        self.pending = False
+        self.detached = False
+
+    def feed(self, data: bytes) -> bytes:
+        """Return the part of data to forward; sets detached on the sequence."""
+        if self.pending:
+            data = bytes([CTRL_CLOSE_BRACKET]) + data
+            self.pending = False
+        elif CTRL_CLOSE_BRACKET not in data:
+            return data
+
+        out = bytearray()
+        start = 0
+        while True:
+            index = data.find(CTRL_CLOSE_BRACKET, start)
+            if index < 0:
+                out += data[start:]
+                return bytes(out)
+            out += data[start:index]
+            if index + 1 == len(data):
+                self.pending = True
+                return bytes(out)
+            if data[index + 1] == DETACH_KEY:
+                self.detached = True
+                return bytes(out)
+            # Not a detach: forward the Ctrl+] and scan on from the next byte
+            out.append(CTRL_CLOSE_BRACKET)
+            start = index + 1
+
+
+def translate_newlines(data: bytes) -> bytes:
+    """
+    Translate \\n to \\r\\n for a terminal in raw mode, in one pass.
+
+    The kernel outputs \\n; existing \\r\\n pairs are kept as they are.
+    """
+    if b"\n" not in data:
+        return data
+    return _NEWLINE.sub(b"\r\n", data)
+
+
+def connect_console(instance_id: int) -> int:
+    """Open the mktty device and connect it to an instance's console."""
+    fd = os.open(MKTTY_DEVICE, os.O_RDWR | os.O_CLOEXEC)
+    try:
+        os.write(fd, f"{instance_id}\n".encode("utf-8"))
+    except OSError:
+        os.close(fd)
+        raise
+    return fd
+
+
+def _write_all(fd: int, data: bytes) -> None:
+    view = memoryview(data)
+    while view:
+        view = view[os.write(fd, view):]
+
+
+def _is_pipe(fd: int) -> bool:
+    try:
+        return stat.S_ISFIFO(os.fstat(fd).st_mode)
+    except OSError:
+        return False
+
+
+def relay_console(
+    stdin_fd: int, stdout_fd: int, mktty_fd: int, instance_name: str, raw: bool = False
+) -> int:
+    """
+    Relay between a terminal and a connected mktty fd until detach or close.
+
+    Both directions move up to CONSOLE_CHUNK bytes per wakeup. Without raw,
+    console output gets newline translation. With raw, output is passed
+    through untouched and, when stdout is a pipe, spliced to it without
+    passing through userspace; spliced output is not scanned for
+    kerf-init timing records.
+
+    Returns:
+        0 when detached, or when either side reaches EOF
+    """
+    detach = DetachScanner()
+    # kerf-init boot timeline records echoed on the console; "exec" is the last
+    timing = InitTimingScanner()
+    # splice() needs one end to be a pipe
+    use_splice = raw and hasattr(os, "splice") and _is_pipe(stdout_fd)
+
+    poller = select.epoll()
+    try:
+        poller.register(stdin_fd, select.EPOLLIN)
+        poller.register(mktty_fd, select.EPOLLIN)
+        while True:
+            for fd, _ in poller.poll():
+                if fd == stdin_fd:
+                    data = os.read(stdin_fd, CONSOLE_CHUNK)
+                    if not data:
+                        # EOF on stdin
+                        return 0
+                    data = detach.feed(data)
+                    if data:
+                        _write_all(mktty_fd, data)
+                    if detach.detached:
+                        return 0
+                    continue
+
+                if use_splice:
+                    try:
+                        if os.splice(mktty_fd, stdout_fd, CONSOLE_CHUNK) == 0:
+                            return 0
+                        continue
+                    except OSError as e:
+                        if e.errno != errno.EINVAL:
+                            return 0
+                        # The device does not support splice; copy through userspace
+                        use_splice = False
+
+                try:
+                    data = os.read(mktty_fd, CONSOLE_CHUNK)
+                except OSError:
+                    # Device closed or error
+                    return 0
+                if not data:
+                    return 0
+                if "exec" not in timing.records and timing.feed(data):
+                    try:
+                        record_init_timing(instance_name, timing.records)
+                    except OSError:
+                        pass
+                _write_all(stdout_fd, data if raw else translate_newlines(data))
+    finally:
+        poller.close()
+
+
+def run_console(  # pylint: disable=unused-argument
+    instance_id: int, instance_name: str, verbose: bool = False, raw: bool = False
+) -> int:
     """
     Attach to a running instance's console via mktty device.
 
@@ -42,6 +196,7 @@ def run_console(instance_id: int, instance_name: str, verbose: bool = False) ->
         instance_id: The instance ID to attach to
         instance_name: The instance name (for display purposes)
         verbose: Enable verbose output
+        raw: Pass console output through without newline translation
 
     Returns:
         0 on success, non-zero on error
@@ -83,54 +238,7 @@ def run_console(instance_id: int, instance_name: str, verbose: bool = False) ->
         try:
             # Enter raw mode
             tty.setraw(stdin_fd)
-
-            # State for detach sequence detection
-            saw_ctrl_bracket = False
-
-            # I/O loop
-            while True:
-                readable, _, _ = select.select([stdin_fd, mktty_fd], [], [], 0.1)
-
-                for fd in readable:
-                    if fd == stdin_fd:
-                        # Read from stdin
-                        data = os.read(stdin_fd, 1)
-                        if not data:
-                            # EOF on stdin
-                            return 0
-
-                        byte = data[0]
-
-                        # Check for detach sequence: Ctrl+] followed by .
-                        if saw_ctrl_bracket:
-                            if byte == ord('.'):
-                                # Detach sequence complete
-                                return 0
-                            # Not a detach sequence, send the buffered Ctrl+]
-                            os.write(mktty_fd, bytes([CTRL_CLOSE_BRACKET]))
-                            saw_ctrl_bracket = False
-                            # Fall through to send current byte
-
-                        if byte == CTRL_CLOSE_BRACKET:
-                            # Start of potential detach sequence
-                            saw_ctrl_bracket = True
-                        else:
-                            # Send to mktty device
-                            os.write(mktty_fd, data)
-
-                    elif fd == mktty_fd:
-                        # Read from mktty device
-                        try:
-                            data = os.read(mktty_fd, 4096)
-                            if data:
-                                # Translate \n to \r\n for proper terminal display
-                                # in raw mode (kernel outputs \n, terminal needs \r\n)
-                                # First normalize any existing \r\n to \n, then convert
-                                data = data.replace(b'\r\n', b'\n').replace(b'\n', b'\r\n')
-                                os.write(stdout_fd, data)
-                        except OSError:
-                            # Device closed or error
-                            return 0
+            return relay_console(stdin_fd, stdout_fd, mktty_fd, instance_name, raw)
 
         finally:
             # Restore terminal settings
@@ -141,14 +249,64 @@ def run_console(instance_id: int, instance_name: str, verbose: bool = False) ->
     finally:
         os.close(mktty_fd)
 
-    return 0
+
+def _capture(name: Optional[str], instance_id: Optional[int], ring_size: str,
+             verbose: bool) -> int:
+    """Resolve the instance to capture, if any, and run the capture loop."""
+    from ..create.main import parse_memory_spec
+    from .capture import run_capture
+
+    try:
+        ring_bytes = parse_memory_spec(ring_size)
+    except ValueError as e:
+        click.echo(f"Error: Invalid --ring-size: {e}", err=True)
+        return 2
+    if ring_bytes <= 0:
+        click.echo("Error: --ring-size must be positive", err=True)
+        return 2
+
+    names = None
+    if name:
+        names = [name]
+    elif instance_id is not None:
+        found = get_instance_name_from_id(instance_id)
+        if not found:
+            click.echo(f"Error: Instance with ID {instance_id} not found", err=True)
+            return 1
+        names = [found]
+    return run_capture(names, ring_bytes, verbose)
 
 
 @click.command(name="console")
 @click.argument("name", required=False)
 @click.option("--id", type=int, help="Instance ID (alternative to name)")
+@click.option(
+    "--raw",
+    is_flag=True,
+    help="Pass console output through untranslated (no \\n to \\r\\n), "
+    "splicing it to stdout when that is a pipe",
+)
+@click.option(
+    "--capture",
+    is_flag=True,
+    help="Run without a terminal, copying console output into ring files under "
+    "/var/lib/kerf/console for `kerf logs`. Without a name, captures every instance",
+)
+@click.option(
+    "--ring-size",
+    default="1MB",
+    show_default=True,
+    help="Size of each instance's ring file with --capture (e.g. 512KB, 4MB)",
+)
 @click.option("--verbose", "-v", is_flag=True, help="Verbose output")
-def console(name: Optional[str], id: Optional[int], verbose: bool):
+def console(  # pylint: disable=too-many-arguments,too-many-positional-arguments
+    name: Optional[str],
+    id: Optional[int],
+    raw: bool,
+    capture: bool,
+    ring_size: str,
+    verbose: bool,
+):
     """
     Attach to a running instance's console.
 
@@ -161,8 +319,13 @@ def console(name: Optional[str], id: Optional[int], verbose: bool):
 
         kerf console web-server
         kerf console --id=1
+        kerf console --raw web-server | tee web-server.log
+        kerf console --capture
     """
     try:
+        if capture:
+            sys.exit(_capture(name, id, ring_size, verbose))
+
         if not name and id is None:
             click.echo("Error: Either instance name or --id must be provided", err=True)
             click.echo("Usage: kerf console <name>  or  kerf console --id=<id>", err=True)
@@ -222,7 +385,7 @@ def console(name: Optional[str], id: Optional[int], verbose: bool):
             click.echo(f"Instance status: {status}")
 
         # Run the console
-        result = run_console(instance_id, instance_name, verbose)
+        result = run_console(instance_id, instance_name, verbose, raw)
         sys.exit(result)
 
     except Exception as e:
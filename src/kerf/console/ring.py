@@ -0,0 +1,165 @@
+# Copyright 2026 Multikernel Technologies, Inc.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""
+Bounded console log files, written as a ring through mmap.
+
+A ring file is a 64-byte header followed by capacity bytes of data:
+
+    offset 0   magic     b"KERFRING"
+    offset 8   capacity  u64, data bytes
+    offset 16  head      u64, total bytes ever written
+
+Integers are little-endian. The byte written at absolute position p lives
+at HEADER_SIZE + p % capacity, so the file always holds the last capacity
+bytes. There is a single writer, which copies data in before it stores
+the new head. A reader that saw head h may trust [h - capacity, h) except
+for what the writer overwrote meanwhile; re-reading head after the copy
+tells it how much that was.
+"""
+
+import fcntl
+import mmap
+import os
+import struct
+from pathlib import Path
+from typing import Tuple
+
+RING_MAGIC = b"KERFRING"
+HEADER_SIZE = 64
+
+_HEADER = struct.Struct("<8sQQ")
+_HEAD = struct.Struct("<Q")
+_HEAD_OFFSET = 16
+
+
+class RingError(Exception):
+    """The file is not a console ring."""
+
+
+class RingWriter:
+    """
+    Appends to a ring file, creating or resizing it as needed.
+
+    The writer holds an exclusive flock on the file while open, so a second
+    writer fails with RingError instead of interleaving with the first.
+    """
+
+    def __init__(self, path: str, capacity: int):
+        if capacity <= 0:
+            raise ValueError("ring capacity must be positive")
+        Path(path).parent.mkdir(parents=True, exist_ok=True)
+        fd = os.open(path, os.O_RDWR | os.O_CREAT | os.O_CLOEXEC, 0o644)
+        try:
+            try:
+                fcntl.flock(fd, fcntl.LOCK_EX | fcntl.LOCK_NB)
+            except BlockingIOError as e:
+                raise RingError(f"{path} is already being written") from e
+            size = HEADER_SIZE + capacity
+            existing = os.pread(fd, _HEADER.size, 0)
+            keep = (
+                len(existing) == _HEADER.size
+                and os.fstat(fd).st_size == size
+                and _HEADER.unpack(existing)[:2] == (RING_MAGIC, capacity)
+            )
+            if not keep:
+                # New file or a different size: start an empty ring
+                os.ftruncate(fd, 0)
+                os.ftruncate(fd, size)
+                os.pwrite(fd, _HEADER.pack(RING_MAGIC, capacity, 0), 0)
+            self._map = mmap.mmap(fd, size)
+        except BaseException:
+            os.close(fd)
+            raise
+        self._fd = fd
+        self.capacity = capacity
+        self.head = _HEAD.unpack_from(self._map, _HEAD_OFFSET)[0]
+
+    def write(self, data: bytes) -> None:
+        """Append data, overwriting the oldest bytes once the ring is full."""
+        total = len(data)
+        if not total:
+            return
+        view = memoryview(data)
+        if total > self.capacity:
+            view = view[total - self.capacity:]
+
+        pos = (self.head + total - len(view)) % self.capacity
+        first = min(len(view), self.capacity - pos)
+        self._map[HEADER_SIZE + pos:HEADER_SIZE + pos + first] = view[:first]
+        if first < len(view):
+            self._map[HEADER_SIZE:HEADER_SIZE + len(view) - first] = view[first:]
+
+        # Publish only after the data is in place
+        self.head += total
+        _HEAD.pack_into(self._map, _HEAD_OFFSET, self.head)
+
+    def close(self) -> None:
+        """Unmap the ring and release the lock."""
+        self._map.close()
+        os.close(self._fd)
+
+
+class RingReader:
+    """Reads a ring file by absolute position, without disturbing the writer."""
+
+    def __init__(self, path: str):
+        fd = os.open(path, os.O_RDONLY | os.O_CLOEXEC)
+        try:
+            size = os.fstat(fd).st_size
+            if size < HEADER_SIZE:
+                raise RingError(f"{path} is not a console ring")
+            self._map = mmap.mmap(fd, size, prot=mmap.PROT_READ)
+        finally:
+            os.close(fd)
+        magic, self.capacity, _ = _HEADER.unpack_from(self._map)
+        if magic != RING_MAGIC or size != HEADER_SIZE + self.capacity:
+            self._map.close()
+            raise RingError(f"{path} is not a console ring")
+
+    @property
+    def head(self) -> int:
+        """Total bytes written so far."""
+        return _HEAD.unpack_from(self._map, _HEAD_OFFSET)[0]
+
+    def read(self, cursor: int = 0) -> Tuple[bytes, int, int]:
+        """
+        Read everything written from cursor on that the ring still holds.
+
+        Returns:
+            (data, cursor for the next read, bytes lost to overwriting)
+        """
+        head = self.head
+        if cursor > head:
+            # The ring was recreated; start over
+            cursor = 0
+        start = max(cursor, head - self.capacity)
+
+        pos = start % self.capacity
+        length = head - start
+        first = min(length, self.capacity - pos)
+        data = self._map[HEADER_SIZE + pos:HEADER_SIZE + pos + first]
+        if first < length:
+            data += self._map[HEADER_SIZE:HEADER_SIZE + length - first]
+
+        # Drop whatever the writer reused while we copied
+        overwritten = min(self.head - self.capacity, head)
+        if overwritten > start:
+            data = data[overwritten - start:]
+            start = overwritten
+        return data, head, start - cursor
+
+    def close(self) -> None:
+        """Unmap the ring."""
+        self._map.close()
@@ -23,7 +23,7 @@ creating an overlay and applying it to the kernel.
 import copy
 import sys
 import traceback
-from typing import List, Optional
+from typing import Dict, List, Optional, Set, Tuple
 import click
 
 from ..runtime import DeviceTreeManager
@@ -35,6 +35,7 @@ from ..resources import (
     get_available_cpus,
 )
 from ..exceptions import ValidationError, KernelInterfaceError, ResourceError, ParseError
+from ..timing import StageTimer
 
 
 def parse_cpu_spec(cpu_spec: str) -> List[int]:
@@ -203,6 +204,106 @@ def _allocate_local(
     raise ResourceError(f"No single NUMA node has {count} available APIC IDs for 'local' affinity")
 
 
+def _smt_core(topology: Dict, cpu: int) -> Tuple[int, ...]:
+    """The SMT threads sharing cpu's core, or just cpu when unknown."""
+    topo = topology.get(cpu)
+    if topo is None or not topo.siblings:
+        return (cpu,)
+    return tuple(topo.siblings)
+
+
+def _smt_isolated_cpus(tree) -> Set[int]:
+    """CPUs on cores held by a no-smt-share instance; nobody else may use them."""
+    topology = tree.hardware.cpus.topology
+    if not topology:
+        return set()
+    blocked = set()
+    for instance in tree.instances.values():
+        if instance.resources.cpu_affinity == "no-smt-share":
+            for cpu in instance.resources.cpus:
+                blocked.update(_smt_core(topology, cpu))
+    return blocked
+
+
+def _llc_domains(topology: Dict, cpus: List[int]) -> List[List[Tuple[Tuple[int, ...], List[int]]]]:
+    """
+    Group CPUs by last-level cache, then by core.
+
+    Returns one list per LLC domain of (core threads, free CPUs on that
+    core) pairs. CPUs without an LLC id are grouped last.
+    """
+    domains: Dict[Optional[int], Dict[Tuple[int, ...], List[int]]] = {}
+    for cpu in cpus:
+        topo = topology.get(cpu)
+        llc_id = topo.llc_id if topo else None
+        domains.setdefault(llc_id, {}).setdefault(_smt_core(topology, cpu), []).append(cpu)
+
+    order = sorted(domains, key=lambda llc_id: (llc_id is None, llc_id or 0))
+    return [list(domains[llc_id].items()) for llc_id in order]
+
+
+def _fill_llc_domains(domains, count: int) -> Optional[List[int]]:
+    """
+    Take count CPUs core by core from the LLC domains.
+
+    The smallest domain that fits the request is used (best fit, leaving
+    larger domains whole for larger instances). Otherwise CPUs spill across
+    domains, largest first. Within a domain, fully free cores are taken
+    before cores whose other thread is already in use.
+    """
+    def free(domain):
+        return sum(len(cpus) for _, cpus in domain)
+
+    fitting = [domain for domain in domains if free(domain) >= count]
+    if fitting:
+        candidates = [min(fitting, key=free)]
+    else:
+        candidates = sorted(domains, key=free, reverse=True)
+
+    allocated: List[int] = []
+    for domain in candidates:
+        for _, cpus in sorted(domain, key=lambda core: len(core[1]) < len(core[0])):
+            allocated.extend(cpus[: count - len(allocated)])
+            if len(allocated) == count:
+                return sorted(allocated)
+    return None
+
+
+def _require_cpu_topology(tree, policy: str) -> Dict:
+    topology = tree.hardware.cpus.topology
+    if not topology:
+        raise ResourceError(
+            f"CPU affinity '{policy}' requires CPU cache and SMT topology. "
+            "Re-run 'kerf init --cpus' on the host to detect it, or use 'compact' instead."
+        )
+    return topology
+
+
+def _allocate_llc_compact(tree, available: List[int], count: int) -> List[int]:
+    """Allocate CPUs filling one last-level cache domain (CCX) before the next."""
+    topology = _require_cpu_topology(tree, "llc-compact")
+    return _fill_llc_domains(_llc_domains(topology, available), count)
+
+
+def _allocate_no_smt_share(tree, available: List[int], count: int) -> List[int]:
+    """Allocate CPUs on cores whose other SMT threads no other instance uses."""
+    topology = _require_cpu_topology(tree, "no-smt-share")
+    owned = {cpu for instance in tree.instances.values() for cpu in instance.resources.cpus}
+    # CPUs with unknown siblings cannot be proven unshared
+    eligible = [
+        cpu for cpu in available
+        if cpu in topology and owned.isdisjoint(_smt_core(topology, cpu))
+    ]
+
+    allocated = _fill_llc_domains(_llc_domains(topology, eligible), count)
+    if allocated is None:
+        raise ResourceError(
+            f"Not enough APIC IDs for 'no-smt-share' affinity: requested {count}, but only "
+            f"{len(eligible)} available with no SMT sibling used by another instance"
+        )
+    return allocated
+
+
 def allocate_cpus_from_pool(
     tree, count: int, cpu_affinity: str = "compact", numa_nodes: Optional[List[int]] = None
 ) -> List[int]:
@@ -212,7 +313,8 @@ def allocate_cpus_from_pool(
     Args:
         tree: GlobalDeviceTree to analyze
         count: Number of CPUs to allocate
-        cpu_affinity: CPU affinity policy - "compact", "spread", or "local"
+        cpu_affinity: CPU affinity policy - "compact", "spread", "local",
+                     "llc-compact" or "no-smt-share"
         numa_nodes: Preferred NUMA node IDs (optional). If specified, allocates
                    CPUs only from these NUMA nodes
 
@@ -222,7 +324,9 @@ def allocate_cpus_from_pool(
     Raises:
         ResourceError: If not enough CPUs available
     """
-    available = sorted(list(get_available_cpus(tree)))
+    # SMT siblings of no-smt-share instances are never handed out
+    isolated = _smt_isolated_cpus(tree)
+    available = sorted(cpu for cpu in get_available_cpus(tree) if cpu not in isolated)
 
     # Filter by NUMA nodes if specified
     if numa_nodes and tree.hardware.topology and tree.hardware.topology.numa_nodes:
@@ -250,6 +354,10 @@ def allocate_cpus_from_pool(
         return _allocate_spread(tree, available, count, numa_nodes)
     if cpu_affinity == "local":
         return _allocate_local(tree, available, count, numa_nodes)
+    if cpu_affinity == "llc-compact":
+        return _allocate_llc_compact(tree, available, count)
+    if cpu_affinity == "no-smt-share":
+        return _allocate_no_smt_share(tree, available, count)
     raise ValueError(f"Unknown CPU affinity policy: {cpu_affinity}")
 
 
@@ -411,10 +519,12 @@ def dump_overlay_for_debug(
 )
 @click.option(
     "--cpu-affinity",
-    type=click.Choice(["compact", "spread", "local"]),
+    type=click.Choice(["compact", "spread", "local", "llc-compact", "no-smt-share"]),
     default="compact",
     help="CPU affinity policy: compact (same NUMA node, consecutive), "
-    "spread (across NUMA nodes), or local (co-locate with memory)",
+    "spread (across NUMA nodes), local (co-locate with memory), "
+    "llc-compact (fill one last-level cache domain first), or "
+    "no-smt-share (never share a core's SMT threads with another instance)",
 )
 @click.option(
     "--numa-nodes",
@@ -635,7 +745,10 @@ def create(  # pylint: disable=too-many-arguments,too-many-positional-arguments
 
             # Find memory base if not specified
             if memory_base_addr is None:
-                found_base = find_available_memory_base(modified, memory_bytes)
+                # Prefer memory local to the CPUs just chosen
+                found_base = find_available_memory_base(
+                    modified, memory_bytes, cpus=cpu_list, numa_nodes=numa_node_list
+                )
                 if found_base is None:
                     raise ResourceError(
                         f"No available memory region found for {memory_bytes} bytes. "
@@ -719,7 +832,8 @@ def create(  # pylint: disable=too-many-arguments,too-many-positional-arguments
                 modified = create_instance_operation(current)
                 dump_overlay_for_debug(manager, current, modified, name)
 
-            tx_id = manager.apply_operation(create_instance_operation)
+            timer = StageTimer()
+            tx_id = manager.apply_operation(create_instance_operation, timer)
 
             click.echo(f"✓ Created instance '{name}' (transaction {tx_id})")
             if verbose:
@@ -737,6 +851,9 @@ def create(  # pylint: disable=too-many-arguments,too-many-positional-arguments
                     click.echo(f"  Memory Policy: {instance.resources.memory_policy}")
                 if instance.resources.devices:
                     click.echo(f"  Devices: {', '.join(instance.resources.devices)}")
+                click.echo("Timing breakdown:")
+                for line in timer.format_lines():
+                    click.echo(line)
         except ResourceError as e:
             click.echo(f"Error: Resource allocation failed: {e}", err=True)
             if verbose:
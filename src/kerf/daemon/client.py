@@ -0,0 +1,110 @@
+# Copyright 2026 Multikernel Technologies, Inc.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""
+The `kerf` entry point: forward lifecycle commands to kerfd when it runs.
+
+Lifecycle commands sent to a running kerfd execute in its warm process,
+so the client needs only the standard library and this package. Anything
+else, or any command when kerfd is not listening, runs in-process as
+before. Set KERF_NO_DAEMON=1 to always run in-process.
+"""
+
+import os
+import socket
+import sys
+from typing import List, Optional
+
+from .protocol import (
+    FRAME_EXIT,
+    FRAME_REQUEST,
+    FRAME_STDERR,
+    FRAME_STDOUT,
+    ProtocolError,
+    decode_exit,
+    encode_request,
+    recv_frame,
+    send_frame,
+    socket_path,
+)
+
+NO_DAEMON_ENV = "KERF_NO_DAEMON"
+
+# Commands kerfd runs; they take no terminal input
+DAEMON_COMMANDS = frozenset(
+    ("create", "update", "load", "unload", "exec", "kill", "delete", "run", "clone")
+)
+
+# Flags that attach this terminal to a console, so the command stays local
+ATTACH_FLAGS = {"exec": "--console", "run": "--attach"}
+
+
+def wants_daemon(argv: List[str]) -> bool:
+    """Whether argv (without the program name) is a command to send to kerfd."""
+    if os.environ.get(NO_DAEMON_ENV):
+        return False
+    command = next((arg for arg in argv if not arg.startswith("-")), None)
+    if command not in DAEMON_COMMANDS:
+        return False
+    return ATTACH_FLAGS.get(command) not in argv
+
+
+def request(argv: List[str], path: Optional[str] = None) -> Optional[int]:
+    """
+    Run argv in kerfd, copying its output through.
+
+    Returns:
+        The command's exit status, or None if kerfd is not listening and
+        the command should run in-process instead
+    """
+    sock = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM | socket.SOCK_CLOEXEC)
+    try:
+        try:
+            sock.connect(path or socket_path())
+        except (FileNotFoundError, ConnectionRefusedError):
+            return None
+
+        send_frame(sock, FRAME_REQUEST, encode_request(argv, os.getcwd()))
+        outputs = {FRAME_STDOUT: sys.stdout, FRAME_STDERR: sys.stderr}
+        with sock.makefile("rb") as replies:
+            while True:
+                frame = recv_frame(replies)
+                if frame is None:
+                    # The command may have run partly: never retry in-process
+                    print("Error: kerfd closed the connection", file=sys.stderr)
+                    return 1
+                kind, payload = frame
+                if kind == FRAME_EXIT:
+                    return decode_exit(payload)
+                out = outputs.get(kind)
+                if out is not None:
+                    out.buffer.write(payload)
+                    out.buffer.flush()
+    except (OSError, ProtocolError) as e:
+        print(f"Error: kerfd request failed: {e}", file=sys.stderr)
+        return 1
+    finally:
+        sock.close()
+
+
+def main() -> None:
+    argv = sys.argv[1:]
+    if wants_daemon(argv):
+        code = request(argv)
+        if code is not None:
+            sys.exit(code)
+
+    from ..cli import main as cli_main  # pylint: disable=import-outside-toplevel
+
+    cli_main()  # pylint: disable=no-value-for-parameter
@@ -0,0 +1,74 @@
+# Copyright 2026 Multikernel Technologies, Inc.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""
+The kerfd command.
+"""
+
+import signal
+import sys
+from typing import Optional
+
+import click
+
+from ..exceptions import KerfError
+from .protocol import DEFAULT_SOCKET_PATH, SOCKET_ENV
+from .server import KerfDaemon
+
+
+@click.command(name="kerfd")
+@click.option(
+    "--socket",
+    "path",
+    envvar=SOCKET_ENV,
+    help=f"Unix socket to listen on (default: {DEFAULT_SOCKET_PATH})",
+)
+@click.option("--verbose", "-v", is_flag=True, help="Verbose output")
+def kerfd(path: Optional[str], verbose: bool):
+    """
+    Serve kerf lifecycle commands from one resident process.
+
+    While kerfd listens, `kerf create`, `update`, `load`, `unload`,
+    `exec`, `kill`, `delete`, `run` and `clone` are sent to it and run in
+    its warm process instead of importing kerf and parsing the device tree
+    anew. Other commands, and all commands while kerfd is down, run as
+    before. kerfd exits on SIGTERM or SIGINT.
+
+    Examples:
+
+        kerfd &
+        kerf run web-server --kernel=/boot/vmlinuz --image=nginx:latest \\
+                 --cpu-count=4 --memory=2GB
+    """
+    stopping = []
+
+    def stop_handler(signum, frame):  # pylint: disable=unused-argument
+        stopping.append(signum)
+
+    daemon = KerfDaemon(path)
+    try:
+        daemon.listen()
+    except (KerfError, OSError) as e:
+        click.echo(f"Error: Cannot listen on {daemon.path}: {e}", err=True)
+        sys.exit(1)
+
+    for sig in (signal.SIGTERM, signal.SIGINT):
+        signal.signal(sig, stop_handler)
+    daemon.warm()
+    if verbose:
+        click.echo(f"kerfd listening on {daemon.path}")
+    try:
+        daemon.serve(stop=lambda: bool(stopping))
+    finally:
+        daemon.close()
@@ -0,0 +1,109 @@
+# Copyright 2026 Multikernel Technologies, Inc.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""
+Wire protocol between kerf and kerfd over a Unix stream socket.
+
+Every message is a frame: a one-byte kind, a little-endian u32 payload
+length, then the payload. The client sends one REQUEST frame holding
+JSON {"argv": [...], "cwd": "..."}; kerfd answers with any number of
+STDOUT and STDERR frames carrying the command's output bytes as it is
+written, then one EXIT frame holding the exit status as a signed u32.
+"""
+
+import json
+import os
+import socket
+import struct
+from typing import Any, BinaryIO, Dict, Optional, Tuple
+
+DEFAULT_SOCKET_PATH = "/run/kerf/kerfd.sock"
+SOCKET_ENV = "KERF_SOCKET"
+
+FRAME_REQUEST = b"R"
+FRAME_STDOUT = b"O"
+FRAME_STDERR = b"E"
+FRAME_EXIT = b"X"
+
+_FRAME = struct.Struct("<cI")
+_EXIT = struct.Struct("<i")
+
+# Bigger payloads are a protocol error, not a request
+MAX_FRAME = 16 * 1024 * 1024
+
+
+class ProtocolError(Exception):
+    """The peer sent something that is not a valid frame."""
+
+
+def socket_path() -> str:
+    """kerfd's socket: $KERF_SOCKET, else DEFAULT_SOCKET_PATH."""
+    return os.environ.get(SOCKET_ENV) or DEFAULT_SOCKET_PATH
+
+
+def send_frame(sock: socket.socket, kind: bytes, payload: bytes = b"") -> None:
+    sock.sendall(_FRAME.pack(kind, len(payload)) + payload)
+
+
+def recv_frame(stream: BinaryIO) -> Optional[Tuple[bytes, bytes]]:
+    """
+    Read one frame from a buffered socket file.
+
+    Returns:
+        (kind, payload), or None at a clean end of stream
+
+    Raises:
+        ProtocolError: On a truncated or oversized frame
+    """
+    header = stream.read(_FRAME.size)
+    if not header:
+        return None
+    if len(header) != _FRAME.size:
+        raise ProtocolError("truncated frame header")
+    kind, length = _FRAME.unpack(header)
+    if length > MAX_FRAME:
+        raise ProtocolError(f"frame of {length} bytes exceeds {MAX_FRAME}")
+    payload = stream.read(length)
+    if len(payload) != length:
+        raise ProtocolError("truncated frame payload")
+    return kind, payload
+
+
+def encode_request(argv: list, cwd: str) -> bytes:
+    return json.dumps({"argv": list(argv), "cwd": cwd}).encode()
+
+
+def decode_request(payload: bytes) -> Dict[str, Any]:
+    try:
+        request = json.loads(payload)
+    except ValueError as e:
+        raise ProtocolError(f"malformed request: {e}") from e
+    if (
+        not isinstance(request, dict)
+        or not isinstance(request.get("argv"), list)
+        or not all(isinstance(arg, str) for arg in request["argv"])
+        or not isinstance(request.get("cwd"), str)
+    ):
+        raise ProtocolError("request needs an argv string list and a cwd")
+    return request
+
+
+def encode_exit(code: int) -> bytes:
+    return _EXIT.pack(code)
+
+
+def decode_exit(payload: bytes) -> int:
+    if len(payload) != _EXIT.size:
+        raise ProtocolError("malformed exit frame")
+    return _EXIT.unpack(payload)[0]
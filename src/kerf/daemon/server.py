@@ -0,0 +1,238 @@
+# Copyright 2026 Multikernel Technologies, Inc.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""
+kerfd: run kerf commands in one resident process.
+
+Each request is a kerf command line, executed through the same click
+group as the `kerf` CLI, with its output streamed back as it is written.
+The package, libfdt and the parsed root device tree stay loaded between
+requests: DeviceTreeManager shares its tree cache across the process, so
+a command only re-parses the tree when an overlay transaction changed it.
+
+Requests run one at a time, in the client's working directory. Commands
+mutate process-wide state (cwd, sys.stdout) and take the kerf lock
+anyway, so serializing them costs nothing. Only root and kerfd's own
+user may connect.
+"""
+
+import contextlib
+import io
+import os
+import socket
+import struct
+import sys
+import traceback
+from pathlib import Path
+from typing import Callable, Optional
+
+import click
+
+from ..exceptions import KerfError, KernelInterfaceError, ParseError
+from ..runtime import DeviceTreeManager
+from .protocol import (
+    FRAME_EXIT,
+    FRAME_REQUEST,
+    FRAME_STDERR,
+    FRAME_STDOUT,
+    ProtocolError,
+    decode_request,
+    encode_exit,
+    recv_frame,
+    send_frame,
+    socket_path,
+)
+
+# Seconds between checks for a stop request while idle
+ACCEPT_POLL_SECONDS = 0.5
+
+_PEERCRED = struct.Struct("3i")
+
+
+class _FrameSink(io.RawIOBase):
+    """Sends whatever is written as frames of one kind; drops it once the client is gone."""
+
+    def __init__(self, sock: socket.socket, kind: bytes):
+        super().__init__()
+        self.sock = sock
+        self.kind = kind
+        self.connected = True
+
+    def writable(self) -> bool:
+        return True
+
+    def write(self, b) -> int:
+        data = bytes(b)
+        if self.connected and data:
+            try:
+                send_frame(self.sock, self.kind, data)
+            except OSError:
+                # Let the command finish; its state must not depend on the client
+                self.connected = False
+        return len(data)
+
+
+def _text_stream(sock: socket.socket, kind: bytes) -> io.TextIOWrapper:
+    return io.TextIOWrapper(
+        io.BufferedWriter(_FrameSink(sock, kind)), encoding="utf-8", errors="replace",
+        write_through=True,
+    )
+
+
+def execute(command: click.Command, argv: list, stdout, stderr) -> int:
+    """Run a kerf command line in this process, printing to stdout and stderr."""
+    saved_stdin = sys.stdin
+    # Commands get no terminal: a prompt sees end of input
+    sys.stdin = io.StringIO()
+    with contextlib.redirect_stdout(stdout), contextlib.redirect_stderr(stderr):
+        try:
+            result = command.main(args=argv, prog_name="kerf", standalone_mode=False)
+            return result if isinstance(result, int) else 0
+        except SystemExit as e:
+            if e.code is None or isinstance(e.code, int):
+                return e.code or 0
+            click.echo(e.code, err=True)
+            return 1
+        except click.ClickException as e:
+            e.show()
+            return e.exit_code
+        except click.Abort:
+            click.echo("Aborted!", err=True)
+            return 1
+        except Exception:
+            traceback.print_exc()
+            return 1
+        finally:
+            sys.stdin = saved_stdin
+            stdout.flush()
+            stderr.flush()
+
+
+class KerfDaemon:
+    """
+    Accepts kerf command lines on a Unix socket and runs them in-process.
+
+    Args:
+        path: Socket path (default: $KERF_SOCKET or /run/kerf/kerfd.sock)
+        command: Click command to run requests through (default: the kerf CLI)
+    """
+
+    def __init__(self, path: Optional[str] = None, command: Optional[click.Command] = None):
+        if command is None:
+            from ..cli import main as command  # pylint: disable=import-outside-toplevel
+        self.path = Path(path or socket_path())
+        self.command = command
+        self.sock: Optional[socket.socket] = None
+
+    def _claim_path(self) -> None:
+        """Remove a stale socket, refusing to replace a live kerfd."""
+        if not self.path.exists():
+            return
+        probe = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+        try:
+            probe.connect(str(self.path))
+        except ConnectionRefusedError:
+            self.path.unlink()
+            return
+        except OSError:
+            return
+        finally:
+            probe.close()
+        raise KerfError(f"kerfd is already listening on {self.path}")
+
+    def listen(self) -> None:
+        """Bind the socket, accessible to its owner only."""
+        self.path.parent.mkdir(parents=True, exist_ok=True)
+        self._claim_path()
+        sock = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM | socket.SOCK_CLOEXEC)
+        old_umask = os.umask(0o177)
+        try:
+            sock.bind(str(self.path))
+        finally:
+            os.umask(old_umask)
+        sock.listen(16)
+        sock.settimeout(ACCEPT_POLL_SECONDS)
+        self.sock = sock
+
+    def warm(self) -> None:
+        """Parse the root device tree once so the first request finds it cached."""
+        try:
+            DeviceTreeManager().read_baseline()
+        except (KernelInterfaceError, ParseError):
+            pass
+
+    def _authorized(self, conn: socket.socket) -> bool:
+        creds = conn.getsockopt(socket.SOL_SOCKET, socket.SO_PEERCRED, _PEERCRED.size)
+        _, uid, _ = _PEERCRED.unpack(creds)
+        return uid in (0, os.geteuid())
+
+    def handle(self, conn: socket.socket) -> None:
+        """Serve one connection: read its request, run it, stream the results."""
+        conn.settimeout(None)
+        if not self._authorized(conn):
+            send_frame(conn, FRAME_STDERR, b"Error: kerfd only accepts root and its owner\n")
+            send_frame(conn, FRAME_EXIT, encode_exit(1))
+            return
+        with conn.makefile("rb") as stream:
+            frame = recv_frame(stream)
+        if frame is None:
+            return
+        kind, payload = frame
+        if kind != FRAME_REQUEST:
+            raise ProtocolError(f"expected a request frame, got {kind!r}")
+        request = decode_request(payload)
+
+        stdout = _text_stream(conn, FRAME_STDOUT)
+        stderr = _text_stream(conn, FRAME_STDERR)
+        previous_cwd = os.getcwd()
+        try:
+            os.chdir(request["cwd"])
+        except OSError as e:
+            stderr.write(f"Error: Cannot enter {request['cwd']}: {e}\n")
+            stderr.flush()
+            code = 1
+        else:
+            try:
+                code = execute(self.command, request["argv"], stdout, stderr)
+            finally:
+                os.chdir(previous_cwd)
+        try:
+            send_frame(conn, FRAME_EXIT, encode_exit(code))
+        except OSError:
+            pass
+
+    def serve(self, stop: Callable[[], bool] = lambda: False) -> None:
+        """Handle connections one at a time until stop() returns True."""
+        if self.sock is None:
+            self.listen()
+        while not stop():
+            try:
+                conn, _ = self.sock.accept()
+            except socket.timeout:
+                continue
+            except InterruptedError:
+                continue
+            with conn:
+                try:
+                    self.handle(conn)
+                except (OSError, ProtocolError) as e:
+                    click.echo(f"kerfd: dropped a request: {e}", err=True)
+
+    def close(self) -> None:
+        """Stop listening and remove the socket."""
+        if self.sock is not None:
+            self.sock.close()
+            self.sock = None
+            with contextlib.suppress(FileNotFoundError):
+                self.path.unlink()
@@ -12,13 +12,18 @@
 # See the License for the specific language governing permissions and
 # limitations under the License.
 
-"""Package data for kerf, including the pre-built init binary."""
+"""Package data for kerf, including the pre-built init and mkdaxfs binaries."""
 
 from pathlib import Path
 
-__all__ = ["get_init_binary_path"]
+__all__ = ["get_init_binary_path", "get_mkdaxfs_binary_path"]
 
 
 def get_init_binary_path() -> Path:
     """Return the path to the pre-built kerf-init binary."""
     return Path(__file__).parent / "kerf-init"
+
+
+def get_mkdaxfs_binary_path() -> Path:
+    """Return the path to the pre-built native mkdaxfs writer."""
+    return Path(__file__).parent / "mkdaxfs"
@@ -14,6 +14,18 @@
 
 """DAXFS filesystem image creation for multikernel."""
 
-from .mkdaxfs import create_daxfs_image, DaxfsError, DaxfsImage, inject_kerf_init
+from .mkdaxfs import (
+    create_daxfs_image, daxfs_region_pinned, DaxfsError, DaxfsImage, inject_kerf_init,
+)
+from .layers import create_daxfs_image_from_layers
+from .store import DaxfsImageStore
 
-__all__ = ["create_daxfs_image", "DaxfsError", "DaxfsImage", "inject_kerf_init"]
+__all__ = [
+    "create_daxfs_image",
+    "create_daxfs_image_from_layers",
+    "daxfs_region_pinned",
+    "DaxfsError",
+    "DaxfsImage",
+    "DaxfsImageStore",
+    "inject_kerf_init",
+]
@@ -0,0 +1,491 @@
+# Copyright 2026 Multikernel Technologies, Inc.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""
+Build daxfs images straight from OCI image layers.
+
+LayerIndex applies layer tarballs in order, honouring OCI whiteouts, into an
+in-memory tree of headers. LayerDaxfsBuilder lays that tree out exactly like
+DaxfsBuilder lays out a directory, then streams each surviving member from
+its decompressed layer into the image. File data goes from the layer stream
+into heap memory once, without an extracted rootfs on disk.
+
+Given a cache directory, the written image is also kept there, keyed on the
+layer digests, the extent alignment and the injected kerf-init, so loading
+the same image again is one sequential read instead of decompressing every
+layer.
+"""
+
+import hashlib
+import os
+import stat
+import tarfile
+from concurrent.futures import ThreadPoolExecutor
+from dataclasses import dataclass
+from pathlib import Path
+from typing import Dict, List, Optional, Tuple, Union
+
+from kerf.timing import StageTimer
+
+from .mkdaxfs import (
+    DAXFS_BLOCK_SIZE,
+    DAXFS_COPY_CHUNK,
+    DAXFS_DEFAULT_THREADS,
+    DAXFS_VERSION,
+    ZEROED_DMA_HEAPS,
+    DaxfsBuilder,
+    DaxfsError,
+    KERF_STATUS_FILE,
+    KERF_STATUS_SIZE,
+    DaxfsImage,
+    FileEntry,
+    _allocate_and_mount,
+    _kerf_init_binary,
+)
+
+WHITEOUT_PREFIX = ".wh."
+OPAQUE_WHITEOUT = ".wh..wh..opq"
+
+# Where a regular file's bytes come from: (layer index, member ordinal)
+# within the layer stream, or a file on the host
+DataSource = Union[Tuple[int, int], Path]
+
+_TAR_TYPE_MODES = {
+    tarfile.CHRTYPE: stat.S_IFCHR,
+    tarfile.BLKTYPE: stat.S_IFBLK,
+    tarfile.FIFOTYPE: stat.S_IFIFO,
+}
+
+
+@dataclass
+class LayerNode:
+    """One path in the merged image tree."""
+    mode: int
+    uid: int = 0
+    gid: int = 0
+    size: int = 0
+    mtime: int = 0
+    linkname: str = ""  # Symlink target
+    source: Optional[DataSource] = None  # None for a zero-filled regular file
+    children: Optional[Dict[str, "LayerNode"]] = None  # Set for directories
+
+
+def _normalize(name: str) -> str:
+    """Turn a tar member name into a path relative to the image root."""
+    parts = [p for p in name.split("/") if p and p != "."]
+    if ".." in parts:
+        raise DaxfsError(f"Layer member escapes the image root: {name}")
+    return "/".join(parts)
+
+
+def _new_dir(mode: int = 0o755) -> LayerNode:
+    return LayerNode(mode=stat.S_IFDIR | mode, children={})
+
+
+class LayerIndex:
+    """Merged view of an image's layers, applied lowest first."""
+
+    def __init__(self):
+        self.root = _new_dir()
+        self.layers: List[Path] = []
+
+    def _lookup(self, path: str) -> Optional[LayerNode]:
+        node = self.root
+        for part in path.split("/") if path else []:
+            if node.children is None:
+                return None
+            node = node.children.get(part)
+            if node is None:
+                return None
+        return node
+
+    def _parent_dir(self, path: str) -> Tuple[LayerNode, str]:
+        """Return (parent directory node, basename), creating missing parents."""
+        parent_path, _, name = path.rpartition("/")
+        node = self.root
+        for part in parent_path.split("/") if parent_path else []:
+            child = node.children.get(part)
+            if child is None or child.children is None:
+                child = _new_dir()
+                node.children[part] = child
+            node = child
+        return node, name
+
+    def _whiteout(self, path: str, name: str) -> None:
+        """Apply one whiteout entry to the layers below."""
+        dir_path = path.rpartition("/")[0]
+        if name == OPAQUE_WHITEOUT:
+            target = self._lookup(dir_path)
+            if target is not None and target.children is not None:
+                target.children.clear()
+            return
+
+        target_dir = self._lookup(dir_path)
+        if target_dir is not None and target_dir.children is not None:
+            target_dir.children.pop(name[len(WHITEOUT_PREFIX):], None)
+
+    @staticmethod
+    def read_layer(layer_path: Path) -> List[tarfile.TarInfo]:
+        """Decompress one layer and return its member headers in order."""
+        try:
+            with tarfile.open(layer_path, mode='r|*') as tar:
+                return list(tar)
+        except (OSError, tarfile.TarError) as e:
+            raise DaxfsError(f"Failed to read layer {layer_path}: {e}") from e
+
+    def apply_layer(self, layer_path: Path,
+                    members: Optional[List[tarfile.TarInfo]] = None) -> None:
+        """Merge one layer's headers over the current tree.
+
+        members may be passed in if read_layer() already ran, e.g. on
+        another thread; layers must still be applied lowest first.
+        """
+        layer_idx = len(self.layers)
+        self.layers.append(Path(layer_path))
+        if members is None:
+            members = self.read_layer(layer_path)
+
+        # Whiteouts only hide entries from lower layers, so apply them all
+        # before adding this layer's own entries
+        paths = [_normalize(m.name) for m in members]
+        for path in paths:
+            name = path.rpartition("/")[2]
+            if name.startswith(WHITEOUT_PREFIX):
+                self._whiteout(path, name)
+
+        # Nodes added by this layer, for resolving hard links
+        added: Dict[str, LayerNode] = {}
+        for ordinal, (member, path) in enumerate(zip(members, paths)):
+            if path.rpartition("/")[2].startswith(WHITEOUT_PREFIX):
+                continue
+            if not path:
+                # The layer's "./" entry carries the root directory metadata
+                if member.isdir():
+                    self._set_meta(self.root, member)
+                continue
+            node = self._add_member(member, path, (layer_idx, ordinal), added)
+            if node is not None:
+                added[path] = node
+
+    @staticmethod
+    def _set_meta(node: LayerNode, member: tarfile.TarInfo) -> None:
+        node.mode = stat.S_IFMT(node.mode) | stat.S_IMODE(member.mode)
+        node.uid = member.uid
+        node.gid = member.gid
+        node.mtime = int(member.mtime)
+
+    def _add_member(self, member: tarfile.TarInfo, path: str, source: Tuple[int, int],
+                    added: Dict[str, LayerNode]) -> Optional[LayerNode]:
+        parent, name = self._parent_dir(path)
+        existing = parent.children.get(name)
+
+        if member.isdir():
+            # Directories merge with a lower directory of the same name
+            if existing is not None and existing.children is not None:
+                node = existing
+            else:
+                node = _new_dir()
+        elif member.islnk():
+            target_path = _normalize(member.linkname)
+            target = added.get(target_path) or self._lookup(target_path)
+            if target is None or not stat.S_ISREG(target.mode):
+                return None
+            node = LayerNode(mode=stat.S_IFREG, size=target.size, source=target.source)
+        elif member.issym():
+            node = LayerNode(mode=stat.S_IFLNK,
+                             size=len(member.linkname.encode('utf-8')),
+                             linkname=member.linkname)
+        elif member.isreg():
+            node = LayerNode(mode=stat.S_IFREG, size=member.size, source=source)
+        elif member.type in _TAR_TYPE_MODES:
+            node = LayerNode(mode=_TAR_TYPE_MODES[member.type])
+        else:
+            return None
+
+        self._set_meta(node, member)
+        parent.children[name] = node
+        return node
+
+    def add_host_file(self, path: str, host_path: Path, mode: int = 0o755) -> None:
+        """Add or replace a regular file whose contents come from the host."""
+        parent, name = self._parent_dir(_normalize(path))
+        parent.children[name] = LayerNode(
+            mode=stat.S_IFREG | mode,
+            size=os.stat(host_path).st_size,
+            source=Path(host_path),
+        )
+
+    def add_zero_file(self, path: str, size: int, mode: int = 0o644) -> None:
+        """Add or replace a zero-filled regular file of the given size."""
+        parent, name = self._parent_dir(_normalize(path))
+        parent.children[name] = LayerNode(mode=stat.S_IFREG | mode, size=size)
+
+
+class LayerDaxfsBuilder(DaxfsBuilder):
+    """DaxfsBuilder fed from a LayerIndex instead of a directory.
+
+    dedup is not supported, since file contents are only read once, while
+    the image is being written.
+    """
+
+    def __init__(self, index: LayerIndex, **kwargs):
+        super().__init__(".", **kwargs)
+        if self.dedup:
+            raise DaxfsError("dedup is not supported when building from layers")
+        self.index = index
+        self._nodes: Dict[int, LayerNode] = {}
+
+    def scan(self) -> None:
+        """Turn the merged tree into entries, in the same order as scan()."""
+        # Regular files sharing a data source are hard links of each other
+        links: Dict[DataSource, int] = {}
+        stack = [self.index.root]
+        while stack:
+            node = stack.pop()
+            if node.source is not None:
+                links[node.source] = links.get(node.source, 0) + 1
+            if node.children:
+                stack.extend(node.children.values())
+
+        self._add_node("", self.index.root, links)
+
+    def _add_node(self, relpath: str, node: LayerNode, links: Dict[DataSource, int]) -> None:
+        if node.children is not None:
+            nlink = 2 + sum(1 for c in node.children.values() if c.children is not None)
+        else:
+            nlink = links.get(node.source, 1)
+
+        entry = self._add_file(relpath, os.stat_result((
+            node.mode, 0, 0, nlink, node.uid, node.gid, node.size,
+            node.mtime, node.mtime, node.mtime,
+        )))
+        self._nodes[entry.ino] = node
+
+        for name in sorted(node.children or ()):
+            child_path = f"{relpath}/{name}" if relpath else name
+            self._add_node(child_path, node.children[name], links)
+
+    def _fill_extents(self, view: memoryview, dmabuf_fd: Optional[int],
+                      zero_fill: bool, threads: int) -> None:
+        """Stream member data out of each layer into its extents.
+
+        Layers are independent and their extents disjoint, so up to threads
+        layers are decompressed concurrently. A layer is not read at all if
+        none of its members survived, and reading stops after the last
+        member that is still needed.
+        """
+        by_layer: Dict[int, Dict[int, List[FileEntry]]] = {}
+        host_files: List[FileEntry] = []
+        zero_files: List[FileEntry] = []
+        written = 0
+
+        for e in self._data_extents():
+            node = self._nodes[e.ino]
+            if stat.S_ISLNK(node.mode):
+                target = node.linkname.encode('utf-8')
+                view[e.data_offset:e.data_offset + len(target)] = target
+                written += len(target)
+            elif node.source is None:
+                zero_files.append(e)
+            elif isinstance(node.source, Path):
+                host_files.append(e)
+            else:
+                layer_idx, ordinal = node.source
+                by_layer.setdefault(layer_idx, {}).setdefault(ordinal, []).append(e)
+
+        if zero_fill:
+            for e in zero_files:
+                self._zero_range(view, e.data_offset, e.data_offset + e.stat.st_size)
+
+        for e in host_files:
+            fd = os.open(self._nodes[e.ino].source, os.O_RDONLY | os.O_CLOEXEC)
+            try:
+                written += self._copy_file_data(fd, view, dmabuf_fd,
+                                                e.data_offset, e.stat.st_size)
+            finally:
+                os.close(fd)
+
+        jobs = sorted(by_layer.items())
+        if threads > 1 and len(jobs) > 1:
+            with ThreadPoolExecutor(max_workers=threads) as pool:
+                written += sum(pool.map(lambda job: self._stream_layer(view, *job), jobs))
+        else:
+            written += sum(self._stream_layer(view, *job) for job in jobs)
+
+        self.bytes_written = written
+
+        if zero_fill:
+            # Everything up to each file's size was written, unless a layer
+            # member turned out shorter than its header said
+            for e in self._data_extents():
+                extent_end = e.data_offset + self._align(e.stat.st_size, DAXFS_BLOCK_SIZE)
+                self._zero_range(view, e.data_offset + e.stat.st_size, extent_end)
+
+    def _stream_layer(self, view: memoryview, layer_idx: int,
+                      wanted: Dict[int, List[FileEntry]]) -> int:
+        """Copy the wanted members of one layer. Returns bytes written."""
+        layer_path = self.index.layers[layer_idx]
+        remaining = len(wanted)
+        written = 0
+
+        with tarfile.open(layer_path, mode='r|*') as tar:
+            for ordinal, member in enumerate(tar):
+                entries = wanted.get(ordinal)
+                if not entries:
+                    continue
+
+                first = entries[0]
+                src = tar.extractfile(member)
+                copied = 0
+                while copied < first.stat.st_size:
+                    start = first.data_offset + copied
+                    n = min(DAXFS_COPY_CHUNK, first.stat.st_size - copied)
+                    with view[start:start + n] as chunk:
+                        got = src.readinto(chunk)
+                    if not got:
+                        break
+                    copied += got
+                if copied < first.stat.st_size:
+                    self._zero_range(view, first.data_offset + copied,
+                                     first.data_offset + first.stat.st_size)
+
+                # Hard links to the same member get their own copy
+                for e in entries[1:]:
+                    src_start = first.data_offset
+                    view[e.data_offset:e.data_offset + copied] = view[src_start:src_start + copied]
+                written += copied * len(entries)
+
+                remaining -= 1
+                if not remaining:
+                    break
+
+        if remaining:
+            raise DaxfsError(f"Layer {layer_path} ended before all members were read")
+        return written
+
+
+def build_layer_index(layers: List[Path], inject_init: bool = True,
+                      threads: int = 1) -> LayerIndex:
+    """Merge image layers, lowest first, optionally adding /init (kerf-init)
+    and room for its status record.
+
+    Up to threads layers are decompressed concurrently; only the merge,
+    which must follow layer order, runs sequentially.
+    """
+    index = LayerIndex()
+    if threads > 1 and len(layers) > 1:
+        with ThreadPoolExecutor(max_workers=threads) as pool:
+            headers = list(pool.map(LayerIndex.read_layer, layers))
+    else:
+        headers = [None] * len(layers)
+    for layer_path, members in zip(layers, headers):
+        index.apply_layer(layer_path, members)
+    if inject_init:
+        index.add_host_file("init", _kerf_init_binary())
+        index.add_zero_file(KERF_STATUS_FILE, KERF_STATUS_SIZE)
+    return index
+
+
+def _cached_image_path(cache_dir: Path, layers: List[Path], inject_init: bool,
+                       huge_align: int) -> Path:
+    """Where the image of these layers and options is cached."""
+    h = hashlib.sha256(DAXFS_VERSION.to_bytes(4, "little"))
+    for layer in layers:
+        # OCI blobs are named blobs/<algorithm>/<digest>
+        h.update(f"{layer.parent.name}:{layer.name}\0".encode())
+    h.update(huge_align.to_bytes(8, "little"))
+    if inject_init:
+        h.update(hashlib.sha256(_kerf_init_binary().read_bytes()).digest())
+    return cache_dir / f"{h.hexdigest()}.img"
+
+
+def _read_cached_image(path: Path, mem, size: int, alloc_size: int, zeroed: bool) -> int:
+    """Copy the first size bytes of a cached image into the dma-buf."""
+    with open(path, "rb") as f, memoryview(mem) as view:
+        done = 0
+        while done < size:
+            n = f.readinto(view[done:size])
+            if not n:
+                raise DaxfsError(f"Cached image {path} is truncated")
+            done += n
+        if not zeroed:
+            DaxfsBuilder._zero_range(view, size, alloc_size)
+    return size
+
+
+def create_daxfs_image_from_layers(
+    layers: List[Path],
+    instance_name: str,
+    heap_path: str = "/dev/dma_heap/multikernel",
+    size: Optional[int] = None,
+    timer: Optional[StageTimer] = None,
+    threads: int = DAXFS_DEFAULT_THREADS,
+    huge_align: int = 0,
+    inject_init: bool = True,
+    cache_dir: Optional[Path] = None,
+) -> DaxfsImage:
+    """
+    Create a daxfs image from OCI layer tarballs without extracting them.
+
+    Args:
+        layers: Layer blob paths, lowest first
+        instance_name: Name of the multikernel instance
+        heap_path: Path to the DMA heap device
+        size: Size to allocate (if None, calculated automatically with 10% padding)
+        timer: Optional StageTimer that receives per-stage timings
+        threads: Number of layers decompressed concurrently
+        huge_align: Align large file extents to up to this hugepage size (2M or 1G)
+        inject_init: Add kerf-init as /init
+        cache_dir: Reuse the image cached here for the same layers and
+                   options, or cache the one built
+
+    Returns:
+        DaxfsImage with physical address and size
+
+    Raises:
+        DaxfsError: If image creation fails
+    """
+    timer = timer or StageTimer()
+    zeroed = os.path.basename(heap_path) in ZEROED_DMA_HEAPS
+
+    cached = None
+    if cache_dir is not None:
+        with timer.stage("lookup"):
+            cached = _cached_image_path(cache_dir, layers, inject_init, huge_align)
+            cached_size = cached.stat().st_size if cached.is_file() else 0
+        if cached_size:
+            image = _allocate_and_mount(
+                instance_name, heap_path, cached_size, size, timer,
+                lambda mem, dmabuf_fd, alloc_size: _read_cached_image(
+                    cached, mem, cached_size, alloc_size, zeroed
+                ),
+            )
+            image.huge_align = huge_align
+            return image
+
+    with timer.stage("index"):
+        index = build_layer_index(layers, inject_init, threads)
+    builder = LayerDaxfsBuilder(index, huge_align=huge_align)
+    builder.build(timer)
+
+    def write(mem, dmabuf_fd: int, alloc_size: int) -> int:
+        builder.write_image(mem, alloc_size, dmabuf_fd, zeroed=zeroed, threads=threads)
+        return builder.bytes_written
+
+    image = _allocate_and_mount(
+        instance_name, heap_path, builder.calculate_total_size(), size, timer, write,
+        save_to=cached,
+    )
+    image.huge_align = huge_align
+    return image
@@ -21,16 +21,25 @@ even after the dmabuf fd is closed.
 """
 
 import ctypes
+import errno
 import fcntl
+import hashlib
 import mmap
 import os
 import shutil
+import socket
+import stat
 import struct
+import subprocess
+import threading
+import time
+from concurrent.futures import ThreadPoolExecutor
 from dataclasses import dataclass
 from pathlib import Path
-from typing import Optional
+from typing import Optional, Tuple
 
-from kerf.data import get_init_binary_path
+from kerf.data import get_init_binary_path, get_mkdaxfs_binary_path
+from kerf.timing import StageTimer
 
 DAXFS_MAGIC = 0x64646178
 DAXFS_VERSION = 1
@@ -38,6 +47,36 @@ DAXFS_BLOCK_SIZE = 4096
 DAXFS_INODE_SIZE = 64
 DAXFS_ROOT_INO = 1
 
+# Hugepage sizes extents can be aligned to, largest first
+DAXFS_HUGE_2M = 2 * 1024 * 1024
+DAXFS_HUGE_1G = 1024 * 1024 * 1024
+DAXFS_HUGE_PAGE_SIZES = (DAXFS_HUGE_1G, DAXFS_HUGE_2M)
+
+# Superblock flags. With DAXFS_FLAG_HUGE_ALIGNED set, bits 8-15 hold log2
+# of the largest extent alignment the image was laid out with.
+DAXFS_FLAG_HUGE_ALIGNED = 1 << 0
+DAXFS_FLAG_ALIGN_SHIFT = 8
+
+# Page kerf-init keeps its status record in. The spawn writes it through
+# /dev/mem at kerf.status=<phys>; the host reads it via its daxfs mount.
+KERF_STATUS_FILE = ".kerf/status"
+KERF_STATUS_SIZE = DAXFS_BLOCK_SIZE
+
+# Chunk size for streaming file contents into the image
+DAXFS_COPY_CHUNK = 4 * 1024 * 1024
+
+# Default number of threads filling data extents
+DAXFS_DEFAULT_THREADS = min(8, os.cpu_count() or 1)
+
+# copy_file_range() errors meaning the dma-buf can't be a copy target
+_KERNEL_COPY_UNSUPPORTED = frozenset(
+    (errno.EXDEV, errno.EINVAL, errno.EOPNOTSUPP, errno.ENOSYS, errno.EBADF)
+)
+
+# DMA heaps whose allocations are already zeroed (the upstream system heap
+# allocates with __GFP_ZERO), so write_image() can skip all zeroing
+ZEROED_DMA_HEAPS = frozenset(("system",))
+
 DMA_HEAP_IOC_MAGIC = ord('H')
 DMA_HEAP_IOCTL_ALLOC = 0xC0184800
 
@@ -51,6 +90,11 @@ class DaxfsImage:
     """Represents a created daxfs image."""
     phys_addr: int
     size: int
+    shared: bool = False  # Reused an identical image already in memory
+    bytes_written: int = 0  # File data copied into the image
+    write_seconds: float = 0.0  # Time spent writing the image
+    huge_align: int = 0  # Largest extent alignment, 0 if 4K only
+    status_offset: int = 0  # Image offset of KERF_STATUS_FILE, 0 if absent
 
 
 @dataclass
@@ -65,16 +109,54 @@ class FileEntry:
     next_sibling: int = 0
     data_offset: int = 0
     name_strtab_offset: int = 0
+    digest: Optional[bytes] = None  # Content hash, only set with dedup
+    extent_ino: int = 0  # Inode whose extent this entry shares, 0 if its own
+    nlink: int = 1  # Links within the image, not the host's st_nlink
 
 
 class DaxfsBuilder:
-    """Builds a daxfs filesystem image."""
+    """Builds a daxfs filesystem image.
+
+    Entries are indexed by path and inode number as they are scanned, and
+    each directory keeps a pointer to its last child, so scan, build_tree and
+    calculate_offsets are all linear in the number of entries.
 
-    def __init__(self, src_dir: str):
+    With dedup enabled, regular files are hashed during the scan and files
+    with identical contents share a single data extent. daxfs is read-only,
+    so an extent can safely back several inodes.
+
+    With huge_align set to 2M or 1G, files of at least huge_threshold bytes
+    get extents aligned to the largest hugepage size, up to huge_align, that
+    they fill, so the spawn kernel can map them with PMD/PUD entries. Those
+    extents are placed after all 4K-aligned ones to keep the padding small.
+    """
+
+    def __init__(self, src_dir: str, dedup: bool = False, huge_align: int = 0,
+                 huge_threshold: int = DAXFS_HUGE_2M):
+        if huge_align and huge_align not in DAXFS_HUGE_PAGE_SIZES:
+            raise DaxfsError(f"Unsupported extent alignment {huge_align}")
         self.src_dir = Path(src_dir)
+        self.dedup = dedup
+        self.huge_align = huge_align
+        self.huge_threshold = huge_threshold
         self.files: list[FileEntry] = []
         self.next_ino = 1
         self.strtab_size = 0
+        self.data_size = 0
+        self.dedup_bytes = 0
+        self.bytes_written = 0
+        # Alignment gaps in front of hugepage-aligned extents
+        self.huge_padding = 0
+        self.huge_extents = 0
+        self._padding_ranges: list[tuple[int, int]] = []
+        self._by_path: dict[str, FileEntry] = {}
+        self._by_ino: dict[int, FileEntry] = {}
+        # Content digest -> entry owning the extent
+        self._extents: dict[bytes, FileEntry] = {}
+        # (st_dev, st_ino) -> digest, so hard links are hashed once
+        self._link_digests: dict[tuple[int, int], bytes] = {}
+        # Cleared once the dma-buf rejects copy_file_range()
+        self.kernel_copy = hasattr(os, "copy_file_range")
 
     def _add_file(self, relpath: str, stat_result: os.stat_result) -> FileEntry:
         """Add a file entry."""
@@ -83,38 +165,96 @@ class DaxfsBuilder:
             name=os.path.basename(relpath) if relpath else "",
             stat=stat_result,
             ino=self.next_ino,
+            nlink=stat_result.st_nlink,
         )
         self.next_ino += 1
         self.strtab_size += len(entry.name) + 1
+        extent_size = self._align(entry.stat.st_size, DAXFS_BLOCK_SIZE)
+        if self.dedup and self._is_regular(entry.stat.st_mode) and extent_size:
+            entry.digest = self._file_digest(relpath, stat_result)
+        if entry.digest is not None and entry.digest in self._extents:
+            entry.extent_ino = self._extents[entry.digest].ino
+            self.dedup_bytes += extent_size
+        elif self._has_data(entry.stat.st_mode):
+            self.data_size += extent_size
+            if entry.digest is not None:
+                self._extents[entry.digest] = entry
         self.files.append(entry)
+        self._by_path[relpath] = entry
+        self._by_ino[entry.ino] = entry
         return entry
 
+    def _file_digest(self, relpath: str, stat_result: os.stat_result) -> Optional[bytes]:
+        """Hash a regular file's contents, or None if it cannot be read."""
+        link_key = (stat_result.st_dev, stat_result.st_ino)
+        if link_key in self._link_digests:
+            return self._link_digests[link_key]
+
+        h = hashlib.sha256()
+        try:
+            with open(self.src_dir / relpath, 'rb', buffering=0) as f:
+                remaining = stat_result.st_size
+                while remaining > 0:
+                    chunk = f.read(min(remaining, DAXFS_COPY_CHUNK))
+                    if not chunk:
+                        break
+                    h.update(chunk)
+                    remaining -= len(chunk)
+        except (PermissionError, FileNotFoundError, IsADirectoryError):
+            return None
+
+        # Bind the digest to the extent size so a shrunken file never
+        # matches a full-size one
+        h.update(stat_result.st_size.to_bytes(8, 'little'))
+        digest = h.digest()
+        self._link_digests[link_key] = digest
+        return digest
+
+    def image_digest(self) -> bytes:
+        """Hash everything that ends up in the image.
+
+        Two trees with the same digest produce byte-identical images. Only
+        meaningful with dedup enabled, since file contents are not hashed
+        otherwise.
+        """
+        h = hashlib.sha256()
+        if self.huge_align:
+            h.update(self.huge_align.to_bytes(8, 'little'))
+        for e in self.files:
+            st = e.stat
+            h.update(e.path.encode('utf-8', 'surrogateescape') + b'\x00')
+            h.update(struct.pack('<IIIQI', st.st_mode, st.st_uid, st.st_gid,
+                                 st.st_size, e.nlink))
+            if self._is_regular(st.st_mode):
+                h.update(e.digest or b'\x00' * 32)
+            elif self._is_symlink(st.st_mode):
+                try:
+                    h.update(os.readlink(self.src_dir / e.path).encode('utf-8'))
+                except (PermissionError, FileNotFoundError):
+                    pass
+        return h.digest()
+
     def _scan_directory_recursive(self, relpath: str) -> None:
         """Recursively scan a directory."""
-        if relpath:
-            fullpath = self.src_dir / relpath
-        else:
-            fullpath = self.src_dir
+        fullpath = self.src_dir / relpath if relpath else self.src_dir
 
         try:
-            entries = list(fullpath.iterdir())
+            with os.scandir(fullpath) as it:
+                entries = sorted(it, key=lambda e: e.name)
         except PermissionError:
             return
 
-        for entry in sorted(entries, key=lambda e: e.name):
-            if relpath:
-                newrel = f"{relpath}/{entry.name}"
-            else:
-                newrel = entry.name
+        for entry in entries:
+            newrel = f"{relpath}/{entry.name}" if relpath else entry.name
 
             try:
-                file_stat = entry.lstat()
+                file_stat = entry.stat(follow_symlinks=False)
             except (PermissionError, FileNotFoundError):
                 continue
 
             self._add_file(newrel, file_stat)
 
-            if entry.is_dir() and not entry.is_symlink():
+            if stat.S_ISDIR(file_stat.st_mode):
                 self._scan_directory_recursive(newrel)
 
     def scan(self) -> None:
@@ -122,86 +262,194 @@ class DaxfsBuilder:
         root_stat = self.src_dir.lstat()
         self._add_file("", root_stat)
         self._scan_directory_recursive("")
+        self._count_links()
 
-    def _find_by_path(self, path: str) -> Optional[FileEntry]:
-        """Find file entry by path."""
+    def _count_links(self) -> None:
+        """Set each entry's nlink from the links inside the scanned tree.
+
+        The host's st_nlink also counts links outside the tree, such as the
+        hard-linked rootfs clones extract_image() hands out from the image
+        cache, and would make identical trees produce different images.
+        """
+        links: dict[tuple[int, int], int] = {}
         for e in self.files:
-            if e.path == path:
-                return e
-        return None
+            if not stat.S_ISDIR(e.stat.st_mode):
+                key = (e.stat.st_dev, e.stat.st_ino)
+                links[key] = links.get(key, 0) + 1
+        for e in self.files:
+            if stat.S_ISDIR(e.stat.st_mode):
+                e.nlink = 2
+            else:
+                e.nlink = links[(e.stat.st_dev, e.stat.st_ino)]
+        for e in self.files:
+            if e.path and stat.S_ISDIR(e.stat.st_mode):
+                self._by_path[os.path.dirname(e.path)].nlink += 1
 
-    def _find_by_ino(self, ino: int) -> Optional[FileEntry]:
+    def find_by_path(self, path: str) -> Optional[FileEntry]:
+        """Find file entry by path."""
+        return self._by_path.get(path)
+
+    def find_by_ino(self, ino: int) -> Optional[FileEntry]:
         """Find file entry by inode number."""
-        for e in self.files:
-            if e.ino == ino:
-                return e
-        return None
+        return self._by_ino.get(ino)
 
     def build_tree(self) -> None:
         """Build the directory tree structure."""
+        # Last child linked so far, per parent inode
+        tails: dict[int, FileEntry] = {}
+
         for e in self.files:
             if not e.path:
                 e.parent_ino = 0
                 continue
 
-            parent_path = os.path.dirname(e.path)
-            parent = self._find_by_path(parent_path)
-            if parent:
-                e.parent_ino = parent.ino
+            parent = self._by_path.get(os.path.dirname(e.path))
+            if not parent:
+                continue
 
-                if parent.first_child == 0:
-                    parent.first_child = e.ino
-                else:
-                    sibling = self._find_by_ino(parent.first_child)
-                    while sibling and sibling.next_sibling:
-                        sibling = self._find_by_ino(sibling.next_sibling)
-                    if sibling:
-                        sibling.next_sibling = e.ino
+            e.parent_ino = parent.ino
+            tail = tails.get(parent.ino)
+            if tail is None:
+                parent.first_child = e.ino
+            else:
+                tail.next_sibling = e.ino
+            tails[parent.ino] = e
 
-    def calculate_offsets(self) -> None:
-        """Calculate data offsets for all files."""
+    def _layout(self) -> tuple[int, int, int]:
+        """Return (inode_offset, strtab_offset, data_offset) of the image regions."""
         inode_offset = DAXFS_BLOCK_SIZE
         strtab_offset = inode_offset + len(self.files) * DAXFS_INODE_SIZE
         data_offset = self._align(strtab_offset + self.strtab_size, DAXFS_BLOCK_SIZE)
+        return inode_offset, strtab_offset, data_offset
+
+    def _extent_alignment(self, size: int) -> int:
+        """Return the alignment of an extent holding size bytes."""
+        if not self.huge_align or size < self.huge_threshold:
+            return DAXFS_BLOCK_SIZE
+        for page_size in DAXFS_HUGE_PAGE_SIZES:
+            if page_size <= self.huge_align and size >= page_size:
+                return page_size
+        # Threshold below 2M: still align, the tail stays 4K mapped
+        return DAXFS_HUGE_2M
+
+    def calculate_offsets(self) -> None:
+        """Calculate data offsets for all files."""
+        _, _, data_offset = self._layout()
         str_off = 0
+        huge: list[tuple[int, FileEntry]] = []
 
         for e in self.files:
             e.name_strtab_offset = str_off
             str_off += len(e.name) + 1
 
-            if self._is_regular(e.stat.st_mode) or self._is_symlink(e.stat.st_mode):
+            if e.extent_ino or not self._has_data(e.stat.st_mode):
+                continue
+            alignment = self._extent_alignment(e.stat.st_size)
+            if alignment > DAXFS_BLOCK_SIZE:
+                huge.append((alignment, e))
+            else:
                 e.data_offset = data_offset
                 data_offset += self._align(e.stat.st_size, DAXFS_BLOCK_SIZE)
 
-    def calculate_total_size(self) -> int:
-        """Calculate total image size."""
-        inode_offset = DAXFS_BLOCK_SIZE
-        strtab_offset = inode_offset + len(self.files) * DAXFS_INODE_SIZE
-        data_offset = self._align(strtab_offset + self.strtab_size, DAXFS_BLOCK_SIZE)
-        total = data_offset
+        # Largest alignment first, otherwise each smaller extent ahead of a
+        # 1G one could push it to the next 1G boundary
+        huge.sort(key=lambda item: item[0], reverse=True)
+        self.huge_padding = 0
+        self.huge_extents = len(huge)
+        self._padding_ranges = []
+        for alignment, e in huge:
+            aligned = self._align(data_offset, alignment)
+            if aligned > data_offset:
+                self._padding_ranges.append((data_offset, aligned))
+                self.huge_padding += aligned - data_offset
+            e.data_offset = aligned
+            data_offset = aligned + self._align(e.stat.st_size, DAXFS_BLOCK_SIZE)
 
         for e in self.files:
-            if self._is_regular(e.stat.st_mode) or self._is_symlink(e.stat.st_mode):
-                total += self._align(e.stat.st_size, DAXFS_BLOCK_SIZE)
+            if e.extent_ino:
+                e.data_offset = self._by_ino[e.extent_ino].data_offset
 
-        return total
+    def calculate_total_size(self) -> int:
+        """Calculate total image size, including hugepage alignment padding."""
+        _, _, data_offset = self._layout()
+        return data_offset + self.data_size + self.huge_padding
+
+    def superblock_flags(self) -> int:
+        """Return the superblock flags for this layout."""
+        if not self.huge_align:
+            return 0
+        return DAXFS_FLAG_HUGE_ALIGNED | (
+            (self.huge_align.bit_length() - 1) << DAXFS_FLAG_ALIGN_SHIFT
+        )
 
-    def write_image(self, mem: mmap.mmap, mem_size: int) -> None:
-        """Write the daxfs image to memory."""
-        inode_offset = DAXFS_BLOCK_SIZE
-        strtab_offset = inode_offset + len(self.files) * DAXFS_INODE_SIZE
-        data_offset = self._align(strtab_offset + self.strtab_size, DAXFS_BLOCK_SIZE)
-        total_size = self.calculate_total_size()
+    def padding_report(self) -> list[dict]:
+        """Compare the layout cost of 4K, 2M and 1G extent alignment.
 
-        mem.seek(0)
-        mem.write(b'\x00' * mem_size)
+        Must be called after build(). The builder's own layout is restored
+        before returning.
+
+        Returns:
+            One dict per alignment with huge_extents, padding and total_size
+        """
+        saved = self.huge_align
+        report = []
+        try:
+            for huge_align in (0,) + DAXFS_HUGE_PAGE_SIZES[::-1]:
+                self.huge_align = huge_align
+                self.calculate_offsets()
+                report.append({
+                    "huge_align": huge_align,
+                    "huge_extents": self.huge_extents,
+                    "padding": self.huge_padding,
+                    "total_size": self.calculate_total_size(),
+                })
+        finally:
+            self.huge_align = saved
+            self.calculate_offsets()
+        return report
+
+    def build(self, timer: Optional[StageTimer] = None) -> None:
+        """Run scan, build_tree and calculate_offsets, timing each stage."""
+        timer = timer or StageTimer()
+        with timer.stage("scan"):
+            self.scan()
+        with timer.stage("build_tree"):
+            self.build_tree()
+        with timer.stage("offsets"):
+            self.calculate_offsets()
+
+    def write_image(
+        self, mem: mmap.mmap, mem_size: int, dmabuf_fd: Optional[int] = None,
+        zeroed: bool = False, threads: int = 1,
+    ) -> None:
+        """Write the daxfs image to memory.
+
+        Regular file contents are streamed into the mapping in chunks rather
+        than read whole. If dmabuf_fd is given, copy_file_range() into the
+        dma-buf is tried first so the copy stays in the kernel; when the
+        dma-buf does not support it, each chunk is read directly into the
+        mapping.
+
+        Only bytes that are not otherwise written are cleared: the rest of
+        the superblock block, the padding after the string table, the gaps
+        in front of hugepage-aligned extents, the tail of each data extent
+        and the slack after the image. If zeroed is True the memory is known
+        to be zero already and nothing is cleared.
+
+        Metadata is written on the calling thread; data extents are then
+        filled by a pool of up to threads workers. The number of data bytes
+        written is left in bytes_written.
+        """
+        inode_offset, strtab_offset, data_offset = self._layout()
+        total_size = self.calculate_total_size()
+        zero_fill = not zeroed
 
         mem.seek(0)
         super_block = struct.pack(
             '<IIIIQQIIQQQ',
             DAXFS_MAGIC,
             DAXFS_VERSION,
-            0,
+            self.superblock_flags(),
             DAXFS_BLOCK_SIZE,
             total_size,
             inode_offset,
@@ -212,6 +460,13 @@ class DaxfsBuilder:
             data_offset,
         )
         mem.write(super_block)
+        if zero_fill:
+            with memoryview(mem) as view:
+                self._zero_range(view, len(super_block), inode_offset)
+                self._zero_range(view, strtab_offset + self.strtab_size, data_offset)
+                for start, end in self._padding_ranges:
+                    self._zero_range(view, start, end)
+                self._zero_range(view, total_size, mem_size)
 
         for e in self.files:
             mem.seek(inode_offset + (e.ino - 1) * DAXFS_INODE_SIZE)
@@ -226,7 +481,7 @@ class DaxfsBuilder:
                 e.name_strtab_offset,
                 len(e.name),
                 e.parent_ino,
-                e.stat.st_nlink,
+                e.nlink,
                 e.first_child,
                 e.next_sibling,
                 b'\x00' * 8,
@@ -236,24 +491,115 @@ class DaxfsBuilder:
             mem.seek(strtab_offset + e.name_strtab_offset)
             mem.write(e.name.encode('utf-8') + b'\x00')
 
-            if self._is_regular(e.stat.st_mode):
-                fullpath = self.src_dir / e.path
-                try:
-                    with open(fullpath, 'rb') as f:
-                        content = f.read()
-                    mem.seek(e.data_offset)
-                    mem.write(content)
-                except (PermissionError, FileNotFoundError, IsADirectoryError):
-                    pass
+        with memoryview(mem) as view:
+            self._fill_extents(view, dmabuf_fd, zero_fill, threads)
+
+    def _data_extents(self) -> list[FileEntry]:
+        """Return the entries owning a non-empty data extent."""
+        return [
+            e for e in self.files
+            if self._has_data(e.stat.st_mode) and e.stat.st_size and not e.extent_ino
+        ]
+
+    def _fill_extents(self, view: memoryview, dmabuf_fd: Optional[int],
+                      zero_fill: bool, threads: int) -> None:
+        """Copy file data into every extent and set bytes_written."""
+        # Extents are disjoint, so they can be filled in any order and from
+        # several threads. Largest first keeps the workers evenly loaded.
+        extents = self._data_extents()
+        extents.sort(key=lambda e: e.stat.st_size, reverse=True)
+
+        if threads > 1 and len(extents) > 1:
+            with ThreadPoolExecutor(max_workers=threads) as pool:
+                written = pool.map(
+                    lambda e: self._write_extent(e, view, dmabuf_fd, zero_fill), extents
+                )
+                self.bytes_written = sum(written)
+        else:
+            self.bytes_written = sum(
+                self._write_extent(e, view, dmabuf_fd, zero_fill) for e in extents
+            )
+
+    def _write_extent(self, e: FileEntry, view: memoryview, dmabuf_fd: Optional[int],
+                      zero_fill: bool) -> int:
+        """Fill one entry's data extent. Safe to call from worker threads.
 
-            elif self._is_symlink(e.stat.st_mode):
-                fullpath = self.src_dir / e.path
+        Returns:
+            Number of data bytes written
+        """
+        written = 0
+        fullpath = self.src_dir / e.path
+        if self._is_regular(e.stat.st_mode):
+            try:
+                src_fd = os.open(fullpath, os.O_RDONLY | os.O_CLOEXEC)
+            except (PermissionError, FileNotFoundError, IsADirectoryError):
+                src_fd = -1
+            if src_fd >= 0:
                 try:
-                    target = os.readlink(fullpath)
-                    mem.seek(e.data_offset)
-                    mem.write(target.encode('utf-8'))
-                except (PermissionError, FileNotFoundError):
-                    pass
+                    written = self._copy_file_data(src_fd, view, dmabuf_fd,
+                                                   e.data_offset, e.stat.st_size)
+                finally:
+                    os.close(src_fd)
+
+        else:
+            try:
+                target = os.readlink(fullpath).encode('utf-8')[:e.stat.st_size]
+                view[e.data_offset:e.data_offset + len(target)] = target
+                written = len(target)
+            except (PermissionError, FileNotFoundError):
+                pass
+
+        if zero_fill:
+            extent_end = e.data_offset + self._align(e.stat.st_size, DAXFS_BLOCK_SIZE)
+            self._zero_range(view, e.data_offset + written, extent_end)
+
+        return written
+
+    def _copy_file_data(self, src_fd: int, view: memoryview, dmabuf_fd: Optional[int],
+                        offset: int, size: int) -> int:
+        """Copy up to size bytes of src_fd into the image at offset.
+
+        The copy is clamped to the size recorded at scan time, so a file that
+        grew since then cannot spill into the next extent.
+
+        Returns:
+            Number of bytes copied (less than size if the file shrank)
+        """
+        copied = 0
+
+        if dmabuf_fd is not None and self.kernel_copy:
+            try:
+                while copied < size:
+                    n = os.copy_file_range(src_fd, dmabuf_fd,
+                                           min(DAXFS_COPY_CHUNK, size - copied),
+                                           copied, offset + copied)
+                    if n == 0:
+                        return copied
+                    copied += n
+                return copied
+            except OSError as e:
+                if e.errno not in _KERNEL_COPY_UNSUPPORTED:
+                    raise
+                # Not supported by this dma-buf; don't retry for later files
+                self.kernel_copy = False
+
+        while copied < size:
+            end = offset + min(size, copied + DAXFS_COPY_CHUNK)
+            with view[offset + copied:end] as chunk:
+                n = os.preadv(src_fd, [chunk], copied)
+            if n == 0:
+                break
+            copied += n
+
+        return copied
+
+    @staticmethod
+    def _zero_range(view: memoryview, start: int, end: int) -> None:
+        """Clear view[start:end] a chunk at a time."""
+        while start < end:
+            n = min(end - start, DAXFS_COPY_CHUNK)
+            view[start:start + n] = bytes(n)
+            start += n
 
     @staticmethod
     def _align(value: int, alignment: int) -> int:
@@ -263,15 +609,18 @@ class DaxfsBuilder:
     @staticmethod
     def _is_regular(mode: int) -> bool:
         """Check if mode is regular file."""
-        import stat
         return stat.S_ISREG(mode)
 
     @staticmethod
     def _is_symlink(mode: int) -> bool:
         """Check if mode is symlink."""
-        import stat
         return stat.S_ISLNK(mode)
 
+    @classmethod
+    def _has_data(cls, mode: int) -> bool:
+        """Check if entries of this mode own a data extent."""
+        return cls._is_regular(mode) or cls._is_symlink(mode)
+
 
 def _get_libc():
     """Get libc with errno support."""
@@ -289,25 +638,35 @@ def _syscall(libc, nr, *args):
     return ret
 
 
-def _get_daxfs_iomem() -> tuple[int, int]:
+def _get_daxfs_iomem() -> set:
     """
-    Parse /proc/iomem to find daxfs allocation.
-    Returns (phys_addr, size) tuple.
+    Parse /proc/iomem for the regions of every mounted daxfs.
+    Returns a set of (phys_addr, size) tuples, empty if it is unreadable.
     """
+    ranges = set()
     try:
         with open('/proc/iomem', 'r', encoding='utf-8') as f:
             for line in f:
                 parts = line.strip().split(' : ')
                 if len(parts) == 2 and parts[1] == 'daxfs':
-                    addr_range = parts[0].strip()
-                    start_str, end_str = addr_range.split('-')
-                    start = int(start_str, 16)
-                    end = int(end_str, 16)
-                    return start, end - start + 1
-    except (FileNotFoundError, PermissionError, ValueError):
+                    start_str, end_str = parts[0].strip().split('-')
+                    start, end = int(start_str, 16), int(end_str, 16)
+                    ranges.add((start, end - start + 1))
+    except (OSError, ValueError):
         pass
+    return ranges
 
-    raise DaxfsError("Could not find 'daxfs' entry in /proc/iomem")
+
+def daxfs_region_pinned(phys_addr: int, size: int) -> bool:
+    """
+    Whether a mounted daxfs still pins [phys_addr, phys_addr + size).
+
+    Read from the 'daxfs' entries of /proc/iomem; False if it is unreadable.
+    """
+    return any(
+        start <= phys_addr and phys_addr + size <= start + length
+        for start, length in _get_daxfs_iomem()
+    )
 
 
 def _allocate_dma_heap(heap_path: str, size: int) -> tuple[int, mmap.mmap]:
@@ -345,6 +704,19 @@ MOVE_MOUNT_F_EMPTY_PATH = 0x00000004
 
 AT_FDCWD = -100
 
+_MOUNT_LOCK = threading.Lock()
+
+
+def _kerf_init_binary() -> Path:
+    """Return the pre-built kerf-init binary, which must exist."""
+    init_binary = get_init_binary_path()
+    if not init_binary.exists():
+        raise DaxfsError(
+            f"Init binary not found at {init_binary}. "
+            "Run 'make' to build it first."
+        )
+    return init_binary
+
 
 def inject_kerf_init(rootfs_path: str) -> None:
     """Inject /init binary into rootfs.
@@ -354,17 +726,21 @@ def inject_kerf_init(rootfs_path: str) -> None:
     rootfs = Path(rootfs_path)
 
     # Copy the pre-built init binary
-    init_binary = get_init_binary_path()
-    if not init_binary.exists():
-        raise DaxfsError(
-            f"Init binary not found at {init_binary}. "
-            "Run 'make' to build it first."
-        )
+    init_binary = _kerf_init_binary()
 
     init_path = rootfs / "init"
+    # The rootfs may be a hard-linked clone of the image cache; replace the
+    # link rather than writing through it
+    init_path.unlink(missing_ok=True)
     shutil.copy2(init_binary, init_path)
     os.chmod(init_path, 0o755)
 
+    # Room for kerf-init's status record, overwritten once the spawn boots
+    status_path = rootfs / KERF_STATUS_FILE
+    status_path.parent.mkdir(exist_ok=True)
+    status_path.unlink(missing_ok=True)
+    status_path.write_bytes(b'\x00' * KERF_STATUS_SIZE)
+
 
 def _mount_daxfs(instance_name: str, dmabuf_fd: int) -> None:
     """
@@ -417,20 +793,135 @@ def _mount_daxfs(instance_name: str, dmabuf_fd: int) -> None:
             os.close(fs_fd)
 
 
+def _native_mkdaxfs() -> Optional[str]:
+    """Return the native mkdaxfs writer if it was built, else None."""
+    path = get_mkdaxfs_binary_path()
+    if path.is_file() and os.access(path, os.X_OK):
+        return str(path)
+    return None
+
+
+class _NativeMkdaxfsRun:
+    """
+    One `mkdaxfs --dmabuf-stdin` run: a single tree walk for size and write.
+
+    Starting it scans the tree and reads back the required size; write()
+    then hands over the dma-buf allocated for that size on the child's
+    stdin, a unix socket, and waits for the copy. close() ends a run that
+    never got its dma-buf.
+    """
+
+    def __init__(self, binary: str, args: list):
+        self._sock, child_sock = socket.socketpair(socket.AF_UNIX, socket.SOCK_STREAM)
+        try:
+            self._proc = subprocess.Popen(
+                [binary, "--dmabuf-stdin"] + args,
+                stdin=child_sock,
+                stdout=subprocess.PIPE,
+                stderr=subprocess.PIPE,
+                text=True,
+            )
+        except OSError as e:
+            self._sock.close()
+            raise DaxfsError(f"Failed to run {binary}: {e}") from e
+        finally:
+            child_sock.close()
+
+        line = self._proc.stdout.readline()
+        if not line.strip():
+            self._finish()
+            raise DaxfsError("mkdaxfs exited without reporting the image size")
+        self.required_size = int(line)
+
+    def write(self, dmabuf_fd: int, size: int) -> int:
+        """Write the image into dmabuf_fd and return the file data bytes copied."""
+        try:
+            socket.send_fds(self._sock, [str(size).encode()], [dmabuf_fd])
+        except OSError as e:
+            self.close()
+            raise DaxfsError(f"Failed to pass the dma-buf to mkdaxfs: {e}") from e
+        return int(self._finish())
+
+    def close(self) -> None:
+        if self._proc.returncode is None:
+            self._finish()
+
+    def _finish(self) -> str:
+        self._sock.close()
+        out, err = self._proc.communicate()
+        if self._proc.returncode != 0:
+            raise DaxfsError(f"mkdaxfs failed: {err.strip()}")
+        return out.strip()
+
+
+def find_image_file(mem, path: str) -> Optional[Tuple[int, int]]:
+    """
+    Look up a regular file in a written daxfs image.
+
+    Returns:
+        (data_offset, size) of the file, or None if the image has no such file
+    """
+    (magic, _, _, _, _, inode_offset, inode_count, root_ino,
+     strtab_offset, _, _) = struct.unpack_from('<IIIIQQIIQQQ', mem, 0)
+    if magic != DAXFS_MAGIC:
+        raise DaxfsError("Not a daxfs image")
+
+    def inode(ino):
+        if not 1 <= ino <= inode_count:
+            raise DaxfsError(f"Corrupt daxfs image: inode {ino} out of range")
+        return struct.unpack_from('<IIIIQQIIIIII8s', mem,
+                                  inode_offset + (ino - 1) * DAXFS_INODE_SIZE)
+
+    node = inode(root_ino)
+    for part in path.strip("/").split("/"):
+        ino = node[10]  # first_child
+        while ino:
+            node = inode(ino)
+            name_off = strtab_offset + node[6]
+            if mem[name_off:name_off + node[7]] == part.encode('utf-8'):
+                break
+            ino = node[11]  # next_sibling
+        else:
+            return None
+
+    if not stat.S_ISREG(node[1]):
+        return None
+    return node[5], node[4]
+
+
 def create_daxfs_image(
     rootfs_path: str,
     instance_name: str,
     heap_path: str = "/dev/dma_heap/multikernel",
     size: Optional[int] = None,
+    timer: Optional[StageTimer] = None,
+    dedup: bool = False,
+    threads: int = DAXFS_DEFAULT_THREADS,
+    huge_align: int = 0,
 ) -> DaxfsImage:
     """
     Create a daxfs filesystem image from a directory.
 
+    With dedup, identical files within the image share one extent, and if an
+    instance already has a mounted image with the same content digest, that
+    read-only region is reused without allocating or writing anything.
+
+    Without dedup, the scan and write are delegated to the native mkdaxfs
+    binary whenever it is in the package data (`make` builds it and copies
+    it there), with the same threads filling extents; it produces the same layout as
+    DaxfsBuilder without per-file interpreter overhead. It walks the tree
+    once: its size report sizes the dma-buf it then writes. With dedup, or
+    without the binary, DaxfsBuilder does the work.
+
     Args:
         rootfs_path: Path to the root filesystem directory
         instance_name: Name of the multikernel instance
         heap_path: Path to the DMA heap device
         size: Size to allocate (if None, calculated automatically with 10% padding)
+        timer: Optional StageTimer that receives per-stage timings
+        dedup: Hash file contents to share extents and whole images
+        threads: Number of threads filling data extents
+        huge_align: Align large file extents to up to this hugepage size (2M or 1G)
 
     Returns:
         DaxfsImage with physical address and size
@@ -441,13 +932,114 @@ def create_daxfs_image(
     if not os.path.isdir(rootfs_path):
         raise DaxfsError(f"Rootfs directory '{rootfs_path}' does not exist")
 
-    builder = DaxfsBuilder(rootfs_path)
-    builder.scan()
-    builder.build_tree()
-    builder.calculate_offsets()
+    timer = timer or StageTimer()
+
+    # Content hashing for dedup is only implemented in the Python builder
+    native = None if dedup else _native_mkdaxfs()
+    if native:
+        args = ["--threads", str(threads)]
+        if huge_align:
+            args += ["--huge-align", str(huge_align)]
+        if os.path.basename(heap_path) in ZEROED_DMA_HEAPS:
+            args.append("--zeroed")
+        with timer.stage("scan"):
+            native_run = _NativeMkdaxfsRun(native, args + [rootfs_path])
+        try:
+            image = _allocate_and_mount(
+                instance_name, heap_path, native_run.required_size, size, timer,
+                lambda mem, dmabuf_fd, alloc_size: native_run.write(dmabuf_fd, alloc_size),
+            )
+        finally:
+            native_run.close()
+        image.huge_align = huge_align
+        return image
 
+    builder = DaxfsBuilder(rootfs_path, dedup=dedup, huge_align=huge_align)
+    builder.build(timer)
     required_size = builder.calculate_total_size()
 
+    store = None
+    digest = None
+    if dedup:
+        from .store import DaxfsImageStore
+
+        store = DaxfsImageStore()
+        digest = builder.image_digest().hex()
+        with timer.stage("lookup"):
+            existing = store.acquire(digest, instance_name)
+        if existing:
+            return DaxfsImage(
+                phys_addr=existing["phys_addr"],
+                size=existing["size"],
+                shared=True,
+                huge_align=huge_align,
+            )
+
+    zeroed = os.path.basename(heap_path) in ZEROED_DMA_HEAPS
+
+    def write(mem: mmap.mmap, dmabuf_fd: int, alloc_size: int) -> int:
+        builder.write_image(mem, alloc_size, dmabuf_fd, zeroed=zeroed, threads=threads)
+        return builder.bytes_written
+
+    image = _allocate_and_mount(instance_name, heap_path, required_size, size, timer, write)
+    image.huge_align = huge_align
+
+    if store:
+        store.register(digest, instance_name, image.phys_addr, image.size)
+
+    return image
+
+
+def _save_image(mem, image_size: int, path: Path) -> None:
+    """Copy a freshly written image to path; a failure only loses the cache entry."""
+    tmp = path.with_name(f"{path.name}.{os.getpid()}.{threading.get_ident()}")
+    try:
+        path.parent.mkdir(parents=True, exist_ok=True)
+        with open(tmp, "wb") as f, memoryview(mem) as view:
+            f.write(view[:image_size])
+        os.replace(tmp, path)
+    except OSError:
+        tmp.unlink(missing_ok=True)
+
+
+def _mount_and_locate(instance_name: str, dmabuf_fd: int, timer: StageTimer) -> tuple[int, int]:
+    """
+    Mount the dma-buf as daxfs and return the (phys_addr, size) it was given.
+
+    kerf never unmounts daxfs, so /proc/iomem lists every image mounted so
+    far; this one's is the single range that appears across the mount.
+    Closes dmabuf_fd.
+    """
+    # Images built concurrently (kerf load --manifest) mount one at a time,
+    # so each sees only its own range appear
+    with _MOUNT_LOCK:
+        before = _get_daxfs_iomem()
+        try:
+            with timer.stage("mount"):
+                _mount_daxfs(instance_name, dmabuf_fd)
+        finally:
+            # daxfs now holds a reference to the dma-buf, safe to close
+            os.close(dmabuf_fd)
+
+        # The physical address goes into the spawn kernel rootflags
+        new = _get_daxfs_iomem() - before
+    if len(new) != 1:
+        raise DaxfsError(
+            f"Expected one new 'daxfs' entry in /proc/iomem after mounting, found {len(new)}"
+        )
+    return new.pop()
+
+
+def _allocate_and_mount(instance_name: str, heap_path: str, required_size: int,
+                        size: Optional[int], timer: StageTimer, write,
+                        save_to: Optional[Path] = None) -> DaxfsImage:
+    """
+    Allocate a dma-buf, fill it with write() and mount it as daxfs.
+
+    write(mem, dmabuf_fd, size) must return the number of file data bytes it
+    copied. The written image is then searched for KERF_STATUS_FILE, and
+    copied to save_to if given, before anything can write to it.
+    """
     if size is None:
         size = int(required_size * 1.1)
         size = (size + DAXFS_BLOCK_SIZE - 1) & ~(DAXFS_BLOCK_SIZE - 1)
@@ -458,30 +1050,32 @@ def create_daxfs_image(
         )
 
     try:
-        dmabuf_fd, mem = _allocate_dma_heap(heap_path, size)
+        with timer.stage("allocate"):
+            dmabuf_fd, mem = _allocate_dma_heap(heap_path, size)
     except OSError as e:
         raise DaxfsError(f"Failed to allocate from DMA heap: {e}") from e
 
     try:
-        builder.write_image(mem, size)
-        mem.close()
+        write_start = time.perf_counter()
+        with timer.stage("write"):
+            bytes_written = write(mem, dmabuf_fd, size)
+        write_seconds = time.perf_counter() - write_start
+        status = find_image_file(mem, KERF_STATUS_FILE)
+        if save_to is not None:
+            with timer.stage("cache"):
+                _save_image(mem, required_size, save_to)
     except Exception as e:
         os.close(dmabuf_fd)
         raise DaxfsError(f"Failed to write daxfs image: {e}") from e
+    finally:
+        mem.close()
 
-    try:
-        _mount_daxfs(instance_name, dmabuf_fd)
-    except DaxfsError:
-        os.close(dmabuf_fd)
-        raise
-
-    # daxfs now holds a reference to the dma-buf, safe to close
-    os.close(dmabuf_fd)
-
-    # Get the physical address from /proc/iomem for the spawn kernel rootflags
-    phys_addr, actual_size = _get_daxfs_iomem()
+    phys_addr, actual_size = _mount_and_locate(instance_name, dmabuf_fd, timer)
 
     return DaxfsImage(
         phys_addr=phys_addr,
         size=actual_size,
+        bytes_written=bytes_written,
+        write_seconds=write_seconds,
+        status_offset=status[0] if status and status[1] >= KERF_STATUS_SIZE else 0,
     )
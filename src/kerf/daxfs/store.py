@@ -0,0 +1,106 @@
+# Copyright 2026 Multikernel Technologies, Inc.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""
+Host-side index of daxfs images shared between instances.
+
+Maps an image content digest (DaxfsBuilder.image_digest()) to the dma-buf
+region holding it. The dma-buf stays pinned by the daxfs mount of the
+instance that built it, so further instances loading the same content can
+boot from that read-only region instead of allocating their own.
+"""
+
+import fcntl
+import json
+import os
+from contextlib import contextmanager
+from pathlib import Path
+from typing import Dict, Optional
+
+KERF_DAXFS_STORE = "/var/lib/kerf/daxfs-store.json"
+
+
+class DaxfsImageStore:
+    """Digest-keyed index of mounted daxfs images."""
+
+    def __init__(self, index_path: str = KERF_DAXFS_STORE, mnt_dir: Optional[str] = None):
+        from .mkdaxfs import KERF_DAXFS_MNT_DIR
+
+        self.index_path = Path(index_path)
+        self.mnt_dir = Path(mnt_dir or KERF_DAXFS_MNT_DIR)
+
+    @contextmanager
+    def _locked(self):
+        """Yield the index as a dict under an exclusive lock, saving it on exit."""
+        self.index_path.parent.mkdir(parents=True, exist_ok=True)
+        fd = os.open(self.index_path, os.O_RDWR | os.O_CREAT | os.O_CLOEXEC, 0o644)
+        with os.fdopen(fd, 'r+', encoding='utf-8') as f:
+            fcntl.flock(f, fcntl.LOCK_EX)
+            try:
+                index: Dict[str, Dict] = json.load(f)
+            except json.JSONDecodeError:
+                index = {}
+
+            yield index
+
+            f.seek(0)
+            f.truncate()
+            json.dump(index, f, indent=2, sort_keys=True)
+
+    def _is_live(self, entry: Dict) -> bool:
+        """Check the owner's daxfs mount, which pins the dma-buf, still exists."""
+        return os.path.ismount(self.mnt_dir / entry["owner"])
+
+    def acquire(self, digest: str, instance_name: str) -> Optional[Dict]:
+        """
+        Look up a live image and record instance_name as one of its users.
+
+        Returns:
+            Dict with phys_addr and size, or None if no live image matches
+        """
+        with self._locked() as index:
+            entry = index.get(digest)
+            if entry is None:
+                return None
+            if not self._is_live(entry):
+                del index[digest]
+                return None
+            if instance_name not in entry["users"]:
+                entry["users"].append(instance_name)
+            return {"phys_addr": entry["phys_addr"], "size": entry["size"]}
+
+    def register(self, digest: str, instance_name: str, phys_addr: int, size: int) -> None:
+        """Record a newly mounted image owned by instance_name."""
+        with self._locked() as index:
+            index[digest] = {
+                "owner": instance_name,
+                "phys_addr": phys_addr,
+                "size": size,
+                "users": [instance_name],
+            }
+
+    def release(self, instance_name: str) -> None:
+        """
+        Drop instance_name from every image it uses.
+
+        The index entry is kept while the owner's mount exists, since the
+        mount still pins the memory and later loads can reuse it.
+        """
+        with self._locked() as index:
+            for digest in list(index):
+                entry = index[digest]
+                if instance_name in entry["users"]:
+                    entry["users"].remove(instance_name)
+                if not self._is_live(entry):
+                    del index[digest]
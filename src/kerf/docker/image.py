@@ -14,17 +14,52 @@
 
 """
 OCI image extraction and configuration parsing using skopeo.
+
+Pulled images are kept in a host-wide cache under KERF_IMAGE_CACHE_DIR:
+
+    tags.json            image reference -> manifest digest, as last resolved
+    oci/                 OCI image layout; layers are stored once per digest,
+                         so skopeo only fetches blobs the host does not have
+    rootfs/<digest>/     flattened rootfs of each image manifest digest
+    rootfs/<digest>.json image config needed at load time (entrypoint, cmd)
+    daxfs/               daxfs images built from layers (kerf.daxfs.layers)
+
+A reference whose digest is cached resolves through tags.json without the
+registry for TAG_TTL seconds, or for as long as the registry cannot be
+reached; pull=True (`kerf load --pull`) asks the registry regardless.
+References pinned by digest never need it. An instance rootfs is a
+hard-linked clone of the cached flattened rootfs, so loading an already
+seen image touches neither the network nor the layers.
+pull_image_layers() stops after the pull and hands back the layer blobs, for
+callers that consume the layers directly instead of a rootfs.
 """
 
+import errno
+import fcntl
 import json
+import os
 import shutil
 import subprocess
 import tarfile
-import tempfile
+import time
+from concurrent.futures import ThreadPoolExecutor
+from contextlib import contextmanager
 from pathlib import Path
-from typing import List, Tuple
+from typing import Dict, List, Tuple
 
 KERF_ROOTFS_DIR = "/var/lib/kerf/rootfs"
+KERF_IMAGE_CACHE_DIR = "/var/lib/kerf/images"
+
+OCI_REF_NAME_ANNOTATION = "org.opencontainers.image.ref.name"
+
+# How long a cached tag -> digest resolution is trusted without the registry
+TAG_TTL = 24 * 3600
+
+WHITEOUT_PREFIX = ".wh."
+OPAQUE_WHITEOUT = ".wh..wh..opq"
+
+# Default number of layers decompressed concurrently
+EXTRACT_THREADS = min(8, os.cpu_count() or 1)
 
 
 class DockerError(Exception):
@@ -42,18 +77,352 @@ def _normalize_image_ref(image_ref: str) -> str:
     return f"docker://{image_ref}"
 
 
+def _pin_digest(normalized_ref: str, digest: str) -> str:
+    """Replace the tag of a docker:// reference with a manifest digest.
+
+    Pulling by digest guarantees the cache entry matches what was inspected,
+    even if the tag moves in between. Other transports are returned as is.
+    """
+    if not normalized_ref.startswith("docker://"):
+        return normalized_ref
+    name = normalized_ref.split("@", 1)[0]
+    slash = name.rfind("/")
+    colon = name.rfind(":")
+    if colon > slash:
+        name = name[:colon]
+    return f"{name}@{digest}"
+
+
 def _check_tool_available(tool: str) -> bool:
     """Check if a command-line tool is available."""
     return shutil.which(tool) is not None
 
 
-def extract_image(image_ref: str, instance_name: str) -> Tuple[str, List[str]]:
+def _run_skopeo(args: List[str]) -> str:
+    """Run skopeo and return its stdout."""
+    try:
+        result = subprocess.run(
+            ["skopeo"] + args,
+            check=True,
+            capture_output=True,
+            text=True
+        )
+    except subprocess.CalledProcessError as e:
+        raise DockerError(f"skopeo {args[0]} failed: {e.stderr}") from e
+    return result.stdout
+
+
+@contextmanager
+def _cache_lock(cache_dir: Path):
+    """Serialize cache population between concurrent kerf invocations."""
+    cache_dir.mkdir(parents=True, exist_ok=True)
+    fd = os.open(cache_dir / ".lock", os.O_RDWR | os.O_CREAT | os.O_CLOEXEC, 0o644)
+    try:
+        fcntl.flock(fd, fcntl.LOCK_EX)
+        yield
+    finally:
+        os.close(fd)
+
+
+def _oci_blob_path(layout: Path, digest: str) -> Path:
+    """Return the path of a blob in an OCI image layout."""
+    algorithm, encoded = digest.split(":", 1)
+    return layout / "blobs" / algorithm / encoded
+
+
+def _read_oci_image(layout: Path, ref_name: str) -> Tuple[Dict, List[Path]]:
+    """
+    Find an image in an OCI layout by reference name.
+
+    Returns:
+        Tuple of (image config, layer blob paths in apply order)
+    """
+    try:
+        with open(layout / "index.json", encoding="utf-8") as f:
+            index = json.load(f)
+
+        descriptor = next(
+            (m for m in index.get("manifests", [])
+             if m.get("annotations", {}).get(OCI_REF_NAME_ANNOTATION) == ref_name),
+            None,
+        )
+        if descriptor is None:
+            raise DockerError(f"Image {ref_name} not found in {layout}")
+
+        with open(_oci_blob_path(layout, descriptor["digest"]), encoding="utf-8") as f:
+            manifest = json.load(f)
+        with open(_oci_blob_path(layout, manifest["config"]["digest"]), encoding="utf-8") as f:
+            config = json.load(f)
+    except (OSError, KeyError, ValueError) as e:
+        raise DockerError(f"Failed to read OCI layout {layout}: {e}") from e
+
+    layers = [_oci_blob_path(layout, layer["digest"]) for layer in manifest.get("layers", [])]
+    return config, layers
+
+
+def _copy_metadata(src: Path, dst: Path) -> None:
+    """Give an entry created by _clone_tree() the owner, mode and times of src."""
+    st = os.lstat(src)
+    try:
+        # Before the mode: chown clears setuid/setgid bits
+        os.lchown(dst, st.st_uid, st.st_gid)
+    except PermissionError:
+        # Unprivileged, as when extracting: everything is ours anyway
+        pass
+    shutil.copystat(src, dst, follow_symlinks=False)
+
+
+def _clone_tree(src: Path, dst: Path) -> None:
+    """
+    Clone a directory tree with hard links, copying across filesystems.
+
+    Hard links keep their owner. The directories, symlinks and copies made
+    here are given the source's owner, as extracting the layers did.
+    """
+    os.mkdir(dst)
+    with os.scandir(src) as entries:
+        for entry in entries:
+            src_path, dst_path = Path(entry.path), dst / entry.name
+            if entry.is_dir(follow_symlinks=False):
+                _clone_tree(src_path, dst_path)
+                continue
+            if entry.is_symlink():
+                os.symlink(os.readlink(src_path), dst_path)
+            else:
+                try:
+                    os.link(src_path, dst_path)
+                    continue
+                except OSError as e:
+                    if e.errno not in (errno.EXDEV, errno.EPERM, errno.EMLINK):
+                        raise
+                shutil.copyfile(src_path, dst_path, follow_symlinks=False)
+            _copy_metadata(src_path, dst_path)
+    _copy_metadata(src, dst)
+
+
+def _read_tag_index(cache_dir: Path) -> Dict[str, Dict]:
+    """The tag index, or an empty one if it is missing or unreadable."""
+    try:
+        with open(cache_dir / "tags.json", encoding="utf-8") as f:
+            index = json.load(f)
+    except (OSError, ValueError):
+        return {}
+    return index if isinstance(index, dict) else {}
+
+
+def _record_tag(cache_dir: Path, normalized_ref: str, digest: str) -> None:
+    """Remember what a reference resolved to; losing a racing update is harmless."""
+    index = _read_tag_index(cache_dir)
+    index[normalized_ref] = {"digest": digest, "resolved": time.time()}
+    tmp = cache_dir / f"tags.json.{os.getpid()}"
+    try:
+        cache_dir.mkdir(parents=True, exist_ok=True)
+        with open(tmp, "w", encoding="utf-8") as f:
+            json.dump(index, f)
+        os.replace(tmp, cache_dir / "tags.json")
+    except OSError:
+        # Only costs a registry lookup next time
+        tmp.unlink(missing_ok=True)
+
+
+def _is_cached(cache_dir: Path, key: str) -> bool:
+    """Whether an image digest can be loaded without the registry."""
+    if (cache_dir / "rootfs" / f"{key}.json").exists():
+        return True
+    try:
+        _read_oci_image(cache_dir / "oci", key)
+    except DockerError:
+        return False
+    return True
+
+
+def _resolve_image(image_ref: str, pull: bool = False) -> Tuple[str, str]:
+    """
+    Resolve an image reference to its manifest digest.
+
+    Digest-pinned references resolve to themselves. A tag resolves through
+    the local tag index while its digest is cached, unless pull is set or
+    the entry is older than TAG_TTL; then skopeo asks the registry, falling
+    back to the stale entry if the registry cannot be reached.
+
+    Returns:
+        Tuple of (pinned skopeo reference, cache key)
+    """
+    normalized_ref = _normalize_image_ref(image_ref)
+    if normalized_ref.startswith("docker://") and "@" in normalized_ref:
+        digest = normalized_ref.rsplit("@", 1)[1]
+        if ":" in digest:
+            return normalized_ref, digest.split(":", 1)[1]
+
+    # The digest last seen for this reference, if it can be loaded offline
+    cache_dir = Path(KERF_IMAGE_CACHE_DIR)
+    known = None
+    fresh = False
+    entry = _read_tag_index(cache_dir).get(normalized_ref) or {}
+    digest = entry.get("digest", "")
+    if not pull and ":" in digest and _is_cached(cache_dir, digest.split(":", 1)[1]):
+        known = (_pin_digest(normalized_ref, digest), digest.split(":", 1)[1])
+        fresh = time.time() - entry.get("resolved", 0) < TAG_TTL
+    if known and fresh:
+        return known
+
+    if not _check_tool_available("skopeo"):
+        if known:
+            return known
+        raise DockerError(
+            "skopeo not installed. Install with: yum install skopeo"
+        )
+
+    try:
+        digest = _run_skopeo(["inspect", "--format", "{{.Digest}}", normalized_ref]).strip()
+    except DockerError:
+        # Registry unreachable: keep using what the tag last pointed at
+        if known:
+            return known
+        raise
+    if ":" not in digest:
+        raise DockerError(f"Unexpected digest '{digest}' for {image_ref}")
+    _record_tag(cache_dir, normalized_ref, digest)
+    return _pin_digest(normalized_ref, digest), digest.split(":", 1)[1]
+
+
+def _pull_to_layout(pinned_ref: str, cache_dir: Path, key: str) -> Tuple[Dict, List[Path]]:
+    """Copy an image into the cached OCI layout unless it is already there."""
+    layout = cache_dir / "oci"
+    try:
+        return _read_oci_image(layout, key)
+    except DockerError:
+        pass
+    _run_skopeo(["copy", pinned_ref, f"oci:{layout}:{key}"])
+    return _read_oci_image(layout, key)
+
+
+def _image_command(config: Dict) -> Dict:
+    """Extract the load-time metadata from an image config."""
+    oci_config = config.get("config", {})
+    return {
+        "entrypoint": oci_config.get("Entrypoint") or [],
+        "cmd": oci_config.get("Cmd") or [],
+    }
+
+
+def _extract_layer(layer_path: Path, dest: Path) -> None:
+    """Unpack one layer into its own staging directory."""
+    dest.mkdir()
+    try:
+        with tarfile.open(layer_path, mode='r:*') as layer_tar:
+            layer_tar.extractall(path=dest)
+    except (OSError, tarfile.TarError) as e:
+        raise DockerError(f"Failed to extract layer {layer_path.name}: {e}") from e
+
+
+def _remove_path(path: Path) -> None:
+    """Remove a file, symlink or directory tree if it exists."""
+    if path.is_dir() and not path.is_symlink():
+        shutil.rmtree(path)
+    elif os.path.lexists(path):
+        path.unlink()
+
+
+def _strip_whiteouts(layer_dir: Path) -> None:
+    """Delete the whiteouts under a directory that hides nothing below it."""
+    for root, dirs, files in os.walk(layer_dir):
+        for name in [n for n in dirs + files if n.startswith(WHITEOUT_PREFIX)]:
+            _remove_path(Path(root) / name)
+            if name in dirs:
+                dirs.remove(name)
+
+
+def _apply_layer_dir(layer_dir: Path, dest: Path) -> None:
+    """
+    Stack an unpacked layer over dest, moving its entries into place.
+
+    OCI whiteouts in the layer hide entries of the layers below: .wh.<name>
+    removes <name>, and .wh..wh..opq empties its directory. Directories
+    present on both sides are merged, anything else is replaced; a directory
+    new to dest is moved in whole, less the whiteouts it holds.
+    """
+    with os.scandir(layer_dir) as it:
+        entries = sorted(it, key=lambda e: e.name)
+
+    for entry in entries:
+        if entry.name == OPAQUE_WHITEOUT:
+            for child in list(dest.iterdir()):
+                _remove_path(child)
+        elif entry.name.startswith(WHITEOUT_PREFIX):
+            _remove_path(dest / entry.name[len(WHITEOUT_PREFIX):])
+
+    for entry in entries:
+        if entry.name.startswith(WHITEOUT_PREFIX):
+            continue
+        target = dest / entry.name
+        if entry.is_dir(follow_symlinks=False) and target.is_dir() and not target.is_symlink():
+            shutil.copystat(entry.path, target, follow_symlinks=False)
+            if os.geteuid() == 0:
+                st = entry.stat(follow_symlinks=False)
+                os.lchown(target, st.st_uid, st.st_gid)
+            _apply_layer_dir(Path(entry.path), target)
+        else:
+            if entry.is_dir(follow_symlinks=False):
+                _strip_whiteouts(Path(entry.path))
+            _remove_path(target)
+            os.rename(entry.path, target)
+
+
+def _populate_rootfs_cache(pinned_ref: str, cache_dir: Path, key: str,
+                           threads: int = EXTRACT_THREADS) -> Dict:
+    """
+    Pull an image into the layer cache and flatten it into rootfs/<key>.
+
+    Returns:
+        Cached image metadata (entrypoint, cmd)
+    """
+    config, layers = _pull_to_layout(pinned_ref, cache_dir, key)
+
+    rootfs_cache = cache_dir / "rootfs"
+    staging = rootfs_cache / f"{key}.tmp"
+    if staging.exists():
+        shutil.rmtree(staging)
+    staging.mkdir(parents=True)
+
+    # Layers are independent until they are stacked, so decompress them
+    # side by side and only apply them in order at the end
+    layer_dirs = [staging / f"layer{i}" for i in range(len(layers))]
+    with ThreadPoolExecutor(max_workers=max(1, threads)) as pool:
+        list(pool.map(_extract_layer, layers, layer_dirs))
+
+    merged = staging / "rootfs"
+    merged.mkdir()
+    for layer_dir in layer_dirs:
+        _apply_layer_dir(layer_dir, merged)
+
+    final = rootfs_cache / key
+    if final.exists():
+        shutil.rmtree(final)
+    merged.rename(final)
+    shutil.rmtree(staging)
+
+    meta = _image_command(config)
+    # Written last: its presence marks the cache entry complete
+    with open(rootfs_cache / f"{key}.json", "w", encoding="utf-8") as f:
+        json.dump(meta, f)
+    return meta
+
+
+def extract_image(image_ref: str, instance_name: str, threads: int = EXTRACT_THREADS,
+                  pull: bool = False) -> Tuple[str, List[str]]:
     """
     Extract OCI image filesystem to a directory using skopeo.
 
+    The image manifest digest is resolved first. If that digest has been
+    flattened before, the cached rootfs is cloned without pulling anything;
+    otherwise only the layers missing from the host cache are fetched.
+
     Args:
         image_ref: Docker image reference (e.g., "nginx:latest")
         instance_name: Instance name for directory naming
+        threads: Number of layers decompressed concurrently on a cache miss
+        pull: Ask the registry what a tag points at even if resolved recently
 
     Returns:
         Tuple of (rootfs_path, entrypoint_cmd)
@@ -61,67 +430,53 @@ def extract_image(image_ref: str, instance_name: str) -> Tuple[str, List[str]]:
     Raises:
         DockerError: If extraction fails
     """
-    if not _check_tool_available("skopeo"):
-        raise DockerError(
-            "skopeo not installed. Install with: yum install skopeo"
-        )
+    pinned_ref, key = _resolve_image(image_ref, pull)
 
-    rootfs_path = Path(KERF_ROOTFS_DIR) / instance_name
-    if rootfs_path.exists():
-        shutil.rmtree(rootfs_path)
-    rootfs_path.mkdir(parents=True, exist_ok=True)
+    cache_dir = Path(KERF_IMAGE_CACHE_DIR)
+    meta_path = cache_dir / "rootfs" / f"{key}.json"
+    with _cache_lock(cache_dir):
+        if meta_path.exists():
+            with open(meta_path, encoding="utf-8") as f:
+                meta = json.load(f)
+        else:
+            meta = _populate_rootfs_cache(pinned_ref, cache_dir, key, threads)
+
+        rootfs_path = Path(KERF_ROOTFS_DIR) / instance_name
+        if rootfs_path.exists():
+            shutil.rmtree(rootfs_path)
+        rootfs_path.parent.mkdir(parents=True, exist_ok=True)
+        _clone_tree(cache_dir / "rootfs" / key, rootfs_path)
+
+    return str(rootfs_path), meta["entrypoint"] + meta["cmd"]
+
+
+def pull_image_layers(image_ref: str, pull: bool = False) -> Tuple[List[Path], List[str]]:
+    """
+    Pull an image into the layer cache without flattening it.
+
+    Args:
+        image_ref: Docker image reference (e.g., "nginx:latest")
+        pull: Ask the registry what a tag points at even if resolved recently
+
+    Returns:
+        Tuple of (layer blob paths, lowest first, entrypoint_cmd)
+
+    Raises:
+        DockerError: If the pull fails
+    """
+    pinned_ref, key = _resolve_image(image_ref, pull)
+
+    cache_dir = Path(KERF_IMAGE_CACHE_DIR)
+    with _cache_lock(cache_dir):
+        config, layers = _pull_to_layout(pinned_ref, cache_dir, key)
+
+    meta = _image_command(config)
+    return layers, meta["entrypoint"] + meta["cmd"]
 
-    normalized_ref = _normalize_image_ref(image_ref)
 
-    with tempfile.TemporaryDirectory() as tmpdir:
-        tar_path = Path(tmpdir) / "image.tar"
-
-        try:
-            subprocess.run(
-                ["skopeo", "copy", normalized_ref, f"docker-archive:{tar_path}"],
-                check=True,
-                capture_output=True,
-                text=True
-            )
-        except subprocess.CalledProcessError as e:
-            raise DockerError(f"skopeo copy failed: {e.stderr}") from e
-
-        entrypoint = []
-        cmd = []
-
-        with tarfile.open(tar_path, 'r') as tar:
-            manifest_data = None
-            for member in tar.getmembers():
-                if member.name == "manifest.json":
-                    f = tar.extractfile(member)
-                    if f:
-                        manifest_data = json.load(f)
-                    break
-
-            if manifest_data and len(manifest_data) > 0:
-                config_file = manifest_data[0].get("Config", "")
-                if config_file:
-                    for member in tar.getmembers():
-                        if member.name == config_file:
-                            f = tar.extractfile(member)
-                            if f:
-                                config = json.load(f)
-                                oci_config = config.get("config", {})
-                                entrypoint = oci_config.get("Entrypoint") or []
-                                cmd = oci_config.get("Cmd") or []
-                            break
-
-                layers = manifest_data[0].get("Layers", [])
-                for layer_name in layers:
-                    for member in tar.getmembers():
-                        if member.name == layer_name:
-                            layer_file = tar.extractfile(member)
-                            if layer_file:
-                                with tarfile.open(fileobj=layer_file, mode='r:*') as layer_tar:
-                                    layer_tar.extractall(path=rootfs_path)
-                            break
-
-    return str(rootfs_path), entrypoint + cmd
+def daxfs_cache_dir() -> Path:
+    """Where daxfs images built from cached layers are kept."""
+    return Path(KERF_IMAGE_CACHE_DIR) / "daxfs"
 
 
 def get_image_entrypoint(image_ref: str) -> List[str]:
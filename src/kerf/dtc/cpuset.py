@@ -0,0 +1,102 @@
+# Copyright 2026 Multikernel Technologies, Inc.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""
+Compact cell encodings of CPU sets for the root device tree.
+
+The standard encoding lists every CPU ID, one cell each, which is what
+the kernel reads. A compact tree (InstanceExtractor(compact=True)) writes
+each set in whichever of three forms takes the fewest cells:
+
+    cpus        <id id ...>              any order, one cell per CPU
+    cpu-ranges  <first count ...>        two cells per run of consecutive IDs
+    cpu-bitmap  <base word word ...>     32 CPUs per cell from base, LSB first
+
+Ranges and bitmaps can only express a sorted set without duplicates, so
+any other list keeps the plain form.
+"""
+
+import struct
+from typing import List, Sequence, Tuple
+
+CPU_LIST = "cpus"
+CPU_RANGES = "cpu-ranges"
+CPU_BITMAP = "cpu-bitmap"
+CPU_SET_PROPERTIES = (CPU_LIST, CPU_RANGES, CPU_BITMAP)
+
+_BITS = 32
+
+
+def _pack(cells: Sequence[int]) -> bytes:
+    return struct.pack(f">{len(cells)}I", *cells)
+
+
+def _ranges(cpus: Sequence[int]) -> List[int]:
+    cells: List[int] = []
+    for cpu in cpus:
+        if cells and cells[-2] + cells[-1] == cpu:
+            cells[-1] += 1
+        else:
+            cells += [cpu, 1]
+    return cells
+
+
+def _bitmap(cpus: Sequence[int]) -> List[int]:
+    base = cpus[0] - cpus[0] % _BITS
+    words = [0] * ((cpus[-1] - base) // _BITS + 1)
+    for cpu in cpus:
+        words[(cpu - base) // _BITS] |= 1 << ((cpu - base) % _BITS)
+    return [base] + words
+
+
+def encode_cpu_set(cpus: Sequence[int]) -> Tuple[str, bytes]:
+    """The property name and value that express cpus in the fewest cells."""
+    cpus = list(cpus)
+    if len(cpus) < 2 or any(a >= b for a, b in zip(cpus, cpus[1:])):
+        return CPU_LIST, _pack(cpus)
+
+    best = (CPU_LIST, cpus)
+    for name, cells in ((CPU_RANGES, _ranges(cpus)), (CPU_BITMAP, _bitmap(cpus))):
+        if len(cells) < len(best[1]):
+            best = (name, cells)
+    return best[0], _pack(best[1])
+
+
+def decode_cpu_set(name: str, cells: Sequence[int]) -> List[int]:
+    """
+    The CPU IDs of a cpus, cpu-ranges or cpu-bitmap property's cells.
+
+    Raises:
+        ValueError: If the cells are not a valid value for that property
+    """
+    if name == CPU_LIST:
+        return list(cells)
+    if name == CPU_RANGES:
+        if len(cells) % 2:
+            raise ValueError("cpu-ranges needs <first count> pairs")
+        cpus: List[int] = []
+        for first, count in zip(cells[::2], cells[1::2]):
+            cpus.extend(range(first, first + count))
+        return cpus
+    if name == CPU_BITMAP:
+        if not cells or cells[0] % _BITS:
+            raise ValueError("cpu-bitmap needs a 32-aligned base cell")
+        base = cells[0]
+        return [
+            base + index * _BITS + bit
+            for index, word in enumerate(cells[1:])
+            for bit in range(_BITS)
+            if word >> bit & 1
+        ]
+    raise ValueError(f"{name} is not a CPU set property")
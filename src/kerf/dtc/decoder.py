@@ -0,0 +1,390 @@
+# Copyright 2026 Multikernel Technologies, Inc.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""
+Single-pass decoder for the multikernel root device tree.
+
+DeviceTreeParser looks every property up through libfdt, and every
+optional property that is absent costs a raised FdtException. Each kerf
+command parses /sys/fs/multikernel/device_tree first, so that cost
+grows with the instance count. This decoder walks the flattened
+structure block once, collecting each node's properties, and then builds
+the models from those dicts.
+
+It only handles well-formed baseline trees. Overlays, malformed headers
+and unexpected property sizes raise Unsupported, and the caller falls back
+to DeviceTreeParser. That parser stays the reference: both must return
+equal models for any tree this module accepts, in the standard and the
+compact encoding alike.
+"""
+
+import struct
+from typing import Dict, List, Optional
+
+from .cpuset import CPU_SET_PROPERTIES, decode_cpu_set
+from ..models import (
+    CPUAllocation,
+    CPUTopology,
+    DeviceInfo,
+    GlobalDeviceTree,
+    HardwareInventory,
+    Instance,
+    InstanceResources,
+    MemoryAllocation,
+    NUMANode,
+    TopologySection,
+)
+
+FDT_MAGIC = 0xD00DFEED
+FDT_BEGIN_NODE = 1
+FDT_END_NODE = 2
+FDT_PROP = 3
+FDT_NOP = 4
+FDT_END = 9
+
+_HEADER = struct.Struct(">10I")
+_TOKEN = struct.Struct(">I")
+_PROP = struct.Struct(">III")
+
+
+class Unsupported(Exception):
+    """The tree is not one this decoder handles; use the reference parser."""
+
+
+class _Node:
+    __slots__ = ("name", "props", "children")
+
+    def __init__(self, name: str):
+        self.name = name
+        self.props: Dict[str, bytes] = {}
+        self.children: Dict[str, "_Node"] = {}
+
+
+def _walk(data: bytes) -> _Node:
+    """Read the structure block into a node tree."""
+    if len(data) < _HEADER.size:
+        raise Unsupported("truncated header")
+    (magic, totalsize, off_struct, off_strings, _, version, last_comp,
+     _, size_strings, size_struct) = _HEADER.unpack_from(data)
+    if magic != FDT_MAGIC or version < 17 or last_comp > 17 or totalsize > len(data):
+        raise Unsupported("unsupported header")
+    if off_struct + size_struct > totalsize or off_strings + size_strings > totalsize:
+        raise Unsupported("blocks outside the blob")
+
+    names: Dict[int, str] = {}
+    stack: List[_Node] = []
+    root = None
+    pos, end = off_struct, off_struct + size_struct
+    try:
+        while pos < end:
+            (token,) = _TOKEN.unpack_from(data, pos)
+            pos += 4
+            if token == FDT_BEGIN_NODE:
+                name_end = data.index(b"\0", pos, end)
+                node = _Node(data[pos:name_end].decode("utf-8"))
+                pos = (name_end + 4) & ~3
+                if stack:
+                    siblings = stack[-1].children
+                    if node.name in siblings:
+                        raise Unsupported(f"duplicate node {node.name}")
+                    siblings[node.name] = node
+                elif root is None:
+                    root = node
+                else:
+                    raise Unsupported("more than one root node")
+                stack.append(node)
+            elif token == FDT_PROP:
+                length, nameoff = _PROP.unpack_from(data, pos - 4)[1:]
+                pos += 8
+                name = names.get(nameoff)
+                if name is None:
+                    start = off_strings + nameoff
+                    name = data[start:data.index(b"\0", start)].decode("utf-8")
+                    names[nameoff] = name
+                if not stack or pos + length > end:
+                    raise Unsupported("stray property")
+                # First definition wins, as with fdt_getprop()
+                stack[-1].props.setdefault(name, data[pos:pos + length])
+                pos = (pos + length + 3) & ~3
+            elif token == FDT_END_NODE:
+                if not stack:
+                    raise Unsupported("unbalanced nodes")
+                stack.pop()
+            elif token == FDT_END:
+                break
+            elif token != FDT_NOP:
+                raise Unsupported(f"bad token {token}")
+    except (struct.error, ValueError, UnicodeDecodeError) as e:
+        raise Unsupported(str(e)) from e
+
+    if root is None or stack:
+        raise Unsupported("unterminated structure block")
+    return root
+
+
+def _str(value: bytes) -> str:
+    if not value or value[-1] != 0 or 0 in value[:-1]:
+        raise Unsupported("bad string property")
+    try:
+        return value[:-1].decode("utf-8")
+    except UnicodeDecodeError as e:
+        raise Unsupported(str(e)) from e
+
+
+def _u32(value: bytes) -> int:
+    if len(value) != 4:
+        raise Unsupported("bad u32 property")
+    return _TOKEN.unpack(value)[0]
+
+
+def _u64(value: bytes) -> int:
+    if len(value) != 8:
+        raise Unsupported("bad u64 property")
+    return struct.unpack(">Q", value)[0]
+
+
+def _u32_list(value: bytes) -> List[int]:
+    if len(value) % 4:
+        raise Unsupported("bad u32 list property")
+    return list(struct.unpack(f">{len(value) // 4}I", value))
+
+
+def _cpu_set(props: Dict[str, bytes], default=None) -> Optional[List[int]]:
+    for name in CPU_SET_PROPERTIES:
+        if name in props:
+            try:
+                return decode_cpu_set(name, _u32_list(props[name]))
+            except ValueError as e:
+                raise Unsupported(str(e)) from e
+    if default is None:
+        raise Unsupported("missing cpus")
+    return default
+
+
+def _phandles(root: _Node) -> Dict[int, str]:
+    """Node names by phandle, for the device and device reference nodes."""
+    resources = root.children.get("resources")
+    devices = resources.children.get("devices") if resources else None
+    nodes = list(devices.children.items()) if devices else []
+    result = {}
+    for name, node in nodes + list(root.children.items()):
+        if "phandle" in node.props:
+            result.setdefault(_u32(node.props["phandle"]), name)
+    return result
+
+
+def _handle_names(value: bytes, phandles: Dict[int, str]) -> List[str]:
+    try:
+        return [phandles[handle] for handle in _u32_list(value)]
+    except KeyError as e:
+        raise Unsupported(f"unknown phandle {e}") from e
+
+
+def _opt(props: Dict[str, bytes], name: str, convert, default=None):
+    value = props.get(name)
+    return default if value is None else convert(value)
+
+
+def _require(props: Dict[str, bytes], name: str, convert):
+    value = props.get(name)
+    if value is None:
+        raise Unsupported(f"missing {name}")
+    return convert(value)
+
+
+def _hardware(resources: _Node) -> HardwareInventory:
+    props = resources.props
+    available = _cpu_set(props, [])
+    memory_pool_base = _require(props, "memory-base", _u64)
+    memory_pool_bytes = _require(props, "memory-bytes", _u64)
+
+    return HardwareInventory(
+        cpus=CPUAllocation(
+            total=max(available) + 1 if available else 0,
+            host_reserved=[],
+            available=available,
+            topology=_cpu_topology(resources.children.get("cpu-topology")),
+        ),
+        memory=MemoryAllocation(
+            total_bytes=memory_pool_base + memory_pool_bytes,
+            host_reserved_bytes=0,
+            memory_pool_base=memory_pool_base,
+            memory_pool_bytes=memory_pool_bytes,
+        ),
+        topology=_topology(resources.children.get("topology")),
+        devices=_devices(resources.children.get("devices")),
+    )
+
+
+def _cpu_topology(topology: Optional[_Node]) -> Optional[Dict[int, CPUTopology]]:
+    if topology is None:
+        return None
+
+    result = {}
+    for name, node in topology.children.items():
+        if not name.startswith("cpu@"):
+            continue
+        try:
+            cpu_id = int(name[4:])
+        except ValueError as e:
+            raise Unsupported(f"bad CPU node {name}") from e
+        props = node.props
+        siblings = _opt(props, "siblings", _u32_list, [])
+        result[cpu_id] = CPUTopology(
+            cpu_id=cpu_id,
+            numa_node=_require(props, "numa-node", _u32),
+            core_id=_require(props, "core-id", _u32),
+            thread_id=_require(props, "thread-id", _u32),
+            socket_id=_require(props, "socket-id", _u32),
+            cache_levels=_opt(props, "cache-sizes", _u32_list, []),
+            flags=["smt"] if len(siblings) > 1 else [],
+            llc_id=_opt(props, "llc-id", _u32),
+            siblings=siblings,
+        )
+    return result or None
+
+
+def _topology(topology: Optional[_Node]) -> Optional[TopologySection]:
+    numa_nodes = topology.children.get("numa-nodes") if topology is not None else None
+    if numa_nodes is None:
+        return None
+
+    nodes = {}
+    for name, node in numa_nodes.children.items():
+        if not name.startswith("node@"):
+            continue
+        try:
+            node_id = int(name[5:])
+        except ValueError as e:
+            raise Unsupported(f"bad NUMA node {name}") from e
+        props = node.props
+        nodes[node_id] = NUMANode(
+            node_id=node_id,
+            memory_base=_opt(props, "memory-base", _u64, 0),
+            memory_size=_opt(props, "memory-size", _u64, 0),
+            cpus=_opt(props, "cpus", _u32_list, []),
+            distance_matrix={},
+            memory_type=_opt(props, "memory-type", _str, "dram"),
+        )
+    return TopologySection(numa_nodes=nodes) if nodes else None
+
+
+def _devices(devices: Optional[_Node]) -> Dict[str, DeviceInfo]:
+    if devices is None:
+        return {}
+
+    result = {}
+    for name, node in devices.children.items():
+        props = node.props
+        result[name] = DeviceInfo(
+            name=name,
+            compatible=_opt(props, "compatible", _str, ""),
+            device_type=_opt(props, "device-type", _str),
+            device_name=_opt(props, "device-name", _str),
+            pci_id=_opt(props, "pci-id", _str),
+            vendor_id=_opt(props, "vendor-id", _u32),
+            device_id=_opt(props, "device-id", _u32),
+            sriov_vfs=_opt(props, "sriov-vfs", _u32),
+            host_reserved_vf=_opt(props, "host-reserved-vf", _u32),
+            available_vfs=_opt(props, "available-vfs", _u32_list),
+            namespaces=_opt(props, "namespaces", _u32),
+            host_reserved_ns=_opt(props, "host-reserved-ns", _u32),
+            available_ns=_opt(props, "available-ns", _u32_list),
+        )
+    return result
+
+
+def _instances(instances: Optional[_Node], phandles: Dict[int, str]) -> Dict[str, Instance]:
+    if instances is None:
+        return {}
+
+    result = {}
+    for name, node in instances.children.items():
+        resources = node.children.get("resources")
+        if resources is None:
+            raise Unsupported(f"instance {name} has no resources")
+        props = resources.props
+        if "device-handles" in props:
+            devices = _handle_names(props["device-handles"], phandles)
+        else:
+            device_names = _opt(props, "device-names", _str, "")
+            devices = [d.strip() for d in device_names.split() if d.strip()]
+        options_node = node.children.get("options")
+        options = None
+        if options_node is not None and "enable-host-kcore" in options_node.props:
+            options = {"enable-host-kcore": True}
+
+        result[name] = Instance(
+            name=name,
+            id=_require(node.props, "id", _u32),
+            resources=InstanceResources(
+                cpus=_cpu_set(props),
+                memory_base=_require(props, "memory-base", _u64),
+                memory_bytes=_require(props, "memory-bytes", _u64),
+                devices=devices,
+                cpu_affinity=_opt(props, "cpu-affinity", _str),
+            ),
+            options=options,
+        )
+    return result
+
+
+def _device_references(root: _Node, phandles: Dict[int, str]) -> Dict[str, Dict]:
+    references = {}
+    for name, node in root.children.items():
+        if name in ("resources", "instances") or ("_vf" not in name and "_ns" not in name):
+            continue
+        reference = {}
+        if "parent-handle" in node.props:
+            handle = _u32(node.props["parent-handle"])
+            if handle not in phandles:
+                raise Unsupported(f"unknown phandle {handle}")
+            reference["parent"] = phandles[handle]
+        elif "parent" in node.props:
+            reference["parent"] = _str(node.props["parent"])
+        if "_vf" in name and "vf-id" in node.props:
+            reference["vf_id"] = _u32(node.props["vf-id"])
+        if "_ns" in name and "namespace-id" in node.props:
+            reference["namespace_id"] = _u32(node.props["namespace-id"])
+        if reference:
+            references[name] = reference
+    return references
+
+
+def decode_dtb(dtb_data: bytes) -> GlobalDeviceTree:
+    """
+    Decode a multikernel root device tree in one pass.
+
+    Raises:
+        Unsupported: If the blob is an overlay or not a well-formed
+                     baseline tree; DeviceTreeParser decides what it is
+    """
+    root = _walk(bytes(dtb_data))
+
+    compatible = root.props.get("compatible")
+    if compatible is not None and _str(compatible).rstrip("\0") == "linux,multikernel-overlay":
+        raise Unsupported("overlay")
+    if any(name.startswith("fragment@") for name in root.children):
+        raise Unsupported("overlay")
+
+    resources = root.children.get("resources")
+    if resources is None:
+        raise Unsupported("no /resources")
+
+    phandles = _phandles(root)
+    return GlobalDeviceTree(
+        hardware=_hardware(resources),
+        instances=_instances(root.children.get("instances"), phandles),
+        device_references=_device_references(root, phandles),
+    )
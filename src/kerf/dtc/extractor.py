@@ -14,17 +14,28 @@
 
 """
 DTB generation from device tree models.
+
+With compact=True the root tree is written for size rather than for the
+kernel's parser: CPU sets take the fewest cells of the encodings in
+cpuset.py, and every device and device reference node gets a phandle that
+instances and VF/namespace references point at instead of repeating the
+device's name. DeviceTreeParser and the decoder read both forms.
 """
 
+from typing import Dict
+
 import libfdt
 from ..models import GlobalDeviceTree, Instance
+from .cpuset import encode_cpu_set
 
 
 class InstanceExtractor:
     """Generates device tree blobs (DTB) from device tree models."""
 
-    def __init__(self):
+    def __init__(self, compact: bool = False):
         self.fdt = None
+        self.compact = compact
+        self._phandles: Dict[str, int] = {}
 
     def _create_minimal_fdt(self) -> bytes:
         """Create a minimal valid FDT structure."""
@@ -94,6 +105,7 @@ class InstanceExtractor:
 
         fdt_sw = libfdt.FdtSw()
         fdt_sw.finish_reservemap()
+        self._phandles = self._assign_phandles(tree) if self.compact else {}
 
         fdt_sw.begin_node("")
         fdt_sw.property_string("compatible", "linux,multikernel-host")
@@ -102,6 +114,12 @@ class InstanceExtractor:
         self._add_cpu_properties_sw(fdt_sw, tree.hardware.cpus)
         self._add_memory_properties_sw(fdt_sw, tree.hardware.memory)
 
+        if tree.hardware.cpus.topology:
+            self._add_cpu_topology_sw(fdt_sw, tree.hardware.cpus.topology)
+
+        if tree.hardware.topology and tree.hardware.topology.numa_nodes:
+            self._add_numa_topology_sw(fdt_sw, tree.hardware.topology.numa_nodes)
+
         if tree.hardware.devices:
             self._add_devices_section_sw(fdt_sw, tree.hardware.devices)
 
@@ -119,12 +137,65 @@ class InstanceExtractor:
         dtb.pack()
         return dtb.as_bytearray()
 
+    @staticmethod
+    def _assign_phandles(tree: GlobalDeviceTree) -> Dict[str, int]:
+        """Number the device nodes, then the device reference nodes, from 1."""
+        phandles: Dict[str, int] = {}
+        for name in list(tree.hardware.devices) + list(tree.device_references):
+            phandles.setdefault(name, len(phandles) + 1)
+        return phandles
+
+    def _add_cpu_set_sw(self, fdt_sw, cpus):
+        """Add a CPU set as a cpus list, or in its smallest encoding when compact."""
+        import struct
+
+        if self.compact:
+            fdt_sw.property(*encode_cpu_set(cpus))
+        else:
+            fdt_sw.property("cpus", struct.pack(">" + "I" * len(cpus), *cpus))
+
     def _add_cpu_properties_sw(self, fdt_sw, cpus):
         """Add CPU properties directly to resources node."""
+        self._add_cpu_set_sw(fdt_sw, cpus.available)
+
+    def _add_cpu_topology_sw(self, fdt_sw, topology):
+        """Add per-CPU core, SMT sibling and LLC topology under cpu-topology."""
         import struct
 
-        available_data = struct.pack(">" + "I" * len(cpus.available), *cpus.available)
-        fdt_sw.property("cpus", available_data)
+        fdt_sw.begin_node("cpu-topology")
+        for cpu_id, topo in sorted(topology.items()):
+            fdt_sw.begin_node(f"cpu@{cpu_id}")
+            fdt_sw.property_u32("core-id", topo.core_id)
+            fdt_sw.property_u32("thread-id", topo.thread_id)
+            fdt_sw.property_u32("socket-id", topo.socket_id)
+            fdt_sw.property_u32("numa-node", topo.numa_node)
+            if topo.llc_id is not None:
+                fdt_sw.property_u32("llc-id", topo.llc_id)
+            if topo.siblings:
+                fdt_sw.property("siblings", struct.pack(f">{len(topo.siblings)}I", *topo.siblings))
+            if topo.cache_levels:
+                fdt_sw.property(
+                    "cache-sizes", struct.pack(f">{len(topo.cache_levels)}I", *topo.cache_levels)
+                )
+            fdt_sw.end_node()
+        fdt_sw.end_node()
+
+    def _add_numa_topology_sw(self, fdt_sw, numa_nodes):
+        """Add each NUMA node's memory window and CPUs under topology/numa-nodes."""
+        import struct
+
+        fdt_sw.begin_node("topology")
+        fdt_sw.begin_node("numa-nodes")
+        for node_id, node in sorted(numa_nodes.items()):
+            fdt_sw.begin_node(f"node@{node_id}")
+            fdt_sw.property_u64("memory-base", node.memory_base)
+            fdt_sw.property_u64("memory-size", node.memory_size)
+            if node.cpus:
+                fdt_sw.property("cpus", struct.pack(f">{len(node.cpus)}I", *node.cpus))
+            fdt_sw.property_string("memory-type", node.memory_type)
+            fdt_sw.end_node()
+        fdt_sw.end_node()
+        fdt_sw.end_node()
 
     def _add_memory_properties_sw(self, fdt_sw, memory):
         """Add memory properties directly to resources node."""
@@ -138,6 +209,9 @@ class InstanceExtractor:
         for name, device_info in devices.items():
             fdt_sw.begin_node(name)
 
+            if self._phandles.get(name):
+                fdt_sw.property_u32("phandle", self._phandles[name])
+
             if device_info.device_type:
                 fdt_sw.property_string("device-type", device_info.device_type)
 
@@ -200,20 +274,23 @@ class InstanceExtractor:
 
             fdt_sw.begin_node("resources")
 
-            import struct
-
-            cpus_data = struct.pack(
-                ">" + "I" * len(instance.resources.cpus), *instance.resources.cpus
-            )
-            fdt_sw.property("cpus", cpus_data)
+            self._add_cpu_set_sw(fdt_sw, instance.resources.cpus)
 
             fdt_sw.property_u64("memory-base", instance.resources.memory_base)
             fdt_sw.property_u64("memory-bytes", instance.resources.memory_bytes)
 
-            if instance.resources.devices:
+            handles = [self._phandles.get(d) for d in instance.resources.devices]
+            if handles and all(handles):
+                import struct
+
+                fdt_sw.property("device-handles", struct.pack(f">{len(handles)}I", *handles))
+            elif instance.resources.devices:
                 stringlist_data = b'\0'.join(d.encode('utf-8') for d in instance.resources.devices) + b'\0'
                 fdt_sw.property("device-names", stringlist_data)
 
+            if instance.resources.cpu_affinity:
+                fdt_sw.property_string("cpu-affinity", instance.resources.cpu_affinity)
+
             fdt_sw.end_node()  # End resources
             fdt_sw.end_node()  # End instance
 
@@ -224,9 +301,15 @@ class InstanceExtractor:
         for name, device_ref in device_references.items():
             fdt_sw.begin_node(name)
 
+            if self._phandles.get(name):
+                fdt_sw.property_u32("phandle", self._phandles[name])
+
             if isinstance(device_ref, dict):
-                if "parent" in device_ref and device_ref["parent"]:
-                    fdt_sw.property_string("parent", device_ref["parent"])
+                parent = device_ref.get("parent")
+                if parent and self._phandles.get(parent):
+                    fdt_sw.property_u32("parent-handle", self._phandles[parent])
+                elif parent:
+                    fdt_sw.property_string("parent", parent)
                 if "vf_id" in device_ref and device_ref["vf_id"] is not None:
                     fdt_sw.property_u32("vf-id", device_ref["vf_id"])
                 if "namespace_id" in device_ref and device_ref["namespace_id"] is not None:
@@ -91,14 +91,116 @@ class OverlayGenerator:
         Returns:
             DTBO blob as bytes containing resource update operations
         """
-        import struct
+        fdt_sw = libfdt.FdtSw()
+        fdt_sw.finish_reservemap()
+
+        fdt_sw.begin_node("")
+        fdt_sw.property_string("compatible", "linux,multikernel-overlay")
+
+        # Single fragment with all operations
+        fdt_sw.begin_node("fragment@0")
+        fdt_sw.begin_node("__overlay__")
+        self._add_update_operations(fdt_sw, instance_name, old_instance, new_instance)
+        fdt_sw.end_node()  # End __overlay__
+        fdt_sw.end_node()  # End fragment@0
+
+        fdt_sw.end_node()  # End root
+
+        dtb = fdt_sw.as_fdt()
+        dtb.pack()
+        return dtb.as_bytearray()
+
+    def generate_cpu_overlay(
+        self, instance_name: str, operation: str, cpu_ids, numa_nodes=None
+    ) -> bytes:
+        """
+        Generate a single cpu-add or cpu-remove fragment for an existing instance.
+
+        The same overlay generate_update_overlay() produces when only CPUs
+        change, without comparing the rest of the instance.
+
+        Args:
+            instance_name: Name of the instance to update
+            operation: "cpu-add" or "cpu-remove"
+            cpu_ids: APIC IDs to add or remove
+            numa_nodes: The instance's NUMA nodes, tagged on added CPUs
+
+        Returns:
+            DTBO blob as bytes
+        """
+        fdt_sw = libfdt.FdtSw()
+        fdt_sw.finish_reservemap()
+
+        fdt_sw.begin_node("")
+        fdt_sw.property_string("compatible", "linux,multikernel-overlay")
+        self._add_cpu_operation(fdt_sw, 0, operation, instance_name, cpu_ids, numa_nodes)
+        fdt_sw.end_node()  # End root
+
+        dtb = fdt_sw.as_fdt()
+        dtb.pack()
+        return dtb.as_bytearray()
+
+    def generate_transaction_overlay(
+        self, current: GlobalDeviceTree, modified: GlobalDeviceTree
+    ) -> bytes:
+        """
+        Generate one overlay for several instance changes applied together.
 
+        Unlike generate_overlay(), instances present in both states are
+        emitted as resource update operations, like generate_update_overlay().
+        Fragments are ordered removals, then updates, then creates, so
+        resources freed earlier in the overlay can be claimed later in it.
+
+        Args:
+            current: Device tree state before the transaction
+            modified: Device tree state after all of its operations
+
+        Returns:
+            DTBO blob as bytes, one fragment per changed instance
+        """
         fdt_sw = libfdt.FdtSw()
         fdt_sw.finish_reservemap()
 
         fdt_sw.begin_node("")
         fdt_sw.property_string("compatible", "linux,multikernel-overlay")
 
+        fragments = [
+            (self._add_instance_remove, (name,))
+            for name in sorted(set(current.instances) - set(modified.instances))
+        ]
+        fragments += [
+            (self._add_update_operations, (name, current.instances[name], instance))
+            for name, instance in modified.instances.items()
+            if name in current.instances and current.instances[name] != instance
+        ]
+        fragments += [
+            (self._add_instance_create, (name, instance))
+            for name, instance in modified.instances.items()
+            if name not in current.instances
+        ]
+
+        for fragment_id, (add, args) in enumerate(fragments):
+            fdt_sw.begin_node(f"fragment@{fragment_id}")
+            fdt_sw.begin_node("__overlay__")
+            add(fdt_sw, *args)
+            fdt_sw.end_node()  # End __overlay__
+            fdt_sw.end_node()  # End fragment
+
+        fdt_sw.end_node()  # End root
+
+        dtb = fdt_sw.as_fdt()
+        dtb.pack()
+        return dtb.as_bytearray()
+
+    def _add_update_operations(self, fdt_sw, instance_name, old_instance, new_instance):
+        """
+        Add the resource update operations of one instance to an open __overlay__.
+
+        Operations are added in order: memory-remove, memory-add, cpu-remove,
+        cpu-add, device-remove, device-add.
+        """
+        import struct
+
         old_cpus = set(old_instance.resources.cpus)
         new_cpus = set(new_instance.resources.cpus)
         cpus_to_remove = sorted(old_cpus - new_cpus)
@@ -115,10 +217,6 @@ class OverlayGenerator:
         devices_to_remove = sorted(old_devices - new_devices)
         devices_to_add = sorted(new_devices - old_devices)
 
-        # Single fragment with all operations
-        fdt_sw.begin_node("fragment@0")
-        fdt_sw.begin_node("__overlay__")
-
         # 1. memory-remove (if memory shrunk or base changed)
         if memory_changed:
             if old_mem_base == new_mem_base:
@@ -221,15 +319,6 @@ class OverlayGenerator:
 
             fdt_sw.end_node()
 
-        fdt_sw.end_node()  # End __overlay__
-        fdt_sw.end_node()  # End fragment@0
-
-        fdt_sw.end_node()  # End root
-
-        dtb = fdt_sw.as_fdt()
-        dtb.pack()
-        return dtb.as_bytearray()
-
     def _add_memory_operation(self, fdt_sw, fragment_id, operation, instance_name, base, size):
         """Helper to add memory operation fragment."""
         import struct
@@ -277,6 +366,65 @@ class OverlayGenerator:
 
         return fragment_id + 1
 
+    def _add_instance_create(self, fdt_sw, name, instance):
+        """Add an instance-create node for one instance to an open __overlay__."""
+        fdt_sw.begin_node("instance-create")
+
+        # Add instance properties
+        fdt_sw.property_string("instance-name", name)
+        if instance.id is not None:
+            fdt_sw.property_u32("id", instance.id)
+
+        fdt_sw.begin_node("resources")
+
+        import struct
+
+        cpus_data = struct.pack(
+            ">" + "I" * len(instance.resources.cpus), *instance.resources.cpus
+        )
+        fdt_sw.property("cpus", cpus_data)
+
+        fdt_sw.property_u64("memory-base", instance.resources.memory_base)
+        fdt_sw.property_u64("memory-bytes", instance.resources.memory_bytes)
+
+        if instance.resources.devices:
+            stringlist_data = b'\0'.join(d.encode('utf-8') for d in instance.resources.devices) + b'\0'
+            fdt_sw.property("device-names", stringlist_data)
+
+        if instance.resources.numa_nodes:
+            numa_data = struct.pack(
+                ">" + "I" * len(instance.resources.numa_nodes), *instance.resources.numa_nodes
+            )
+            fdt_sw.property("numa-nodes", numa_data)
+
+        if instance.resources.cpu_affinity:
+            fdt_sw.property_string("cpu-affinity", instance.resources.cpu_affinity)
+
+        if instance.resources.memory_policy:
+            fdt_sw.property_string("memory-policy", instance.resources.memory_policy)
+
+        fdt_sw.end_node()  # End resources
+
+        # Add options node if options exist
+        if instance.options:
+            fdt_sw.begin_node("options")
+
+            # Add enable-host-kcore if enabled
+            if instance.options.get("enable-host-kcore"):
+                fdt_sw.property("enable-host-kcore", b"")
+
+            # Future options can be added here
+
+            fdt_sw.end_node()  # End options
+
+        fdt_sw.end_node()  # End instance-create
+
+    def _add_instance_remove(self, fdt_sw, name):
+        """Add an instance-remove node for one instance to an open __overlay__."""
+        fdt_sw.begin_node("instance-remove")
+        fdt_sw.property_string("instance-name", name)
+        fdt_sw.end_node()  # End instance-remove
+
     def _create_overlay_dtb(
         self, instances_to_add: dict, instances_to_update: dict, instances_to_remove: Set[str]
     ) -> bytes:
@@ -304,58 +452,7 @@ class OverlayGenerator:
         for name, instance in all_instances.items():
             fdt_sw.begin_node(f"fragment@{fragment_id}")
             fdt_sw.begin_node("__overlay__")
-            fdt_sw.begin_node("instance-create")
-
-            # Add instance properties
-            fdt_sw.property_string("instance-name", name)
-            if instance.id is not None:
-                fdt_sw.property_u32("id", instance.id)
-
-            fdt_sw.begin_node("resources")
-
-            import struct
-
-            cpus_data = struct.pack(
-                ">" + "I" * len(instance.resources.cpus), *instance.resources.cpus
-            )
-            fdt_sw.property("cpus", cpus_data)
-
-            fdt_sw.property_u64("memory-base", instance.resources.memory_base)
-            fdt_sw.property_u64("memory-bytes", instance.resources.memory_bytes)
-
-            if instance.resources.devices:
-                stringlist_data = b'\0'.join(d.encode('utf-8') for d in instance.resources.devices) + b'\0'
-                fdt_sw.property("device-names", stringlist_data)
-
-            if instance.resources.numa_nodes:
-                import struct
-
-                numa_data = struct.pack(
-                    ">" + "I" * len(instance.resources.numa_nodes), *instance.resources.numa_nodes
-                )
-                fdt_sw.property("numa-nodes", numa_data)
-
-            if instance.resources.cpu_affinity:
-                fdt_sw.property_string("cpu-affinity", instance.resources.cpu_affinity)
-
-            if instance.resources.memory_policy:
-                fdt_sw.property_string("memory-policy", instance.resources.memory_policy)
-
-            fdt_sw.end_node()  # End resources
-
-            # Add options node if options exist
-            if instance.options:
-                fdt_sw.begin_node("options")
-
-                # Add enable-host-kcore if enabled
-                if instance.options.get("enable-host-kcore"):
-                    fdt_sw.property("enable-host-kcore", b"")
-
-                # Future options can be added here
-
-                fdt_sw.end_node()  # End options
-
-            fdt_sw.end_node()  # End instance-create
+            self._add_instance_create(fdt_sw, name, instance)
             fdt_sw.end_node()  # End __overlay__
             fdt_sw.end_node()  # End fragment
             fragment_id += 1
@@ -363,9 +460,7 @@ class OverlayGenerator:
         for name in instances_to_remove:
             fdt_sw.begin_node(f"fragment@{fragment_id}")
             fdt_sw.begin_node("__overlay__")
-            fdt_sw.begin_node("instance-remove")
-            fdt_sw.property_string("instance-name", name)
-            fdt_sw.end_node()  # End instance-remove
+            self._add_instance_remove(fdt_sw, name)
             fdt_sw.end_node()  # End __overlay__
             fdt_sw.end_node()  # End fragment
             fragment_id += 1
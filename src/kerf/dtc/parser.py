@@ -22,8 +22,11 @@ from typing import Dict, List, Optional
 import libfdt
 
 from ..exceptions import ParseError
+from . import decoder
+from .cpuset import CPU_SET_PROPERTIES, decode_cpu_set
 from ..models import (
     CPUAllocation,
+    CPUTopology,
     DeviceInfo,
     GlobalDeviceTree,
     HardwareInventory,
@@ -39,9 +42,17 @@ from ..models import (
 class DeviceTreeParser:
     """Parser for multikernel device trees."""
 
-    def __init__(self):
+    def __init__(self, fast: bool = True):
+        """
+        Args:
+            fast: Decode root device trees with the single-pass decoder
+                  when it can, falling back to the libfdt walk below.
+                  Pass False to always use the libfdt walk.
+        """
         self.fdt = None
+        self.fast = fast
         self._last_overlay_data: Optional[OverlayInstanceData] = None
+        self._phandles: Optional[Dict[int, str]] = None
 
     def parse_dts(self, dts_content: str) -> GlobalDeviceTree:
         """Parse DTS content into GlobalDeviceTree model."""
@@ -77,8 +88,18 @@ class DeviceTreeParser:
 
     def parse_dtb_from_bytes(self, dtb_data: bytes) -> GlobalDeviceTree:
         """Parse DTB from bytes into GlobalDeviceTree model."""
+        if self.fast:
+            try:
+                tree = decoder.decode_dtb(dtb_data)
+                self.fdt = None
+                self._last_overlay_data = None
+                return tree
+            except decoder.Unsupported:
+                pass
+
         try:
             self.fdt = libfdt.Fdt(dtb_data)
+            self._phandles = None
             return self._build_global_tree()
         except libfdt.FdtException as e:
             error_msg = f"FDT error: {e}"
@@ -200,14 +221,52 @@ class DeviceTreeParser:
             devices=devices
         )
 
+    def _get_cpu_set(self, node_offset: int) -> Optional[List[int]]:
+        """Read a node's cpus, cpu-ranges or cpu-bitmap property, if it has one."""
+        for name in CPU_SET_PROPERTIES:
+            try:
+                cells = self.fdt.getprop(node_offset, name).as_uint32_list()
+            except libfdt.FdtException:
+                continue
+            try:
+                return decode_cpu_set(name, cells)
+            except ValueError as e:
+                raise ParseError(f"Invalid '{name}' property: {e}") from e
+        return None
+
+    def _phandle_name(self, phandle: int) -> str:
+        """The name of the device or device reference node with this phandle."""
+        if self._phandles is None:
+            self._phandles = {}
+            parents = [self.fdt.path_offset('/')]
+            try:
+                parents.insert(0, self.fdt.path_offset('/resources/devices'))
+            except libfdt.FdtException:
+                pass
+            for parent in parents:
+                try:
+                    offset = self.fdt.first_subnode(parent)
+                except libfdt.FdtException:
+                    continue
+                while offset >= 0:
+                    try:
+                        handle = self.fdt.getprop(offset, 'phandle').as_uint32()
+                        self._phandles.setdefault(handle, self.fdt.get_name(offset))
+                    except libfdt.FdtException:
+                        pass
+                    try:
+                        offset = self.fdt.next_subnode(offset)
+                    except libfdt.FdtException:
+                        break
+
+        if phandle not in self._phandles:
+            raise ParseError(f"Reference to unknown phandle {phandle}")
+        return self._phandles[phandle]
+
     def _parse_cpu_allocation(self, resources_node: int) -> CPUAllocation:
         """Parse CPU allocation from resources node."""
-        try:
-            cpus_prop = self.fdt.getprop(resources_node, 'cpus')
-            available = cpus_prop.as_uint32_list()
-        except libfdt.FdtException:
-            # No cpus property means all CPUs are allocated
-            available = []
+        # No cpus property means all CPUs are allocated
+        available = self._get_cpu_set(resources_node) or []
 
         if available:
             total = max(available) + 1
@@ -218,9 +277,56 @@ class DeviceTreeParser:
         return CPUAllocation(
             total=total,
             host_reserved=host_reserved,
-            available=available
+            available=available,
+            topology=self._parse_cpu_topology(resources_node)
         )
 
+    def _parse_cpu_topology(self, resources_node: int) -> Optional[Dict[int, CPUTopology]]:
+        """Parse per-CPU topology from resources/cpu-topology/cpu@<apic-id>."""
+        try:
+            topology_node = self.fdt.subnode_offset(resources_node, 'cpu-topology')
+        except libfdt.FdtException:
+            return None
+
+        def optional_u32_list(offset, name):
+            try:
+                return self.fdt.getprop(offset, name).as_uint32_list()
+            except libfdt.FdtException:
+                return []
+
+        topology = {}
+        try:
+            offset = self.fdt.first_subnode(topology_node)
+        except libfdt.FdtException:
+            return None
+        while offset >= 0:
+            name = self.fdt.get_name(offset)
+            if name.startswith('cpu@'):
+                cpu_id = int(name.split('@')[1])
+                llc_id = None
+                try:
+                    llc_id = self.fdt.getprop(offset, 'llc-id').as_uint32()
+                except libfdt.FdtException:
+                    pass
+                siblings = optional_u32_list(offset, 'siblings')
+                topology[cpu_id] = CPUTopology(
+                    cpu_id=cpu_id,
+                    numa_node=self.fdt.getprop(offset, 'numa-node').as_uint32(),
+                    core_id=self.fdt.getprop(offset, 'core-id').as_uint32(),
+                    thread_id=self.fdt.getprop(offset, 'thread-id').as_uint32(),
+                    socket_id=self.fdt.getprop(offset, 'socket-id').as_uint32(),
+                    cache_levels=optional_u32_list(offset, 'cache-sizes'),
+                    flags=['smt'] if len(siblings) > 1 else [],
+                    llc_id=llc_id,
+                    siblings=siblings
+                )
+            try:
+                offset = self.fdt.next_subnode(offset)
+            except libfdt.FdtException:
+                break
+
+        return topology if topology else None
+
     def _parse_memory_allocation(self, resources_node: int) -> MemoryAllocation:
         """Parse memory allocation from resources node."""
         try:
@@ -538,10 +644,9 @@ class DeviceTreeParser:
         except libfdt.FdtException as e:
             raise ParseError(f"Missing resources node for instance: {e}") from e
 
-        try:
-            cpus = self.fdt.getprop(resources_node, 'cpus').as_uint32_list()
-        except libfdt.FdtException as e:
-            raise ParseError(f"Missing 'cpus' property in instance resources: {e}") from e
+        cpus = self._get_cpu_set(resources_node)
+        if cpus is None:
+            raise ParseError("Missing 'cpus' property in instance resources")
 
         try:
             memory_base = self.fdt.getprop(resources_node, 'memory-base').as_uint64()
@@ -555,10 +660,20 @@ class DeviceTreeParser:
 
         devices = []
         try:
-            device_names_prop = self.fdt.getprop(resources_node, 'device-names')
-            device_names_str = device_names_prop.as_str()
-            if device_names_str:
-                devices = [d.strip() for d in device_names_str.split() if d.strip()]
+            handles = self.fdt.getprop(resources_node, 'device-handles').as_uint32_list()
+            devices = [self._phandle_name(handle) for handle in handles]
+        except libfdt.FdtException:
+            try:
+                device_names_prop = self.fdt.getprop(resources_node, 'device-names')
+                device_names_str = device_names_prop.as_str()
+                if device_names_str:
+                    devices = [d.strip() for d in device_names_str.split() if d.strip()]
+            except libfdt.FdtException:
+                pass
+
+        cpu_affinity = None
+        try:
+            cpu_affinity = self.fdt.getprop(resources_node, 'cpu-affinity').as_str()
         except libfdt.FdtException:
             pass
 
@@ -566,7 +681,8 @@ class DeviceTreeParser:
             cpus=cpus,
             memory_base=memory_base,
             memory_bytes=memory_bytes,
-            devices=devices
+            devices=devices,
+            cpu_affinity=cpu_affinity
         )
 
     def _parse_instance_options(self, node_offset: int) -> Optional[Dict[str, bool]]:
@@ -614,12 +730,16 @@ class DeviceTreeParser:
                 if '_vf' in name or '_ns' in name:
                     device_ref = {}
 
-                    # Parse parent property
+                    # Parse parent property, by phandle in compact trees
                     try:
-                        parent = self.fdt.getprop(offset, 'parent').as_str()
-                        device_ref['parent'] = parent
+                        handle = self.fdt.getprop(offset, 'parent-handle').as_uint32()
+                        device_ref['parent'] = self._phandle_name(handle)
                     except libfdt.FdtException:
-                        pass
+                        try:
+                            parent = self.fdt.getprop(offset, 'parent').as_str()
+                            device_ref['parent'] = parent
+                        except libfdt.FdtException:
+                            pass
 
                     # Parse vf-id if it's a VF reference
                     if '_vf' in name:
@@ -1208,10 +1328,8 @@ class DeviceTreeParser:
 
         return numa_nodes if numa_nodes else None
 
-    def _parse_cpu_topology_from_dts(self, dts_content: str) -> Optional[Dict[int, 'CPUTopology']]:
+    def _parse_cpu_topology_from_dts(self, dts_content: str) -> Optional[Dict[int, CPUTopology]]:
         """Parse CPU topology from DTS content."""
-        from ..models import CPUTopology
-
         topology = {}
 
         # Look for cores section
@@ -1239,7 +1357,8 @@ class DeviceTreeParser:
                     thread_id=i,
                     socket_id=0,  # Will be determined from NUMA topology
                     cache_levels=[],  # Could be parsed from additional properties
-                    flags=[]  # Could be parsed from additional properties
+                    flags=[],  # Could be parsed from additional properties
+                    siblings=sorted(cpus)
                 )
 
         return topology if topology else None
@@ -1266,17 +1385,22 @@ class DeviceTreeParser:
         nodes = {}
 
         # Iterate through NUMA node definitions
-        offset = self.fdt.first_subnode(numa_nodes_node)
+        try:
+            offset = self.fdt.first_subnode(numa_nodes_node)
+        except libfdt.FdtException:
+            return None
         while offset >= 0:
-            try:
-                node_name = self.fdt.get_name(offset)
-                if node_name.startswith('node@'):
+            node_name = self.fdt.get_name(offset)
+            if node_name.startswith('node@'):
+                try:
                     node_id = int(node_name.split('@')[1])
-                    node_info = self._parse_numa_node_info(offset, node_id)
-                    nodes[node_id] = node_info
-                offset = self.fdt.next_subnode(offset)
-            except Exception:
+                    nodes[node_id] = self._parse_numa_node_info(offset, node_id)
+                except ValueError:
+                    pass
+            try:
                 offset = self.fdt.next_subnode(offset)
+            except libfdt.FdtException:
+                break
 
         return nodes if nodes else None
 
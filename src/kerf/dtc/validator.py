@@ -16,10 +16,162 @@
 Validation layer for multikernel device tree configurations.
 """
 
+import bisect
+import functools
 import re
 from pathlib import Path
 from typing import List, Dict, Tuple, Optional
-from ..models import GlobalDeviceTree, ValidationResult, ResourceUsage
+from ..models import GlobalDeviceTree, Instance, ValidationResult, ResourceUsage
+
+
+# Host facts do not change under a running kerf, so /proc is read once per
+# process. clear_host_facts() drops them, e.g. after CPU hotplug.
+
+@functools.lru_cache(maxsize=None)
+def _read_cpuinfo() -> Tuple[frozenset, Dict[int, int]]:
+    """Physical IDs and logical processor -> physical ID map from /proc/cpuinfo."""
+    physical_ids = set()
+    processor_to_physical = {}
+    try:
+        cpuinfo_path = Path("/proc/cpuinfo")
+        if cpuinfo_path.exists():
+            with open(cpuinfo_path, "r", encoding="utf-8") as f:
+                current_processor = None
+                for line in f:
+                    if line.startswith("processor"):
+                        match = re.search(r"processor\s*:\s*(\d+)", line)
+                        current_processor = int(match.group(1)) if match else None
+                    elif line.startswith("physical id"):
+                        match = re.search(r"physical id\s*:\s*(\d+)", line)
+                        if match:
+                            physical_id = int(match.group(1))
+                            physical_ids.add(physical_id)
+                            if current_processor is not None:
+                                processor_to_physical[current_processor] = physical_id
+    except (OSError, IOError, ValueError):
+        pass
+
+    return frozenset(physical_ids), processor_to_physical
+
+
+@functools.lru_cache(maxsize=None)
+def _read_mem_total() -> Optional[int]:
+    """MemTotal from /proc/meminfo in bytes."""
+    try:
+        meminfo_path = Path("/proc/meminfo")
+        if meminfo_path.exists():
+            with open(meminfo_path, "r", encoding="utf-8") as f:
+                for line in f:
+                    if line.startswith("MemTotal:"):
+                        # Format: "MemTotal:       16384000 kB"
+                        match = re.search(r"MemTotal:\s*(\d+)\s*kB", line)
+                        if match:
+                            # Convert from kB to bytes
+                            return int(match.group(1)) * 1024
+    except (OSError, IOError, ValueError):
+        pass
+
+    return None
+
+
+@functools.lru_cache(maxsize=None)
+def _read_iomem_pool() -> Optional[Tuple[int, int]]:
+    """The "Multikernel Memory Pool" entry of /proc/iomem as (base, size)."""
+    try:
+        iomem_path = Path("/proc/iomem")
+        if not iomem_path.exists():
+            return None
+        with open(iomem_path, "r", encoding="utf-8") as f:
+            for line in f:
+                if "multikernel" in line.lower():
+                    match = re.search(r"([0-9a-fA-F]+)-([0-9a-fA-F]+)", line)
+                    if match:
+                        base = int(match.group(1), 16)
+                        end = int(match.group(2), 16)
+                        # Size is end - start + 1 (inclusive range)
+                        size = end - base + 1
+                        return (base, size)
+    except (OSError, IOError, ValueError):
+        pass
+
+    return None
+
+
+def clear_host_facts() -> None:
+    """Forget the memoized /proc/cpuinfo, /proc/meminfo and /proc/iomem contents."""
+    _read_cpuinfo.cache_clear()
+    _read_mem_total.cache_clear()
+    _read_iomem_pool.cache_clear()
+
+
+def _cpu_mask(cpus) -> int:
+    mask = 0
+    for cpu in cpus:
+        mask |= 1 << cpu
+    return mask
+
+
+class AllocationIndex:
+    """
+    Resources held by a set of instances, for checking others against them.
+
+    CPUs are a bitmap with an owner per CPU, memory a list of extents
+    sorted by base, plus the CPU and memory totals. All are built once,
+    so checking an instance costs its own resources rather than a pass
+    over every other instance. Lookups take the names of instances to
+    leave out, so one index of a state serves every change made to it.
+    """
+
+    def __init__(self, instances):
+        self.cpu_mask = 0
+        self.cpu_owner: Dict[int, str] = {}
+        self.cpus: Dict[str, set] = {}
+        self.ids: Dict[int, str] = {}
+        self.cpus_allocated = 0
+        self.memory_allocated = 0
+        extents = []
+        for instance in instances:
+            cpus = set(instance.resources.cpus)
+            self.cpus[instance.name] = cpus
+            self.cpu_mask |= _cpu_mask(cpus)
+            for cpu in cpus:
+                self.cpu_owner[cpu] = instance.name
+            start = instance.resources.memory_base
+            extents.append((start, start + instance.resources.memory_bytes, instance.name))
+            if instance.id is not None:
+                self.ids[instance.id] = instance.name
+            self.cpus_allocated += len(instance.resources.cpus)
+            self.memory_allocated += instance.resources.memory_bytes
+
+        self.extents = sorted(extents)
+        # Highest end among extents[:i + 1], so a lookup can stop early
+        # even if a bad baseline left extents overlapping one another
+        self.max_end: List[int] = []
+        for _, end, _ in self.extents:
+            self.max_end.append(max(end, self.max_end[-1]) if self.max_end else end)
+
+    def cpu_conflicts(self, cpus: set, excluded: frozenset = frozenset()) -> Dict[str, set]:
+        """Instances not in excluded holding any of cpus, with the CPUs they share."""
+        conflicts: Dict[str, set] = {}
+        if _cpu_mask(cpus) & self.cpu_mask:
+            for cpu in sorted(cpus):
+                owner = self.cpu_owner.get(cpu)
+                if owner is not None and owner not in excluded:
+                    conflicts.setdefault(owner, set()).add(cpu)
+        return conflicts
+
+    def memory_conflicts(self, start: int, end: int,
+                         excluded: frozenset = frozenset()) -> List[Tuple[int, int, str]]:
+        """Extents of instances not in excluded overlapping [start, end), in base order."""
+        conflicts = []
+        index = bisect.bisect_left(self.extents, (end,)) - 1
+        while index >= 0 and self.max_end[index] > start:
+            other_start, other_end, name = self.extents[index]
+            if other_end > start and name not in excluded:
+                conflicts.append((other_start, other_end, name))
+            index -= 1
+        conflicts.reverse()
+        return conflicts
 
 
 class MultikernelValidator:
@@ -99,69 +251,125 @@ class MultikernelValidator:
             suggestions=self.suggestions.copy(),
         )
 
+    def validate_delta(
+        self, current: GlobalDeviceTree, modified: GlobalDeviceTree,
+        allocations: Optional[AllocationIndex] = None,
+    ) -> ValidationResult:
+        """
+        Validate modified, assuming current was valid.
+
+        Only instances that are new or differ from current are checked in
+        full. They are checked against each other and against the
+        allocations of the untouched instances, which are not re-checked
+        among themselves. When anything besides instances changed, this
+        falls back to validate(modified).
+
+        allocations is AllocationIndex(current.instances.values()), for
+        callers that keep it with current across changes; it is built
+        here when not given.
+        """
+        if (current.hardware != modified.hardware
+                or current.device_references != modified.device_references):
+            return self.validate(modified)
+
+        self.errors.clear()
+        self.warnings.clear()
+        self.suggestions.clear()
+
+        touched = [
+            instance for name, instance in modified.instances.items()
+            if current.instances.get(name) != instance
+        ]
+        # Instances of current that were changed or removed
+        replaced = frozenset(
+            name for name, instance in current.instances.items()
+            if modified.instances.get(name) != instance
+        )
+        if allocations is None:
+            allocations = AllocationIndex(current.instances.values())
+
+        self._validate_hardware_inventory(modified)
+        for instance in touched:
+            owner = allocations.ids.get(instance.id) if instance.id is not None else None
+            if owner is not None and owner not in replaced:
+                self.errors.append(
+                    f"Duplicate instance ID: {instance.id} assigned to multiple instances"
+                )
+            self._validate_touched_instance(instance, touched, allocations, replaced, modified)
+
+        cpus_allocated = allocations.cpus_allocated + sum(
+            len(instance.resources.cpus) for instance in touched
+        ) - sum(len(current.instances[name].resources.cpus) for name in replaced)
+        memory_allocated = allocations.memory_allocated + sum(
+            instance.resources.memory_bytes for instance in touched
+        ) - sum(current.instances[name].resources.memory_bytes for name in replaced)
+        self._validate_resource_totals(cpus_allocated, memory_allocated, modified)
+        # Device references and hardware are current's, which was valid
+
+        usage = self._resource_usage(cpus_allocated, memory_allocated, modified)
+        self._validate_resource_limits(usage, modified)
+
+        return ValidationResult(
+            is_valid=len(self.errors) == 0,
+            errors=self.errors.copy(),
+            warnings=self.warnings.copy(),
+            suggestions=self.suggestions.copy(),
+        )
+
+    def _validate_touched_instance(
+        self, instance, touched: List[Instance], allocations: AllocationIndex,
+        replaced: frozenset, tree: GlobalDeviceTree,
+    ):
+        """Validate one changed instance against the others for validate_delta()."""
+        instance_cpus = set(instance.resources.cpus)
+        memory_start = instance.resources.memory_base
+        memory_end = memory_start + instance.resources.memory_bytes
+
+        self._validate_cpu_bounds(instance, tree)
+        for other_name, overlap in allocations.cpu_conflicts(instance_cpus, replaced).items():
+            other_cpus = allocations.cpus[other_name]
+            self._report_cpu_overlap(instance, other_name, overlap, other_cpus, tree)
+
+        self._validate_memory_bounds(instance, tree)
+        conflicts = allocations.memory_conflicts(memory_start, memory_end, replaced)
+        for other_start, other_end, other_name in conflicts:
+            self._report_memory_overlap(instance, other_name, other_start, other_end)
+
+        # Changed instances are few, so check them against each other directly
+        for other in touched:
+            if other.name == instance.name:
+                continue
+            other_cpus = set(other.resources.cpus)
+            overlap = instance_cpus.intersection(other_cpus)
+            if overlap:
+                self._report_cpu_overlap(instance, other.name, overlap, other_cpus, tree)
+            other_start = other.resources.memory_base
+            other_end = other_start + other.resources.memory_bytes
+            if not (memory_end <= other_start or other_end <= memory_start):
+                self._report_memory_overlap(instance, other.name, other_start, other_end)
+            if instance.id is not None and instance.id == other.id and instance.name < other.name:
+                self.errors.append(
+                    f"Duplicate instance ID: {instance.id} assigned to multiple instances"
+                )
+
+        self._validate_device_allocation(instance, tree)
+        self._validate_topology_constraints(instance, tree)
+
     def _get_system_cpu_ids(self) -> Optional[set[int]]:
         """
         Get the set of physical CPU IDs from /proc/cpuinfo.
         Maps logical processor IDs to physical IDs and returns the set of physical IDs.
         """
-        try:
-            cpuinfo_path = Path("/proc/cpuinfo")
-            if cpuinfo_path.exists():
-                with open(cpuinfo_path, "r", encoding="utf-8") as f:
-                    content = f.read()
-                    physical_ids = set()
-                    current_physical_id = None
-
-                    for line in content.split("\n"):
-                        if line.startswith("processor"):
-                            # Extract logical processor ID
-                            current_physical_id = None
-                        elif line.startswith("physical id"):
-                            # Extract physical ID for current processor
-                            match = re.search(r"physical id\s*:\s*(\d+)", line)
-                            if match:
-                                current_physical_id = int(match.group(1))
-                                physical_ids.add(current_physical_id)
-
-                    if physical_ids:
-                        return physical_ids
-        except (OSError, IOError, ValueError):
-            pass
-
-        return None
+        physical_ids, _ = _read_cpuinfo()
+        return set(physical_ids) if physical_ids else None
 
     def _get_processor_to_physical_id_map(self) -> Optional[Dict[int, int]]:
         """
         Get mapping from logical processor ID to physical ID from /proc/cpuinfo.
         Returns dict mapping processor ID -> physical ID.
         """
-        try:
-            cpuinfo_path = Path("/proc/cpuinfo")
-            if cpuinfo_path.exists():
-                with open(cpuinfo_path, "r", encoding="utf-8") as f:
-                    content = f.read()
-                    processor_to_physical = {}
-                    current_processor = None
-
-                    for line in content.split("\n"):
-                        if line.startswith("processor"):
-                            # Extract logical processor ID
-                            match = re.search(r"processor\s*:\s*(\d+)", line)
-                            if match:
-                                current_processor = int(match.group(1))
-                        elif line.startswith("physical id") and current_processor is not None:
-                            # Extract physical ID for current processor
-                            match = re.search(r"physical id\s*:\s*(\d+)", line)
-                            if match:
-                                physical_id = int(match.group(1))
-                                processor_to_physical[current_processor] = physical_id
-
-                    if processor_to_physical:
-                        return processor_to_physical
-        except (OSError, IOError, ValueError):
-            pass
-
-        return None
+        _, processor_to_physical = _read_cpuinfo()
+        return dict(processor_to_physical) if processor_to_physical else None
 
     def _get_system_cpu_count(self) -> Optional[int]:
         """Get the actual CPU count from /proc/cpuinfo."""
@@ -172,21 +380,7 @@ class MultikernelValidator:
 
     def _get_system_physical_memory(self) -> Optional[int]:
         """Get total physical memory in bytes from /proc/meminfo."""
-        try:
-            meminfo_path = Path("/proc/meminfo")
-            if meminfo_path.exists():
-                with open(meminfo_path, "r", encoding="utf-8") as f:
-                    for line in f:
-                        if line.startswith("MemTotal:"):
-                            # Format: "MemTotal:       16384000 kB"
-                            match = re.search(r"MemTotal:\s*(\d+)\s*kB", line)
-                            if match:
-                                # Convert from kB to bytes
-                                return int(match.group(1)) * 1024
-        except (OSError, IOError, ValueError):
-            pass
-
-        return None
+        return _read_mem_total()
 
     def _get_multikernel_memory_pool_from_iomem(self) -> Optional[Tuple[int, int]]:
         """
@@ -195,24 +389,7 @@ class MultikernelValidator:
 
         Expected format: "40000000-7fefffff : Multikernel Memory Pool"
         """
-        try:
-            iomem_path = Path("/proc/iomem")
-            if not iomem_path.exists():
-                return None
-            with open(iomem_path, "r", encoding="utf-8") as f:
-                for line in f:
-                    if "multikernel" in line.lower():
-                        match = re.search(r"([0-9a-fA-F]+)-([0-9a-fA-F]+)", line)
-                        if match:
-                            base = int(match.group(1), 16)
-                            end = int(match.group(2), 16)
-                            # Size is end - start + 1 (inclusive range)
-                            size = end - base + 1
-                            return (base, size)
-        except (OSError, IOError, ValueError):
-            pass
-
-        return None
+        return _read_iomem_pool()
 
     def _validate_hardware_inventory(self, tree: GlobalDeviceTree):
         """Validate hardware inventory consistency and against running system."""
@@ -351,6 +528,20 @@ class MultikernelValidator:
 
     def _validate_cpu_allocation(self, instance, tree: GlobalDeviceTree):
         """Validate CPU allocation for an instance."""
+        self._validate_cpu_bounds(instance, tree)
+
+        instance_cpus = set(instance.resources.cpus)
+        for other_name, other_instance in tree.instances.items():
+            if other_name == instance.name:
+                continue
+
+            other_cpus = set(other_instance.resources.cpus)
+            overlap = instance_cpus.intersection(other_cpus)
+            if overlap:
+                self._report_cpu_overlap(instance, other_name, overlap, other_cpus, tree)
+
+    def _validate_cpu_bounds(self, instance, tree: GlobalDeviceTree):
+        """Validate an instance's CPUs exist and are not reserved for the host."""
         cpus = tree.hardware.cpus
         instance_cpus = set(instance.resources.cpus)
 
@@ -382,32 +573,45 @@ class MultikernelValidator:
             )
             self.errors.append(error_msg)
 
+    def _report_cpu_overlap(self, instance, other_name: str, overlap: set, other_cpus: set,
+                            tree: GlobalDeviceTree):
+        """Record that instance shares the CPUs in overlap with other_name."""
+        instance_cpus = set(instance.resources.cpus)
+        error_msg = self._format_error_with_context(
+            error_type="CPU allocation conflict",
+            instance_name=instance.name,
+            problem=f"CPU overlap with instance '{other_name}'",
+            current_state=f"Both instances use CPUs: {sorted(overlap)}",
+            suggestion=f"Assign different CPUs to {instance.name} or {other_name}",
+            alternative="Use CPU ranges instead of individual CPUs",
+            pattern=f"cpus = <{','.join(map(str, sorted(instance_cpus)))}>",
+        )
+        self.errors.append(error_msg)
+        # Add suggestions
+        available_cpus = set(tree.hardware.cpus.available) - instance_cpus - other_cpus
+        if available_cpus:
+            self.suggestions.append(
+                f"Consider using available CPUs: {sorted(list(available_cpus)[:len(overlap)])}"
+            )
+
+    def _validate_memory_allocation(self, instance, tree: GlobalDeviceTree):
+        """Validate memory allocation for an instance."""
+        self._validate_memory_bounds(instance, tree)
+
+        memory_start = instance.resources.memory_base
+        memory_end = memory_start + instance.resources.memory_bytes
         for other_name, other_instance in tree.instances.items():
             if other_name == instance.name:
                 continue
 
-            other_cpus = set(other_instance.resources.cpus)
-            overlap = instance_cpus.intersection(other_cpus)
-            if overlap:
-                error_msg = self._format_error_with_context(
-                    error_type="CPU allocation conflict",
-                    instance_name=instance.name,
-                    problem=f"CPU overlap with instance '{other_name}'",
-                    current_state=f"Both instances use CPUs: {sorted(overlap)}",
-                    suggestion=f"Assign different CPUs to {instance.name} or {other_name}",
-                    alternative="Use CPU ranges instead of individual CPUs",
-                    pattern=f"cpus = <{','.join(map(str, sorted(instance_cpus)))}>",
-                )
-                self.errors.append(error_msg)
-                # Add suggestions
-                available_cpus = set(cpus.available) - instance_cpus - other_cpus
-                if available_cpus:
-                    self.suggestions.append(
-                        f"Consider using available CPUs: {sorted(list(available_cpus)[:len(overlap)])}"
-                    )
+            other_start = other_instance.resources.memory_base
+            other_end = other_start + other_instance.resources.memory_bytes
 
-    def _validate_memory_allocation(self, instance, tree: GlobalDeviceTree):
-        """Validate memory allocation for an instance."""
+            if not (memory_end <= other_start or other_end <= memory_start):
+                self._report_memory_overlap(instance, other_name, other_start, other_end)
+
+    def _validate_memory_bounds(self, instance, tree: GlobalDeviceTree):
+        """Validate an instance's memory lies page-aligned within the memory pool."""
         memory = tree.hardware.memory
         instance_memory = instance.resources
 
@@ -447,24 +651,20 @@ class MultikernelValidator:
                 f"  Suggestion: Use base address {hex((memory_start // 0x1000) * 0x1000)}"
             )
 
-        for other_name, other_instance in tree.instances.items():
-            if other_name == instance.name:
-                continue
-
-            other_start = other_instance.resources.memory_base
-            other_end = other_start + other_instance.resources.memory_bytes
-
-            if not (memory_end <= other_start or other_end <= memory_start):
-                overlap_start = max(memory_start, other_start)
-                overlap_end = min(memory_end, other_end)
-                overlap_size = overlap_end - overlap_start
-
-                self.errors.append(
-                    f"Instance {instance.name} and {other_name}: Memory region overlap detected\n"
-                    f"  {instance.name} memory: {hex(memory_start)} - {hex(memory_end)}\n"
-                    f"  {other_name} memory: {hex(other_start)} - {hex(other_end)}\n"
-                    f"  Overlapping region: {hex(overlap_start)} - {hex(overlap_end)} ({overlap_size} bytes)"
-                )
+    def _report_memory_overlap(self, instance, other_name: str, other_start: int, other_end: int):
+        """Record that instance's memory overlaps other_name's."""
+        memory_start = instance.resources.memory_base
+        memory_end = memory_start + instance.resources.memory_bytes
+        overlap_start = max(memory_start, other_start)
+        overlap_end = min(memory_end, other_end)
+        overlap_size = overlap_end - overlap_start
+
+        self.errors.append(
+            f"Instance {instance.name} and {other_name}: Memory region overlap detected\n"
+            f"  {instance.name} memory: {hex(memory_start)} - {hex(memory_end)}\n"
+            f"  {other_name} memory: {hex(other_start)} - {hex(other_end)}\n"
+            f"  Overlapping region: {hex(overlap_start)} - {hex(overlap_end)} ({overlap_size} bytes)"
+        )
 
     def _validate_device_allocation(self, instance, tree: GlobalDeviceTree):
         """Validate device allocation for an instance."""
@@ -534,6 +734,11 @@ class MultikernelValidator:
             total_cpus_allocated += len(instance.resources.cpus)
             total_memory_allocated += instance.resources.memory_bytes
 
+        self._validate_resource_totals(total_cpus_allocated, total_memory_allocated, tree)
+
+    def _validate_resource_totals(self, total_cpus_allocated: int, total_memory_allocated: int,
+                                  tree: GlobalDeviceTree):
+        """Validate allocation totals against the CPUs and memory pool available."""
         available_cpus = len(tree.hardware.cpus.available)
         if total_cpus_allocated > available_cpus:
             self.errors.append(
@@ -591,7 +796,11 @@ class MultikernelValidator:
         total_memory_allocated = sum(
             instance.resources.memory_bytes for instance in tree.instances.values()
         )
+        return self._resource_usage(total_cpus_allocated, total_memory_allocated, tree)
 
+    def _resource_usage(self, total_cpus_allocated: int, total_memory_allocated: int,
+                        tree: GlobalDeviceTree) -> ResourceUsage:
+        """Resource usage summary from allocation totals."""
         return ResourceUsage(
             cpus_allocated=total_cpus_allocated,
             cpus_total=len(tree.hardware.cpus.available),
@@ -625,6 +834,8 @@ class MultikernelValidator:
             self._validate_numa_constraints(instance, tree)
         if resources.cpu_affinity:
             self._validate_cpu_affinity_constraints(instance, tree)
+        if tree.hardware.cpus.topology:
+            self._validate_smt_isolation(instance, tree)
         if resources.memory_policy:
             self._validate_memory_policy_constraints(instance, tree)
 
@@ -663,6 +874,60 @@ class MultikernelValidator:
             self._validate_spread_affinity(instance, tree)
         elif resources.cpu_affinity == "local":
             self._validate_local_affinity(instance, tree)
+        elif resources.cpu_affinity == "llc-compact":
+            self._validate_llc_compact_affinity(instance, tree)
+
+    def _validate_llc_compact_affinity(self, instance, tree: GlobalDeviceTree):
+        """Validate llc-compact CPU affinity (CPUs in as few LLC domains as possible)."""
+        topology = tree.hardware.cpus.topology
+        if not topology:
+            return
+
+        llc_ids = {
+            topology[cpu].llc_id for cpu in instance.resources.cpus
+            if cpu in topology and topology[cpu].llc_id is not None
+        }
+        if len(llc_ids) > 1:
+            self.warnings.append(
+                f"Instance {instance.name}: LLC-compact CPU affinity requested but CPUs span "
+                f"{len(llc_ids)} last-level cache domains: {sorted(llc_ids)}"
+            )
+
+    def _validate_smt_isolation(self, instance, tree: GlobalDeviceTree):
+        """Reject SMT siblings shared with or by a no-smt-share instance."""
+        topology = tree.hardware.cpus.topology
+        own = set(instance.resources.cpus)
+        isolated = instance.resources.cpu_affinity == "no-smt-share"
+
+        siblings = set()
+        for cpu in own:
+            if cpu in topology:
+                siblings.update(topology[cpu].siblings)
+        siblings -= own
+        if not siblings:
+            return
+
+        for other in tree.instances.values():
+            if other.name == instance.name:
+                continue
+            if not isolated and other.resources.cpu_affinity != "no-smt-share":
+                continue
+            shared = siblings.intersection(other.resources.cpus)
+            if not shared:
+                continue
+
+            # Both instances see the conflict; report it once
+            first, second = sorted((instance.name, other.name))
+            cores = shared | {
+                cpu for cpu in own
+                if cpu in topology and shared.intersection(topology[cpu].siblings)
+            }
+            error = (
+                f"Instances {first} and {second} share SMT cores (APIC IDs {sorted(cores)}), "
+                f"but no-smt-share CPU affinity forbids sibling threads across instances"
+            )
+            if error not in self.errors:
+                self.errors.append(error)
 
     def _validate_compact_affinity(self, instance, tree: GlobalDeviceTree):
         """Validate compact CPU affinity."""
@@ -0,0 +1,278 @@
+# Copyright 2026 Multikernel Technologies, Inc.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""
+Booting many instances from one process, for `kerf exec --all/--ids`.
+
+Instances boot in waves. The wave's consoles are attached first, since
+output printed before attaching is lost, then every reboot syscall of the
+wave is issued at once from its own thread, each bracketed by TSC reads.
+The consoles are watched for kerf-init's "exec" timing record, and the
+next wave starts once all of them have reached their entrypoint (or timed
+out).
+
+Per instance this gives the syscall duration and the time from syscall
+return to the entrypoint. Within a wave, syscalls whose durations add up
+to the wave's syscall span did not overlap: the kernel serialized them.
+"""
+
+import os
+import select
+import time
+from concurrent.futures import ThreadPoolExecutor
+from dataclasses import dataclass
+from pathlib import Path
+from typing import Callable, Dict, List, Optional, Tuple
+
+import rdtsc
+
+from ..console.main import connect_console
+from ..models import InstanceState
+from ..timing import InitTimingScanner, record_exec_tsc, record_init_timing
+from ..utils import get_instance_id_from_name, get_instance_status
+
+INSTANCES_DIR = "/sys/fs/multikernel/instances"
+
+# Seconds to wait for a wave's instances to reach their entrypoint
+FANOUT_DEFAULT_TIMEOUT = 30.0
+
+
+@dataclass
+class BootResult:
+    """TSC stamps of one instance's boot; error is None when the syscall succeeded."""
+    name: str
+    instance_id: int
+    wave: int
+    call_tsc: int = 0
+    return_tsc: int = 0
+    entry_tsc: Optional[int] = None
+    error: Optional[str] = None
+
+    def syscall_ms(self, khz: float) -> float:
+        """Time spent inside the reboot syscall."""
+        return (self.return_tsc - self.call_tsc) / khz
+
+    def entry_ms(self, khz: float) -> Optional[float]:
+        """Time from syscall return to kerf-init executing the entrypoint."""
+        if self.entry_tsc is None:
+            return None
+        return (self.entry_tsc - self.return_tsc) / khz
+
+
+def parse_id_list(spec: str) -> List[int]:
+    """
+    Parse an instance ID list such as "1-8,12" into sorted IDs.
+
+    Raises:
+        ValueError: If the list is malformed or an ID is outside 1-511
+    """
+    ids = set()
+    for part in spec.split(","):
+        part = part.strip()
+        try:
+            if "-" in part:
+                start, end = (int(x) for x in part.split("-", 1))
+            else:
+                start = end = int(part)
+        except ValueError as e:
+            raise ValueError(f"invalid instance ID range '{part}'") from e
+        if start > end or start < 1 or end > 511:
+            raise ValueError(f"instance IDs must be ascending and within 1-511 (got '{part}')")
+        ids.update(range(start, end + 1))
+    return sorted(ids)
+
+
+def loaded_instances(ids: Optional[List[int]] = None) -> Tuple[List[Tuple[str, int]], List[str]]:
+    """
+    Find instances with a kernel loaded, optionally restricted to ids.
+
+    Returns:
+        (name, id) pairs sorted by ID, and errors for requested IDs that
+        do not exist or have no kernel loaded
+    """
+    found = {}
+    instances_dir = Path(INSTANCES_DIR)
+    if instances_dir.exists():
+        for inst_dir in instances_dir.iterdir():
+            if inst_dir.is_dir() and not inst_dir.name.startswith("."):
+                instance_id = get_instance_id_from_name(inst_dir.name)
+                if instance_id is not None:
+                    found[instance_id] = inst_dir.name
+
+    selected, errors = [], []
+    for instance_id in (ids if ids is not None else sorted(found)):
+        name = found.get(instance_id)
+        if name is None:
+            errors.append(f"Instance with ID {instance_id} not found")
+            continue
+        status = (get_instance_status(name) or "").lower()
+        if status != InstanceState.LOADED.value:
+            if ids is not None:
+                errors.append(f"Instance '{name}' (ID: {instance_id}) is '{status}', not loaded")
+            continue
+        selected.append((name, instance_id))
+    return selected, errors
+
+
+def _open_console(instance_id: int) -> int:
+    """Connect to an instance's mktty console for reading."""
+    return connect_console(instance_id)
+
+
+def _boot_one(result: BootResult, boot: Callable[[int], int]) -> None:
+    result.call_tsc = rdtsc.get_cycles()
+    try:
+        boot(result.instance_id)
+    except OSError as e:
+        result.error = f"reboot syscall failed: {e}"
+    result.return_tsc = rdtsc.get_cycles()
+
+
+def _save_records(result: BootResult, scanner: InitTimingScanner) -> None:
+    if "exec" in scanner.records:
+        result.entry_tsc = scanner.records["exec"]
+    if scanner.records:
+        try:
+            record_init_timing(result.name, scanner.records)
+        except OSError:
+            pass
+
+
+def _open_consoles(results: List[BootResult]) -> Dict[int, BootResult]:
+    """Attach to the consoles of a wave about to boot, by console fd."""
+    consoles = {}
+    for result in results:
+        try:
+            consoles[_open_console(result.instance_id)] = result
+        except OSError:
+            # No console: the boot goes ahead, its latency is just unknown
+            continue
+    return consoles
+
+
+def _watch_entrypoints(consoles: Dict[int, BootResult], timeout: float) -> None:
+    """Read the booted instances' consoles until each logs its "exec" record; closes them."""
+    scanners = {fd: (result, InitTimingScanner()) for fd, result in consoles.items()}
+    deadline = time.monotonic() + timeout
+    try:
+        while scanners:
+            remaining = deadline - time.monotonic()
+            if remaining <= 0:
+                break
+            readable, _, _ = select.select(list(scanners), [], [], remaining)
+            for fd in readable:
+                result, scanner = scanners[fd]
+                try:
+                    data = os.read(fd, 4096)
+                except OSError:
+                    data = b""
+                # Keep reading until the entrypoint starts or the console closes
+                if data and (not scanner.feed(data) or "exec" not in scanner.records):
+                    continue
+                del scanners[fd]
+                os.close(fd)
+                _save_records(result, scanner)
+    finally:
+        for fd, (result, scanner) in scanners.items():
+            os.close(fd)
+            _save_records(result, scanner)
+
+
+def boot_instances(
+    instances: List[Tuple[str, int]],
+    boot: Callable[[int], int],
+    wave_size: Optional[int] = None,
+    timeout: float = FANOUT_DEFAULT_TIMEOUT,
+    watch: bool = True,
+) -> List[BootResult]:
+    """
+    Boot instances in waves of wave_size (default: all in one wave).
+
+    Args:
+        instances: (name, id) pairs, booted in this order
+        boot: The reboot syscall, boot_multikernel(mk_id)
+        wave_size: Instances booted concurrently before waiting on them
+        timeout: Seconds to wait for each wave's entrypoints
+        watch: Read consoles for kerf-init's "exec" record
+
+    Returns:
+        One BootResult per instance, in order
+    """
+    wave_size = wave_size or len(instances) or 1
+    results = []
+    for start in range(0, len(instances), wave_size):
+        wave = [
+            BootResult(name, instance_id, start // wave_size + 1)
+            for name, instance_id in instances[start:start + wave_size]
+        ]
+        consoles = _open_consoles(wave) if watch else {}
+        try:
+            with ThreadPoolExecutor(max_workers=len(wave)) as pool:
+                list(pool.map(lambda result: _boot_one(result, boot), wave))
+        except BaseException:
+            for fd in consoles:
+                os.close(fd)
+            raise
+
+        for fd, result in list(consoles.items()):
+            if result.error:
+                os.close(fd)
+                del consoles[fd]
+        booted = [result for result in wave if not result.error]
+        # Recorded after the wave so file writes stay out of the syscalls
+        for result in booted:
+            try:
+                record_exec_tsc(result.name, result.call_tsc)
+            except OSError:
+                pass
+        if consoles:
+            _watch_entrypoints(consoles, timeout)
+        results.extend(wave)
+    return results
+
+
+def format_fanout(results: List[BootResult], khz: float) -> List[str]:
+    """Format per-instance boot latencies and a summary line per wave."""
+    if not results:
+        return []
+
+    width = max(len("INSTANCE"), max(len(r.name) for r in results))
+    lines = [f"{'INSTANCE':<{width}}  {'ID':>3}  {'WAVE':>4}  {'SYSCALL':>11}  {'TO ENTRYPOINT':>14}"]
+    for r in results:
+        if r.error:
+            lines.append(f"{r.name:<{width}}  {r.instance_id:>3}  {r.wave:>4}  {r.error}")
+            continue
+        entry = r.entry_ms(khz)
+        entry_str = f"{entry:11.3f} ms" if entry is not None else "no record"
+        lines.append(
+            f"{r.name:<{width}}  {r.instance_id:>3}  {r.wave:>4}  "
+            f"{r.syscall_ms(khz):8.3f} ms  {entry_str:>14}"
+        )
+
+    for wave in sorted({r.wave for r in results}):
+        booted = [r for r in results if r.wave == wave and not r.error]
+        if not booted:
+            continue
+        first = min(r.call_tsc for r in booted)
+        span = (max(r.return_tsc for r in booted) - first) / khz
+        summed = sum(r.syscall_ms(khz) for r in booted)
+        line = (
+            f"wave {wave}: {len(booted)} booted, syscalls spanned {span:.3f} ms "
+            f"({summed:.3f} ms summed)"
+        )
+        entries = [r.entry_tsc for r in booted if r.entry_tsc is not None]
+        if entries:
+            line += f", last entrypoint {(max(entries) - first) / khz:.3f} ms after first syscall"
+        lines.append(line)
+    return lines
@@ -27,7 +27,11 @@ import click
 import rdtsc
 
 from ..models import InstanceState
+from ..timing import record_exec_tsc, tsc_khz
 from ..utils import get_instance_id_from_name
+from .fanout import (
+    FANOUT_DEFAULT_TIMEOUT, boot_instances, format_fanout, loaded_instances, parse_id_list,
+)
 
 
 LINUX_REBOOT_MAGIC1 = 0xFEE1DEAD
@@ -100,12 +104,60 @@ def boot_multikernel(mk_id: int) -> int:
     return result
 
 
+def _exec_fanout(ids: Optional[str], wave: Optional[int], timeout: float, verbose: bool) -> int:
+    """Boot many instances for `kerf exec --all/--ids`; return the exit code."""
+    try:
+        id_list = parse_id_list(ids) if ids else None
+    except ValueError as e:
+        click.echo(f"Error: --ids: {e}", err=True)
+        return 2
+
+    instances, errors = loaded_instances(id_list)
+    for error in errors:
+        click.echo(f"Error: {error}", err=True)
+    if not instances:
+        click.echo("Error: No instances with a kernel loaded to boot", err=True)
+        return 1
+
+    if verbose:
+        click.echo(f"Booting {len(instances)} instances in waves of {wave or len(instances)}")
+    results = boot_instances(instances, boot_multikernel, wave_size=wave, timeout=timeout)
+
+    for line in format_fanout(results, tsc_khz()):
+        click.echo(line)
+    return 1 if errors or any(r.error for r in results) else 0
+
+
 @click.command(name="exec")
 @click.argument("name", required=False)
 @click.option("--id", type=int, help="Multikernel instance ID to boot (alternative to name)")
 @click.option("--console", "attach_console", is_flag=True, help="Attach to console after boot")
+@click.option("--all", "boot_all", is_flag=True, help="Boot every instance with a kernel loaded")
+@click.option("--ids", help="Boot the loaded instances with these IDs, e.g. 1-32")
+@click.option(
+    "--wave",
+    type=click.IntRange(min=1),
+    help="With --all/--ids, boot this many at once and wait for their entrypoints "
+         "before the next wave (default: all at once)",
+)
+@click.option(
+    "--timeout",
+    type=click.FloatRange(min=0),
+    default=FANOUT_DEFAULT_TIMEOUT,
+    show_default=True,
+    help="With --all/--ids, seconds to wait for each wave to reach its entrypoints",
+)
 @click.option("--verbose", "-v", is_flag=True, help="Verbose output")
-def exec_cmd(name: Optional[str], id: Optional[int], attach_console: bool, verbose: bool):
+def exec_cmd(  # pylint: disable=too-many-arguments,too-many-positional-arguments
+    name: Optional[str],
+    id: Optional[int],
+    attach_console: bool,
+    boot_all: bool,
+    ids: Optional[str],
+    wave: Optional[int],
+    timeout: float,
+    verbose: bool,
+):
     """
     Boot a multikernel instance using the reboot syscall.
 
@@ -115,13 +167,27 @@ def exec_cmd(name: Optional[str], id: Optional[int], attach_console: bool, verbo
     Use --console to immediately attach to the instance's console after boot.
     Press Ctrl+] followed by . to detach from the console.
 
+    With --all or --ids, many instances are booted from one process and each
+    one's time from syscall return to its kerf-init entrypoint is reported.
+
     Examples:
 
         kerf exec web-server
         kerf exec --id=1
         kerf exec web-server --console
+        kerf exec --all
+        kerf exec --ids=1-32 --wave=8
     """
     try:
+        if boot_all or ids:
+            if name or id is not None or attach_console or (boot_all and ids):
+                click.echo(
+                    "Error: --all/--ids cannot be combined with a name, --id, --console "
+                    "or each other", err=True
+                )
+                sys.exit(2)
+            sys.exit(_exec_fanout(ids, wave, timeout, verbose))
+
         if not name and id is None:
             click.echo("Error: Either instance name or --id must be provided", err=True)
             click.echo("Usage: kerf exec <name>  or  kerf exec --id=<id>", err=True)
@@ -211,13 +277,23 @@ def exec_cmd(name: Optional[str], id: Optional[int], attach_console: bool, verbo
             click.echo(f"✓ Kernel image found for instance '{instance_name}'")
             click.echo(f"Instance ID to boot: {instance_id}")
             click.echo(f"Using reboot syscall with command: 0x{LINUX_REBOOT_CMD_MULTIKERNEL:x}")
-            tsc = rdtsc.get_cycles()
-            click.echo(f"Calling reboot syscall at TSC {tsc}")
         else:
             click.echo(f"Booting instance '{instance_name}' (ID: {instance_id})...")
 
+        tsc = rdtsc.get_cycles()
         result = boot_multikernel(instance_id)
 
+        # Recorded after the syscall so the file write stays out of the
+        # measured kexec latency; `kerf show --timing` reads it back
+        try:
+            record_exec_tsc(instance_name, tsc)
+        except OSError as e:
+            if verbose:
+                click.echo(f"Warning: could not record boot timing: {e}", err=True)
+
+        if verbose:
+            click.echo(f"Called reboot syscall at TSC {tsc}")
+
         if verbose:
             click.echo(f"✓ Boot command executed successfully (result: {result})")
         else:
@@ -0,0 +1,136 @@
+# Copyright 2026 Multikernel Technologies, Inc.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""
+Host-side reader for kerf-init's status record.
+
+kerf-init keeps a small record of its services' state (booting, running,
+exited, restarting), exit codes and a heartbeat in the KERF_STATUS_FILE
+page of its daxfs image, written through /dev/mem at kerf.status=<phys>.
+The host reads the same page back through its own daxfs mount of the
+image, so `kerf show` and fleet controllers see it without a console.
+
+The record layout matches struct status_record in src/init/init.c.
+"""
+
+import os
+import struct
+from dataclasses import dataclass
+from pathlib import Path
+from typing import List, Optional
+
+from .daxfs.mkdaxfs import KERF_DAXFS_MNT_DIR, KERF_STATUS_FILE
+
+STATUS_MAGIC = 0x7366726b  # "krfs"
+STATUS_VERSION = 1
+STATUS_MAX_SERVICES = 8
+
+# magic, version, seq, nr_services, boot_tsc, update_tsc, heartbeats, reserved
+_HEADER = struct.Struct('<IIIIQQQQ')
+# state, exit_status, pid, restarts
+_SERVICE = struct.Struct('<IiII')
+_SEQ_OFFSET = 8
+STATUS_RECORD_SIZE = _HEADER.size + STATUS_MAX_SERVICES * _SERVICE.size
+
+SERVICE_STATES = {1: "booting", 2: "running", 3: "exited", 4: "restarting"}
+
+# Attempts at a consistent read while kerf-init is mid-update
+_READ_RETRIES = 100
+
+
+@dataclass
+class ServiceStatus:
+    """State of one kerf-init service."""
+    state: str
+    exit_status: int
+    pid: int
+    restarts: int
+
+
+@dataclass
+class InstanceHealth:
+    """A consistent snapshot of an instance's status record."""
+    boot_tsc: int
+    update_tsc: int
+    heartbeats: int
+    services: List[ServiceStatus]
+
+    @property
+    def state(self) -> str:
+        """Overall state: the first service that is not running, else running."""
+        for svc in self.services:
+            if svc.state != "running":
+                return svc.state
+        return "running" if self.services else "booting"
+
+    def age_seconds(self, now_tsc: int, khz: float) -> float:
+        """Seconds since kerf-init last updated the record (TSC is shared)."""
+        return max(now_tsc - self.update_tsc, 0) / (khz * 1000)
+
+
+def parse_status(data: bytes) -> Optional[InstanceHealth]:
+    """
+    Decode a status record.
+
+    Returns:
+        InstanceHealth, or None if kerf-init has not written the record
+    """
+    if len(data) < STATUS_RECORD_SIZE:
+        return None
+
+    (magic, version, _, nr_services, boot_tsc, update_tsc, heartbeats,
+     _) = _HEADER.unpack_from(data, 0)
+    if magic != STATUS_MAGIC or version != STATUS_VERSION:
+        return None
+
+    services = []
+    for i in range(min(nr_services, STATUS_MAX_SERVICES)):
+        state, exit_status, pid, restarts = _SERVICE.unpack_from(
+            data, _HEADER.size + i * _SERVICE.size
+        )
+        services.append(ServiceStatus(
+            SERVICE_STATES.get(state, "unknown"), exit_status, pid, restarts
+        ))
+    return InstanceHealth(boot_tsc, update_tsc, heartbeats, services)
+
+
+def read_status_file(path: Path) -> Optional[InstanceHealth]:
+    """
+    Read a status record, retrying reads that raced with an update.
+
+    kerf-init makes seq odd while it writes, so a copy is consistent when
+    its seq is even and unchanged once the copy was taken.
+    """
+    try:
+        fd = os.open(path, os.O_RDONLY | os.O_CLOEXEC)
+    except OSError:
+        return None
+
+    try:
+        for _ in range(_READ_RETRIES):
+            data = os.pread(fd, STATUS_RECORD_SIZE, 0)
+            if len(data) < STATUS_RECORD_SIZE:
+                return None
+            seq = struct.unpack_from('<I', data, _SEQ_OFFSET)[0]
+            after = struct.unpack('<I', os.pread(fd, 4, _SEQ_OFFSET))[0]
+            if seq % 2 == 0 and seq == after:
+                return parse_status(data)
+        return None
+    finally:
+        os.close(fd)
+
+
+def read_instance_health(instance_name: str) -> Optional[InstanceHealth]:
+    """Read the status record of an instance booted from a daxfs image."""
+    return read_status_file(Path(KERF_DAXFS_MNT_DIR) / instance_name / KERF_STATUS_FILE)
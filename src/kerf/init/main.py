@@ -25,7 +25,7 @@ import os
 import re
 import sys
 from pathlib import Path
-from typing import Optional, Tuple
+from typing import Dict, Iterable, List, Optional, Tuple
 
 import click
 import libfdt
@@ -43,14 +43,21 @@ from ..dtc.validator import MultikernelValidator
 from ..exceptions import KernelInterfaceError, ParseError, ValidationError
 from ..models import (
     CPUAllocation,
+    CPUTopology,
     DeviceInfo,
     GlobalDeviceTree,
     HardwareInventory,
     MemoryAllocation,
+    NUMANode,
+    TopologySection,
 )
 
 
 MULTIKERNEL_MOUNT_POINT = "/sys/fs/multikernel"
+CPU_SYSFS_DIR = "/sys/devices/system/cpu"
+NODE_SYSFS_DIR = "/sys/devices/system/node"
+MEMORY_SYSFS_DIR = "/sys/devices/system/memory"
+CPUINFO_PATH = "/proc/cpuinfo"
 
 def is_multikernel_mounted() -> bool:
     mount_point = Path(MULTIKERNEL_MOUNT_POINT)
@@ -375,6 +382,196 @@ def get_valid_apic_ids_from_system() -> Optional[set]:
     return None
 
 
+def _read_sysfs_int(path: Path) -> Optional[int]:
+    try:
+        return int(path.read_text(encoding='utf-8').strip())
+    except (OSError, ValueError):
+        return None
+
+
+def _read_sysfs_cpu_list(path: Path) -> List[int]:
+    try:
+        return parse_cpu_spec(path.read_text(encoding='utf-8'))
+    except (OSError, ValueError):
+        return []
+
+
+def _parse_cache_size(size: str) -> Optional[int]:
+    """Parse a sysfs cache size such as "32K" or "32768K" into KiB."""
+    size = size.strip().upper()
+    multiplier = 1
+    if size.endswith('K'):
+        size = size[:-1]
+    elif size.endswith('M'):
+        size, multiplier = size[:-1], 1024
+    try:
+        return int(size) * multiplier
+    except ValueError:
+        return None
+
+
+def get_logical_to_apic_map() -> Dict[int, int]:
+    """
+    Map logical CPU numbers to APIC IDs via /proc/cpuinfo.
+    Returns an empty dict if /proc/cpuinfo cannot be read.
+    """
+    mapping = {}
+    processor = None
+    try:
+        with open(CPUINFO_PATH, 'r', encoding='utf-8') as f:
+            for line in f:
+                key, _, value = line.partition(':')
+                key = key.strip()
+                try:
+                    if key == 'processor':
+                        processor = int(value)
+                    elif key == 'apicid' and processor is not None:
+                        mapping[processor] = int(value)
+                except ValueError:
+                    pass
+    except OSError:
+        pass
+
+    return mapping
+
+
+def _read_llc(cpu_dir: Path) -> Tuple[Optional[int], List[int]]:
+    """
+    Read a logical CPU's cache hierarchy.
+
+    Returns:
+        (last-level cache id, data/unified cache sizes in KiB by level)
+    """
+    llc_level = -1
+    llc_id = None
+    sizes = {}
+    for index in sorted((cpu_dir / 'cache').glob('index[0-9]*')):
+        try:
+            cache_type = (index / 'type').read_text(encoding='utf-8').strip()
+            level = int((index / 'level').read_text(encoding='utf-8'))
+        except (OSError, ValueError):
+            continue
+        if cache_type == 'Instruction':
+            continue
+        try:
+            size = _parse_cache_size((index / 'size').read_text(encoding='utf-8'))
+        except OSError:
+            size = None
+        if size is not None:
+            sizes[level] = size
+        if level > llc_level:
+            llc_level = level
+            llc_id = _read_sysfs_int(index / 'id')
+            if llc_id is None:
+                # Older kernels have no cache id; the first sharing CPU names the domain
+                shared = _read_sysfs_cpu_list(index / 'shared_cpu_list')
+                llc_id = min(shared) if shared else None
+
+    return llc_id, [sizes[level] for level in sorted(sizes)]
+
+
+def detect_cpu_topology(apic_ids: Iterable[int]) -> Optional[Dict[int, CPUTopology]]:
+    """
+    Detect core, SMT sibling and last-level cache topology from sysfs.
+
+    Reads /sys/devices/system/cpu/cpuN/topology and cpuN/cache for every
+    online CPU whose APIC ID is in apic_ids. Sibling lists are kept as APIC
+    IDs. CPUs that are offline in the host have no topology in sysfs and are
+    left out, so allocation treats them as having no known neighbours.
+
+    Returns:
+        APIC ID -> CPUTopology, or None if nothing could be read
+    """
+    wanted = set(apic_ids)
+    logical_to_apic = get_logical_to_apic_map()
+    cpu_root = Path(CPU_SYSFS_DIR)
+
+    topology = {}
+    for logical, apic_id in sorted(logical_to_apic.items()):
+        if apic_id not in wanted:
+            continue
+        cpu_dir = cpu_root / f'cpu{logical}'
+        core_id = _read_sysfs_int(cpu_dir / 'topology' / 'core_id')
+        socket_id = _read_sysfs_int(cpu_dir / 'topology' / 'physical_package_id')
+        if core_id is None or socket_id is None:
+            continue
+
+        thread_siblings = _read_sysfs_cpu_list(cpu_dir / 'topology' / 'thread_siblings_list')
+        siblings = sorted(logical_to_apic[cpu] for cpu in thread_siblings if cpu in logical_to_apic)
+        if apic_id not in siblings:
+            siblings = sorted(siblings + [apic_id])
+
+        numa_node = 0
+        for node_dir in cpu_dir.glob('node[0-9]*'):
+            numa_node = int(node_dir.name[4:])
+            break
+
+        llc_id, cache_levels = _read_llc(cpu_dir)
+        topology[apic_id] = CPUTopology(
+            cpu_id=apic_id,
+            numa_node=numa_node,
+            core_id=core_id,
+            thread_id=siblings.index(apic_id),
+            socket_id=socket_id,
+            cache_levels=cache_levels,
+            flags=['smt'] if len(siblings) > 1 else [],
+            llc_id=llc_id,
+            siblings=siblings,
+        )
+
+    return topology if topology else None
+
+
+def detect_numa_topology() -> Optional[TopologySection]:
+    """
+    Detect each NUMA node's memory window and CPUs from sysfs.
+
+    A node's window spans the memory blocks linked as
+    /sys/devices/system/node/nodeN/memoryM; block M starts at M times
+    /sys/devices/system/memory/block_size_bytes. Its CPUs are the APIC
+    IDs of the logical CPUs in nodeN/cpulist.
+
+    Returns:
+        TopologySection with one NUMANode per node, or None if sysfs has none
+    """
+    try:
+        block_size = int(
+            (Path(MEMORY_SYSFS_DIR) / 'block_size_bytes').read_text(encoding='utf-8'), 16
+        )
+    except (OSError, ValueError):
+        return None
+    logical_to_apic = get_logical_to_apic_map()
+
+    nodes = {}
+    for node_dir in Path(NODE_SYSFS_DIR).glob('node[0-9]*'):
+        try:
+            node_id = int(node_dir.name[4:])
+        except ValueError:
+            continue
+        blocks = []
+        for block in node_dir.glob('memory[0-9]*'):
+            try:
+                blocks.append(int(block.name[6:]))
+            except ValueError:
+                continue
+        memory_base = min(blocks) * block_size if blocks else 0
+        memory_end = (max(blocks) + 1) * block_size if blocks else 0
+        cpus = sorted(
+            logical_to_apic[cpu] for cpu in _read_sysfs_cpu_list(node_dir / 'cpulist')
+            if cpu in logical_to_apic
+        )
+        nodes[node_id] = NUMANode(
+            node_id=node_id,
+            memory_base=memory_base,
+            memory_size=memory_end - memory_base,
+            cpus=cpus,
+            distance_matrix={},
+            memory_type="dram",
+        )
+
+    return TopologySection(numa_nodes=nodes) if nodes else None
+
+
 def build_baseline_from_cmdline(
     cpus: str,
     devices: Optional[str] = None,
@@ -449,10 +646,34 @@ def build_baseline_from_cmdline(
         click.echo(f"  Total bytes: {total_bytes} bytes ({total_bytes / (1024**3):.2f} GB)")
         click.echo(f"  Host-reserved: {host_reserved_bytes} bytes ({host_reserved_bytes / (1024**3):.2f} GB)")
 
+    cpu_topology = detect_cpu_topology(cpu_list)
+    if verbose:
+        if cpu_topology:
+            llcs = {topo.llc_id for topo in cpu_topology.values() if topo.llc_id is not None}
+            smt = sum(1 for topo in cpu_topology.values() if len(topo.siblings) > 1)
+            click.echo(
+                f"CPU topology: {len(cpu_topology)} APIC IDs, {len(llcs)} LLC domain(s), "
+                f"{smt} with SMT siblings"
+            )
+        else:
+            click.echo("CPU topology: not available from sysfs")
+
+    numa_topology = detect_numa_topology()
+    if verbose:
+        if numa_topology:
+            for node_id, node in sorted(numa_topology.numa_nodes.items()):
+                click.echo(
+                    f"NUMA node {node_id}: memory {hex(node.memory_base)}-"
+                    f"{hex(node.memory_base + node.memory_size)}, {len(node.cpus)} APIC IDs"
+                )
+        else:
+            click.echo("NUMA topology: not available from sysfs")
+
     cpu_allocation = CPUAllocation(
         total=total_cpus,
         host_reserved=host_reserved_cpus,
-        available=cpu_list
+        available=cpu_list,
+        topology=cpu_topology
     )
 
     memory_allocation = MemoryAllocation(
@@ -490,6 +711,7 @@ def build_baseline_from_cmdline(
     hardware = HardwareInventory(
         cpus=cpu_allocation,
         memory=memory_allocation,
+        topology=numa_topology,
         devices=device_dict
     )
 
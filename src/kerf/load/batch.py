@@ -0,0 +1,422 @@
+# Copyright 2026 Multikernel Technologies, Inc.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""
+Loading many instances from one kernel image in a single process.
+
+load_instances() (and `kerf load --manifest`) opens the kernel and initrd
+once and passes the same fds to every kexec_file_load call. Rootfs images
+are pulled and written to daxfs concurrently, and the kexec calls are then
+issued back to back, so scaling a node out costs one process startup.
+
+A manifest is YAML (or JSON):
+
+    kernel: /boot/vmlinuz
+    cmdline: quiet              # prepended to every instance's cmdline
+    defaults:                   # keys applied to every instance
+      image: nginx:latest
+    instances:
+      - name: web-1
+        ip: 10.0.0.11
+      - name: web-2
+        ip: 10.0.0.12
+        cpus: 0-1
+
+Instance keys are the long `kerf load` options (rootfs-dir, huge-align,
+...), with `services` and `prefault` given as lists.
+"""
+
+import os
+from concurrent.futures import ThreadPoolExecutor
+from dataclasses import dataclass, field, fields
+from pathlib import Path
+from typing import Any, Dict, List, Optional, Tuple
+
+import click
+import yaml
+
+from ..exceptions import KerfError
+from ..timing import StageTimer
+from ..utils import get_instance_id_from_name, get_instance_name_from_id
+from .main import (
+    HUGE_ALIGN_SIZES,
+    INIT_RESTART_POLICIES,
+    KEXEC_FILE_DEBUG,
+    _init_params,
+    _parse_cpu_list,
+    _parse_mounts,
+    _parse_prefault,
+    _parse_sched,
+    _parse_services,
+    boot_cmdline,
+    build_ip_param,
+    kexec_file_load,
+    kexec_flags,
+)
+from .record import LoadRecord, write_load_record
+
+# Instances whose rootfs images are built at the same time
+BATCH_DEFAULT_JOBS = 4
+
+# Manifest key -> InstanceSpec field, where they differ
+_SPEC_KEYS = {
+    "rootfs-dir": "rootfs_dir",
+    "ip": "ip_addr",
+    "console": "console_device",
+    "huge-align": "huge_align",
+}
+_LIST_KEYS = ("services", "prefault")
+
+
+class LoadError(KerfError):
+    """Raised when a manifest is invalid or an instance cannot be loaded."""
+
+
+@dataclass
+class InstanceSpec:  # pylint: disable=too-many-instance-attributes
+    """What to load into one instance; fields mirror the `kerf load` options."""
+    name: Optional[str] = None
+    id: Optional[int] = None
+    image: Optional[str] = None
+    rootfs_dir: Optional[str] = None
+    entrypoint: Optional[str] = None
+    services: Tuple[str, ...] = ()
+    restart: Optional[str] = None
+    cmdline: Optional[str] = None
+    ip_addr: Optional[str] = None
+    gateway: Optional[str] = None
+    netmask: str = "255.255.255.0"
+    nic: Optional[str] = None
+    hostname: Optional[str] = None
+    console_device: Optional[str] = None
+    mounts: Optional[str] = None
+    sched: Optional[str] = None
+    cpus: Optional[str] = None
+    mlockall: bool = False
+    prefault: Tuple[str, ...] = ()
+    dedup: bool = False
+    huge_align: Optional[str] = None
+
+    @property
+    def label(self) -> str:
+        """Name to report the instance under before it is resolved."""
+        return self.name or f"id {self.id}"
+
+
+@dataclass
+class Manifest:
+    """A parsed fleet manifest."""
+    kernel: Optional[str]
+    initrd: Optional[str]
+    cmdline: Optional[str]
+    instances: List[InstanceSpec]
+
+
+@dataclass
+class InstanceLoad:  # pylint: disable=too-many-instance-attributes
+    """Outcome of loading one instance; error is None on success."""
+    spec: InstanceSpec
+    name: Optional[str] = None
+    instance_id: Optional[int] = None
+    cmdline: str = ""
+    flags: int = 0
+    daxfs_image: Any = None
+    record: Optional[LoadRecord] = None
+    timer: StageTimer = field(default_factory=StageTimer)
+    error: Optional[str] = None
+
+
+def _check(validator, value, what: str):
+    """Run a `kerf load` option validator, raising LoadError for what."""
+    try:
+        return validator(None, None, value)
+    except click.BadParameter as e:
+        raise LoadError(f"{what}: {e.message}") from e
+
+
+def make_spec(entry: Dict[str, Any], defaults: Optional[Dict[str, Any]] = None) -> InstanceSpec:
+    """
+    Build and validate an InstanceSpec from a manifest entry.
+
+    Raises:
+        LoadError: On unknown keys or values `kerf load` would reject
+    """
+    known = {f.name for f in fields(InstanceSpec)}
+    values = {}
+    for key, value in {**(defaults or {}), **entry}.items():
+        attr = _SPEC_KEYS.get(key, key.replace("-", "_"))
+        if attr not in known:
+            raise LoadError(f"unknown instance key '{key}'")
+        if attr in _LIST_KEYS and isinstance(value, str):
+            value = [value]
+        values[attr] = tuple(value) if attr in _LIST_KEYS else value
+    spec = InstanceSpec(**values)
+
+    what = f"instance {spec.label}"
+    if not spec.name and spec.id is None:
+        raise LoadError("every instance needs a name or an id")
+    if spec.id is not None and not 1 <= spec.id <= 511:
+        raise LoadError(f"{what}: id must be between 1 and 511 (got {spec.id})")
+    if spec.image and spec.rootfs_dir:
+        raise LoadError(f"{what}: image and rootfs-dir are mutually exclusive")
+    if spec.entrypoint and spec.services:
+        raise LoadError(f"{what}: entrypoint and services are mutually exclusive")
+    if spec.rootfs_dir and not (spec.entrypoint or spec.services):
+        raise LoadError(f"{what}: entrypoint or services is required with rootfs-dir")
+    if spec.restart and spec.restart not in INIT_RESTART_POLICIES:
+        raise LoadError(f"{what}: restart must be one of {', '.join(INIT_RESTART_POLICIES)}")
+    if spec.huge_align and spec.huge_align not in HUGE_ALIGN_SIZES:
+        raise LoadError(f"{what}: huge-align must be one of {', '.join(HUGE_ALIGN_SIZES)}")
+
+    _check(_parse_services, spec.services, what)
+    spec.mounts = _check(_parse_mounts, spec.mounts, what)
+    _check(_parse_sched, spec.sched, what)
+    _check(_parse_cpu_list, spec.cpus, what)
+    _check(_parse_prefault, spec.prefault, what)
+    return spec
+
+
+def parse_manifest(data: Any) -> Manifest:
+    """
+    Validate a decoded manifest document.
+
+    Raises:
+        LoadError: If the document or any instance entry is invalid
+    """
+    if not isinstance(data, dict) or not isinstance(data.get("instances"), list):
+        raise LoadError("manifest must be a mapping with an 'instances' list")
+    defaults = data.get("defaults") or {}
+    if not isinstance(defaults, dict):
+        raise LoadError("'defaults' must be a mapping")
+
+    instances = []
+    seen = set()
+    for entry in data["instances"]:
+        if not isinstance(entry, dict):
+            raise LoadError("each entry in 'instances' must be a mapping")
+        spec = make_spec(entry, defaults)
+        key = spec.name or spec.id
+        if key in seen:
+            raise LoadError(f"instance {spec.label} is listed more than once")
+        seen.add(key)
+        instances.append(spec)
+
+    return Manifest(data.get("kernel"), data.get("initrd"), data.get("cmdline"), instances)
+
+
+def load_manifest(path: str) -> Manifest:
+    """Read and validate a YAML or JSON manifest file."""
+    try:
+        with open(path, "r", encoding="utf-8") as f:
+            data = yaml.safe_load(f)
+    except (OSError, yaml.YAMLError) as e:
+        raise LoadError(f"cannot read manifest '{path}': {e}") from e
+    return parse_manifest(data)
+
+
+def _resolve(spec: InstanceSpec) -> Tuple[str, int]:
+    """Return (name, id) of an existing instance."""
+    if spec.name:
+        instance_id = get_instance_id_from_name(spec.name)
+        if instance_id is None:
+            raise LoadError(f"Instance '{spec.name}' not found")
+        return spec.name, instance_id
+
+    name = get_instance_name_from_id(spec.id)
+    if not name:
+        raise LoadError(f"Instance with ID {spec.id} not found")
+    return name, spec.id
+
+
+def _init_path(spec: InstanceSpec, default_cmd: List[str]) -> Optional[str]:
+    """Pick the kerf.entrypoint for an image, as `kerf load --image` does."""
+    if spec.services:
+        return None
+    if spec.entrypoint:
+        return spec.entrypoint
+    if default_cmd:
+        return default_cmd[0]
+    raise LoadError("Image has no ENTRYPOINT/CMD, set an entrypoint")
+
+
+def _build_rootfs(  # pylint: disable=too-many-arguments,too-many-positional-arguments
+    spec: InstanceSpec, name: str, has_initrd: bool, threads: int, pull: bool,
+    timer: StageTimer,
+):
+    """Create the instance's daxfs image; return (daxfs_image, init_path)."""
+    from ..daxfs import create_daxfs_image, create_daxfs_image_from_layers, inject_kerf_init
+
+    huge_align = HUGE_ALIGN_SIZES.get(spec.huge_align, 0)
+
+    if spec.rootfs_dir:
+        if not Path(spec.rootfs_dir).is_dir():
+            raise LoadError(f"Rootfs directory '{spec.rootfs_dir}' does not exist")
+        if not has_initrd:
+            inject_kerf_init(spec.rootfs_dir)
+        image = create_daxfs_image(
+            spec.rootfs_dir, name, timer=timer, dedup=spec.dedup,
+            threads=threads, huge_align=huge_align,
+        )
+        return image, spec.entrypoint
+
+    from ..docker.image import daxfs_cache_dir, extract_image, pull_image_layers
+
+    # Content dedup hashes files on disk, so it needs the extracted rootfs
+    if spec.dedup:
+        with timer.stage("extract"):
+            rootfs_path, default_cmd = extract_image(spec.image, name, threads=threads, pull=pull)
+        init_path = _init_path(spec, default_cmd)
+        if not has_initrd:
+            inject_kerf_init(rootfs_path)
+        image = create_daxfs_image(
+            rootfs_path, name, timer=timer, dedup=True, threads=threads, huge_align=huge_align,
+        )
+    else:
+        with timer.stage("pull"):
+            layers, default_cmd = pull_image_layers(spec.image, pull=pull)
+        init_path = _init_path(spec, default_cmd)
+        image = create_daxfs_image_from_layers(
+            layers, name, timer=timer, threads=threads, huge_align=huge_align,
+            inject_init=not has_initrd, cache_dir=daxfs_cache_dir(),
+        )
+    return image, init_path
+
+
+def _prepare(spec: InstanceSpec, base_cmdline: Optional[str], has_initrd: bool,
+             threads: int, pull: bool) -> InstanceLoad:
+    """Resolve an instance and build its rootfs and cmdline, recording any error."""
+    inst = InstanceLoad(spec)
+    try:
+        inst.name, inst.instance_id = _resolve(spec)
+
+        init_path = None
+        if spec.image or spec.rootfs_dir:
+            inst.daxfs_image, init_path = _build_rootfs(
+                spec, inst.name, has_initrd, threads, pull, inst.timer
+            )
+
+        cmdline = " ".join(c for c in (base_cmdline, spec.cmdline) if c)
+        daxfs_image = None if has_initrd else inst.daxfs_image
+        init_params = _init_params(spec.services, spec.restart, spec.mounts, spec.sched,
+                                   spec.cpus, spec.mlockall, spec.prefault)
+        inst.cmdline = boot_cmdline(
+            cmdline or None,
+            daxfs_image,
+            init_path,
+            init_params,
+            build_ip_param(spec.ip_addr, spec.gateway, spec.netmask, spec.hostname, spec.nic),
+            spec.console_device,
+        )
+        inst.flags = kexec_flags(inst.instance_id, has_initrd)
+        inst.record = LoadRecord(
+            kernel="",  # Filled in by load_instances()
+            cmdline=cmdline or None,
+            daxfs_phys_addr=daxfs_image.phys_addr if daxfs_image else None,
+            daxfs_size=daxfs_image.size if daxfs_image else None,
+            entrypoint=init_path if daxfs_image else None,
+            init_params=list(init_params) if daxfs_image else [],
+            console_device=spec.console_device,
+            boot_cmdline=inst.cmdline,
+        )
+    except Exception as e:  # one instance's failure must not stop the batch
+        inst.error = str(e)
+    return inst
+
+
+def _open_image(path: str, what: str) -> int:
+    """Open a kernel or initrd image once for every kexec_file_load call."""
+    try:
+        fd = os.open(path, os.O_RDONLY | os.O_CLOEXEC)
+    except OSError as e:
+        raise LoadError(f"Failed to open {what} image: {e}") from e
+    # Each kexec_file_load reads the whole file; keep it in the page cache
+    # while the rootfs images are being built
+    os.posix_fadvise(fd, 0, 0, os.POSIX_FADV_WILLNEED)
+    return fd
+
+
+def load_instances(  # pylint: disable=too-many-arguments,too-many-positional-arguments
+    kernel: str,
+    specs: List[InstanceSpec],
+    initrd: Optional[str] = None,
+    cmdline: Optional[str] = None,
+    jobs: Optional[int] = None,
+    threads: Optional[int] = None,
+    pull: bool = False,
+    debug: bool = False,
+) -> List[InstanceLoad]:
+    """
+    Load a kernel into many instances.
+
+    Up to jobs rootfs images are built at once, each with threads writer
+    threads. Once every image is ready, kexec_file_load is called for each
+    instance in order, reusing one kernel fd.
+
+    Args:
+        kernel: Path to the kernel image shared by all instances
+        specs: Instances to load
+        initrd: Optional initrd for all instances (disables daxfs root)
+        cmdline: Command line prepended to each instance's own cmdline
+        jobs: Images built concurrently (default: BATCH_DEFAULT_JOBS)
+        threads: Writer threads per image (default: CPUs shared among jobs)
+        pull: Ask the registry for each image's current digest, ignoring cached tags
+        debug: Pass KEXEC_FILE_DEBUG and print the syscall arguments
+
+    Returns:
+        One InstanceLoad per spec, in order; failed instances carry an error
+
+    Raises:
+        LoadError: If the kernel or initrd cannot be opened
+    """
+    from ..daxfs.mkdaxfs import DAXFS_DEFAULT_THREADS
+
+    if not specs:
+        return []
+    jobs = max(1, min(jobs or BATCH_DEFAULT_JOBS, len(specs)))
+    threads = threads or max(1, DAXFS_DEFAULT_THREADS // jobs)
+
+    kernel_fd = _open_image(kernel, "kernel")
+    initrd_fd = -1
+    try:
+        if initrd:
+            initrd_fd = _open_image(initrd, "initrd")
+
+        with ThreadPoolExecutor(max_workers=jobs) as pool:
+            loads = list(pool.map(
+                lambda spec: _prepare(spec, cmdline, bool(initrd), threads, pull), specs
+            ))
+
+        for inst in loads:
+            if inst.error:
+                continue
+            flags = inst.flags | (KEXEC_FILE_DEBUG if debug else 0)
+            try:
+                with inst.timer.stage("kexec_file_load"):
+                    kexec_file_load(kernel_fd, initrd_fd, inst.cmdline, flags, debug=debug)
+            except OSError as e:
+                inst.error = f"kexec_file_load failed: {e}"
+                continue
+            inst.record.kernel = os.path.abspath(kernel)
+            inst.record.initrd = os.path.abspath(initrd) if initrd else None
+            try:
+                write_load_record(inst.name, inst.record)
+            except OSError:
+                # Only `kerf clone` needs it; the instance is loaded
+                pass
+    finally:
+        os.close(kernel_fd)
+        if initrd_fd >= 0:
+            os.close(initrd_fd)
+
+    return loads
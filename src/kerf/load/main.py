@@ -19,13 +19,16 @@ Kernel loading subcommand implementation using kexec_file_load syscall.
 import ctypes
 import os
 import platform
+import re
 import sys
 from pathlib import Path
-from typing import Optional
+from typing import List, Optional, Sequence, Tuple
 
 import click
 
+from ..timing import StageTimer
 from ..utils import get_instance_id_from_name, get_instance_name_from_id
+from .record import LoadRecord, write_load_record
 
 
 # KEXEC flags definitions
@@ -199,15 +202,376 @@ def kexec_file_load(
     return result
 
 
+def _echo_daxfs_throughput(daxfs_image, threads: int) -> None:
+    """Report how fast the daxfs image was populated."""
+    if daxfs_image.shared or daxfs_image.write_seconds <= 0:
+        return
+    mb = daxfs_image.bytes_written / (1024 * 1024)
+    click.echo(
+        f"Populated {mb:.1f} MB in {daxfs_image.write_seconds:.3f}s "
+        f"({mb / daxfs_image.write_seconds:.1f} MB/s, {threads} threads)"
+    )
+
+
+# --huge-align values, in bytes
+HUGE_ALIGN_SIZES = {"2M": 2 * 1024 * 1024, "1G": 1024 * 1024 * 1024}
+
+
+# kerf.mounts= entries understood by kerf-init
+INIT_MOUNTS = ("proc", "sys", "dev", "devpts", "none")
+
+
+def _parse_mounts(ctx, param, value):  # pylint: disable=unused-argument
+    """Validate --mounts and normalize it to kerf-init's comma list."""
+    if value is None:
+        return None
+    mounts = [m.strip() for m in value.split(",") if m.strip()]
+    unknown = [m for m in mounts if m not in INIT_MOUNTS]
+    if unknown or not mounts:
+        raise click.BadParameter(
+            f"expected a comma-separated subset of {', '.join(INIT_MOUNTS)}"
+        )
+    return ",".join(mounts)
+
+
+# kerf.sched= policies understood by kerf-init
+INIT_SCHED_POLICIES = ("other", "batch", "idle", "fifo", "rr")
+_SCHED_RE = re.compile(rf"^({'|'.join(INIT_SCHED_POLICIES)})(:\d+)?$")
+_CPU_LIST_RE = re.compile(r"^\d+(-\d+)?(,\d+(-\d+)?)*$")
+
+
+def _parse_sched(ctx, param, value):  # pylint: disable=unused-argument
+    """Validate --sched as <policy>[:<priority>]."""
+    if value is not None and not _SCHED_RE.match(value):
+        raise click.BadParameter(
+            f"expected <policy>[:<priority>] with policy one of {', '.join(INIT_SCHED_POLICIES)}"
+        )
+    return value
+
+
+def _parse_cpu_list(ctx, param, value):  # pylint: disable=unused-argument
+    """Validate --cpus as a cpu list such as 0-3,6."""
+    if value is not None and not _CPU_LIST_RE.match(value):
+        raise click.BadParameter("expected a cpu list such as 0-3,6")
+    return value
+
+
+def _parse_prefault(ctx, param, value):  # pylint: disable=unused-argument
+    """Validate --prefault paths, which kerf-init reads as a comma list."""
+    for path in value:
+        if not path.startswith("/") or any(c in path for c in ", \"\t\n"):
+            raise click.BadParameter(
+                f"'{path}' must be an absolute path without commas or whitespace"
+            )
+    return value
+
+
+# kerf-init supervises up to this many kerf.svc.N= services
+MAX_INIT_SERVICES = 8
+INIT_RESTART_POLICIES = ("always", "on-failure", "never")
+
+
+def _parse_services(ctx, param, value):  # pylint: disable=unused-argument
+    """Validate --service commands, which kerf-init reads as kerf.svc.N=."""
+    if len(value) > MAX_INIT_SERVICES:
+        raise click.BadParameter(f"at most {MAX_INIT_SERVICES} services are supported")
+    for command in value:
+        if not command.strip() or '"' in command:
+            raise click.BadParameter(f"'{command}' must be non-empty and contain no '\"'")
+    return value
+
+
+def _quote_param(key: str, value: str) -> str:
+    """Format a kerf.* key, quoting values with spaces like kerf-init expects."""
+    return f'{key}="{value}"' if " " in value else f"{key}={value}"
+
+
+def _init_params(  # pylint: disable=too-many-arguments,too-many-positional-arguments
+    services: Tuple[str, ...],
+    restart: Optional[str],
+    mounts: Optional[str],
+    sched: Optional[str],
+    cpus: Optional[str],
+    mlockall: bool,
+    prefault: Tuple[str, ...],
+) -> List[str]:
+    """Build the kerf.* cmdline keys kerf-init applies before execv."""
+    params = [_quote_param(f"kerf.svc.{i}", command) for i, command in enumerate(services)]
+    if restart:
+        params.append(f"kerf.restart={restart}")
+    if mounts:
+        params.append(f"kerf.mounts={mounts}")
+    if sched:
+        params.append(f"kerf.sched={sched}")
+    if cpus:
+        params.append(f"kerf.cpus={cpus}")
+    if mlockall:
+        params.append("kerf.mlockall=1")
+    if prefault:
+        params.append(f"kerf.prefault={','.join(prefault)}")
+    return params
+
+
+def kexec_flags(instance_id: int, has_initrd: bool) -> int:
+    """Return the kexec_file_load flags for a multikernel instance."""
+    flags = KEXEC_MULTIKERNEL | KEXEC_MK_ID(instance_id)
+    if not has_initrd:
+        flags |= KEXEC_FILE_NO_INITRAMFS
+    return flags
+
+
+def boot_cmdline(  # pylint: disable=too-many-arguments,too-many-positional-arguments
+    cmdline: Optional[str],
+    daxfs_image=None,
+    init_path: Optional[str] = None,
+    init_params: Sequence[str] = (),
+    ip_param: Optional[str] = None,
+    console_device: Optional[str] = None,
+) -> str:
+    """
+    Build the spawn kernel command line.
+
+    daxfs_image, when given, becomes the root filesystem with kerf-init as
+    /init; init_path and init_params are only used in that case.
+    """
+    parts = [cmdline] if cmdline else []
+
+    if daxfs_image:
+        parts.append("rootfstype=daxfs")
+        parts.append(f"rootflags=phys=0x{daxfs_image.phys_addr:x},size={daxfs_image.size}")
+        parts.append("init=/init")
+        if init_path:
+            parts.append(_quote_param("kerf.entrypoint", init_path))
+        # A shared image's status page belongs to the instance that built it
+        if daxfs_image.status_offset and not daxfs_image.shared:
+            parts.append(f"kerf.status=0x{daxfs_image.phys_addr + daxfs_image.status_offset:x}")
+        parts.extend(init_params)
+
+    if ip_param:
+        parts.append(ip_param)
+    if console_device:
+        parts.append(f"console={console_device}")
+    return " ".join(parts)
+
+
+def _align_name(huge_align: int) -> str:
+    """Return the --huge-align spelling of an alignment, 4K for none."""
+    return next((k for k, v in HUGE_ALIGN_SIZES.items() if v == huge_align), "4K")
+
+
+def _echo_padding_report(builder) -> None:
+    """Print the size cost of each daxfs extent alignment for a rootfs."""
+    builder.build()
+    report = builder.padding_report()
+    base = report[0]["total_size"]
+
+    click.echo(f"{'ALIGN':<6} {'EXTENTS':>8} {'PADDING':>14} {'IMAGE SIZE':>14} {'EXTRA':>7}")
+    for row in report:
+        name = _align_name(row["huge_align"])
+        extra = (row["total_size"] - base) / base * 100 if base else 0.0
+        click.echo(
+            f"{name:<6} {row['huge_extents']:>8} {row['padding']:>14} "
+            f"{row['total_size']:>14} {extra:>6.1f}%"
+        )
+
+
+def _warn_unaligned_base(daxfs_image) -> None:
+    """Warn when the image base defeats hugepage-aligned extents."""
+    if daxfs_image.huge_align and daxfs_image.phys_addr % daxfs_image.huge_align:
+        click.echo(
+            f"Warning: daxfs image at phys=0x{daxfs_image.phys_addr:x} is not "
+            f"{_align_name(daxfs_image.huge_align)} aligned, "
+            "large files will not get hugepage mappings",
+            err=True,
+        )
+
+
+# load options that still apply with --manifest; the rest come from it
+_MANIFEST_OPTIONS = (
+    "manifest", "kernel", "initrd", "cmdline", "jobs", "threads", "pull", "verbose", "stats",
+)
+
+
+def load_kernel(  # pylint: disable=too-many-arguments,too-many-positional-arguments
+    instance_name: str,
+    kernel_path: Path,
+    initrd_path: Optional[Path],
+    cmdline_str: str,
+    flags: int,
+    timer: StageTimer,
+    debug: bool = False,
+    verbose: bool = False,
+) -> None:
+    """
+    Open the images and call kexec_file_load, exiting with a diagnosis on failure.
+
+    Exits with status 3 if an image cannot be opened and 1 if the syscall fails.
+    """
+    try:
+        kernel_fd = os.open(str(kernel_path), os.O_RDONLY)
+    except OSError as e:
+        click.echo(f"Error: Failed to open kernel image: {e}", err=True)
+        sys.exit(3)
+
+    # Open initrd file if provided
+    initrd_fd = -1
+    if initrd_path:
+        try:
+            initrd_fd = os.open(str(initrd_path), os.O_RDONLY)
+        except OSError as e:
+            os.close(kernel_fd)
+            click.echo(f"Error: Failed to open initrd image: {e}", err=True)
+            sys.exit(3)
+
+    try:
+        if verbose:
+            click.echo("Calling kexec_file_load syscall...")
+
+        if debug:
+            flags |= KEXEC_FILE_DEBUG
+        with timer.stage("kexec_file_load"):
+            result = kexec_file_load(kernel_fd, initrd_fd, cmdline_str, flags, debug=debug)
+
+        if verbose:
+            click.echo(f"✓ Kernel loaded successfully (result: {result})")
+        else:
+            click.echo("✓ Kernel loaded successfully")
+
+    except OSError as e:
+        click.echo(f"Error: kexec_file_load failed: {e}", err=True)
+        if e.errno == 1:  # EPERM
+            click.echo("Note: This operation requires root privileges", err=True)
+        elif e.errno == 16:  # EBUSY
+            click.echo(
+                f"Note: Instance '{instance_name}' already has a kernel loaded. "
+                f"Run 'kerf unload {instance_name}' first.", err=True
+            )
+        elif e.errno == 22:  # EINVAL
+            click.echo(
+                "Note: Invalid arguments. Check kernel image format and flags.", err=True
+            )
+        elif e.errno == 95:  # EOPNOTSUPP
+            click.echo("Note: kexec_file_load not supported on this system.", err=True)
+        sys.exit(1)
+
+    finally:
+        # Clean up file descriptors
+        os.close(kernel_fd)
+        if initrd_fd >= 0:
+            os.close(initrd_fd)
+
+
+def _record_load(instance_name: str, record: LoadRecord, verbose: bool) -> None:
+    """Save what the instance was loaded with; the kernel is loaded either way."""
+    try:
+        write_load_record(instance_name, record)
+    except OSError as e:
+        if verbose:
+            click.echo(f"Warning: Could not record the load for kerf clone: {e}", err=True)
+
+
+def _load_manifest(  # pylint: disable=too-many-arguments,too-many-positional-arguments
+    ctx: click.Context,
+    manifest: str,
+    kernel: Optional[str],
+    initrd: Optional[str],
+    cmdline: Optional[str],
+    jobs: Optional[int],
+    threads: Optional[int],
+    pull: bool,
+    verbose: bool,
+    stats: bool,
+) -> None:
+    """Load every instance of a manifest, for `kerf load --manifest`."""
+    from click.core import ParameterSource
+    from .batch import LoadError, load_instances, load_manifest
+
+    conflicts = [
+        p.opts[0] for p in ctx.command.params
+        if p.name not in _MANIFEST_OPTIONS
+        and ctx.get_parameter_source(p.name) == ParameterSource.COMMANDLINE
+    ]
+    if conflicts:
+        click.echo(
+            f"Error: {', '.join(conflicts)} cannot be combined with --manifest; "
+            "set them per instance in the manifest", err=True
+        )
+        sys.exit(2)
+
+    try:
+        fleet = load_manifest(manifest)
+    except LoadError as e:
+        click.echo(f"Error: {e}", err=True)
+        sys.exit(2)
+
+    # Command-line images override the manifest's
+    kernel = kernel or fleet.kernel
+    initrd = initrd or fleet.initrd
+    if not kernel:
+        click.echo("Error: no kernel given by --kernel or the manifest", err=True)
+        sys.exit(2)
+    for path in filter(None, (kernel, initrd)):
+        if not Path(path).is_file():
+            click.echo(f"Error: '{path}' is not a regular file", err=True)
+            sys.exit(3)
+
+    debug = ctx.obj.get("debug", False) if ctx and ctx.obj else False
+    try:
+        loads = load_instances(
+            kernel, fleet.instances, initrd=initrd, cmdline=cmdline or fleet.cmdline,
+            jobs=jobs, threads=threads, pull=pull, debug=debug,
+        )
+    except LoadError as e:
+        click.echo(f"Error: {e}", err=True)
+        sys.exit(3)
+
+    failed = 0
+    for inst in loads:
+        if inst.error:
+            failed += 1
+            click.echo(f"Error: {inst.name or inst.spec.label}: {inst.error}", err=True)
+            continue
+        click.echo(f"✓ {inst.name} (ID: {inst.instance_id}) loaded")
+        if verbose:
+            if inst.daxfs_image:
+                action = "reused" if inst.daxfs_image.shared else "created"
+                click.echo(
+                    f"  Daxfs image {action} at phys=0x{inst.daxfs_image.phys_addr:x}, "
+                    f"size={inst.daxfs_image.size}"
+                )
+            click.echo(f"  Command line: {inst.cmdline if inst.cmdline else '(empty)'}")
+        if stats:
+            for line in inst.timer.format_lines():
+                click.echo(f"  {line}")
+
+    click.echo(f"Loaded {len(loads) - failed} of {len(loads)} instances")
+    if failed:
+        sys.exit(1)
+
+
 @click.command()
 @click.pass_context
 @click.argument("name", required=False)
-@click.option("--kernel", "-k", required=True, help="Path to kernel image file")
+@click.option("--kernel", "-k", help="Path to kernel image file")
 @click.option("--initrd", "-i", help="Path to initrd image file (optional)")
 @click.option("--cmdline", "-c", help="Boot command line parameters")
 @click.option("--id", type=int, help="Multikernel instance ID (1-511)")
 @click.option("--image", help="Docker image to use as rootfs (e.g., nginx:latest)")
 @click.option("--entrypoint", help="Override image entrypoint for init")
+@click.option(
+    "--service",
+    "services",
+    multiple=True,
+    callback=_parse_services,
+    help="Command for kerf-init to supervise instead of the entrypoint "
+         f"(repeatable, up to {MAX_INIT_SERVICES})",
+)
+@click.option(
+    "--restart",
+    type=click.Choice(INIT_RESTART_POLICIES),
+    help="When kerf-init restarts exited services, with backoff "
+         "(default: always with --service, never otherwise)",
+)
 @click.option("--rootfs-dir", help="Use existing directory as rootfs instead of Docker image")
 @click.option("--ip", "ip_addr", help="IP address for spawn kernel (or 'dhcp')")
 @click.option("--gateway", help="Default gateway IP address")
@@ -215,7 +579,75 @@ def kexec_file_load(
 @click.option("--nic", help="Network interface name (e.g., eth0)")
 @click.option("--hostname", help="Hostname for spawn kernel")
 @click.option("--console", "console_device", help="Console device (e.g., mktty0)")
+@click.option(
+    "--mounts",
+    callback=_parse_mounts,
+    help="Filesystems kerf-init mounts, from proc,sys,dev,devpts or none "
+         "(default: all; proc is always mounted)",
+)
+@click.option(
+    "--sched",
+    callback=_parse_sched,
+    help="Scheduling policy for the entrypoint, e.g. fifo:50 (other, batch, idle, fifo, rr)",
+)
+@click.option(
+    "--cpus",
+    "init_cpus",
+    callback=_parse_cpu_list,
+    help="Spawn kernel CPUs to pin the entrypoint to, e.g. 0-3,6",
+)
+@click.option(
+    "--mlockall",
+    is_flag=True,
+    help="Lift RLIMIT_MEMLOCK for the entrypoint and keep prefaulted files locked",
+)
+@click.option(
+    "--prefault",
+    multiple=True,
+    callback=_parse_prefault,
+    help="Rootfs file to fault in before the entrypoint starts (repeatable)",
+)
+@click.option(
+    "--manifest",
+    type=click.Path(exists=True, dir_okay=False),
+    help="Load every instance in a YAML/JSON manifest, sharing one kernel image",
+)
+@click.option(
+    "--jobs",
+    type=click.IntRange(min=1),
+    default=None,
+    help="With --manifest, rootfs images built concurrently (default: 4)",
+)
 @click.option("--verbose", "-v", is_flag=True, help="Verbose output")
+@click.option("--stats", is_flag=True, help="Print a timing breakdown of each load stage")
+@click.option(
+    "--dedup",
+    is_flag=True,
+    help="Share identical file extents, and reuse an identical daxfs image already in memory "
+         "(extracts --image to disk instead of streaming its layers)",
+)
+@click.option(
+    "--threads",
+    type=click.IntRange(min=1),
+    default=None,
+    help="Threads used to decompress image layers and populate the daxfs image "
+         "(default: up to 8, one per CPU)",
+)
+@click.option(
+    "--pull",
+    is_flag=True,
+    help="Ask the registry for the image's current digest even if the cached tag is fresh",
+)
+@click.option(
+    "--huge-align",
+    type=click.Choice(list(HUGE_ALIGN_SIZES)),
+    help="Align large file extents in the daxfs image for hugepage mappings",
+)
+@click.option(
+    "--padding-report",
+    is_flag=True,
+    help="Print the daxfs size cost of 2M/1G extent alignment for the rootfs, then exit",
+)
 def load(  # pylint: disable=too-many-arguments,too-many-positional-arguments,too-many-locals
     ctx: click.Context,
     name: Optional[str],
@@ -225,6 +657,8 @@ def load(  # pylint: disable=too-many-arguments,too-many-positional-arguments,to
     id: Optional[int],
     image: Optional[str],
     entrypoint: Optional[str],
+    services: Tuple[str, ...],
+    restart: Optional[str],
     rootfs_dir: Optional[str],
     ip_addr: Optional[str],
     gateway: Optional[str],
@@ -232,7 +666,20 @@ def load(  # pylint: disable=too-many-arguments,too-many-positional-arguments,to
     nic: Optional[str],
     hostname: Optional[str],
     console_device: Optional[str],
+    mounts: Optional[str],
+    sched: Optional[str],
+    init_cpus: Optional[str],
+    mlockall: bool,
+    prefault: Tuple[str, ...],
+    manifest: Optional[str],
+    jobs: Optional[int],
     verbose: bool,
+    stats: bool,
+    dedup: bool,
+    threads: Optional[int],
+    pull: bool,
+    huge_align: Optional[str],
+    padding_report: bool,
 ):
     """
     Load kernel image using kexec_file_load syscall.
@@ -273,8 +720,47 @@ def load(  # pylint: disable=too-many-arguments,too-many-positional-arguments,to
         # Load with console enabled
         kerf load web-server --kernel=/boot/vmlinuz --image=nginx:latest \\
                  --console=mktty0
+
+        # Share the daxfs image with other instances of the same image
+        kerf load web-2 --kernel=/boot/vmlinuz --image=nginx:latest --dedup
+
+        # Show where the load time goes
+        kerf load web-server --kernel=/boot/vmlinuz --image=nginx:latest --stats
+
+        # Map large binaries and model weights with 2M pages
+        kerf load infer --kernel=/boot/vmlinuz --image=vllm:latest --huge-align=2M
+
+        # Supervise two processes, restarting them when they fail
+        kerf load app --kernel=/boot/vmlinuz --image=app:latest \\
+                 --service="/usr/bin/api --port=80" --service=/usr/bin/worker \\
+                 --restart=on-failure
+
+        # Single-binary workload that only needs /proc
+        kerf load job --kernel=/boot/vmlinuz --image=app:latest --mounts=proc
+
+        # Latency-critical service: real-time class, pinned, binary prefaulted
+        kerf load api --kernel=/boot/vmlinuz --image=api:latest \\
+                 --sched=fifo:50 --cpus=1-3 --mlockall --prefault=/usr/bin/api
+
+        # See what hugepage alignment would cost, without loading
+        kerf load infer --kernel=/boot/vmlinuz --image=vllm:latest --padding-report
+
+        # Load a fleet in one go: images built concurrently, one kernel fd
+        kerf load --manifest=fleet.yaml --jobs=8
     """
+    timer = StageTimer()
+
     try:
+        if manifest:
+            _load_manifest(
+                ctx, manifest, kernel, initrd, cmdline, jobs, threads, pull, verbose, stats
+            )
+            return
+
+        if not kernel:
+            click.echo("Error: --kernel is required", err=True)
+            sys.exit(2)
+
         if not name and id is None:
             click.echo("Error: Either instance name or --id must be provided", err=True)
             click.echo(
@@ -287,8 +773,14 @@ def load(  # pylint: disable=too-many-arguments,too-many-positional-arguments,to
             click.echo("Error: --image and --rootfs-dir are mutually exclusive", err=True)
             sys.exit(2)
 
-        if rootfs_dir and not entrypoint:
-            click.echo("Error: --entrypoint is required when using --rootfs-dir", err=True)
+        if entrypoint and services:
+            click.echo("Error: --entrypoint and --service are mutually exclusive", err=True)
+            sys.exit(2)
+
+        if rootfs_dir and not (entrypoint or services):
+            click.echo(
+                "Error: --entrypoint or --service is required when using --rootfs-dir", err=True
+            )
             sys.exit(2)
 
         instance_name = None
@@ -354,20 +846,46 @@ def load(  # pylint: disable=too-many-arguments,too-many-positional-arguments,to
         init_path = None
 
         if image:
-            from ..docker.image import extract_image, DockerError
-            from ..daxfs import create_daxfs_image, DaxfsError, inject_kerf_init
+            from ..docker.image import (
+                daxfs_cache_dir, extract_image, pull_image_layers, DockerError,
+            )
+            from ..daxfs import (
+                create_daxfs_image, create_daxfs_image_from_layers, DaxfsError, inject_kerf_init,
+            )
+            from ..daxfs.layers import LayerDaxfsBuilder, build_layer_index
+            from ..daxfs.mkdaxfs import DAXFS_DEFAULT_THREADS, DaxfsBuilder
+
+            threads = threads or DAXFS_DEFAULT_THREADS
+            # Content dedup hashes files on disk, so it needs the extracted rootfs
+            streaming = not dedup
 
             try:
-                if verbose:
-                    click.echo(f"Extracting Docker image: {image}")
+                if streaming:
+                    if verbose:
+                        click.echo(f"Pulling Docker image: {image}")
 
-                rootfs_path, default_cmd = extract_image(image, instance_name)
+                    with timer.stage("pull"):
+                        layers, default_cmd = pull_image_layers(image, pull=pull)
 
-                if verbose:
-                    click.echo(f"Rootfs extracted to: {rootfs_path}")
-                    click.echo(f"Image command: {default_cmd}")
+                    if verbose:
+                        click.echo(f"Streaming {len(layers)} layers into daxfs")
+                        click.echo(f"Image command: {default_cmd}")
+                else:
+                    if verbose:
+                        click.echo(f"Extracting Docker image: {image}")
+
+                    with timer.stage("extract"):
+                        rootfs_path, default_cmd = extract_image(
+                            image, instance_name, threads=threads, pull=pull
+                        )
+
+                    if verbose:
+                        click.echo(f"Rootfs extracted to: {rootfs_path}")
+                        click.echo(f"Image command: {default_cmd}")
 
-                if entrypoint:
+                if services:
+                    init_path = None
+                elif entrypoint:
                     init_path = entrypoint
                 elif default_cmd:
                     init_path = default_cmd[0]
@@ -378,18 +896,47 @@ def load(  # pylint: disable=too-many-arguments,too-many-positional-arguments,to
                     )
                     sys.exit(2)
 
-                if not initrd_path:
-                    inject_kerf_init(rootfs_path)
+                if padding_report:
+                    if streaming:
+                        _echo_padding_report(
+                            LayerDaxfsBuilder(
+                                build_layer_index(layers, inject_init=False, threads=threads)
+                            )
+                        )
+                    else:
+                        _echo_padding_report(DaxfsBuilder(rootfs_path))
+                    sys.exit(0)
+
+                if streaming:
                     if verbose:
-                        click.echo(f"Injected /init wrapper (entrypoint: {init_path})")
+                        if not initrd_path:
+                            click.echo(f"Injecting /init wrapper (entrypoint: {init_path})")
+                        click.echo(f"Creating daxfs image for instance {instance_name}...")
+
+                    daxfs_image = create_daxfs_image_from_layers(
+                        layers, instance_name, timer=timer, threads=threads,
+                        huge_align=HUGE_ALIGN_SIZES.get(huge_align, 0),
+                        inject_init=not initrd_path, cache_dir=daxfs_cache_dir(),
+                    )
+                else:
+                    if not initrd_path:
+                        inject_kerf_init(rootfs_path)
+                        if verbose:
+                            click.echo(f"Injected /init wrapper (entrypoint: {init_path})")
 
-                if verbose:
-                    click.echo(f"Creating daxfs image for instance {instance_name}...")
+                    if verbose:
+                        click.echo(f"Creating daxfs image for instance {instance_name}...")
 
-                daxfs_image = create_daxfs_image(rootfs_path, instance_name)
+                    daxfs_image = create_daxfs_image(
+                        rootfs_path, instance_name, timer=timer, dedup=dedup,
+                        threads=threads, huge_align=HUGE_ALIGN_SIZES.get(huge_align, 0),
+                    )
+                _warn_unaligned_base(daxfs_image)
 
                 if verbose:
-                    click.echo(f"Daxfs image created at phys=0x{daxfs_image.phys_addr:x}, size={daxfs_image.size}")
+                    action = "reused" if daxfs_image.shared else "created"
+                    click.echo(f"Daxfs image {action} at phys=0x{daxfs_image.phys_addr:x}, size={daxfs_image.size}")
+                    _echo_daxfs_throughput(daxfs_image, threads)
                     click.echo(f"Entrypoint: {init_path}")
 
             except DockerError as e:
@@ -404,6 +951,9 @@ def load(  # pylint: disable=too-many-arguments,too-many-positional-arguments,to
 
         elif rootfs_dir:
             from ..daxfs import create_daxfs_image, DaxfsError, inject_kerf_init
+            from ..daxfs.mkdaxfs import DAXFS_DEFAULT_THREADS, DaxfsBuilder
+
+            threads = threads or DAXFS_DEFAULT_THREADS
 
             try:
                 rootfs_path = Path(rootfs_dir)
@@ -413,6 +963,10 @@ def load(  # pylint: disable=too-many-arguments,too-many-positional-arguments,to
 
                 init_path = entrypoint
 
+                if padding_report:
+                    _echo_padding_report(DaxfsBuilder(str(rootfs_path)))
+                    sys.exit(0)
+
                 if not initrd_path:
                     inject_kerf_init(str(rootfs_path))
                     if verbose:
@@ -422,10 +976,16 @@ def load(  # pylint: disable=too-many-arguments,too-many-positional-arguments,to
                     click.echo(f"Using rootfs directory: {rootfs_path}")
                     click.echo(f"Creating daxfs image for instance {instance_name}...")
 
-                daxfs_image = create_daxfs_image(str(rootfs_path), instance_name)
+                daxfs_image = create_daxfs_image(
+                    str(rootfs_path), instance_name, timer=timer, dedup=dedup,
+                    threads=threads, huge_align=HUGE_ALIGN_SIZES.get(huge_align, 0),
+                )
+                _warn_unaligned_base(daxfs_image)
 
                 if verbose:
-                    click.echo(f"Daxfs image created at phys=0x{daxfs_image.phys_addr:x}, size={daxfs_image.size}")
+                    action = "reused" if daxfs_image.shared else "created"
+                    click.echo(f"Daxfs image {action} at phys=0x{daxfs_image.phys_addr:x}, size={daxfs_image.size}")
+                    _echo_daxfs_throughput(daxfs_image, threads)
                     click.echo(f"Entrypoint: {init_path}")
 
             except DaxfsError as e:
@@ -435,115 +995,66 @@ def load(  # pylint: disable=too-many-arguments,too-many-positional-arguments,to
                 click.echo(f"Error: {e}", err=True)
                 sys.exit(1)
 
-        # Always enable multikernel mode
-        mk_id_flags = KEXEC_MK_ID(instance_id)
-        flags = KEXEC_MULTIKERNEL | mk_id_flags
-
-        # If no initrd, set NO_INITRAMFS flag
-        if not initrd_path:
-            flags |= KEXEC_FILE_NO_INITRAMFS
+        flags = kexec_flags(instance_id, bool(initrd_path))
 
         if verbose:
             click.echo(f"Multikernel mode enabled with ID: {instance_id}")
-            flag_parts = [f"KEXEC_MULTIKERNEL=0x{KEXEC_MULTIKERNEL:x}", f"KEXEC_MK_ID({instance_id})=0x{mk_id_flags:x}"]
+            flag_parts = [f"KEXEC_MULTIKERNEL=0x{KEXEC_MULTIKERNEL:x}", f"KEXEC_MK_ID({instance_id})=0x{KEXEC_MK_ID(instance_id):x}"]
             if not initrd_path:
                 flag_parts.append(f"KEXEC_FILE_NO_INITRAMFS=0x{KEXEC_FILE_NO_INITRAMFS:x}")
             click.echo(f"Flags: {', '.join(flag_parts)}, combined=0x{flags:x}")
 
-        # Prepare command line
-        cmdline_parts = []
-        if cmdline:
-            cmdline_parts.append(cmdline)
-
-        # Add daxfs root parameters if using daxfs
-        if daxfs_image and not initrd_path:
-            cmdline_parts.append("rootfstype=daxfs")
-            cmdline_parts.append(f"rootflags=phys=0x{daxfs_image.phys_addr:x},size={daxfs_image.size}")
-            cmdline_parts.append("init=/init")
-            if init_path:
-                # Quote entrypoint if it contains spaces
-                if ' ' in init_path:
-                    cmdline_parts.append(f'kerf.entrypoint="{init_path}"')
-                else:
-                    cmdline_parts.append(f"kerf.entrypoint={init_path}")
-            if verbose:
+        # daxfs root parameters only apply when booting without an initrd
+        if initrd_path:
+            daxfs_image = None
+
+        ip_param = build_ip_param(ip_addr, gateway, netmask, hostname, nic)
+        init_params = _init_params(services, restart, mounts, sched, init_cpus, mlockall, prefault)
+        cmdline_str = boot_cmdline(
+            cmdline, daxfs_image, init_path, init_params, ip_param, console_device
+        )
+
+        if verbose:
+            if daxfs_image:
                 click.echo(f"Daxfs root: rootfstype=daxfs rootflags=phys=0x{daxfs_image.phys_addr:x},size={daxfs_image.size}")
                 if init_path:
                     click.echo(f"Entrypoint: kerf.entrypoint={init_path}")
-
-        # Add IP configuration if specified
-        ip_param = build_ip_param(ip_addr, gateway, netmask, hostname, nic)
-        if ip_param:
-            cmdline_parts.append(ip_param)
-            if verbose:
+                for i, command in enumerate(services):
+                    click.echo(f"Service {i}: {command}")
+            if ip_param:
                 click.echo(f"Network config: {ip_param}")
-
-        # Add console device if specified
-        if console_device:
-            cmdline_parts.append(f"console={console_device}")
-            if verbose:
+            if console_device:
                 click.echo(f"Console: console={console_device}")
 
-        cmdline_str = " ".join(cmdline_parts)
-
         if verbose:
             click.echo(f"Command line: {cmdline_str if cmdline_str else '(empty)'}")
             click.echo(f"Flags: 0x{flags:x}")
 
-        # Open kernel file
-        try:
-            kernel_fd = os.open(str(kernel_path), os.O_RDONLY)
-        except OSError as e:
-            click.echo(f"Error: Failed to open kernel image: {e}", err=True)
-            sys.exit(3)
-
-        # Open initrd file if provided
-        initrd_fd = -1
-        if initrd_path:
-            try:
-                initrd_fd = os.open(str(initrd_path), os.O_RDONLY)
-            except OSError as e:
-                os.close(kernel_fd)
-                click.echo(f"Error: Failed to open initrd image: {e}", err=True)
-                sys.exit(3)
-
-        try:
-            # Call kexec_file_load syscall
-            if verbose:
-                click.echo("Calling kexec_file_load syscall...")
-
-            debug = ctx.obj.get("debug", False) if ctx and ctx.obj else False
-            if debug:
-                flags |= KEXEC_FILE_DEBUG
-            result = kexec_file_load(kernel_fd, initrd_fd, cmdline_str, flags, debug=debug)
-
-            if verbose:
-                click.echo(f"✓ Kernel loaded successfully (result: {result})")
-            else:
-                click.echo("✓ Kernel loaded successfully")
-
-        except OSError as e:
-            click.echo(f"Error: kexec_file_load failed: {e}", err=True)
-            if e.errno == 1:  # EPERM
-                click.echo("Note: This operation requires root privileges", err=True)
-            elif e.errno == 16:  # EBUSY
-                click.echo(
-                    f"Note: Instance '{instance_name}' already has a kernel loaded. "
-                    f"Run 'kerf unload {instance_name}' first.", err=True
-                )
-            elif e.errno == 22:  # EINVAL
-                click.echo(
-                    "Note: Invalid arguments. Check kernel image format and flags.", err=True
-                )
-            elif e.errno == 95:  # EOPNOTSUPP
-                click.echo("Note: kexec_file_load not supported on this system.", err=True)
-            sys.exit(1)
+        debug = ctx.obj.get("debug", False) if ctx and ctx.obj else False
+        load_kernel(
+            instance_name, kernel_path, initrd_path, cmdline_str, flags, timer,
+            debug=debug, verbose=verbose,
+        )
+        _record_load(
+            instance_name,
+            LoadRecord(
+                kernel=str(kernel_path.resolve()),
+                initrd=str(initrd_path.resolve()) if initrd_path else None,
+                cmdline=cmdline,
+                daxfs_phys_addr=daxfs_image.phys_addr if daxfs_image else None,
+                daxfs_size=daxfs_image.size if daxfs_image else None,
+                entrypoint=init_path if daxfs_image else None,
+                init_params=list(init_params) if daxfs_image else [],
+                console_device=console_device,
+                boot_cmdline=cmdline_str,
+            ),
+            verbose,
+        )
 
-        finally:
-            # Clean up file descriptors
-            os.close(kernel_fd)
-            if initrd_fd >= 0:
-                os.close(initrd_fd)
+        if stats or verbose:
+            click.echo("Timing breakdown:")
+            for line in timer.format_lines():
+                click.echo(line)
 
     except Exception as e:
         click.echo(f"Unexpected error: {e}", err=True)
@@ -0,0 +1,75 @@
+# Copyright 2026 Multikernel Technologies, Inc.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""
+What each instance was loaded with, for `kerf clone` and `kerf bench`.
+
+`kerf load` records the kernel and initrd paths, the user's command line,
+the daxfs root region and the kerf-init parameters once kexec_file_load
+succeeds; `kerf unload` removes the record. The per-instance parts of the
+command line (network configuration) are kept apart, so a clone can reuse
+everything else and regenerate only those; the complete command line is
+kept too, so a benchmark can reload the instance exactly as it was.
+"""
+
+import json
+import os
+from dataclasses import asdict, dataclass, field
+from pathlib import Path
+from typing import List, Optional
+
+KERF_LOAD_DIR = "/var/lib/kerf/loads"
+
+
+@dataclass
+class LoadRecord:  # pylint: disable=too-many-instance-attributes
+    """Inputs of one successful kexec_file_load into an instance."""
+    kernel: str
+    initrd: Optional[str] = None
+    cmdline: Optional[str] = None  # The user's command line, before kerf's additions
+    daxfs_phys_addr: Optional[int] = None  # daxfs root region, None with an initrd
+    daxfs_size: Optional[int] = None
+    entrypoint: Optional[str] = None
+    init_params: List[str] = field(default_factory=list)
+    console_device: Optional[str] = None
+    boot_cmdline: Optional[str] = None  # Exactly what was loaded, for `kerf bench`
+
+
+def _record_path(instance_name: str) -> Path:
+    return Path(KERF_LOAD_DIR) / f"{instance_name}.json"
+
+
+def write_load_record(instance_name: str, record: LoadRecord) -> None:
+    path = _record_path(instance_name)
+    path.parent.mkdir(parents=True, exist_ok=True)
+    tmp = path.with_suffix(".tmp")
+    with open(tmp, "w", encoding="utf-8") as f:
+        json.dump(asdict(record), f)
+    os.replace(tmp, path)
+
+
+def read_load_record(instance_name: str) -> Optional[LoadRecord]:
+    """The instance's load record, or None if it has none or it is unreadable."""
+    try:
+        with open(_record_path(instance_name), "r", encoding="utf-8") as f:
+            return LoadRecord(**json.load(f))
+    except (OSError, ValueError, TypeError):
+        return None
+
+
+def remove_load_record(instance_name: str) -> None:
+    try:
+        _record_path(instance_name).unlink()
+    except FileNotFoundError:
+        pass
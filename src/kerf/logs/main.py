@@ -0,0 +1,115 @@
+# Copyright 2026 Multikernel Technologies, Inc.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""
+Read instance console output captured by `kerf console --capture`.
+"""
+
+import sys
+import time
+from typing import Optional
+
+import click
+
+from ..console.capture import console_ring_path
+from ..console.ring import RingError, RingReader
+from ..utils import get_instance_name_from_id
+
+# Seconds between checks for new output with --follow
+LOGS_FOLLOW_INTERVAL = 0.2
+
+
+def tail_lines(data: bytes, lines: int) -> bytes:
+    """Return the last `lines` lines of data; a trailing partial line counts as one."""
+    if lines <= 0:
+        return b""
+    end = len(data) - 1 if data.endswith(b"\n") else len(data)
+    start = end
+    for _ in range(lines):
+        start = data.rfind(b"\n", 0, start)
+        if start < 0:
+            return data
+    return data[start + 1:]
+
+
+def print_logs(reader: RingReader, out, lines: Optional[int] = None,
+               follow: bool = False, interval: float = LOGS_FOLLOW_INTERVAL) -> None:
+    """Write the ring's contents to out, then keep writing new output if follow."""
+    data, cursor, _ = reader.read(0)
+    if lines is not None:
+        data = tail_lines(data, lines)
+    out.write(data)
+    out.flush()
+
+    while follow:
+        time.sleep(interval)
+        data, cursor, lost = reader.read(cursor)
+        if lost:
+            click.echo(f"[kerf logs: {lost} bytes overwritten before they were read]", err=True)
+        if data:
+            out.write(data)
+            out.flush()
+
+
+@click.command(name="logs")
+@click.argument("name", required=False)
+@click.option("--id", type=int, help="Instance ID (alternative to name)")
+@click.option("--follow", "-f", is_flag=True, help="Keep printing new output as it is captured")
+@click.option("--lines", "-n", type=int, help="Only print the last N lines")
+def logs(name: Optional[str], id: Optional[int], follow: bool, lines: Optional[int]):
+    """
+    Print an instance's captured console output.
+
+    Output is read from the ring file `kerf console --capture` keeps for the
+    instance under /var/lib/kerf/console, so it includes boot output from
+    before anyone attached, up to the ring size. The file can outlive the
+    instance.
+
+    Examples:
+
+        kerf logs web-server
+        kerf logs web-server -f
+        kerf logs --id=1 -n 50
+    """
+    if not name and id is None:
+        click.echo("Error: Either instance name or --id must be provided", err=True)
+        click.echo("Usage: kerf logs <name>  or  kerf logs --id=<id>", err=True)
+        sys.exit(2)
+
+    if not name:
+        name = get_instance_name_from_id(id)
+        if not name:
+            click.echo(f"Error: Instance with ID {id} not found", err=True)
+            sys.exit(1)
+
+    path = console_ring_path(name)
+    try:
+        reader = RingReader(str(path))
+    except FileNotFoundError:
+        click.echo(f"Error: No captured console output for '{name}' ({path})", err=True)
+        click.echo("Capture consoles with: kerf console --capture", err=True)
+        sys.exit(1)
+    except (OSError, RingError) as e:
+        click.echo(f"Error: Cannot read {path}: {e}", err=True)
+        sys.exit(1)
+
+    try:
+        print_logs(reader, click.get_binary_stream("stdout"), lines, follow)
+    except KeyboardInterrupt:
+        pass
+    except BrokenPipeError:
+        # Reader went away (e.g. piped into head)
+        pass
+    finally:
+        reader.close()
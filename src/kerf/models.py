@@ -16,7 +16,7 @@
 Data models for multikernel device tree representation.
 """
 
-from dataclasses import dataclass
+from dataclasses import dataclass, field
 from typing import List, Dict, Optional, Set, Tuple
 from enum import Enum
 
@@ -73,6 +73,8 @@ class CPUTopology:
     socket_id: int
     cache_levels: List[int]  # Cache sizes at each level
     flags: List[str]  # CPU flags like "smt", "ht", etc.
+    llc_id: Optional[int] = None  # Last-level cache domain (an L3 slice / CCX)
+    siblings: List[int] = field(default_factory=list)  # SMT threads of this core, self included
 
 
 @dataclass
@@ -144,7 +146,7 @@ class InstanceResources:
     memory_bytes: int
     devices: List[str]  # List of device references
     numa_nodes: Optional[List[int]] = None  # Preferred NUMA nodes
-    cpu_affinity: Optional[str] = None  # "compact", "spread", "local"
+    cpu_affinity: Optional[str] = None  # "compact", "spread", "local", "llc-compact", ...
     memory_policy: Optional[str] = None  # "local", "interleave", "bind"
 
 
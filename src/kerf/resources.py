@@ -20,10 +20,15 @@ These utilities assist with allocating CPUs, memory, and devices when
 creating or updating kernel instances.
 """
 
-from typing import List, Set, Optional
+import bisect
+from typing import Dict, Iterable, List, Set, Optional, Tuple
 from .models import GlobalDeviceTree
 from .exceptions import ResourceError
 
+PAGE_SIZE = 0x1000
+HUGEPAGE_2M = 2 * 1024**2
+HUGEPAGE_1G = 1024**3
+
 
 def get_available_cpus(tree: GlobalDeviceTree) -> Set[int]:
     """
@@ -117,64 +122,209 @@ def get_allocated_memory_regions(tree: GlobalDeviceTree) -> List[tuple[int, int]
     return regions
 
 
+class MemoryPool:
+    """
+    Free extents of the multikernel memory pool.
+
+    Free space is kept as disjoint [start, end) extents sorted by start,
+    so locating the extents within a window is a bisection rather than a
+    scan over every instance.
+    """
+
+    def __init__(self, base: int, end: int, allocated: Iterable[Tuple[int, int]] = ()):
+        """
+        Args:
+            base: First byte of the pool
+            end: First byte past the pool
+            allocated: (base, size) regions already in use
+        """
+        self.base = base
+        self.end = end
+        self._starts: List[int] = [base] if end > base else []
+        self._ends: List[int] = [end] if end > base else []
+        for region_base, size in allocated:
+            self.reserve(region_base, size)
+
+    @classmethod
+    def from_tree(cls, tree: GlobalDeviceTree, use_iomem: bool = True) -> "MemoryPool":
+        """Build the pool of tree's hardware, minus the regions in use."""
+        if use_iomem:
+            allocated = get_allocated_memory_regions_from_iomem()
+        else:
+            allocated = get_allocated_memory_regions(tree)
+        memory = tree.hardware.memory
+        return cls(memory.memory_pool_base, memory.memory_pool_end, allocated)
+
+    def reserve(self, base: int, size: int) -> None:
+        """Mark [base, base + size) as in use; parts already in use are ignored."""
+        end = base + size
+        if size <= 0:
+            return
+        # First extent that ends after base; everything before is untouched
+        i = bisect.bisect_right(self._ends, base)
+        pieces_starts, pieces_ends = [], []
+        j = i
+        while j < len(self._starts) and self._starts[j] < end:
+            if self._starts[j] < base:
+                pieces_starts.append(self._starts[j])
+                pieces_ends.append(base)
+            if self._ends[j] > end:
+                pieces_starts.append(end)
+                pieces_ends.append(self._ends[j])
+            j += 1
+        self._starts[i:j] = pieces_starts
+        self._ends[i:j] = pieces_ends
+
+    def free_extents(
+        self, lo: Optional[int] = None, hi: Optional[int] = None
+    ) -> List[Tuple[int, int]]:
+        """Free (start, end) extents clipped to [lo, hi), in address order."""
+        lo = self.base if lo is None else lo
+        hi = self.end if hi is None else hi
+        extents = []
+        i = bisect.bisect_right(self._ends, lo)
+        while i < len(self._starts) and self._starts[i] < hi:
+            start, end = max(self._starts[i], lo), min(self._ends[i], hi)
+            if end > start:
+                extents.append((start, end))
+            i += 1
+        return extents
+
+    def largest_free(self, lo: Optional[int] = None, hi: Optional[int] = None) -> int:
+        """Size of the largest free extent within [lo, hi)."""
+        return max((end - start for start, end in self.free_extents(lo, hi)), default=0)
+
+    def best_fit(
+        self, size: int, alignment: int = PAGE_SIZE, lo: Optional[int] = None,
+        hi: Optional[int] = None,
+    ) -> Optional[int]:
+        """
+        Place size bytes in the smallest free extent within [lo, hi) that holds them.
+
+        Ties go to the lowest address. Filling the tightest gap keeps
+        large extents whole for large requests, where first-fit splits
+        the first big extent it meets.
+
+        Returns:
+            Aligned base address, or None if nothing fits
+        """
+        best = None
+        for start, end in self.free_extents(lo, hi):
+            aligned = _align_up(start, alignment)
+            if aligned + size > end:
+                continue
+            if best is None or end - start < best[0]:
+                best = (end - start, aligned)
+        return best[1] if best else None
+
+
+def _align_up(value: int, alignment: int) -> int:
+    return (value + alignment - 1) // alignment * alignment
+
+
+def preferred_alignments(size_bytes: int, alignment: int = PAGE_SIZE) -> List[int]:
+    """
+    Alignments to try for a region of size_bytes, largest first.
+
+    Regions of at least 1 GB try 1 GB, then 2 MB, alignment so the spawn
+    kernel can map them with huge pages; regions of at least 2 MB try
+    2 MB. Every list ends with alignment itself.
+    """
+    alignments = [a for a in (HUGEPAGE_1G, HUGEPAGE_2M) if size_bytes >= a and a > alignment]
+    return alignments + [alignment]
+
+
+def numa_nodes_for_cpus(tree: GlobalDeviceTree, cpus: Iterable[int]) -> List[int]:
+    """NUMA nodes holding cpus, the node with the most of them first."""
+    topology = tree.hardware.topology
+    if not topology or not topology.numa_nodes:
+        return []
+    counts: Dict[int, int] = {}
+    for cpu in cpus:
+        node = topology.get_numa_node_for_cpu(cpu)
+        if node is not None:
+            counts[node] = counts.get(node, 0) + 1
+    return sorted(counts, key=lambda node: (-counts[node], node))
+
+
 def find_available_memory_base(
-    tree: GlobalDeviceTree, size_bytes: int, alignment: int = 0x1000, use_iomem: bool = True
+    tree: GlobalDeviceTree,
+    size_bytes: int,
+    alignment: int = PAGE_SIZE,
+    use_iomem: bool = True,
+    cpus: Optional[List[int]] = None,
+    numa_nodes: Optional[List[int]] = None,
 ) -> Optional[int]:
     """
     Find available memory region for allocation.
 
+    The region is placed best-fit. Where the topology is known, memory
+    local to the instance comes first: the NUMA nodes given, else those
+    of its CPUs. Then one remote node, and only then a region spanning
+    nodes. Within each candidate window, hugepage alignments are tried
+    before the plain one (see preferred_alignments()).
+
     Args:
         tree: GlobalDeviceTree to analyze (for pool boundaries)
         size_bytes: Size of memory region needed
         alignment: Required alignment (default 4KB)
         use_iomem: If True, read actual allocations from /proc/iomem (kernel source of truth).
                    If False, use allocations from tree (for validation/dry-run).
+        cpus: CPUs of the instance, used to pick its NUMA nodes
+        numa_nodes: NUMA nodes to prefer over those of cpus
 
     Returns:
         Base address for allocation, or None if no space available
     """
-    pool_base = tree.hardware.memory.memory_pool_base
-    pool_end = tree.hardware.memory.memory_pool_end
+    pool = MemoryPool.from_tree(tree, use_iomem)
+
+    windows: List[Tuple[Optional[int], Optional[int]]] = []
+    topology = tree.hardware.topology
+    if topology and topology.numa_nodes:
+        local = numa_nodes or (numa_nodes_for_cpus(tree, cpus) if cpus else [])
+        # Local nodes first, then a single remote node, then spanning nodes
+        remote = [node for node in sorted(topology.numa_nodes) if node not in local]
+        for node in list(local) + remote:
+            region = topology.get_memory_region_for_numa_node(node)
+            if region is not None:
+                windows.append((region[0], region[0] + region[1]))
+    windows.append((None, None))
+
+    for lo, hi in windows:
+        for align in preferred_alignments(size_bytes, alignment):
+            base = pool.best_fit(size_bytes, align, lo, hi)
+            if base is not None:
+                return base
+    return None
 
-    if use_iomem:
-        allocated_regions = get_allocated_memory_regions_from_iomem()
-    else:
-        allocated_regions = get_allocated_memory_regions(tree)
-    # Sort by base address
-    allocated_regions.sort()
-
-    # Try to find gap between allocations or at start/end
-    if not allocated_regions:
-        # No allocations yet, use start of pool (aligned)
-        aligned_base = (pool_base + alignment - 1) // alignment * alignment
-        if aligned_base + size_bytes <= pool_end:
-            return aligned_base
-        return None
-
-    # Check gap at start
-    first_base = allocated_regions[0][0]
-    aligned_base = (pool_base + alignment - 1) // alignment * alignment
-    if aligned_base + size_bytes <= first_base:
-        return aligned_base
-
-    # Check gaps between allocations
-    for i in range(len(allocated_regions) - 1):
-        current_end = allocated_regions[i][0] + allocated_regions[i][1]
-        next_base = allocated_regions[i + 1][0]
-
-        # Align current_end
-        aligned_base = (current_end + alignment - 1) // alignment * alignment
-
-        if aligned_base + size_bytes <= next_base:
-            return aligned_base
-
-    # Check gap at end
-    last_end = allocated_regions[-1][0] + allocated_regions[-1][1]
-    aligned_base = (last_end + alignment - 1) // alignment * alignment
-    if aligned_base + size_bytes <= pool_end:
-        return aligned_base
 
-    return None
+def memory_fragmentation(
+    tree: GlobalDeviceTree, use_iomem: bool = True
+) -> List[Tuple[Optional[int], int, int, int]]:
+    """
+    Free memory of the pool per NUMA node.
+
+    Returns:
+        (node, free_bytes, largest_free_extent, free_extent_count) rows:
+        one per NUMA node overlapping the pool, then node None for the
+        whole pool
+    """
+    pool = MemoryPool.from_tree(tree, use_iomem)
+    rows = []
+    topology = tree.hardware.topology
+    if topology and topology.numa_nodes:
+        for node in sorted(topology.numa_nodes):
+            lo, size = topology.get_memory_region_for_numa_node(node)
+            if lo < pool.end and lo + size > pool.base:
+                extents = pool.free_extents(max(lo, pool.base), min(lo + size, pool.end))
+                rows.append(_fragmentation_row(node, extents))
+    rows.append(_fragmentation_row(None, pool.free_extents()))
+    return rows
+
+
+def _fragmentation_row(node: Optional[int], extents: List[Tuple[int, int]]):
+    sizes = [end - start for start, end in extents]
+    return (node, sum(sizes), max(sizes, default=0), len(sizes))
 
 
 def validate_cpu_allocation(
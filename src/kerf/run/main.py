@@ -0,0 +1,147 @@
+# Copyright 2026 Multikernel Technologies, Inc.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""
+Create, load and boot an instance in one command.
+
+`kerf run` invokes `kerf create`, `kerf load` and `kerf exec` in one
+process (one round trip when kerfd is running). If the load fails, the
+instance just created is deleted again, so a failed run leaves nothing
+behind.
+"""
+
+from typing import Optional, Tuple
+
+import click
+
+from ..create.main import create
+from ..delete.main import delete
+from ..exec.main import exec_cmd
+from ..load.main import INIT_RESTART_POLICIES, _parse_services, load
+
+
+@click.command(name="run")
+@click.pass_context
+@click.argument("name")
+@click.option("--id", "instance_id", type=int, help="Instance ID (1-511, auto-assigned if omitted)")
+@click.option("--cpus", help="Explicit APIC IDs, as for kerf create (e.g. 128-134)")
+@click.option("--cpu-count", type=int, help="Auto-allocate this many CPUs from the pool")
+@click.option(
+    "--cpu-affinity",
+    type=click.Choice(["compact", "spread", "local", "llc-compact", "no-smt-share"]),
+    default="compact",
+    help="CPU affinity policy, as for kerf create",
+)
+@click.option("--numa-nodes", help='Preferred NUMA node IDs (e.g. "0" or "0,1")')
+@click.option(
+    "--memory-policy",
+    type=click.Choice(["local", "interleave", "bind"]),
+    help="Memory allocation policy, as for kerf create",
+)
+@click.option("--memory", "-m", required=True, help='Memory allocation (e.g. "2GB")')
+@click.option("--memory-base", help="Memory base address (auto-assigned if omitted)")
+@click.option("--devices", "-d", help="Device names (comma-separated)")
+@click.option("--kernel", "-k", required=True, help="Path to kernel image file")
+@click.option("--initrd", "-i", help="Path to initrd image file (optional)")
+@click.option("--cmdline", help="Boot command line parameters")
+@click.option("--image", help="Docker image to use as rootfs (e.g., nginx:latest)")
+@click.option("--entrypoint", help="Override image entrypoint for init")
+@click.option(
+    "--service",
+    "services",
+    multiple=True,
+    callback=_parse_services,
+    help="Command for kerf-init to supervise instead of the entrypoint (repeatable)",
+)
+@click.option("--restart", type=click.Choice(INIT_RESTART_POLICIES), help="Service restart policy")
+@click.option("--rootfs-dir", help="Use existing directory as rootfs instead of Docker image")
+@click.option("--ip", "ip_addr", help="IP address for spawn kernel (or 'dhcp')")
+@click.option("--gateway", help="Default gateway IP address")
+@click.option("--netmask", default="255.255.255.0", help="Network mask (default: 255.255.255.0)")
+@click.option("--nic", help="Network interface name (e.g., eth0)")
+@click.option("--hostname", help="Hostname for spawn kernel")
+@click.option("--console", "console_device", help="Console device (e.g., mktty0)")
+@click.option(
+    "--dedup", is_flag=True, help="Share identical file extents and identical daxfs images"
+)
+@click.option("--attach", is_flag=True, help="Attach to the console after boot")
+@click.option("--verbose", "-v", is_flag=True, help="Verbose output")
+def run(  # pylint: disable=too-many-arguments,too-many-positional-arguments,too-many-locals
+    ctx: click.Context,
+    name: str,
+    instance_id: Optional[int],
+    cpus: Optional[str],
+    cpu_count: Optional[int],
+    cpu_affinity: str,
+    numa_nodes: Optional[str],
+    memory_policy: Optional[str],
+    memory: str,
+    memory_base: Optional[str],
+    devices: Optional[str],
+    kernel: str,
+    initrd: Optional[str],
+    cmdline: Optional[str],
+    image: Optional[str],
+    entrypoint: Optional[str],
+    services: Tuple[str, ...],
+    restart: Optional[str],
+    rootfs_dir: Optional[str],
+    ip_addr: Optional[str],
+    gateway: Optional[str],
+    netmask: str,
+    nic: Optional[str],
+    hostname: Optional[str],
+    console_device: Optional[str],
+    dedup: bool,
+    attach: bool,
+    verbose: bool,
+):
+    """
+    Create, load and boot a kernel instance in one step.
+
+    Runs `kerf create`, `kerf load` and `kerf exec` in turn with the given
+    resources and image. If loading fails, the new instance is deleted
+    again. With kerfd running, the whole sequence is one request.
+
+    Examples:
+
+        kerf run web-server --cpu-count=4 --memory=2GB \\
+                 --kernel=/boot/vmlinuz --image=nginx:latest
+
+        kerf run worker --cpus=128-131 --memory=4GB --kernel=/boot/vmlinuz \\
+                 --image=app:latest --service=/usr/bin/worker --restart=on-failure --attach
+    """
+    ctx.invoke(
+        create, name=name, instance_id=instance_id, cpus=cpus, cpu_count=cpu_count,
+        cpu_affinity=cpu_affinity, numa_nodes=numa_nodes, memory_policy=memory_policy,
+        memory=memory, memory_base=memory_base, devices=devices, verbose=verbose,
+    )
+
+    try:
+        ctx.invoke(
+            load, name=name, kernel=kernel, initrd=initrd, cmdline=cmdline, image=image,
+            entrypoint=entrypoint, services=services, restart=restart, rootfs_dir=rootfs_dir,
+            ip_addr=ip_addr, gateway=gateway, netmask=netmask, nic=nic, hostname=hostname,
+            console_device=console_device, dedup=dedup, verbose=verbose,
+        )
+    except SystemExit as e:
+        if e.code:
+            click.echo(f"Removing instance '{name}' after the failed load", err=True)
+            try:
+                ctx.invoke(delete, name=name, verbose=verbose)
+            except SystemExit:
+                pass
+        raise
+
+    ctx.invoke(exec_cmd, name=name, attach_console=attach, verbose=verbose)
@@ -95,21 +95,133 @@ def create(name: str, cpus: List[int], memory: int):
 ```
 
 All operations follow this same pattern, ensuring consistency and validation.
+
+Several operations can share one lock, one read, one validation and one
+overlay through a transaction:
+
+```python
+with manager.transaction() as tx:
+    tx.create_instance(web)
+    tx.update_instance(db)
+    tx.remove_instance("old-worker")
+click.echo(f"Applied transaction {tx.tx_id}")
+```
 """
 
+import copy
+import fcntl
 import os
 import re
+import signal
+import threading
+import time
 from pathlib import Path
-from typing import Callable, Optional, List, Dict
+from typing import Callable, Optional, List, Dict, Iterator, Tuple
 from contextlib import contextmanager
 
 from .dtc.parser import DeviceTreeParser
 from .dtc.overlay import OverlayGenerator
-from .dtc.validator import MultikernelValidator
+from .dtc.validator import AllocationIndex, MultikernelValidator
 from .baseline import BaselineManager
-from .models import GlobalDeviceTree
+from .models import GlobalDeviceTree, Instance
+from .timing import StageTimer
 from .exceptions import ValidationError, ParseError, KernelInterfaceError
 
+# Poll interval for lock waits off the main thread, where SIGALRM cannot
+# interrupt a blocking flock()
+_LOCK_POLL_INTERVAL = 0.01
+
+
+class _LockTimeout(Exception):
+    """Raised from SIGALRM to break out of a blocking flock()."""
+
+
+def _flock(fd: int, timeout: float) -> bool:
+    """
+    Take an exclusive flock on fd, waiting up to timeout seconds.
+
+    Returns:
+        True if the lock was taken, False on timeout
+    """
+    try:
+        fcntl.flock(fd, fcntl.LOCK_EX | fcntl.LOCK_NB)
+        return True
+    except BlockingIOError:
+        if timeout <= 0:
+            return False
+
+    if threading.current_thread() is not threading.main_thread():
+        deadline = time.monotonic() + timeout
+        while time.monotonic() < deadline:
+            time.sleep(_LOCK_POLL_INTERVAL)
+            try:
+                fcntl.flock(fd, fcntl.LOCK_EX | fcntl.LOCK_NB)
+                return True
+            except BlockingIOError:
+                continue
+        return False
+
+    def expired(signum, frame):  # pylint: disable=unused-argument
+        raise _LockTimeout()
+
+    # Sleep in the kernel until the holder releases the lock or the timer fires
+    previous = signal.signal(signal.SIGALRM, expired)
+    signal.setitimer(signal.ITIMER_REAL, timeout)
+    try:
+        fcntl.flock(fd, fcntl.LOCK_EX)
+        return True
+    except _LockTimeout:
+        return False
+    finally:
+        signal.setitimer(signal.ITIMER_REAL, 0)
+        signal.signal(signal.SIGALRM, previous)
+
+
+class Transaction:
+    """
+    Instance operations applied to the kernel as one overlay.
+
+    Each operation sees the state left by the ones before it. Use through
+    DeviceTreeManager.transaction(), which applies the result.
+
+    Attributes:
+        current: Effective state read when the transaction started
+        state: State after the operations so far
+        tx_id: Kernel transaction ID, set once the overlay is applied
+    """
+
+    def __init__(self, current: GlobalDeviceTree):
+        self.current = current
+        self.state = copy.deepcopy(current)
+        self.tx_id: Optional[str] = None
+
+    @property
+    def changed(self) -> bool:
+        """Whether any operation changed the instances."""
+        return self.state.instances != self.current.instances
+
+    def apply(self, operation: Callable[[GlobalDeviceTree], GlobalDeviceTree]) -> None:
+        """Apply an apply_operation()-style operation to the pending state."""
+        self.state = operation(self.state)
+
+    def create_instance(self, instance: Instance) -> None:
+        """Add a new instance."""
+        if instance.name in self.state.instances:
+            raise ValidationError(f"Instance '{instance.name}' already exists")
+        self.state.instances[instance.name] = instance
+
+    def update_instance(self, instance: Instance) -> None:
+        """Replace an existing instance's definition, e.g. its resources."""
+        if instance.name not in self.state.instances:
+            raise ValidationError(f"Instance '{instance.name}' does not exist")
+        self.state.instances[instance.name] = instance
+
+    def remove_instance(self, name: str) -> None:
+        """Remove an existing instance."""
+        if name not in self.state.instances:
+            raise ValidationError(f"Instance '{name}' does not exist")
+        del self.state.instances[name]
+
 
 class DeviceTreeManager:
     """
@@ -124,6 +236,7 @@ class DeviceTreeManager:
         overlays_dir: Path to overlays directory
         overlays_new: Path to write new overlays
         lock_file: Path to lock file for concurrency control
+        lock_timeout: Seconds to wait for another kerf holding the lock
         parser: DeviceTreeParser instance for reading state
         overlay_gen: OverlayGenerator instance for creating overlays
         validator: MultikernelValidator instance for validation
@@ -131,6 +244,13 @@ class DeviceTreeManager:
 
     DEFAULT_BASELINE_PATH = "/sys/fs/multikernel/device_tree"
     DEFAULT_OVERLAYS_DIR = "/sys/fs/multikernel/overlays"
+    DEFAULT_LOCK_TIMEOUT = 30.0
+
+    # Parsed root device trees by baseline path with their state_key(), shared
+    # by every manager in the process so a resident kerfd parses each state once
+    _tree_cache: Dict[Path, Tuple[tuple, GlobalDeviceTree]] = {}
+    # Allocation index of that tree's instances, built when a change is validated
+    _allocations_cache: Dict[Path, Tuple[tuple, AllocationIndex]] = {}
 
     def __init__(self, baseline_path: Optional[str] = None, overlays_dir: Optional[str] = None):
         """
@@ -150,13 +270,15 @@ class DeviceTreeManager:
         if not lock_dir.exists() or not os.access(lock_dir, os.W_OK):
             lock_dir = Path("/tmp")
         self.lock_file = lock_dir / "kerf.lock"
+        self.lock_timeout = self.DEFAULT_LOCK_TIMEOUT
+        self._lock_fd: Optional[int] = None
 
         self.parser = DeviceTreeParser()
         self.overlay_gen = OverlayGenerator()
         self.validator = MultikernelValidator()
         self.baseline_mgr = BaselineManager(str(self.baseline_path))
 
-    def read_baseline(self) -> GlobalDeviceTree:
+    def read_baseline(self, shared: bool = False) -> GlobalDeviceTree:
         """
         Read root device tree from kernel.
 
@@ -164,6 +286,12 @@ class DeviceTreeManager:
         already merged, so this returns the complete current state including
         both resources and instances.
 
+        The parsed tree is cached until an overlay transaction is added or
+        removed or the baseline is rewritten, and is shared with the other
+        managers of this process. Callers get their own copy and may modify
+        it freely, unless they pass shared=True to skip the copy and get the
+        cached tree itself, which they must not modify.
+
         Returns:
             GlobalDeviceTree model representing current complete state
 
@@ -171,9 +299,50 @@ class DeviceTreeManager:
             KernelInterfaceError: If kernel interface is inaccessible
             ParseError: If device tree cannot be parsed
         """
-        return self.baseline_mgr.read_baseline()
+        key = self.state_key()
+        cached = self._tree_cache.get(self.baseline_path)
+        if key is None or cached is None or cached[0] != key:
+            cached = (key, self.baseline_mgr.read_baseline())
+            if key is not None:
+                self._tree_cache[self.baseline_path] = cached
+        return cached[1] if shared else copy.deepcopy(cached[1])
+
+    def cache_applied(self, tree: GlobalDeviceTree) -> None:
+        """
+        Cache tree as the current state after an overlay built from it was applied.
+
+        Saves parsing what the kernel just merged. Call with the lock held,
+        so that no other overlay can have been applied in between; tree
+        must not be modified afterwards.
+        """
+        key = self.state_key()
+        if key is not None:
+            self._tree_cache[self.baseline_path] = (key, tree)
+
+    def state_key(self) -> Optional[tuple]:
+        """
+        Identify the current root device tree without reading it.
 
-    def apply_overlay(self, current: GlobalDeviceTree, modified: GlobalDeviceTree) -> str:
+        Every overlay applied or rolled back changes the set of tx_N
+        directories, keyed here by the latest ID and their count. The
+        baseline's mtime and size cover `kerf init` rewriting it. None when
+        the baseline cannot be examined, which disables caching.
+        """
+        try:
+            st = self.baseline_path.stat()
+        except OSError:
+            return None
+
+        tx_ids = self._transaction_ids()
+        return (max(tx_ids, default=None), len(tx_ids), st.st_mtime_ns, st.st_size)
+
+    def invalidate_cache(self) -> None:
+        """Drop the cached root device tree so the next read parses it again."""
+        self._tree_cache.pop(self.baseline_path, None)
+        self._allocations_cache.pop(self.baseline_path, None)
+
+    def apply_overlay(self, current: GlobalDeviceTree, modified: GlobalDeviceTree,
+                      timer: Optional[StageTimer] = None) -> str:
         """
         Apply overlay by writing DTBO to kernel.
 
@@ -184,6 +353,7 @@ class DeviceTreeManager:
         Args:
             current: Current effective state (before change)
             modified: Modified state (after change)
+            timer: Optional StageTimer that receives per-stage timings
 
         Returns:
             Transaction ID (from kernel-created directory)
@@ -192,6 +362,32 @@ class DeviceTreeManager:
             ValidationError: If modified state validation fails
             KernelInterfaceError: If overlay application fails
         """
+        timer = timer or StageTimer()
+        dtbo_data = self.build_overlay(current, modified, timer)
+        with timer.stage("write"):
+            return self._write_overlay(dtbo_data)
+
+    def build_overlay(self, current: GlobalDeviceTree, modified: GlobalDeviceTree,
+                      timer: Optional[StageTimer] = None) -> bytes:
+        """
+        Validate a change and generate its DTBO without applying it.
+
+        Raises:
+            ValidationError: If modified state validation fails
+            KernelInterfaceError: If the overlay cannot be generated
+        """
+        timer = timer or StageTimer()
+        with timer.stage("validate"):
+            self._validate_change(current, modified)
+
+        try:
+            with timer.stage("generate"):
+                return self.overlay_gen.generate_overlay(current, modified)
+        except Exception as e:
+            raise KernelInterfaceError(f"Failed to generate overlay: {e}") from e
+
+    def _validate_change(self, current: GlobalDeviceTree, modified: GlobalDeviceTree) -> None:
+        """Check modified is a valid state reachable from current by an overlay."""
         # Validate overlay doesn't modify resources
         if current.hardware != modified.hardware:
             raise ValidationError(
@@ -200,8 +396,11 @@ class DeviceTreeManager:
                 "Current and modified states have different hardware definitions."
             )
 
-        # Validate modified state before generating overlay
-        validation_result = self.validator.validate(modified)
+        # Validate modified state before generating overlay; current is the
+        # kernel's accepted state, so only the instances that change are checked
+        validation_result = self.validator.validate_delta(
+            current, modified, self._allocations(current)
+        )
         if not validation_result.is_valid:
             error_msg = "Cannot apply overlay with invalid state:\n"
             error_msg += "\n".join(f"  - {err}" for err in validation_result.errors)
@@ -210,11 +409,27 @@ class DeviceTreeManager:
                 error_msg += "\n".join(f"  - {warn}" for warn in validation_result.warnings)
             raise ValidationError(error_msg)
 
-        try:
-            dtbo_data = self.overlay_gen.generate_overlay(current, modified)
-        except Exception as e:
-            raise KernelInterfaceError(f"Failed to generate overlay: {e}") from e
+    def _allocations(self, current: GlobalDeviceTree) -> AllocationIndex:
+        """
+        Index current's instances, reusing the index while state_key() is unchanged.
+
+        current must be the state read under the lock held by the caller.
+        """
+        key = self.state_key()
+        cached = self._allocations_cache.get(self.baseline_path)
+        if key is None or cached is None or cached[0] != key:
+            cached = (key, AllocationIndex(current.instances.values()))
+            if key is not None:
+                self._allocations_cache[self.baseline_path] = cached
+        return cached[1]
+
+    def _write_overlay(self, dtbo_data: bytes) -> str:
+        """
+        Write a DTBO to the kernel and return the transaction it created.
 
+        Raises:
+            KernelInterfaceError: If the write fails or the kernel reports failure
+        """
         try:
             if not self.overlays_new.exists():
                 raise KernelInterfaceError(f"Overlay interface not found: {self.overlays_new}")
@@ -284,69 +499,28 @@ class DeviceTreeManager:
             except Exception as e:
                 raise KernelInterfaceError(f"Failed to generate removal overlay: {e}") from e
 
-            try:
-                if not self.overlays_new.exists():
-                    raise KernelInterfaceError(f"Overlay interface not found: {self.overlays_new}")
-
-                with open(self.overlays_new, "wb") as f:
-                    f.write(dtbo_data)
-
-                tx_id = self._find_latest_transaction()
-                if not tx_id:
-                    raise KernelInterfaceError(
-                        "Overlay written but kernel did not create transaction directory"
-                    )
-
-                tx_dir = self.overlays_dir / f"tx_{tx_id}"
-                status_file = tx_dir / "status"
-
-                if status_file.exists():
-                    try:
-                        with open(status_file, "r", encoding="utf-8") as f:
-                            status = f.read().strip()
-                        if status not in ("applied", "success", "ok"):
-                            error_msg = (
-                                f"Overlay transaction {tx_id} failed with status: '{status}'"
-                            )
-                            instance_file = tx_dir / "instance"
-                            if instance_file.exists():
-                                try:
-                                    with open(instance_file, "r", encoding="utf-8") as f:
-                                        tx_instance_name = f.read().strip()
-                                    error_msg += f" (instance: {tx_instance_name})"
-                                except OSError:
-                                    pass
-                            raise KernelInterfaceError(error_msg)
-                    except OSError:
-                        pass
-
-                return tx_id
-
-            except OSError as e:
-                raise KernelInterfaceError(
-                    f"Failed to write overlay to {self.overlays_new}: {e}"
-                ) from e
+            return self._write_overlay(dtbo_data)
 
-    def _find_latest_transaction(self) -> Optional[str]:
-        """Find the latest transaction ID from kernel-created directories."""
+    def _transaction_ids(self) -> Dict[int, str]:
+        """IDs of the kernel-created tx_N transaction directories, by value."""
         if not self.overlays_dir.exists():
-            return None
-
-        max_tx_id = None
-        max_id = -1
+            return {}
 
+        tx_ids = {}
         for tx_dir in self.overlays_dir.iterdir():
             if not tx_dir.is_dir():
                 continue
 
             match = re.match(r"^tx_(\d+)$", tx_dir.name)
             if match:
-                tx_id = int(match.group(1))
-                if tx_id > max_id:
-                    max_id = tx_id
-                    max_tx_id = match.group(1)
+                tx_ids[int(match.group(1))] = match.group(1)
 
-        return max_tx_id
+        return tx_ids
+
+    def _find_latest_transaction(self) -> Optional[str]:
+        """Find the latest transaction ID from kernel-created directories."""
+        tx_ids = self._transaction_ids()
+        return tx_ids[max(tx_ids)] if tx_ids else None
 
     def rollback_transaction(self, tx_id: str) -> None:
         """
@@ -419,7 +593,12 @@ class DeviceTreeManager:
     @contextmanager
     def _acquire_lock(self):
         """
-        Acquire file lock for concurrency safety.
+        Hold the kerf lock, an flock on lock_file, for the enclosed block.
+
+        Waits for the current holder for up to lock_timeout seconds. The
+        kernel drops the lock when its holder exits, so a crashed kerf
+        never leaves a stale lock behind. Nested use on one manager is
+        a no-op, so transactions can call locking methods.
 
         Yields:
             Lock context
@@ -427,40 +606,71 @@ class DeviceTreeManager:
         Raises:
             KernelInterfaceError: If lock cannot be acquired
         """
-        lock_acquired = False
+        if self._lock_fd is not None:
+            yield
+            return
 
         try:
-            max_retries = 10
-            retry_delay = 0.1
+            fd = os.open(self.lock_file, os.O_RDWR | os.O_CREAT | os.O_CLOEXEC, 0o644)
+        except OSError as e:
+            raise KernelInterfaceError(f"Could not open lock file {self.lock_file}: {e}") from e
 
-            for _ in range(max_retries):
-                try:
-                    if not self.lock_file.exists():
-                        self.lock_file.touch(exist_ok=False)
-                        lock_acquired = True
-                        break
-                    import time
+        try:
+            if not _flock(fd, self.lock_timeout):
+                holder = os.pread(fd, 32, 0).decode("ascii", "replace").strip()
+                raise KernelInterfaceError(
+                    f"Could not acquire lock {self.lock_file} within {self.lock_timeout:g}s"
+                    + (f" (held by pid {holder})" if holder else "")
+                    + ". Another kerf operation may be in progress."
+                )
+            # Record the holder for the message above; purely informational
+            os.ftruncate(fd, 0)
+            os.pwrite(fd, f"{os.getpid()}\n".encode("ascii"), 0)
+        except BaseException:
+            os.close(fd)
+            raise
+
+        self._lock_fd = fd
+        try:
+            yield
+        finally:
+            self._lock_fd = None
+            # Closing the last descriptor releases the flock
+            os.close(fd)
+
+    @contextmanager
+    def transaction(self) -> Iterator["Transaction"]:
+        """
+        Group several instance operations into one overlay.
 
-                    time.sleep(retry_delay)
-                except FileExistsError:
-                    import time
+        The lock is held and the root device tree read once for the whole
+        block. Operations on the yielded Transaction build on each other's
+        results. When the block exits cleanly, the final state is validated
+        once and written as a single DTBO; on an exception nothing is applied.
 
-                    time.sleep(retry_delay)
-                    continue
+        Yields:
+            Transaction whose tx_id is set once the overlay is applied
 
-            if not lock_acquired:
-                raise KernelInterfaceError(
-                    f"Could not acquire lock after {max_retries} attempts. "
-                    "Another kerf operation may be in progress."
-                )
+        Raises:
+            ValidationError: If the combined state is invalid
+            KernelInterfaceError: If kernel interface operations fail
+        """
+        with self._acquire_lock():
+            tx = Transaction(self.read_baseline())
+            yield tx
 
-            yield
+            if not tx.changed:
+                return
 
-        finally:
-            if lock_acquired and self.lock_file.exists():
-                self.lock_file.unlink()
+            self._validate_change(tx.current, tx.state)
+            try:
+                dtbo_data = self.overlay_gen.generate_transaction_overlay(tx.current, tx.state)
+            except Exception as e:
+                raise KernelInterfaceError(f"Failed to generate overlay: {e}") from e
+            tx.tx_id = self._write_overlay(dtbo_data)
 
-    def apply_operation(self, operation: Callable[[GlobalDeviceTree], GlobalDeviceTree]) -> str:
+    def apply_operation(self, operation: Callable[[GlobalDeviceTree], GlobalDeviceTree],
+                        timer: Optional[StageTimer] = None) -> str:
         """
         Apply an operation transactionally via overlay.
 
@@ -477,6 +687,8 @@ class DeviceTreeManager:
         Args:
             operation: Callable that takes GlobalDeviceTree and returns modified
                       GlobalDeviceTree. Should raise appropriate exceptions for errors.
+            timer: Optional StageTimer that receives the read, operation,
+                   validate, generate and write stages
 
         Returns:
             Transaction ID from applied overlay
@@ -486,15 +698,18 @@ class DeviceTreeManager:
             KernelInterfaceError: If kernel interface operations fail
             Any exceptions raised by the operation function
         """
+        timer = timer or StageTimer()
         with self._acquire_lock():
-            current = self.read_baseline()
+            with timer.stage("read"):
+                current = self.read_baseline()
 
             # Apply operation (returns modified state)
-            modified = operation(current)
+            with timer.stage("operation"):
+                modified = operation(current)
 
             # Generate overlay comparing current effective to modified
             # Each overlay represents incremental change from current state
-            tx_id = self.apply_overlay(current, modified)
+            tx_id = self.apply_overlay(current, modified, timer)
 
             return tx_id
 
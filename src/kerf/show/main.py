@@ -20,6 +20,7 @@ instance information from /sys/fs/multikernel/instances/*, and kernel image info
 from /proc/kimage in an organized format.
 """
 
+import json
 import re
 import sys
 from pathlib import Path
@@ -31,7 +32,16 @@ import libfdt
 from ..baseline import BaselineManager
 from ..dtc.parser import DeviceTreeParser
 from ..exceptions import KernelInterfaceError, ParseError
+from ..health import InstanceHealth, read_instance_health
 from ..models import GlobalDeviceTree
+from ..resources import memory_fragmentation
+from ..timing import (
+    format_boot_timing,
+    load_boot_timing,
+    parse_init_timing,
+    record_init_timing,
+    tsc_khz,
+)
 from ..utils import get_instance_id_from_name, get_instance_status
 
 
@@ -286,9 +296,15 @@ def display_baseline_info(tree: GlobalDeviceTree, verbose: bool = False):
     if verbose and hardware.cpus.topology:
         click.echo("\n    Topology:")
         for cpu_id, topo in sorted(hardware.cpus.topology.items()):
-            click.echo(
-                f"      CPU {cpu_id}: NUMA {topo.numa_node}, Socket {topo.socket_id}, Core {topo.core_id}, Thread {topo.thread_id}"
+            line = (
+                f"      CPU {cpu_id}: NUMA {topo.numa_node}, Socket {topo.socket_id}, "
+                f"Core {topo.core_id}, Thread {topo.thread_id}"
             )
+            if topo.llc_id is not None:
+                line += f", LLC {topo.llc_id}"
+            if len(topo.siblings) > 1:
+                line += f", SMT siblings {topo.siblings}"
+            click.echo(line)
 
     # Memory Information
     click.echo("\n  Memory:")
@@ -337,10 +353,31 @@ def display_baseline_info(tree: GlobalDeviceTree, verbose: bool = False):
                     click.echo(f"      Available NS:  {device_info.available_ns}")
 
 
+def display_health(health: InstanceHealth):
+    """
+    Display the status record kerf-init keeps for the host.
+
+    Args:
+        health: Snapshot read from the instance's status page
+    """
+    import rdtsc  # pylint: disable=import-outside-toplevel
+
+    age = health.age_seconds(rdtsc.get_cycles(), tsc_khz())
+    click.echo("\n  Health:")
+    click.echo(f"    {'State':15} {health.state}")
+    click.echo(f"    {'Last Update':15} {age:.1f}s ago ({health.heartbeats} heartbeats)")
+    for i, svc in enumerate(health.services):
+        detail = f"pid {svc.pid}" if svc.state == "running" else f"status {svc.exit_status}"
+        click.echo(
+            f"    {f'Service {i}':15} {svc.state}, {detail}, {svc.restarts} restarts"
+        )
+
+
 def display_instance_info(
     instance_info: Dict[str, Optional[str]],
     kimage_data: Optional[Dict[str, str]] = None,
     verbose: bool = False,
+    health: Optional[InstanceHealth] = None,
 ):
     """
     Display formatted instance information.
@@ -349,6 +386,7 @@ def display_instance_info(
         instance_info: Instance information dictionary
         kimage_data: Optional kimage data for this instance
         verbose: Whether to show verbose information
+        health: Optional kerf-init status record for this instance
     """
     name = instance_info.get("name", "unknown")
     instance_id = instance_info.get("id")
@@ -375,6 +413,9 @@ def display_instance_info(
     elif instance_id and verbose:
         click.echo("\n  Kernel Image:     (not loaded)")
 
+    if health:
+        display_health(health)
+
     # Device tree source
     if "device_tree_source" in instance_info and instance_info["device_tree_source"]:
         dts = instance_info["device_tree_source"]
@@ -416,10 +457,105 @@ def display_instance_info(
             click.echo(f"    {key_display:15} {value_str}")
 
 
+def display_boot_timing(name: str, khz: float):
+    """
+    Display the recorded boot timeline of an instance.
+
+    Args:
+        name: Instance name
+        khz: Host TSC frequency in kHz
+    """
+    click.echo(f"\n{'=' * 80}")
+    click.echo(f"Boot Timing: {name}")
+    click.echo(f"{'=' * 80}")
+
+    data = load_boot_timing(name)
+    lines = format_boot_timing(data, khz) if data else []
+    if not lines:
+        click.echo("  No kerf-init timing records recorded.")
+        click.echo("  Boot with `kerf exec --console`, or import a saved console log")
+        click.echo("  with --timing-log.")
+        return
+
+    if data.get("exec_tsc") is None:
+        click.echo("  (no `kerf exec` TSC recorded; times are relative to init start)")
+    for line in lines:
+        click.echo(line)
+
+
+def display_fragmentation(tree: GlobalDeviceTree):
+    """Display free memory and the largest free extent of the pool per NUMA node."""
+    click.echo(f"\n{'=' * 80}")
+    click.echo("Memory Pool Fragmentation")
+    click.echo(f"{'=' * 80}")
+    click.echo(
+        f"  {'NODE':<6} {'FREE':>12} {'LARGEST EXTENT':>16} {'EXTENTS':>8} {'LARGEST/FREE':>13}"
+    )
+    for node, free, largest, count in memory_fragmentation(tree):
+        label = "pool" if node is None else str(node)
+        ratio = f"{largest / free * 100:.1f}%" if free else "-"
+        click.echo(
+            f"  {label:<6} {free / 1024**3:9.2f} GB {largest / 1024**3:13.2f} GB "
+            f"{count:>8} {ratio:>13}"
+        )
+    click.echo()
+
+
+def show_timing(name: Optional[str], timing_log: Optional[str]):
+    """Show boot timelines for one instance, or for all of them."""
+    if timing_log:
+        if not name:
+            click.echo("Error: --timing-log requires an instance name", err=True)
+            sys.exit(2)
+        with open(timing_log, "r", encoding="utf-8", errors="replace") as f:
+            records = parse_init_timing(f.read())
+        if not records:
+            click.echo(f"Error: No kerf-init timing records in {timing_log}", err=True)
+            sys.exit(1)
+        record_init_timing(name, records)
+
+    names = [name] if name else get_all_instance_names()
+    if not names:
+        click.echo("No instances found in /sys/fs/multikernel/instances/")
+        return
+
+    khz = tsc_khz()
+    for inst_name in names:
+        display_boot_timing(inst_name, khz)
+    click.echo()
+
+
 @click.command(name="show")
 @click.argument("name", required=False)
+@click.option("--timing", is_flag=True, help="Show the boot-phase timeline from kexec to entrypoint")
+@click.option(
+    "--timing-log",
+    type=click.Path(exists=True, dir_okay=False),
+    help="Import kerf-init timing records from a saved console log (implies --timing)",
+)
+@click.option(
+    "--fragmentation",
+    is_flag=True,
+    help="Show free memory and the largest free extent of the pool per NUMA node",
+)
+@click.option("--json", "as_json", is_flag=True, help="Print one machine-readable JSON snapshot")
+@click.option(
+    "--watch",
+    is_flag=True,
+    help="Stream a JSON snapshot, then a JSON delta line whenever something changes",
+)
+@click.option(
+    "--interval",
+    type=click.FloatRange(min=0.05),
+    default=1.0,
+    show_default=True,
+    help="Seconds between refreshes with --watch",
+)
 @click.option("--verbose", "-v", is_flag=True, help="Verbose output")
-def show(name: Optional[str], verbose: bool):
+def show(
+    name: Optional[str], timing: bool, timing_log: Optional[str], fragmentation: bool,
+    as_json: bool, watch: bool, interval: float, verbose: bool,
+):
     """
     Show kernel instance information and baseline hardware resources.
 
@@ -430,13 +566,69 @@ def show(name: Optional[str], verbose: bool):
     Without an instance name, it shows baseline and all instances.
     With a specific instance name, it shows only that instance (no baseline).
 
+    With --fragmentation, it shows how the free memory of the pool is
+    split up: a request larger than the largest free extent of a node
+    cannot be placed there, however much memory is free in total.
+
+    With --timing, it shows the cold-start breakdown recorded for each
+    instance: the host TSC at `kerf exec` followed by the TSC stamps
+    kerf-init logs after cmdline parsing, mounting, console setup, right
+    before execv and at first child exit.
+
+    With --json, it prints one JSON object with each instance's ID, status,
+    kernel image, allocation and health, plus the free resources of the
+    pool. With --watch, it prints that snapshot as one line and then keeps
+    running, printing only what changed as one JSON delta line per change,
+    so monitors need not re-run and diff `kerf show`.
+
     Examples:
 
         kerf show
         kerf show web-server
         kerf show --verbose
+        kerf show web-server --timing
+        kerf show --fragmentation
+        kerf show --json
+        kerf show web-server --watch
     """
     try:
+        if as_json or watch:
+            # Imported here: the snapshot module builds on this one
+            # pylint: disable=import-outside-toplevel
+            from .snapshot import Snapshotter, watch as watch_snapshots
+
+            if name and get_instance_id_from_name(name) is None:
+                click.echo(f"Error: Instance '{name}' not found", err=True)
+                sys.exit(1)
+            names = [name] if name else None
+            if watch:
+                try:
+                    watch_snapshots(click.echo, names, interval)
+                except KeyboardInterrupt:
+                    # Ctrl+C is how a watch ends
+                    pass
+            else:
+                click.echo(json.dumps(Snapshotter().collect(names), indent=2))
+            return
+
+        if fragmentation:
+            if name:
+                click.echo("Error: --fragmentation takes no instance name", err=True)
+                sys.exit(2)
+            try:
+                display_fragmentation(BaselineManager().read_baseline())
+            except (KernelInterfaceError, ParseError) as e:
+                click.echo(f"Error: Could not read baseline: {e}", err=True)
+                sys.exit(1)
+            return
+
+        if timing or timing_log:
+            if name and get_instance_id_from_name(name) is None:
+                click.echo(f"Error: Instance '{name}' not found", err=True)
+                sys.exit(1)
+            show_timing(name, timing_log)
+            return
+
         # Read /proc/kimage content
         kimage_content = read_proc_kimage()
         kimage_table = parse_kimage_table(kimage_content)
@@ -457,7 +649,9 @@ def show(name: Optional[str], verbose: bool):
             kimage_data = kimage_table.get(instance_id)
 
             # Display information
-            display_instance_info(instance_info, kimage_data, verbose)
+            display_instance_info(
+                instance_info, kimage_data, verbose, read_instance_health(name)
+            )
         else:
             # Show all instances and baseline
             instance_names = get_all_instance_names()
@@ -503,7 +697,9 @@ def show(name: Optional[str], verbose: bool):
                     except (ValueError, TypeError):
                         pass
 
-                display_instance_info(instance_info, kimage_data, verbose)
+                display_instance_info(
+                    instance_info, kimage_data, verbose, read_instance_health(inst_name)
+                )
 
             click.echo()
 
@@ -0,0 +1,202 @@
+# Copyright 2026 Multikernel Technologies, Inc.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""
+Machine-readable instance state, for `kerf show --json` and `--watch`.
+
+A snapshot holds what monitoring needs: per instance its ID, status,
+kernel image, allocation and kerf-init health, plus the pool's free
+resources. There is no DTS conversion or text formatting.
+
+A resident Snapshotter refreshes cheaply. /proc/kimage is re-parsed only
+when its text changes. The root device tree is re-parsed only when
+DeviceTreeManager.state_key() changes, i.e. an overlay transaction was
+added or removed or the baseline was rewritten. The health records leave
+out the heartbeat count and TSC, so a snapshot changes only when
+something a monitor acts on does.
+"""
+
+import json
+import time
+from typing import Any, Callable, Dict, Iterable, Optional
+
+from ..exceptions import KernelInterfaceError, ParseError
+from ..health import InstanceHealth, read_instance_health
+from ..resources import get_available_cpus, memory_fragmentation
+from ..runtime import DeviceTreeManager
+from ..utils import get_instance_id_from_name, get_instance_status
+from .main import get_all_instance_names, parse_kimage_table, read_proc_kimage
+
+# Seconds between refreshes in watch mode
+WATCH_DEFAULT_INTERVAL = 1.0
+
+Snapshot = Dict[str, Any]
+
+
+def _health_record(health: Optional[InstanceHealth]) -> Optional[Dict[str, Any]]:
+    if health is None:
+        return None
+    return {
+        "state": health.state,
+        "services": [
+            {"state": svc.state, "pid": svc.pid, "exit_status": svc.exit_status,
+             "restarts": svc.restarts}
+            for svc in health.services
+        ],
+    }
+
+
+class Snapshotter:
+    """Builds snapshots, reusing parsed kimage and device tree state while unchanged."""
+
+    def __init__(self, manager: Optional[DeviceTreeManager] = None):
+        self.manager = manager or DeviceTreeManager()
+        self._kimage_text: Optional[str] = None
+        self._kimage_table: Dict[int, Dict[str, str]] = {}
+        self._tree_key: Optional[tuple] = None
+        self._tree_state: Optional[Dict[str, Any]] = None
+
+    def _kimage(self) -> Dict[int, Dict[str, str]]:
+        text = read_proc_kimage()
+        if text != self._kimage_text:
+            self._kimage_text = text
+            self._kimage_table = parse_kimage_table(text)
+        return self._kimage_table
+
+    def _tree(self) -> Dict[str, Any]:
+        """Pool resources and per-instance allocations from the root device tree."""
+        key = self.manager.state_key()
+        if key is not None and key == self._tree_key and self._tree_state is not None:
+            return self._tree_state
+
+        try:
+            # Cached here by key already; skip the manager's defensive copy
+            tree = self.manager.baseline_mgr.read_baseline()
+        except (KernelInterfaceError, ParseError) as e:
+            state = {"resources": None, "allocations": {}, "error": str(e)}
+        else:
+            memory = tree.hardware.memory
+            state = {
+                "resources": {
+                    "cpus": sorted(tree.hardware.cpus.available),
+                    "cpus_free": sorted(get_available_cpus(tree)),
+                    "memory_pool_base": memory.memory_pool_base,
+                    "memory_pool_bytes": memory.memory_pool_bytes,
+                    # From the tree alone: /proc/iomem changes would not bump the key
+                    "memory_free_bytes": memory_fragmentation(tree, use_iomem=False)[-1][1],
+                    "devices": sorted(tree.hardware.devices or {}),
+                },
+                "allocations": {
+                    name: {
+                        "cpus": list(inst.resources.cpus),
+                        "memory_base": inst.resources.memory_base,
+                        "memory_bytes": inst.resources.memory_bytes,
+                        "devices": list(inst.resources.devices),
+                    }
+                    for name, inst in tree.instances.items()
+                },
+            }
+        self._tree_key, self._tree_state = key, state
+        return state
+
+    def collect(self, names: Optional[Iterable[str]] = None) -> Snapshot:
+        """
+        Take a snapshot of the named instances (default: all, plus resources).
+
+        Returns:
+            {"instances": {name: {...}}, "resources": {...}}; resources is
+            left out when names are given
+        """
+        kimage = self._kimage()
+        tree = self._tree()
+        selected = sorted(names) if names is not None else get_all_instance_names()
+
+        instances = {}
+        for name in selected:
+            instance_id = get_instance_id_from_name(name)
+            if instance_id is None:
+                continue
+            instances[name] = {
+                "id": instance_id,
+                "status": get_instance_status(name),
+                "kimage": kimage.get(instance_id),
+                "resources": tree["allocations"].get(name),
+                "health": _health_record(read_instance_health(name)),
+            }
+
+        snapshot: Snapshot = {"instances": instances}
+        if names is None:
+            snapshot["resources"] = tree["resources"]
+            if "error" in tree:
+                snapshot["error"] = tree["error"]
+        return snapshot
+
+
+def diff_snapshots(old: Snapshot, new: Snapshot) -> Optional[Dict[str, Any]]:
+    """
+    Describe how new differs from old.
+
+    Returns:
+        None if they are equal, else a delta with "added" (full instance
+        records), "removed" (names), "changed" (name -> the fields that
+        changed, with their new values), and "resources" when the pool
+        changed
+    """
+    if old == new:
+        return None
+
+    old_instances, new_instances = old["instances"], new["instances"]
+    delta: Dict[str, Any] = {
+        "added": {n: new_instances[n] for n in sorted(new_instances) if n not in old_instances},
+        "removed": sorted(n for n in old_instances if n not in new_instances),
+        "changed": {},
+    }
+    for name in sorted(new_instances):
+        before = old_instances.get(name)
+        if before is None or before == new_instances[name]:
+            continue
+        after = new_instances[name]
+        delta["changed"][name] = {k: v for k, v in after.items() if before.get(k) != v}
+
+    for key in ("resources", "error"):
+        if old.get(key) != new.get(key):
+            delta[key] = new.get(key)
+    return delta
+
+
+def watch(
+    emit: Callable[[str], None],
+    names: Optional[Iterable[str]] = None,
+    interval: float = WATCH_DEFAULT_INTERVAL,
+    stop: Callable[[], bool] = lambda: False,
+    snapshotter: Optional[Snapshotter] = None,
+) -> None:
+    """
+    Emit a snapshot line, then one JSON delta line per change, until stop().
+
+    Every line is one JSON object with "type" ("snapshot" or "delta") and
+    "time" (Unix seconds).
+    """
+    names = list(names) if names is not None else None
+    snapshotter = snapshotter or Snapshotter()
+
+    current = snapshotter.collect(names)
+    emit(json.dumps({"type": "snapshot", "time": time.time(), **current}))
+    while not stop():
+        time.sleep(interval)
+        latest = snapshotter.collect(names)
+        delta = diff_snapshots(current, latest)
+        if delta is not None:
+            emit(json.dumps({"type": "delta", "time": time.time(), **delta}))
+            current = latest
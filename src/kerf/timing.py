@@ -0,0 +1,268 @@
+# Copyright 2026 Multikernel Technologies, Inc.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""
+Wall-clock stage timing for kerf commands, and spawn boot timelines.
+
+Commands wrap each phase of their work in StageTimer.stage() and print the
+breakdown on request, e.g. `kerf load --stats` or `kerf create --verbose`.
+`kerf bench` repeats the same stages and reduces the rounds to percentiles
+with summarize_stages().
+
+Boot timelines join the host TSC taken by `kerf exec` right before the
+reboot syscall with the "kerf-init: timing" records the spawn init writes
+to its kmsg. Both sides read the same invariant TSC, so the difference is
+the kexec-to-phase latency. Records reach the host over the instance
+console and are kept per instance under KERF_TIMING_DIR.
+"""
+
+import json
+import math
+import os
+import re
+import time
+from contextlib import contextmanager
+from pathlib import Path
+from typing import Dict, List, Optional, Sequence
+
+KERF_TIMING_DIR = "/var/lib/kerf/timing"
+
+# Phases kerf-init stamps, in boot order ("prefault" and "console" only
+# with kerf.prefault= and console=)
+BOOT_PHASES = ("start", "cmdline", "mounted", "prefault", "console", "exec", "child_exit")
+
+INIT_TIMING_MARKER = b"kerf-init: timing "
+_INIT_TIMING_RE = re.compile(r"kerf-init: timing phase=(\w+) tsc=(\d+)")
+
+TSC_FREQ_KHZ_PATH = "/sys/devices/system/cpu/cpu0/tsc_freq_khz"
+TSC_CALIBRATE_SECONDS = 0.05
+
+
+class StageTimer:
+    """Accumulates elapsed wall-clock time per named stage."""
+
+    def __init__(self):
+        # Insertion-ordered, so the report follows execution order
+        self.stages: Dict[str, float] = {}
+
+    @contextmanager
+    def stage(self, name: str):
+        """Time the enclosed block and add it to the named stage."""
+        start = time.perf_counter()
+        try:
+            yield
+        finally:
+            elapsed = time.perf_counter() - start
+            self.stages[name] = self.stages.get(name, 0.0) + elapsed
+
+    def total(self) -> float:
+        """Total seconds across all recorded stages."""
+        return sum(self.stages.values())
+
+    def format_lines(self) -> List[str]:
+        """Format the breakdown as aligned 'stage  ms  %' lines."""
+        if not self.stages:
+            return []
+
+        total = self.total()
+        width = max(len(name) for name in self.stages)
+        lines = []
+        for name, seconds in self.stages.items():
+            pct = (seconds / total * 100) if total > 0 else 0.0
+            lines.append(f"  {name:<{width}}  {seconds * 1000:10.1f} ms  {pct:5.1f}%")
+        lines.append(f"  {'total':<{width}}  {total * 1000:10.1f} ms")
+        return lines
+
+
+def percentile(samples: Sequence[float], pct: float) -> float:
+    """Nearest-rank percentile of samples, which must not be empty."""
+    ordered = sorted(samples)
+    rank = max(1, math.ceil(pct / 100 * len(ordered)))
+    return ordered[rank - 1]
+
+
+def summarize_stages(timers: Sequence[StageTimer]) -> Dict[str, Dict[str, float]]:
+    """
+    Reduce repeated runs to per-stage statistics in milliseconds.
+
+    Each timer is one round; a stage missing from some rounds is
+    summarized over the rounds that have it. Stages follow the order of
+    their first appearance, with the round total last.
+    """
+    samples: Dict[str, List[float]] = {}
+    for timer in timers:
+        for name, seconds in timer.stages.items():
+            samples.setdefault(name, []).append(seconds * 1000)
+    if timers:
+        samples["total"] = [timer.total() * 1000 for timer in timers]
+
+    def stats(values: List[float]) -> Dict[str, float]:
+        # Microseconds are resolution enough and keep reports readable
+        return {
+            "n": len(values),
+            "min": round(min(values), 3),
+            "p50": round(percentile(values, 50), 3),
+            "p90": round(percentile(values, 90), 3),
+            "p99": round(percentile(values, 99), 3),
+            "max": round(max(values), 3),
+            "mean": round(sum(values) / len(values), 3),
+        }
+
+    return {name: stats(values) for name, values in samples.items()}
+
+
+def parse_init_timing(text: str) -> Dict[str, int]:
+    """
+    Parse kerf-init timing records out of console or kmsg output.
+
+    Only the first record of each phase is kept, so a log holding several
+    boots yields the earliest one.
+    """
+    records: Dict[str, int] = {}
+    for match in _INIT_TIMING_RE.finditer(text):
+        records.setdefault(match.group(1), int(match.group(2)))
+    return records
+
+
+class InitTimingScanner:
+    """
+    Picks kerf-init timing records out of a console byte stream.
+
+    Console reads split lines at arbitrary points, so the trailing partial
+    line is carried over to the next feed().
+    """
+
+    MAX_PARTIAL = 256
+
+    def __init__(self):
+        self._partial = b""
+        self.records: Dict[str, int] = {}
+
+    def feed(self, data: bytes) -> bool:
+        """Scan a chunk; return True if it completed any new record."""
+        buf = self._partial + data
+        end = buf.rfind(b"\n")
+        if end < 0:
+            self._partial = buf[-self.MAX_PARTIAL:]
+            return False
+        self._partial = buf[end + 1:][-self.MAX_PARTIAL:]
+
+        lines = buf[:end]
+        if INIT_TIMING_MARKER not in lines:
+            return False
+
+        found = False
+        for phase, tsc in parse_init_timing(lines.decode("utf-8", "replace")).items():
+            if phase not in self.records:
+                self.records[phase] = tsc
+                found = True
+        return found
+
+
+def _timing_path(instance_name: str) -> Path:
+    return Path(KERF_TIMING_DIR) / f"{instance_name}.json"
+
+
+def _write_timing(instance_name: str, data: Dict) -> None:
+    path = _timing_path(instance_name)
+    path.parent.mkdir(parents=True, exist_ok=True)
+    tmp = path.with_suffix(".tmp")
+    with open(tmp, "w", encoding="utf-8") as f:
+        json.dump(data, f)
+    os.replace(tmp, path)
+
+
+def load_boot_timing(instance_name: str) -> Optional[Dict]:
+    """Load the recorded boot timeline for an instance, if any."""
+    try:
+        with open(_timing_path(instance_name), "r", encoding="utf-8") as f:
+            return json.load(f)
+    except (OSError, ValueError):
+        return None
+
+
+def record_exec_tsc(instance_name: str, tsc: int) -> None:
+    """Start a new boot timeline from the host TSC taken at `kerf exec`."""
+    _write_timing(instance_name, {"exec_tsc": tsc, "phases": {}})
+
+
+def record_init_timing(instance_name: str, records: Dict[str, int]) -> None:
+    """Merge kerf-init records into the instance's current boot timeline."""
+    data = load_boot_timing(instance_name) or {"exec_tsc": None, "phases": {}}
+    phases = data.setdefault("phases", {})
+    for phase, tsc in records.items():
+        phases.setdefault(phase, tsc)
+    _write_timing(instance_name, data)
+
+
+def tsc_khz() -> float:
+    """
+    Host TSC frequency in kHz.
+
+    Uses the kernel's tsc_freq_khz where exported, otherwise calibrates
+    the TSC against the monotonic clock.
+    """
+    try:
+        with open(TSC_FREQ_KHZ_PATH, "r", encoding="utf-8") as f:
+            return float(f.read().strip())
+    except (OSError, ValueError):
+        pass
+
+    import rdtsc  # pylint: disable=import-outside-toplevel
+
+    start_ns = time.perf_counter_ns()
+    start_tsc = rdtsc.get_cycles()
+    time.sleep(TSC_CALIBRATE_SECONDS)
+    cycles = rdtsc.get_cycles() - start_tsc
+    elapsed_ns = time.perf_counter_ns() - start_ns
+    return cycles * 1e6 / elapsed_ns
+
+
+def format_boot_timing(data: Dict, khz: float) -> List[str]:
+    """
+    Format a boot timeline as aligned 'phase  ms-since-exec  +delta' lines.
+
+    Phases are measured from the `kerf exec` TSC when one was recorded,
+    otherwise from kerf-init's own start stamp.
+    """
+    phases = data.get("phases") or {}
+    ordered = [(p, phases[p]) for p in BOOT_PHASES if p in phases]
+    ordered += sorted((p, t) for p, t in phases.items() if p not in BOOT_PHASES)
+    if not ordered:
+        return []
+
+    exec_tsc = data.get("exec_tsc")
+    rows = [("kexec", exec_tsc)] if exec_tsc is not None else []
+    rows += ordered
+    base = rows[0][1]
+
+    def to_ms(cycles: int) -> float:
+        return cycles / khz
+
+    summary = exec_tsc is not None and "exec" in phases
+    width = max(len(name) for name, _ in rows)
+    if summary:
+        width = max(width, len("kexec to entrypoint"))
+    lines = []
+    prev = base
+    for name, tsc in rows:
+        lines.append(
+            f"  {name:<{width}}  {to_ms(tsc - base):10.3f} ms  (+{to_ms(tsc - prev):.3f} ms)"
+        )
+        prev = tsc
+    if summary:
+        lines.append(
+            f"  {'kexec to entrypoint':<{width}}  {to_ms(phases['exec'] - exec_tsc):10.3f} ms"
+        )
+    return lines
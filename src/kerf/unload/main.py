@@ -44,6 +44,24 @@ def _cleanup_load_resources(instance_name: str, _instance_id: int, verbose: bool
             if verbose:
                 click.echo(f"Warning: Failed to clean up rootfs: {e}", err=True)
 
+    # Its kernel is gone, so it can no longer be cloned
+    try:
+        from ..load.record import remove_load_record
+
+        remove_load_record(instance_name)
+    except OSError as e:
+        if verbose:
+            click.echo(f"Warning: Failed to remove load record: {e}", err=True)
+
+    # Drop this instance from any shared daxfs image it was using
+    try:
+        from ..daxfs import DaxfsImageStore
+
+        DaxfsImageStore().release(instance_name)
+    except Exception as e:
+        if verbose:
+            click.echo(f"Warning: Failed to update daxfs image store: {e}", err=True)
+
 
 # KEXEC flags definitions
 KEXEC_FILE_UNLOAD = 0x00000001
@@ -26,17 +26,25 @@ clean resource migration:
 
 import sys
 import copy
-from typing import Optional, List
+import dataclasses
+from typing import Optional, List, Tuple
 import click
 
-from ..create.main import parse_cpu_spec, parse_memory_base, parse_memory_spec
+from ..create.main import (
+    allocate_cpus_from_pool,
+    parse_cpu_spec,
+    parse_memory_base,
+    parse_memory_spec,
+)
 from ..exceptions import KernelInterfaceError, ParseError, ResourceError, ValidationError
+from ..models import GlobalDeviceTree, Instance
 from ..resources import (
     find_available_memory_base,
     validate_cpu_allocation,
     validate_memory_allocation,
 )
 from ..runtime import DeviceTreeManager
+from ..timing import StageTimer
 
 
 def parse_device_spec(device_spec: str) -> List[str]:
@@ -84,6 +92,109 @@ def dump_overlay_for_debug(
         click.echo(f"Debug: Failed to convert overlay to DTS: {e}", err=True)
 
 
+def _delta_numa_nodes(tree: GlobalDeviceTree, instance: Instance) -> Optional[List[int]]:
+    """NUMA nodes to take added CPUs from: the instance's own, else those of its CPUs."""
+    if instance.resources.numa_nodes:
+        return instance.resources.numa_nodes
+    topology = tree.hardware.topology
+    if not topology or not topology.numa_nodes:
+        return None
+    nodes = {topology.get_numa_node_for_cpu(cpu) for cpu in instance.resources.cpus}
+    nodes.discard(None)
+    return sorted(nodes) or None
+
+
+def select_cpu_delta(
+    tree: GlobalDeviceTree, name: str, add: int = 0, remove: int = 0
+) -> Tuple[List[int], List[int]]:
+    """
+    Choose the CPUs to add to or remove from an instance.
+
+    Added CPUs follow the instance's affinity policy, preferring its NUMA
+    nodes; removed ones are its highest APIC IDs, and at least one CPU
+    must remain. Only the added CPUs are checked against the other
+    instances.
+
+    Returns:
+        (added, removed) APIC IDs, one of them empty
+    """
+    instance = tree.instances.get(name)
+    if instance is None:
+        raise ResourceError(f"Instance '{name}' does not exist")
+
+    cpus = sorted(instance.resources.cpus)
+    if remove:
+        if remove >= len(cpus):
+            raise ResourceError(
+                f"Instance '{name}' has {len(cpus)} CPUs; cannot remove {remove}, "
+                "at least one must remain"
+            )
+        return [], cpus[-remove:]
+
+    affinity = instance.resources.cpu_affinity or "compact"
+    nodes = _delta_numa_nodes(tree, instance)
+    try:
+        added = allocate_cpus_from_pool(tree, add, cpu_affinity=affinity, numa_nodes=nodes)
+    except ResourceError:
+        # Only an explicit --numa-nodes choice is binding
+        if instance.resources.numa_nodes or nodes is None:
+            raise
+        added = allocate_cpus_from_pool(tree, add, cpu_affinity=affinity)
+    validate_cpu_allocation(tree, added, exclude_instance=name)
+    return added, []
+
+
+def apply_cpu_delta(
+    manager: DeviceTreeManager,
+    name: str,
+    add: int = 0,
+    remove: int = 0,
+    dry_run: bool = False,
+    timer: Optional[StageTimer] = None,
+) -> Tuple[Optional[str], List[int], Instance]:
+    """
+    Add or remove a few CPUs of an instance with one cpu-add or cpu-remove fragment.
+
+    Unlike the general update, this neither copies the device tree nor
+    reads the instance's own device_tree: it works on the cached root tree
+    (parsed again only if another overlay changed it), checks only the
+    CPUs that change, and caches the updated tree once the kernel accepts
+    the overlay. Repeated calls in one process, e.g. in kerfd serving an
+    autoscaler, therefore never parse the tree.
+
+    Returns:
+        (transaction ID or None for a dry run, CPUs added or removed, updated instance)
+    """
+    timer = timer or StageTimer()
+    with manager._acquire_lock():  # pylint: disable=protected-access
+        with timer.stage("read"):
+            current = manager.read_baseline(shared=True)
+        with timer.stage("select"):
+            added, removed = select_cpu_delta(current, name, add, remove)
+
+        instance = current.instances[name]
+        cpus = sorted(set(instance.resources.cpus).difference(removed).union(added))
+        updated = dataclasses.replace(
+            instance, resources=dataclasses.replace(instance.resources, cpus=cpus)
+        )
+        if dry_run:
+            return None, added or removed, updated
+
+        with timer.stage("generate"):
+            dtbo_data = manager.overlay_gen.generate_cpu_overlay(
+                name, "cpu-add" if added else "cpu-remove", added or removed,
+                instance.resources.numa_nodes,
+            )
+        with timer.stage("write"):
+            tx_id = manager._write_overlay(dtbo_data)  # pylint: disable=protected-access
+
+        # The cached tree is shared, so swap in a new one rather than edit it
+        modified = copy.copy(current)
+        modified.instances = {**current.instances, name: updated}
+        manager.cache_applied(modified)
+    return tx_id, added or removed, updated
+
+
 @click.command(name='update')
 @click.argument('name', required=True)
 @click.option('--cpus', '-c',
@@ -94,16 +205,22 @@ def dump_overlay_for_debug(
               help='Update memory base address (hex: 0x80000000 or decimal, auto-assigned if not specified with --memory)')
 @click.option('--devices', '-d',
               help='Update device allocation: PCI IDs (comma-separated, e.g., "0000:09:00.0,0000:0a:00.0")')
+@click.option('--add-cpus', type=click.IntRange(min=1),
+              help='Add this many CPUs from the pool, near the instance\'s NUMA nodes')
+@click.option('--remove-cpus', type=click.IntRange(min=1),
+              help='Remove this many CPUs, highest APIC IDs first')
 @click.option('--dry-run', is_flag=True, help='Validate without applying to kernel')
 @click.option('--verbose', '-v', is_flag=True, help='Verbose output')
 @click.pass_context
-def update(
+def update(  # pylint: disable=too-many-arguments,too-many-positional-arguments
     ctx: click.Context,
     name: str,
     cpus: Optional[str],
     memory: Optional[str],
     memory_base: Optional[str],
     devices: Optional[str],
+    add_cpus: Optional[int],
+    remove_cpus: Optional[int],
     dry_run: bool,
     verbose: bool
 ):
@@ -114,7 +231,10 @@ def update(
     Operations are processed in order: memory-remove, memory-add, cpu-remove, cpu-add,
     device-remove, device-add.
 
-    At least one of --cpus, --memory, or --devices must be specified.
+    At least one of --cpus, --memory, or --devices must be specified, or
+    one of --add-cpus and --remove-cpus on its own. Those two take a fast
+    path for autoscaling: a single cpu-add or cpu-remove fragment computed
+    against the cached device tree, with only the changed CPUs checked.
 
     Examples:
 
@@ -135,8 +255,22 @@ def update(
 
         # Validate without applying
         kerf update web-server --cpus=8-15 --memory=4GB --dry-run
+
+        # Grow or shrink by two CPUs
+        kerf update web-server --add-cpus=2
+        kerf update web-server --remove-cpus=2
     """
     try:
+        if add_cpus or remove_cpus:
+            if (add_cpus and remove_cpus) or cpus or memory or memory_base or devices:
+                click.echo(
+                    "Error: --add-cpus and --remove-cpus cannot be combined with each other "
+                    "or with other resource options", err=True
+                )
+                sys.exit(2)
+            _update_cpu_delta(name, add_cpus or 0, remove_cpus or 0, dry_run, verbose)
+            return
+
         if not cpus and not memory and not devices:
             click.echo("Error: At least one of --cpus, --memory, or --devices must be specified", err=True)
             sys.exit(2)
@@ -193,7 +327,7 @@ def update(
             from pathlib import Path
             import libfdt
             import struct
-            from ..models import Instance, InstanceResources
+            from ..models import InstanceResources
 
             instance_dt_path = Path(f'/sys/fs/multikernel/instances/{name}/device_tree')
             if not instance_dt_path.exists():
@@ -296,7 +430,11 @@ def update(
                             memory_base_addr = old_base
                         except (ResourceError,) as exc:
                             # Extension conflicts, find a completely new region
-                            found_base = find_available_memory_base(modified, memory_bytes)
+                            found_base = find_available_memory_base(
+                                modified, memory_bytes,
+                                cpus=cpu_list or existing_instance.resources.cpus,
+                                numa_nodes=existing_instance.resources.numa_nodes,
+                            )
                             if found_base is None:
                                 raise ResourceError(
                                     f"No available memory region found for {memory_bytes} bytes. "
@@ -445,5 +583,37 @@ def update(
         sys.exit(1)
 
 
+def _update_cpu_delta(name: str, add: int, remove: int, dry_run: bool, verbose: bool) -> None:
+    """Run the --add-cpus/--remove-cpus fast path and report the result."""
+    manager = DeviceTreeManager()
+    timer = StageTimer()
+    try:
+        tx_id, changed, instance = apply_cpu_delta(
+            manager, name, add, remove, dry_run=dry_run, timer=timer
+        )
+    except (ResourceError, ValidationError) as e:
+        click.echo(f"Error: Resource allocation failed: {e}", err=True)
+        sys.exit(1)
+    except (KernelInterfaceError, ParseError) as e:
+        click.echo(f"Error: Kernel interface error: {e}", err=True)
+        sys.exit(1)
+
+    action = "Added" if add else "Removed"
+    preposition = "to" if add else "from"
+    changed_str = ", ".join(map(str, changed))
+    if dry_run:
+        click.echo(f"✓ Validation passed: would {action.lower()} CPUs {changed_str} "
+                   f"{preposition} instance '{name}'")
+        click.echo("  Remove --dry-run to apply overlay to kernel")
+    else:
+        click.echo(f"✓ {action} CPUs {changed_str} {preposition} instance '{name}' "
+                   f"(transaction {tx_id})")
+    if verbose:
+        click.echo(f"  CPUs: {', '.join(map(str, instance.resources.cpus))}")
+        click.echo("Timing breakdown:")
+        for line in timer.format_lines():
+            click.echo(line)
+
+
 if __name__ == '__main__':
     update()
@@ -0,0 +1,126 @@
+#!/usr/bin/env python3
+# Copyright 2026 Multikernel Technologies, Inc.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""
+Benchmark root device tree parsing with 1, 64 and 511 instances.
+
+Compares the single-pass decoder with the libfdt reference parser on
+trees generated by InstanceExtractor, and checks both agree.
+
+    python3 tests/bench_parser.py [--rounds N]
+"""
+
+import argparse
+import sys
+import time
+from pathlib import Path
+
+# Add the src directory to the path
+sys.path.insert(0, str(Path(__file__).parent.parent / "src"))
+
+# pylint: disable=wrong-import-position
+from kerf.models import (
+    GlobalDeviceTree,
+    HardwareInventory,
+    CPUAllocation,
+    MemoryAllocation,
+    DeviceInfo,
+    Instance,
+    InstanceResources,
+)
+from kerf.dtc.extractor import InstanceExtractor
+from kerf.dtc.parser import DeviceTreeParser
+
+INSTANCE_COUNTS = (1, 64, 511)
+INSTANCE_MEMORY = 256 * 1024**2
+
+
+def create_tree(count: int) -> GlobalDeviceTree:
+    """Create a root tree with count instances of two CPUs each."""
+    cpus = list(range(2, 2 + 2 * count))
+    memory_base = 0x100000000
+    hardware = HardwareInventory(
+        cpus=CPUAllocation(total=cpus[-1] + 1, host_reserved=[], available=cpus),
+        memory=MemoryAllocation(
+            total_bytes=memory_base + count * INSTANCE_MEMORY,
+            host_reserved_bytes=0,
+            memory_pool_base=memory_base,
+            memory_pool_bytes=count * INSTANCE_MEMORY,
+        ),
+        devices={
+            "eth0": DeviceInfo(
+                name="eth0", compatible="intel,i40e", pci_id="0000:01:00.0",
+                sriov_vfs=count, host_reserved_vf=0, available_vfs=list(range(1, count + 1)),
+            )
+        },
+    )
+
+    instances = {}
+    for i in range(count):
+        name = f"instance-{i + 1}"
+        instances[name] = Instance(
+            name=name,
+            id=i + 1,
+            resources=InstanceResources(
+                cpus=cpus[2 * i:2 * i + 2],
+                memory_base=memory_base + i * INSTANCE_MEMORY,
+                memory_bytes=INSTANCE_MEMORY,
+                devices=[f"eth0_vf{i + 1}"],
+            ),
+        )
+    references = {
+        f"eth0_vf{i + 1}": {"parent": "eth0", "vf_id": i + 1} for i in range(count)
+    }
+    return GlobalDeviceTree(hardware=hardware, instances=instances, device_references=references)
+
+
+def best_of(rounds: int, parse, dtb_data: bytes) -> float:
+    """Fastest of rounds parses, in milliseconds."""
+    best = float("inf")
+    for _ in range(rounds):
+        start = time.perf_counter()
+        parse(dtb_data)
+        best = min(best, time.perf_counter() - start)
+    return best * 1000
+
+
+def main():
+    """Run the benchmark."""
+    arg_parser = argparse.ArgumentParser(description=__doc__.split("\n\n", 1)[0])
+    arg_parser.add_argument("--rounds", type=int, default=20, help="parses per measurement")
+    args = arg_parser.parse_args()
+
+    fast = DeviceTreeParser()
+    reference = DeviceTreeParser(fast=False)
+    extractor = InstanceExtractor()
+
+    print(f"{'INSTANCES':>9}  {'DTB':>8}  {'REFERENCE':>12}  {'DECODER':>12}  {'SPEEDUP':>7}")
+    for count in INSTANCE_COUNTS:
+        dtb_data = bytes(extractor.generate_global_dtb(create_tree(count)))
+        if fast.parse_dtb_from_bytes(dtb_data) != reference.parse_dtb_from_bytes(dtb_data):
+            print(f"error: decoder and reference parser disagree at {count} instances")
+            return 1
+
+        reference_ms = best_of(args.rounds, reference.parse_dtb_from_bytes, dtb_data)
+        fast_ms = best_of(args.rounds, fast.parse_dtb_from_bytes, dtb_data)
+        print(
+            f"{count:>9}  {len(dtb_data):>8}  {reference_ms:9.3f} ms  {fast_ms:9.3f} ms  "
+            f"{reference_ms / fast_ms:6.1f}x"
+        )
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -18,6 +18,7 @@ Pytest configuration and fixtures for kerf tests.
 
 import sys
 from pathlib import Path
+from unittest.mock import patch
 
 import pytest
 
@@ -26,6 +27,8 @@ src_path = Path(__file__).parent.parent / "src"
 sys.path.insert(0, str(src_path))
 
 # pylint: disable=wrong-import-position
+from kerf import timing
+from kerf.load import record as load_record
 from kerf.models import (
     GlobalDeviceTree,
     HardwareInventory,
@@ -104,3 +107,17 @@ def sample_tree(sample_hardware, sample_instances):  # pylint: disable=redefined
     return GlobalDeviceTree(
         hardware=sample_hardware, instances=sample_instances, device_references={}
     )
+
+
+@pytest.fixture
+def load_dir(tmp_path):
+    """Keep load records under tmp_path."""
+    with patch.object(load_record, "KERF_LOAD_DIR", str(tmp_path / "loads")):
+        yield tmp_path / "loads"
+
+
+@pytest.fixture
+def timing_dir(tmp_path):
+    """Keep recorded timelines under tmp_path."""
+    with patch.object(timing, "KERF_TIMING_DIR", str(tmp_path / "timing")):
+        yield tmp_path / "timing"
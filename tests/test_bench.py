@@ -0,0 +1,130 @@
+# Copyright 2026 Multikernel Technologies, Inc.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""
+Tests for kerf bench.
+"""
+
+import io
+import json
+from pathlib import Path
+from unittest.mock import patch
+
+import pytest
+
+from kerf.bench import main as bench_main
+from kerf.daemon.server import execute
+from kerf.load import main as load_main
+from kerf.load.record import LoadRecord, write_load_record
+from kerf.unload import main as unload_main
+
+EXAMPLES = Path(__file__).parent.parent / "examples"
+
+
+class TestBench:
+    """Test the benchmarks that need no multikernel support."""
+
+    def test_daxfs(self, tmp_path):
+        """Test every builder stage and the write are summarized per file count."""
+        results = bench_main.bench_daxfs(tmp_path, [0, 300], 512, rounds=2)
+        assert list(results) == ["0x512", "300x512"]
+        stages = results["300x512"]
+        assert list(stages) == ["scan", "build_tree", "offsets", "write", "total"]
+        assert stages["write"]["n"] == 2
+        assert not list(tmp_path.iterdir())
+
+    def test_extract(self, tmp_path):
+        """Test each layer of each round is one sample."""
+        results = bench_main.bench_extract(tmp_path, 3, 10, 64, rounds=2)
+        assert results["3x10x64"]["extract"]["n"] == 6
+        assert not list(tmp_path.iterdir())
+
+    def test_synthetic_inputs_reproducible(self, tmp_path):
+        """Test the same seed generates the same tree."""
+        def tree(root, seed):
+            bench_main.synth_rootfs(root, 5, 32, bench_main.random.Random(seed))
+            return {p.relative_to(root): p.read_bytes() for p in root.rglob("f*")}
+
+        assert tree(tmp_path / "a", 7) == tree(tmp_path / "b", 7)
+        assert tree(tmp_path / "c", 7) != tree(tmp_path / "d", 8)
+
+    def test_overlay(self):
+        """Test overlays on the example trees, skipping counts that do not fit."""
+        dts = [str(EXAMPLES / "high_performance.dts"), str(EXAMPLES / "numa_topology.dts")]
+        results = bench_main.bench_overlay(dts, [0, 8, 60], rounds=2)
+        assert sorted(results) == [
+            "high_performance/0", "high_performance/60", "high_performance/8",
+            "numa_topology/0", "numa_topology/8",
+        ]
+        assert list(results["numa_topology/8"]) == ["copy", "validate", "generate", "total"]
+
+    def test_dtb(self):
+        """Test both encodings of each tree are measured, the compact one smaller."""
+        dts = [str(EXAMPLES / "high_performance.dts")]
+        results = bench_main.bench_dtb(dts, [16], rounds=2)
+        assert sorted(results) == [
+            "high_performance/16/compact", "high_performance/16/standard"
+        ]
+        compact, standard = (results[f"high_performance/16/{e}"] for e in ("compact", "standard"))
+        assert list(compact) == ["bytes", "generate", "parse", "total"]
+        assert compact["bytes"] < standard["bytes"]
+
+    def test_report(self, tmp_path):
+        """Test the command writes a JSON report of its options and results."""
+        output = tmp_path / "bench.json"
+        argv = ["--only=overlay", "--instances=1", "-n", "2", "-o", str(output)]
+        assert execute(bench_main.bench, argv, io.StringIO(), io.StringIO()) == 0
+        report = json.loads(output.read_text())
+        assert report["unit"] == "ms"
+        assert report["config"]["dts"] == ["high_performance.dts", "numa_topology.dts"]
+        assert sorted(report["results"]["overlay"]) == [
+            "high_performance/1", "numa_topology/1"
+        ]
+
+    def test_kexec_needs_instance(self):
+        """Test the kexec benchmark and --boot are refused without an instance."""
+        err = io.StringIO()
+        assert execute(bench_main.bench, ["--only=kexec"], io.StringIO(), err) == 2
+        assert "--instance" in err.getvalue()
+        assert execute(bench_main.bench, ["--boot"], io.StringIO(), io.StringIO()) == 2
+
+
+class TestKexecBench:
+    """Test reloading a recorded instance each round."""
+
+    def test_rounds(self, load_dir, tmp_path):
+        """Test each round unloads and reloads the recorded kernel and cmdline."""
+        kernel = tmp_path / "vmlinuz"
+        kernel.write_bytes(b"kernel")
+        write_load_record("web", LoadRecord(kernel=str(kernel), boot_cmdline="quiet ip=dhcp"))
+        calls = []
+
+        def kexec(kernel_fd, initrd_fd, cmdline, flags, debug=False):
+            # pylint: disable=unused-argument,too-many-arguments,too-many-positional-arguments
+            calls.append(("load", initrd_fd, cmdline))
+
+        with patch.object(load_main, "kexec_file_load", side_effect=kexec), \
+             patch.object(unload_main, "kexec_file_unload",
+                          side_effect=lambda flags: calls.append(("unload",))), \
+             patch.object(bench_main, "get_instance_id_from_name", return_value=3), \
+             patch.object(bench_main, "get_instance_status", return_value="loaded"):
+            results = bench_main.bench_kexec("web", rounds=2)
+
+        assert calls == [("unload",), ("load", -1, "quiet ip=dhcp")] * 2
+        assert list(results["web"]) == ["kexec_file_unload", "kexec_file_load", "total"]
+
+    def test_not_recorded(self, load_dir):
+        """Test an instance without a load record is refused."""
+        with pytest.raises(bench_main.BenchError, match="no recorded load"):
+            bench_main.bench_kexec("web", rounds=1)
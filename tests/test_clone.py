@@ -0,0 +1,159 @@
+# Copyright 2026 Multikernel Technologies, Inc.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""
+Tests for load records and kerf clone.
+"""
+
+import contextlib
+import dataclasses
+import io
+import sys
+from unittest.mock import MagicMock, mock_open, patch
+
+import click
+
+from kerf.clone import main as clone_main
+from kerf.daemon.server import execute
+from kerf.daxfs import daxfs_region_pinned
+from kerf.load.record import LoadRecord, read_load_record, remove_load_record, write_load_record
+from kerf.models import Instance, InstanceResources
+
+TEMPLATE = LoadRecord(
+    kernel="/boot/vmlinuz",
+    cmdline="quiet",
+    daxfs_phys_addr=0x80000000,
+    daxfs_size=64 << 20,
+    entrypoint="/bin/app",
+    init_params=["kerf.mounts=proc,dev"],
+    console_device="mktty0",
+)
+
+IOMEM = """\
+00000000-00000fff : Reserved
+80000000-83ffffff : daxfs
+"""
+
+
+class TestLoadRecord:
+    """Test load records written by kerf load."""
+
+    def test_roundtrip(self, load_dir):
+        """Test a record reads back as written and is gone once removed."""
+        write_load_record("web", TEMPLATE)
+        assert read_load_record("web") == TEMPLATE
+        remove_load_record("web")
+        assert read_load_record("web") is None
+        remove_load_record("web")
+
+    def test_unreadable(self, load_dir):
+        """Test a corrupt record reads as no record."""
+        load_dir.mkdir()
+        (load_dir / "web.json").write_text("{not json")
+        assert read_load_record("web") is None
+
+    def test_region_pinned(self):
+        """Test the daxfs region must lie within a daxfs entry of /proc/iomem."""
+        with patch("builtins.open", mock_open(read_data=IOMEM)):
+            assert daxfs_region_pinned(0x80000000, 64 << 20)
+            assert not daxfs_region_pinned(0x80000000, (64 << 20) + 1)
+            assert not daxfs_region_pinned(0x0, 0x1000)
+        with patch("builtins.open", side_effect=PermissionError):
+            assert not daxfs_region_pinned(0x80000000, 64 << 20)
+
+
+class TestClone:
+    """Test kerf clone loading the template's kernel into a new instance."""
+
+    def fakes(self, load_code=0):
+        """Fake create/delete/exec commands and load_kernel recording what ran."""
+        calls = []
+
+        def step(step_name):
+            @click.command(name=step_name)
+            def command(**kwargs):
+                calls.append((step_name, kwargs))
+            command.params = [
+                click.Option([f"--{p}"]) for p in ("name", "cpu-count", "memory", "verbose")
+            ]
+            return command
+
+        def load_kernel(name, kernel, initrd, cmdline, flags, timer, **kwargs):
+            # pylint: disable=unused-argument,too-many-arguments,too-many-positional-arguments
+            calls.append(("load", name, str(kernel), initrd, cmdline))
+            if load_code:
+                sys.exit(load_code)
+
+        source = Instance(
+            name="web-1", id=3,
+            resources=InstanceResources(
+                cpus=[2, 3], memory_base=0, memory_bytes=2 << 30, devices=[],
+                cpu_affinity="compact",
+            ),
+        )
+        manager = MagicMock()
+        manager.read_baseline.return_value.instances = {"web-1": source}
+        return calls, {
+            "create": step("create"),
+            "delete": step("delete"),
+            "exec_cmd": step("exec"),
+            "load_kernel": load_kernel,
+            "DeviceTreeManager": MagicMock(return_value=manager),
+            "get_instance_id_from_name": MagicMock(return_value=4),
+            "daxfs_region_pinned": MagicMock(return_value=True),
+        }
+
+    def invoke(self, fakes, argv):
+        stderr = io.StringIO()
+        with contextlib.ExitStack() as stack:
+            for attr, fake in fakes.items():
+                stack.enter_context(patch.object(clone_main, attr, fake))
+            return execute(clone_main.clone, argv, io.StringIO(), stderr), stderr.getvalue()
+
+    def test_clone(self, load_dir):
+        """Test the clone shares the daxfs image and gets its own ip= and record."""
+        write_load_record("web-1", TEMPLATE)
+        calls, fakes = self.fakes()
+        code, _ = self.invoke(fakes, ["web-1", "web-2", "--ip=10.0.0.12", "--exec"])
+        assert code == 0
+        assert [c[0] for c in calls] == ["create", "load", "exec"]
+        assert calls[0][1]["cpu_count"] == 2 and calls[0][1]["memory"] == str(2 << 30)
+
+        _, name, kernel, initrd, cmdline = calls[1]
+        assert (name, kernel, initrd) == ("web-2", "/boot/vmlinuz", None)
+        assert "rootflags=phys=0x80000000,size=67108864" in cmdline
+        assert "kerf.entrypoint=/bin/app" in cmdline and "kerf.mounts=proc,dev" in cmdline
+        assert "ip=10.0.0.12" in cmdline and "console=mktty0" in cmdline
+        assert "kerf.status" not in cmdline
+        assert read_load_record("web-2") == dataclasses.replace(TEMPLATE, boot_cmdline=cmdline)
+
+    def test_template_not_loaded(self, load_dir):
+        """Test cloning needs a load record and a still-pinned daxfs image."""
+        calls, fakes = self.fakes()
+        code, err = self.invoke(fakes, ["web-1", "web-2"])
+        assert code == 1 and "no recorded load" in err and not calls
+
+        write_load_record("web-1", TEMPLATE)
+        fakes["daxfs_region_pinned"].return_value = False
+        code, err = self.invoke(fakes, ["web-1", "web-2"])
+        assert code == 1 and "no longer mounted" in err and not calls
+
+    def test_failed_load_deletes(self, load_dir):
+        """Test a failed load removes the created instance and keeps the exit status."""
+        write_load_record("web-1", TEMPLATE)
+        calls, fakes = self.fakes(load_code=1)
+        code, _ = self.invoke(fakes, ["web-1", "web-2"])
+        assert code == 1
+        assert [c[0] for c in calls] == ["create", "load", "delete"]
+        assert read_load_record("web-2") is None
@@ -0,0 +1,193 @@
+# Copyright 2026 Multikernel Technologies, Inc.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""
+Tests for the console relay, console capture and `kerf logs`.
+"""
+
+import io
+import os
+import socket
+from unittest.mock import patch
+
+import pytest
+
+from kerf.console import capture
+from kerf.console.main import DetachScanner, relay_console, translate_newlines
+from kerf.console.ring import RingError, RingReader, RingWriter
+from kerf.logs.main import print_logs, tail_lines
+
+
+@pytest.fixture
+def console_fds():
+    """A stdin pipe, a socketpair standing in for mktty and a stdout pipe."""
+    stdin_r, stdin_w = os.pipe()
+    stdout_r, stdout_w = os.pipe()
+    mktty, instance = socket.socketpair()
+    fds = {"stdin_r": stdin_r, "stdin_w": stdin_w, "stdout_r": stdout_r, "stdout_w": stdout_w}
+    yield fds, mktty, instance
+    for fd in fds.values():
+        try:
+            os.close(fd)
+        except OSError:
+            pass
+    mktty.close()
+    instance.close()
+
+
+class TestDetachScanner:
+    """Test detach sequence detection over chunked input."""
+
+    def test_passthrough(self):
+        """Test chunks without Ctrl+] are forwarded untouched."""
+        scanner = DetachScanner()
+        assert scanner.feed(b"echo hello\r") == b"echo hello\r"
+        assert not scanner.detached
+
+    def test_detach_split_across_chunks(self):
+        """Test a Ctrl+] ending one chunk is held until the next decides."""
+        scanner = DetachScanner()
+        assert scanner.feed(b"ls\x1d") == b"ls"
+        assert scanner.pending
+        assert scanner.feed(b".rest") == b""
+        assert scanner.detached
+
+    def test_lone_ctrl_bracket_forwarded(self):
+        """Test Ctrl+] followed by anything but . is sent on, as is a doubled one."""
+        scanner = DetachScanner()
+        assert scanner.feed(b"a\x1db\x1d\x1d") == b"a\x1db\x1d"
+        assert scanner.feed(b"x") == b"\x1dx"
+        assert not scanner.detached
+
+
+class TestRelay:
+    """Test the console relay loop."""
+
+    def test_translate_newlines(self):
+        """Test \\n becomes \\r\\n without doubling existing \\r\\n."""
+        assert translate_newlines(b"a\nb\r\nc") == b"a\r\nb\r\nc"
+        assert translate_newlines(b"no newline") == b"no newline"
+
+    def test_output_translated_until_eof(self, console_fds):
+        """Test console output is translated and the relay ends on device EOF."""
+        fds, mktty, instance = console_fds
+        instance.sendall(b"boot\nlogin: ")
+        instance.shutdown(socket.SHUT_WR)
+
+        assert relay_console(fds["stdin_r"], fds["stdout_w"], mktty.fileno(), "web") == 0
+        assert os.read(fds["stdout_r"], 4096) == b"boot\r\nlogin: "
+
+    def test_raw_output_spliced(self, console_fds):
+        """Test raw mode passes output through unchanged to a pipe."""
+        fds, mktty, instance = console_fds
+        payload = b"line\n" * 2000
+        instance.sendall(payload)
+        instance.shutdown(socket.SHUT_WR)
+
+        assert relay_console(fds["stdin_r"], fds["stdout_w"], mktty.fileno(), "web", raw=True) == 0
+        assert os.read(fds["stdout_r"], len(payload) + 1) == payload
+
+    def test_input_until_detach(self, console_fds):
+        """Test stdin is forwarded in chunks and the relay stops on Ctrl+] ."""
+        fds, mktty, instance = console_fds
+        os.write(fds["stdin_w"], b"uname -a\r\x1d.ignored")
+
+        assert relay_console(fds["stdin_r"], fds["stdout_w"], mktty.fileno(), "web") == 0
+        assert instance.recv(4096) == b"uname -a\r"
+
+
+class TestRing:
+    """Test the mmap'd console ring file."""
+
+    def test_wraparound(self, tmp_path):
+        """Test only the last capacity bytes are kept and readers see what they lost."""
+        path = str(tmp_path / "web.ring")
+        writer = RingWriter(path, 16)
+        writer.write(b"0123456789")
+        reader = RingReader(path)
+        assert reader.read(0) == (b"0123456789", 10, 0)
+
+        writer.write(b"abcdefghij")
+        assert reader.read(10) == (b"abcdefghij", 20, 0)
+        # Position 0-3 has been overwritten
+        assert reader.read(0) == (b"456789abcdefghij", 20, 4)
+
+        writer.write(b"x" * 40)
+        assert reader.read(20) == (b"x" * 16, 60, 24)
+        reader.close()
+        writer.close()
+
+    def test_reopen_appends(self, tmp_path):
+        """Test a restarted writer appends to the same ring, and resizing resets it."""
+        path = str(tmp_path / "web.ring")
+        writer = RingWriter(path, 64)
+        writer.write(b"boot\n")
+        writer.close()
+
+        writer = RingWriter(path, 64)
+        writer.write(b"login\n")
+        assert writer.head == 11
+        with pytest.raises(RingError):
+            RingWriter(path, 64)
+        writer.close()
+
+        RingWriter(path, 128).close()
+        reader = RingReader(path)
+        assert reader.read(0) == (b"", 0, 0)
+        reader.close()
+
+    def test_not_a_ring(self, tmp_path):
+        """Test arbitrary files are rejected."""
+        path = tmp_path / "notes.txt"
+        path.write_bytes(b"x" * 100)
+        with pytest.raises(RingError):
+            RingReader(str(path))
+
+
+class TestCapture:
+    """Test console capture into rings and reading them back."""
+
+    def test_capture_and_logs(self, tmp_path):
+        """Test an instance's console lands in its ring and kerf logs prints it."""
+        (tmp_path / "instances" / "web").mkdir(parents=True)
+        peers = {}
+
+        def connect(instance_id):
+            mktty, peers[instance_id] = socket.socketpair()
+            return mktty.detach()
+
+        with patch.object(capture, "INSTANCES_DIR", str(tmp_path / "instances")), \
+             patch.object(capture, "KERF_CONSOLE_DIR", str(tmp_path / "console")), \
+             patch.object(capture, "get_instance_id_from_name", return_value=7):
+            cap = capture.ConsoleCapture(ring_size=4096, connect=connect)
+            cap.scan()
+            peers[7].sendall(b"[    0.000000] Linux version\nlogin: ")
+            cap.pump(1.0)
+            # The instance stops: its console closes, the ring stays
+            peers[7].close()
+            cap.pump(1.0)
+            assert not cap.connections
+            cap.close()
+
+            reader = RingReader(str(capture.console_ring_path("web")))
+        out = io.BytesIO()
+        print_logs(reader, out)
+        reader.close()
+        assert out.getvalue() == b"[    0.000000] Linux version\nlogin: "
+
+    def test_tail_lines(self):
+        """Test --lines keeps the last lines, counting a partial last line."""
+        assert tail_lines(b"a\nb\nc\n", 2) == b"b\nc\n"
+        assert tail_lines(b"a\nb\nc", 2) == b"b\nc"
+        assert tail_lines(b"a\nb\n", 5) == b"a\nb\n"
@@ -0,0 +1,247 @@
+# Copyright 2026 Multikernel Technologies, Inc.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""
+Tests for LLC- and SMT-aware CPU topology and placement.
+"""
+
+from unittest.mock import patch
+
+import pytest
+
+from kerf.create.main import allocate_cpus_from_pool
+from kerf.dtc import decoder
+from kerf.dtc.extractor import InstanceExtractor
+from kerf.dtc.parser import DeviceTreeParser
+from kerf.dtc.validator import MultikernelValidator
+from kerf.exceptions import ResourceError
+from kerf.init import main as init_main
+from kerf.models import CPUTopology, GlobalDeviceTree, Instance, InstanceResources
+from kerf.resources import find_available_memory_base
+
+GB = 1024**3
+
+# Two-thread cores (4,5), (6,7), ...; LLC 0 is APIC IDs 4-11, LLC 1 12-19, LLC 2 20-31
+LLC_RANGES = {0: range(4, 12), 1: range(12, 20), 2: range(20, 32)}
+
+
+@pytest.fixture
+def smt_tree(sample_hardware):
+    """The sample pool with SMT pairs and three LLC domains, and no instances."""
+    topology = {}
+    for llc_id, cpus in LLC_RANGES.items():
+        for cpu in cpus:
+            core = cpu & ~1
+            topology[cpu] = CPUTopology(
+                cpu_id=cpu, numa_node=0, core_id=core // 2, thread_id=cpu & 1,
+                socket_id=0, cache_levels=[48, 1280, 32768], flags=["smt"],
+                llc_id=llc_id, siblings=[core, core + 1],
+            )
+    sample_hardware.cpus.topology = topology
+    return GlobalDeviceTree(hardware=sample_hardware, instances={}, device_references={})
+
+
+def add_instance(tree, name, cpus, cpu_affinity=None):
+    """Add an instance holding cpus, with 1 GB of memory after the previous one."""
+    index = len(tree.instances)
+    tree.instances[name] = Instance(
+        name=name,
+        id=index + 1,
+        resources=InstanceResources(
+            cpus=cpus,
+            memory_base=0x80000000 + index * GB,
+            memory_bytes=GB,
+            devices=[],
+            cpu_affinity=cpu_affinity,
+        ),
+    )
+
+
+def write_sysfs(root, cpus):
+    """Write a fake /sys/devices/system/cpu; cpus maps logical CPU -> (core, llc)."""
+    for logical, (core, llc) in cpus.items():
+        cpu_dir = root / f"cpu{logical}"
+        (cpu_dir / "topology").mkdir(parents=True)
+        (cpu_dir / "node0").mkdir()
+        (cpu_dir / "topology" / "core_id").write_text(f"{core}\n")
+        (cpu_dir / "topology" / "physical_package_id").write_text("0\n")
+        siblings = [cpu for cpu, (other, _) in cpus.items() if other == core]
+        (cpu_dir / "topology" / "thread_siblings_list").write_text(
+            ",".join(str(cpu) for cpu in siblings) + "\n"
+        )
+        for index, (level, cache_type, size) in enumerate(
+            ((1, "Data", "48K"), (1, "Instruction", "32K"), (2, "Unified", "1280K"),
+             (3, "Unified", "32768K"))
+        ):
+            cache_dir = cpu_dir / "cache" / f"index{index}"
+            cache_dir.mkdir(parents=True)
+            (cache_dir / "level").write_text(f"{level}\n")
+            (cache_dir / "type").write_text(f"{cache_type}\n")
+            (cache_dir / "size").write_text(f"{size}\n")
+            if level == 3:
+                llc_cpus = [cpu for cpu, (_, other) in cpus.items() if other == llc]
+                (cache_dir / "shared_cpu_list").write_text(f"{min(llc_cpus)}-{max(llc_cpus)}\n")
+
+
+def write_node_sysfs(root, block_size, nodes):
+    """Write fake node and memory sysfs; nodes maps node -> (memory blocks, logical CPUs)."""
+    (root / "memory").mkdir(parents=True)
+    (root / "memory" / "block_size_bytes").write_text(f"{block_size:x}\n")
+    for node_id, (blocks, cpus) in nodes.items():
+        node_dir = root / "node" / f"node{node_id}"
+        node_dir.mkdir(parents=True)
+        (node_dir / "cpulist").write_text(cpus + "\n")
+        for block in blocks:
+            (node_dir / f"memory{block}").mkdir()
+
+
+class TestTopologyDetection:
+    """Test `kerf init` topology detection from sysfs."""
+
+    def test_detect(self, tmp_path):
+        """Test siblings and LLCs are read per logical CPU and keyed by APIC ID."""
+        # Logical CPUs 0-3 on cores 0 and 1 of one LLC, 4-5 on core 2 of another;
+        # logical CPU n has APIC ID 2n + 8
+        write_sysfs(tmp_path / "cpu", {0: (0, 0), 1: (1, 0), 2: (0, 0), 3: (1, 0),
+                                       4: (2, 1), 5: (2, 1)})
+        cpuinfo = tmp_path / "cpuinfo"
+        cpuinfo.write_text("".join(
+            f"processor\t: {n}\ncore id\t\t: 0\napicid\t\t: {2 * n + 8}\n\n" for n in range(6)
+        ))
+
+        with patch.object(init_main, "CPU_SYSFS_DIR", str(tmp_path / "cpu")), \
+             patch.object(init_main, "CPUINFO_PATH", str(cpuinfo)):
+            topology = init_main.detect_cpu_topology([8, 10, 12, 16, 18])
+
+        assert sorted(topology) == [8, 10, 12, 16, 18]
+        assert topology[8].siblings == [8, 12]
+        assert topology[12].thread_id == 1
+        assert topology[16].siblings == [16, 18]
+        # No cache id files: the lowest logical CPU sharing the LLC names it
+        assert topology[10].llc_id == 0
+        assert topology[18].llc_id == 4
+        assert topology[8].cache_levels == [48, 1280, 32768]
+        assert topology[8].flags == ["smt"]
+
+    def test_no_sysfs(self, tmp_path):
+        """Test detection yields nothing when sysfs has no topology."""
+        with patch.object(init_main, "CPU_SYSFS_DIR", str(tmp_path / "cpu")), \
+             patch.object(init_main, "CPUINFO_PATH", str(tmp_path / "cpuinfo")), \
+             patch.object(init_main, "NODE_SYSFS_DIR", str(tmp_path / "node")), \
+             patch.object(init_main, "MEMORY_SYSFS_DIR", str(tmp_path / "memory")):
+            assert init_main.detect_cpu_topology([4, 5]) is None
+            assert init_main.detect_numa_topology() is None
+
+    def test_numa_windows_from_init(self, tmp_path):
+        """Test a baseline from `kerf init` keeps each node's window for placement."""
+        # 1 GB blocks: node 0 holds 0-8 GB with APIC IDs 0-17, node 1 8-16 GB with 18-31
+        write_node_sysfs(tmp_path, GB, {0: (range(0, 8), "0-17"), 1: (range(8, 16), "18-31")})
+        cpuinfo = tmp_path / "cpuinfo"
+        cpuinfo.write_text("".join(f"processor\t: {n}\napicid\t\t: {n}\n\n" for n in range(32)))
+
+        with patch.object(init_main, "CPU_SYSFS_DIR", str(tmp_path / "cpu")), \
+             patch.object(init_main, "CPUINFO_PATH", str(cpuinfo)), \
+             patch.object(init_main, "NODE_SYSFS_DIR", str(tmp_path / "node")), \
+             patch.object(init_main, "MEMORY_SYSFS_DIR", str(tmp_path / "memory")), \
+             patch.object(init_main, "get_valid_apic_ids_from_system",
+                          return_value=set(range(32))), \
+             patch.object(init_main, "get_multikernel_memory_pool_from_iomem",
+                          return_value=(0x80000000, 14 * GB)):
+            tree = init_main.build_baseline_from_cmdline("4-31")
+
+        nodes = tree.hardware.topology.numa_nodes
+        assert (nodes[1].memory_base, nodes[1].memory_size) == (8 * GB, 8 * GB)
+        assert nodes[1].cpus == list(range(18, 32))
+
+        # What later commands read back from the root tree
+        dtb_data = InstanceExtractor().generate_global_dtb(tree)
+        stored = DeviceTreeParser(fast=False).parse_dtb_from_bytes(dtb_data)
+        assert stored.hardware.topology == tree.hardware.topology
+        assert decoder.decode_dtb(dtb_data) == stored
+        compact = InstanceExtractor(compact=True).generate_global_dtb(tree)
+        assert decoder.decode_dtb(compact) == stored
+
+        base = find_available_memory_base(stored, 2 * GB, use_iomem=False, cpus=[20, 21])
+        assert base == 0x200000000
+        base = find_available_memory_base(stored, 2 * GB, use_iomem=False, cpus=[4, 5])
+        assert base == 0x80000000
+
+
+class TestPlacementPolicies:
+    """Test the llc-compact and no-smt-share allocation policies."""
+
+    def test_llc_compact_best_fit(self, smt_tree):
+        """Test the smallest LLC domain that fits is filled first."""
+        assert allocate_cpus_from_pool(smt_tree, 6, "llc-compact") == list(range(4, 10))
+        assert allocate_cpus_from_pool(smt_tree, 10, "llc-compact") == list(range(20, 30))
+
+    def test_llc_compact_spills_largest_first(self, smt_tree):
+        """Test a request larger than every domain spans as few domains as possible."""
+        cpus = allocate_cpus_from_pool(smt_tree, 14, "llc-compact")
+        assert cpus == [4, 5] + list(range(20, 32))
+
+    def test_llc_compact_prefers_whole_cores(self, smt_tree):
+        """Test free cores are used before half-used ones."""
+        add_instance(smt_tree, "a", [4])
+        assert allocate_cpus_from_pool(smt_tree, 2, "llc-compact") == [6, 7]
+
+    def test_no_smt_share_skips_used_cores(self, smt_tree):
+        """Test no-smt-share avoids cores another instance already uses."""
+        add_instance(smt_tree, "a", [4, 12])
+        assert allocate_cpus_from_pool(smt_tree, 3, "no-smt-share") == [6, 7, 8]
+
+    def test_siblings_of_isolated_instance_are_reserved(self, smt_tree):
+        """Test no other policy hands out a no-smt-share instance's sibling threads."""
+        add_instance(smt_tree, "a", [4, 5, 6], cpu_affinity="no-smt-share")
+        assert allocate_cpus_from_pool(smt_tree, 2, "compact") == [8, 9]
+
+    def test_requires_topology(self, sample_hardware):
+        """Test both policies need detected topology."""
+        tree = GlobalDeviceTree(hardware=sample_hardware, instances={}, device_references={})
+        for policy in ("llc-compact", "no-smt-share"):
+            with pytest.raises(ResourceError, match="requires CPU cache and SMT topology"):
+                allocate_cpus_from_pool(tree, 2, policy)
+
+
+class TestTopologyValidation:
+    """Test validation and device tree storage of CPU topology."""
+
+    def test_smt_sharing_rejected(self, smt_tree):
+        """Test a no-smt-share instance may not share a core, reported once."""
+        add_instance(smt_tree, "a", [4, 6], cpu_affinity="no-smt-share")
+        add_instance(smt_tree, "b", [7, 8])
+
+        result = MultikernelValidator().validate(smt_tree)
+        smt_errors = [e for e in result.errors if "share SMT cores" in e]
+        assert smt_errors == [
+            "Instances a and b share SMT cores (APIC IDs [6, 7]), "
+            "but no-smt-share CPU affinity forbids sibling threads across instances"
+        ]
+
+    def test_llc_compact_spanning_warns(self, smt_tree):
+        """Test an llc-compact instance spanning LLC domains is warned about."""
+        add_instance(smt_tree, "a", [10, 11, 12, 13], cpu_affinity="llc-compact")
+
+        result = MultikernelValidator().validate(smt_tree)
+        assert any("span 2 last-level cache domains" in w for w in result.warnings)
+
+    def test_dtb_roundtrip(self, smt_tree):
+        """Test topology and CPU affinity survive the DTB, in both parsers."""
+        add_instance(smt_tree, "a", [4, 5], cpu_affinity="no-smt-share")
+        dtb_data = InstanceExtractor().generate_global_dtb(smt_tree)
+
+        reference = DeviceTreeParser(fast=False).parse_dtb_from_bytes(dtb_data)
+        assert reference.hardware.cpus.topology == smt_tree.hardware.cpus.topology
+        assert reference.instances["a"].resources.cpu_affinity == "no-smt-share"
+        assert decoder.decode_dtb(dtb_data) == reference
@@ -0,0 +1,161 @@
+# Copyright 2026 Multikernel Technologies, Inc.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""
+Tests for kerfd, its client and `kerf run`.
+"""
+
+import contextlib
+import io
+import os
+import sys
+import threading
+from unittest.mock import patch
+
+import click
+import pytest
+
+from kerf.daemon import client
+from kerf.daemon.server import KerfDaemon, execute
+from kerf.run import main as run_main
+
+
+@click.group()
+def toy():
+    """Stand-in for the kerf CLI."""
+
+
+@toy.command()
+@click.argument("words", nargs=-1)
+def echo(words):
+    click.echo(" ".join(words))
+    click.echo(os.getcwd(), err=True)
+
+
+@toy.command()
+def fail():
+    click.echo("Error: no such instance", err=True)
+    sys.exit(3)
+
+
+@pytest.fixture
+def daemon(tmp_path):
+    """A kerfd serving the toy CLI on a socket under tmp_path."""
+    path = str(tmp_path / "kerfd.sock")
+    server = KerfDaemon(path, command=toy)
+    server.listen()
+    stopping = threading.Event()
+    thread = threading.Thread(target=server.serve, args=(stopping.is_set,), daemon=True)
+    thread.start()
+    yield path
+    stopping.set()
+    thread.join()
+    server.close()
+
+
+def run_client(argv, path):
+    """client.request() with its stdout and stderr captured as bytes."""
+    out = io.TextIOWrapper(io.BytesIO())
+    err = io.TextIOWrapper(io.BytesIO())
+    with patch.object(sys, "stdout", out), patch.object(sys, "stderr", err):
+        code = client.request(argv, path)
+    return code, out.buffer.getvalue(), err.buffer.getvalue()
+
+
+class TestDaemon:
+    """Test requests round-tripping through kerfd."""
+
+    def test_output_and_cwd(self, daemon, tmp_path):
+        """Test output is relayed and the command runs in the client's directory."""
+        work = tmp_path / "work"
+        work.mkdir()
+        previous = os.getcwd()
+        os.chdir(work)
+        try:
+            code, out, err = run_client(["echo", "hello", "kerfd"], daemon)
+        finally:
+            os.chdir(previous)
+        assert code == 0 and out == b"hello kerfd\n"
+        assert err.decode().strip() == str(work)
+
+    def test_exit_status(self, daemon):
+        """Test sys.exit() codes and usage errors come back as the exit status."""
+        code, out, err = run_client(["fail"], daemon)
+        assert (code, out, err) == (3, b"", b"Error: no such instance\n")
+
+        code, _, err = run_client(["nosuch"], daemon)
+        assert code == 2 and b"No such command" in err
+
+    def test_not_running(self, tmp_path):
+        """Test the client falls back to running in-process without kerfd."""
+        assert client.request(["create", "web"], str(tmp_path / "missing.sock")) is None
+
+    def test_routing(self):
+        """Test only lifecycle commands that need no terminal go to kerfd."""
+        with patch.dict(os.environ, {client.NO_DAEMON_ENV: ""}):
+            assert client.wants_daemon(["--debug", "create", "web", "--memory=2GB"])
+            assert client.wants_daemon(["load", "web", "--console=mktty0"])
+            assert not client.wants_daemon(["exec", "web", "--console"])
+            assert not client.wants_daemon(["run", "web", "--attach"])
+            assert not client.wants_daemon(["show", "--watch"])
+            assert not client.wants_daemon(["--help"])
+        with patch.dict(os.environ, {client.NO_DAEMON_ENV: "1"}):
+            assert not client.wants_daemon(["create", "web"])
+
+
+class TestRun:
+    """Test kerf run chaining create, load and exec."""
+
+    def steps(self, load_code=0):
+        """Fake create/load/delete/exec commands recording what ran."""
+        calls = []
+
+        def step(step_name, code=0):
+            @click.command(name=step_name)
+            @click.pass_context
+            def command(ctx, **kwargs):  # pylint: disable=unused-argument
+                calls.append((step_name, kwargs.get("name")))
+                if code:
+                    sys.exit(code)
+            command.params = [click.Option([f"--{p}"]) for p in ("name", "verbose")]
+            return command
+
+        fakes = {
+            "create": step("create"),
+            "load": step("load", load_code),
+            "delete": step("delete"),
+            "exec_cmd": step("exec"),
+        }
+        return calls, fakes
+
+    def invoke(self, fakes, argv):
+        # Not patch.multiple(): its create= argument would swallow the create fake
+        with contextlib.ExitStack() as stack:
+            for attr, fake in fakes.items():
+                stack.enter_context(patch.object(run_main, attr, fake))
+            return execute(run_main.run, argv, io.StringIO(), io.StringIO())
+
+    def test_run(self):
+        """Test a run creates, loads and boots the instance in order."""
+        calls, fakes = self.steps()
+        argv = ["web", "--memory=2GB", "--cpu-count=2", "--kernel=/boot/vmlinuz"]
+        assert self.invoke(fakes, argv) == 0
+        assert calls == [("create", "web"), ("load", "web"), ("exec", "web")]
+
+    def test_failed_load_deletes(self):
+        """Test a failed load removes the created instance and keeps the exit status."""
+        calls, fakes = self.steps(load_code=1)
+        argv = ["web", "--memory=2GB", "--cpu-count=2", "--kernel=/boot/vmlinuz"]
+        assert self.invoke(fakes, argv) == 1
+        assert calls == [("create", "web"), ("load", "web"), ("delete", "web")]
@@ -0,0 +1,460 @@
+# Copyright 2026 Multikernel Technologies, Inc.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""
+Tests for daxfs image layout.
+"""
+
+import io
+import mmap
+import os
+import subprocess
+from unittest.mock import patch
+
+import pytest
+
+from kerf.data import get_mkdaxfs_binary_path
+from kerf.daxfs.mkdaxfs import (
+    DaxfsBuilder, DAXFS_BLOCK_SIZE, DAXFS_FLAG_HUGE_ALIGNED, DAXFS_HUGE_2M, find_image_file,
+)
+from kerf.daxfs.store import DaxfsImageStore
+from kerf.timing import StageTimer
+
+
+@pytest.fixture
+def rootfs(tmp_path):
+    """Create a small rootfs tree."""
+    (tmp_path / "bin").mkdir()
+    (tmp_path / "bin" / "sh").write_bytes(b"\x7fELF" + b"\x00" * 5000)
+    (tmp_path / "etc").mkdir()
+    (tmp_path / "etc" / "hostname").write_text("kerf\n")
+    (tmp_path / "etc" / "empty").write_bytes(b"")
+    (tmp_path / "etc" / "ssl").mkdir()
+    os.symlink("/bin/sh", tmp_path / "sh")
+    return tmp_path
+
+
+@pytest.fixture
+def huge_rootfs(rootfs):
+    """Add a file large enough for a 2M mapping."""
+    (rootfs / "weights").write_bytes(os.urandom(DAXFS_HUGE_2M + 100))
+    return rootfs
+
+
+class TestDaxfsBuilder:
+    """Test DaxfsBuilder tree and layout construction."""
+
+    def _children(self, builder, entry):
+        names = []
+        ino = entry.first_child
+        while ino:
+            child = builder.find_by_ino(ino)
+            names.append(child.name)
+            ino = child.next_sibling
+        return names
+
+    def test_tree_links(self, rootfs):
+        """Test parent and sibling chains follow sorted directory order."""
+        builder = DaxfsBuilder(str(rootfs))
+        builder.build()
+
+        root = builder.find_by_path("")
+        assert root.ino == 1
+        assert root.parent_ino == 0
+        assert self._children(builder, root) == ["bin", "etc", "sh"]
+
+        etc = builder.find_by_path("etc")
+        assert self._children(builder, etc) == ["empty", "hostname", "ssl"]
+        assert builder.find_by_path("etc/hostname").parent_ino == etc.ino
+        assert builder.find_by_path("etc/ssl").first_child == 0
+
+    def test_offsets_aligned(self, rootfs):
+        """Test data extents are block aligned and do not overlap."""
+        builder = DaxfsBuilder(str(rootfs))
+        builder.build()
+
+        extents = sorted(
+            (e.data_offset, e.stat.st_size) for e in builder.files if e.data_offset
+        )
+        for (off, size), (next_off, _) in zip(extents, extents[1:]):
+            assert off % DAXFS_BLOCK_SIZE == 0
+            assert off + size <= next_off
+
+        last_off, last_size = extents[-1]
+        assert builder.calculate_total_size() >= last_off + last_size
+        assert builder.calculate_total_size() % DAXFS_BLOCK_SIZE == 0
+
+    def test_strtab_offsets(self, rootfs):
+        """Test names are packed back to back in the string table."""
+        builder = DaxfsBuilder(str(rootfs))
+        builder.build()
+
+        offset = 0
+        for e in builder.files:
+            assert e.name_strtab_offset == offset
+            offset += len(e.name) + 1
+        assert offset == builder.strtab_size
+
+    def test_write_image_contents(self, rootfs):
+        """Test file and symlink data land at their extents."""
+        builder = DaxfsBuilder(str(rootfs))
+        builder.build()
+        size = builder.calculate_total_size()
+
+        mem = mmap.mmap(-1, size)
+        builder.write_image(mem, size)
+
+        sh = builder.find_by_path("bin/sh")
+        assert mem[sh.data_offset:sh.data_offset + sh.stat.st_size] == (
+            rootfs / "bin" / "sh"
+        ).read_bytes()
+        link = builder.find_by_path("sh")
+        assert mem[link.data_offset:link.data_offset + link.stat.st_size] == b"/bin/sh"
+        mem.close()
+
+    def test_write_image_clears_unwritten(self, rootfs):
+        """Test targeted zeroing matches writing into zeroed memory."""
+        builder = DaxfsBuilder(str(rootfs))
+        builder.build()
+        size = builder.calculate_total_size() + 2 * DAXFS_BLOCK_SIZE
+
+        clean = mmap.mmap(-1, size)
+        builder.write_image(clean, size, zeroed=True)
+
+        dirty = mmap.mmap(-1, size)
+        dirty.write(b"\xff" * size)
+        builder.write_image(dirty, size)
+
+        assert dirty[:] == clean[:]
+        clean.close()
+        dirty.close()
+
+    def test_write_image_threaded(self, rootfs):
+        """Test a worker pool produces the same image as a single thread."""
+        builder = DaxfsBuilder(str(rootfs))
+        builder.build()
+        size = builder.calculate_total_size()
+
+        serial = mmap.mmap(-1, size)
+        builder.write_image(serial, size, threads=1)
+        parallel = mmap.mmap(-1, size)
+        builder.write_image(parallel, size, threads=4)
+
+        assert parallel[:] == serial[:]
+        assert builder.bytes_written == 5004 + 5 + 7
+        serial.close()
+        parallel.close()
+
+    def test_find_image_file(self, rootfs):
+        """Test files are found by walking the written image."""
+        builder = DaxfsBuilder(str(rootfs))
+        builder.build()
+        size = builder.calculate_total_size()
+        mem = mmap.mmap(-1, size)
+        builder.write_image(mem, size)
+
+        hostname = builder.find_by_path("etc/hostname")
+        assert find_image_file(mem, "etc/hostname") == (hostname.data_offset, 5)
+        assert find_image_file(mem, "/bin/sh")[1] == 5004
+        assert find_image_file(mem, "etc/missing") is None
+        assert find_image_file(mem, "etc/ssl") is None
+        mem.close()
+
+    def test_build_records_stages(self, rootfs):
+        """Test build() reports scan, tree and offset stages."""
+        timer = StageTimer()
+        DaxfsBuilder(str(rootfs)).build(timer)
+
+        assert list(timer.stages) == ["scan", "build_tree", "offsets"]
+        assert len(timer.format_lines()) == 4
+
+
+class TestDaxfsHugeAlign:
+    """Test hugepage-aligned extent layout."""
+
+    def test_large_file_aligned(self, huge_rootfs):
+        """Test large extents are 2M aligned and placed after small ones."""
+        builder = DaxfsBuilder(str(huge_rootfs), huge_align=DAXFS_HUGE_2M)
+        builder.build()
+
+        weights = builder.find_by_path("weights")
+        assert weights.data_offset % DAXFS_HUGE_2M == 0
+        assert builder.huge_extents == 1
+        assert all(
+            e.data_offset < weights.data_offset
+            for e in builder.files if e.data_offset and e is not weights
+        )
+        assert builder.calculate_total_size() == weights.data_offset + DAXFS_HUGE_2M + DAXFS_BLOCK_SIZE
+
+    def test_superblock_records_alignment(self, huge_rootfs):
+        """Test the superblock flags carry the alignment and padding is cleared."""
+        builder = DaxfsBuilder(str(huge_rootfs), huge_align=DAXFS_HUGE_2M)
+        builder.build()
+        size = builder.calculate_total_size()
+
+        clean = mmap.mmap(-1, size)
+        builder.write_image(clean, size, zeroed=True)
+        dirty = mmap.mmap(-1, size)
+        dirty.write(b"\xff" * size)
+        builder.write_image(dirty, size)
+
+        flags = int.from_bytes(dirty[8:12], 'little')
+        assert flags & DAXFS_FLAG_HUGE_ALIGNED
+        assert 1 << (flags >> 8) == DAXFS_HUGE_2M
+        assert dirty[:] == clean[:]
+        clean.close()
+        dirty.close()
+
+    def test_padding_report(self, huge_rootfs):
+        """Test the report prices each alignment and keeps the layout."""
+        builder = DaxfsBuilder(str(huge_rootfs))
+        builder.build()
+        plain_size = builder.calculate_total_size()
+
+        report = builder.padding_report()
+        assert [r["huge_align"] for r in report] == [0, DAXFS_HUGE_2M, 1 << 30]
+        assert report[0]["padding"] == 0
+        assert report[1]["huge_extents"] == 1
+        assert report[1]["total_size"] == plain_size + report[1]["padding"]
+        assert builder.calculate_total_size() == plain_size
+        assert builder.find_by_path("weights").data_offset % DAXFS_HUGE_2M != 0
+
+
+class TestNativeMkdaxfs:
+    """Test the native writer against DaxfsBuilder."""
+
+    def test_matches_python_builder(self, rootfs):
+        """Test the native image is byte-identical to the Python one."""
+        binary = get_mkdaxfs_binary_path()
+        if not binary.is_file():
+            pytest.skip("native mkdaxfs not built")
+
+        builder = DaxfsBuilder(str(rootfs))
+        builder.build()
+        size = builder.calculate_total_size()
+        mem = mmap.mmap(-1, size)
+        builder.write_image(mem, size)
+
+        printed = subprocess.run(
+            [str(binary), "--print-size", str(rootfs)],
+            capture_output=True, text=True, check=True,
+        )
+        assert int(printed.stdout) == size
+
+        # Outside the tree being imaged
+        image = rootfs.parent / f"{rootfs.name}.img"
+        written = subprocess.run(
+            [str(binary), "--output", str(image), str(rootfs)],
+            capture_output=True, text=True, check=True,
+        )
+        assert int(written.stdout) == builder.bytes_written
+        assert image.read_bytes() == mem[:]
+        mem.close()
+
+    def test_single_run_over_stdin(self, rootfs):
+        """Test one --dmabuf-stdin run reports the size, then writes the fd it is sent."""
+        from kerf.daxfs.mkdaxfs import _NativeMkdaxfsRun
+
+        binary = get_mkdaxfs_binary_path()
+        if not binary.is_file():
+            pytest.skip("native mkdaxfs not built")
+        (rootfs / "etc" / "big").write_bytes(os.urandom(3 * DAXFS_BLOCK_SIZE + 7))
+
+        builder = DaxfsBuilder(str(rootfs))
+        builder.build()
+        size = builder.calculate_total_size() + DAXFS_BLOCK_SIZE
+        mem = mmap.mmap(-1, size)
+        builder.write_image(mem, size)
+
+        run = _NativeMkdaxfsRun(str(binary), ["--threads", "4", str(rootfs)])
+        assert run.required_size == builder.calculate_total_size()
+        # A file outside the tree stands in for the dma-buf
+        fd = os.open(rootfs.parent / f"{rootfs.name}.dmabuf", os.O_RDWR | os.O_CREAT, 0o600)
+        try:
+            os.ftruncate(fd, size)
+            assert run.write(fd, size) == builder.bytes_written
+            assert os.pread(fd, size, 0) == mem[:]
+        finally:
+            os.close(fd)
+            mem.close()
+
+        # A run whose allocation failed ends without writing anything
+        aborted = _NativeMkdaxfsRun(str(binary), [str(rootfs)])
+        aborted.close()
+
+    def test_create_image_forwards_threads(self, rootfs):
+        """Test loads through the native writer walk the tree once with --threads."""
+        from unittest.mock import patch
+        from kerf.daxfs import mkdaxfs
+
+        runs = []
+
+        class FakeRun:
+            required_size = 8 * DAXFS_BLOCK_SIZE
+
+            def __init__(self, binary, args):
+                runs.append(args)
+
+            def write(self, dmabuf_fd, size):
+                return size
+
+            def close(self):
+                pass
+
+        def allocate_and_mount(instance_name, heap_path, required_size, size, timer, write):
+            return mkdaxfs.DaxfsImage(phys_addr=0x1000, size=required_size,
+                                      bytes_written=write(None, 3, required_size))
+
+        with patch.object(mkdaxfs, "_native_mkdaxfs", return_value="/usr/bin/mkdaxfs"), \
+             patch.object(mkdaxfs, "_NativeMkdaxfsRun", FakeRun), \
+             patch.object(mkdaxfs, "_allocate_and_mount", allocate_and_mount):
+            image = mkdaxfs.create_daxfs_image(str(rootfs), "web", threads=6)
+
+        assert runs == [["--threads", "6", str(rootfs)]]
+        assert image.bytes_written == 8 * DAXFS_BLOCK_SIZE
+
+
+IOMEM_TWO_MOUNTED = """\
+00000000-00000fff : Reserved
+80000000-83ffffff : daxfs
+84000000-87ffffff : daxfs
+"""
+
+
+class TestDaxfsMount:
+    """Test finding the region of a freshly mounted image in /proc/iomem."""
+
+    @staticmethod
+    def _mount(iomem, added):
+        """Mount through a fake /proc/iomem, to which the mount appends added lines."""
+        from kerf.daxfs import mkdaxfs
+
+        state = [iomem]
+
+        def mount_daxfs(instance_name, dmabuf_fd):
+            state[0] += added
+
+        read_fd, write_fd = os.pipe()
+        os.close(write_fd)
+        with patch.object(mkdaxfs, "open", create=True,
+                          new=lambda *args, **kwargs: io.StringIO(state[0])), \
+             patch.object(mkdaxfs, "_mount_daxfs", mount_daxfs):
+            return mkdaxfs._mount_and_locate(  # pylint: disable=protected-access
+                "web", read_fd, StageTimer()
+            )
+
+    def test_new_range_returned(self):
+        """Test the range that appeared is returned, not an earlier image's."""
+        assert self._mount(IOMEM_TWO_MOUNTED, "90000000-91ffffff : daxfs\n") == (
+            0x90000000, 0x2000000
+        )
+
+    def test_no_new_range(self):
+        """Test a mount that adds no daxfs entry is an error."""
+        from kerf.daxfs.mkdaxfs import DaxfsError
+
+        with pytest.raises(DaxfsError, match="found 0"):
+            self._mount(IOMEM_TWO_MOUNTED, "")
+        with pytest.raises(DaxfsError, match="found 2"):
+            self._mount(IOMEM_TWO_MOUNTED,
+                        "90000000-91ffffff : daxfs\na0000000-a1ffffff : daxfs\n")
+
+
+class TestDaxfsDedup:
+    """Test content-addressed extent sharing."""
+
+    def test_identical_files_share_extent(self, rootfs):
+        """Test duplicate contents map to one extent."""
+        (rootfs / "bin" / "sh2").write_bytes((rootfs / "bin" / "sh").read_bytes())
+
+        plain = DaxfsBuilder(str(rootfs))
+        plain.build()
+        builder = DaxfsBuilder(str(rootfs), dedup=True)
+        builder.build()
+
+        sh = builder.find_by_path("bin/sh")
+        sh2 = builder.find_by_path("bin/sh2")
+        assert sh2.extent_ino == sh.ino
+        assert sh2.data_offset == sh.data_offset
+        assert builder.dedup_bytes == 2 * DAXFS_BLOCK_SIZE
+        assert builder.calculate_total_size() == (
+            plain.calculate_total_size() - builder.dedup_bytes
+        )
+
+        size = builder.calculate_total_size()
+        mem = mmap.mmap(-1, size)
+        builder.write_image(mem, size)
+        assert mem[sh2.data_offset:sh2.data_offset + sh2.stat.st_size] == (
+            rootfs / "bin" / "sh"
+        ).read_bytes()
+        mem.close()
+
+    def test_image_digest_tracks_content(self, rootfs):
+        """Test the image digest changes only when content does."""
+        first = DaxfsBuilder(str(rootfs), dedup=True)
+        first.build()
+        again = DaxfsBuilder(str(rootfs), dedup=True)
+        again.build()
+        assert first.image_digest() == again.image_digest()
+
+        (rootfs / "etc" / "hostname").write_text("kerg\n")
+        changed = DaxfsBuilder(str(rootfs), dedup=True)
+        changed.build()
+        assert changed.image_digest() != first.image_digest()
+
+    def test_hard_link_clones_match(self, rootfs):
+        """Test clones of the image cache hash and link like the cache itself."""
+        from kerf.docker.image import _clone_tree
+
+        os.link(rootfs / "bin" / "sh", rootfs / "bin" / "sh.link")
+        builders = []
+        for name in ("a", "b"):
+            # Outside the tree being cloned
+            clone = rootfs.parent / f"{rootfs.name}-{name}"
+            _clone_tree(rootfs, clone)
+            builder = DaxfsBuilder(str(clone), dedup=True)
+            builder.build()
+            builders.append(builder)
+
+        assert os.stat(rootfs / "bin" / "sh").st_nlink == 6
+        assert builders[0].image_digest() == builders[1].image_digest()
+        assert builders[0].find_by_path("bin/sh").nlink == 2
+        assert builders[0].find_by_path("etc/hostname").nlink == 1
+        assert builders[0].find_by_path("etc").nlink == 3
+
+
+class _AlwaysLiveStore(DaxfsImageStore):
+    def _is_live(self, entry):
+        return entry["owner"] != "gone"
+
+
+class TestDaxfsImageStore:
+    """Test the shared image index."""
+
+    def test_acquire_after_register(self, tmp_path):
+        """Test a registered image is handed to later instances."""
+        store = _AlwaysLiveStore(str(tmp_path / "store.json"), str(tmp_path))
+        assert store.acquire("abc", "web-1") is None
+
+        store.register("abc", "web-1", 0x100000, 0x2000)
+        assert store.acquire("abc", "web-2") == {"phys_addr": 0x100000, "size": 0x2000}
+
+        store.release("web-2")
+        assert store.acquire("abc", "web-3") is not None
+
+    def test_dead_owner_dropped(self, tmp_path):
+        """Test images whose owner mount is gone are not reused."""
+        store = _AlwaysLiveStore(str(tmp_path / "store.json"), str(tmp_path))
+        store.register("abc", "gone", 0x100000, 0x2000)
+        assert store.acquire("abc", "web-2") is None
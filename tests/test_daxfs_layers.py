@@ -0,0 +1,246 @@
+# Copyright 2026 Multikernel Technologies, Inc.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""
+Tests for building daxfs images straight from OCI layers.
+"""
+
+import io
+import mmap
+import stat
+import tarfile
+from unittest.mock import patch
+
+import pytest
+
+from kerf.daxfs import layers as daxfs_layers
+from kerf.daxfs import mkdaxfs
+from kerf.daxfs.layers import LayerDaxfsBuilder, LayerIndex, build_layer_index
+
+
+def _write_layer(path, entries):
+    """Write a gzip'ed layer. entries: (name, type, data_or_linkname)."""
+    with tarfile.open(path, mode="w:gz") as tar:
+        for name, kind, payload in entries:
+            info = tarfile.TarInfo(name)
+            info.mode = 0o755 if kind == tarfile.DIRTYPE else 0o644
+            info.type = kind
+            if kind in (tarfile.SYMTYPE, tarfile.LNKTYPE):
+                info.linkname = payload
+                tar.addfile(info)
+            elif kind == tarfile.REGTYPE:
+                info.size = len(payload)
+                tar.addfile(info, io.BytesIO(payload))
+            else:
+                tar.addfile(info)
+    return path
+
+
+@pytest.fixture
+def layers(tmp_path):
+    """A base layer and an upper layer with whiteouts and overrides."""
+    base = _write_layer(tmp_path / "base.tar.gz", [
+        ("./", tarfile.DIRTYPE, None),
+        ("bin/", tarfile.DIRTYPE, None),
+        ("bin/app", tarfile.REGTYPE, b"v1"),
+        ("bin/app-link", tarfile.LNKTYPE, "bin/app"),
+        ("etc/conf", tarfile.REGTYPE, b"base"),
+        ("etc/conf-link", tarfile.LNKTYPE, "etc/conf"),
+        ("etc/old", tarfile.REGTYPE, b"gone"),
+        ("cache/a", tarfile.REGTYPE, b"a"),
+        ("cache/b", tarfile.REGTYPE, b"b"),
+        ("sh", tarfile.SYMTYPE, "/bin/app"),
+    ])
+    upper = _write_layer(tmp_path / "upper.tar.gz", [
+        ("bin/app", tarfile.REGTYPE, b"v2" * 3000),
+        ("etc/.wh.old", tarfile.REGTYPE, b""),
+        ("cache/.wh..wh..opq", tarfile.REGTYPE, b""),
+        ("cache/c", tarfile.REGTYPE, b"c"),
+    ])
+    return [base, upper]
+
+
+def _build(layers, **kwargs):
+    index = LayerIndex()
+    for layer in layers:
+        index.apply_layer(layer)
+    builder = LayerDaxfsBuilder(index, **kwargs)
+    builder.build()
+    return builder
+
+
+def _read(builder, mem, path):
+    e = builder.find_by_path(path)
+    return mem[e.data_offset:e.data_offset + e.stat.st_size]
+
+
+class TestLayerIndex:
+    """Test merging layers into one tree."""
+
+    def test_whiteouts(self, layers):
+        """Test file and opaque whiteouts hide lower entries only."""
+        builder = _build(layers)
+
+        assert builder.find_by_path("etc/old") is None
+        assert builder.find_by_path("etc/conf") is not None
+        assert builder.find_by_path("cache/a") is None
+        assert builder.find_by_path("cache/c") is not None
+        assert all(".wh." not in e.path for e in builder.files)
+
+    def test_implicit_parents(self, layers):
+        """Test missing parent directories are created."""
+        etc = _build(layers).find_by_path("etc")
+        assert stat.S_ISDIR(etc.stat.st_mode)
+
+    def test_parallel_read_matches_serial(self, layers):
+        """Test reading layer headers concurrently merges the same tree."""
+        serial = LayerDaxfsBuilder(build_layer_index(layers, inject_init=False))
+        serial.build()
+        parallel = LayerDaxfsBuilder(build_layer_index(layers, inject_init=False, threads=4))
+        parallel.build()
+
+        assert [(e.path, e.stat, e.data_offset) for e in parallel.files] == [
+            (e.path, e.stat, e.data_offset) for e in serial.files
+        ]
+
+    def test_hard_links_share_source(self, layers):
+        """Test a hard link keeps its own layer's contents and counts links."""
+        builder = _build(layers)
+        assert builder.find_by_path("etc/conf").stat.st_nlink == 2
+        assert builder.find_by_path("etc/conf-link").stat.st_nlink == 2
+
+        # bin/app was replaced above, leaving the lower link on its own
+        link = builder.find_by_path("bin/app-link")
+        assert link.stat.st_size == 2
+        assert link.stat.st_nlink == 1
+
+
+class TestLayerDaxfsBuilder:
+    """Test streaming layer contents into the image."""
+
+    def test_contents(self, layers):
+        """Test upper layers win and each extent holds the right bytes."""
+        builder = _build(layers)
+        size = builder.calculate_total_size()
+        mem = mmap.mmap(-1, size)
+        mem.write(b"\xff" * size)
+        builder.write_image(mem, size)
+
+        assert _read(builder, mem, "bin/app") == b"v2" * 3000
+        assert _read(builder, mem, "bin/app-link") == b"v1"
+        assert _read(builder, mem, "etc/conf") == b"base"
+        assert _read(builder, mem, "etc/conf-link") == b"base"
+        assert _read(builder, mem, "sh") == b"/bin/app"
+        assert builder.bytes_written == 6000 + 2 + 4 + 4 + 1 + 8
+
+        clean = mmap.mmap(-1, size)
+        builder.write_image(clean, size, zeroed=True)
+        assert mem[:] == clean[:]
+        mem.close()
+        clean.close()
+
+    def test_threaded_matches_serial(self, layers):
+        """Test decompressing layers concurrently gives the same image."""
+        builder = _build(layers)
+        size = builder.calculate_total_size()
+
+        serial = mmap.mmap(-1, size)
+        builder.write_image(serial, size, threads=1)
+        parallel = mmap.mmap(-1, size)
+        builder.write_image(parallel, size, threads=4)
+
+        assert parallel[:] == serial[:]
+        serial.close()
+        parallel.close()
+
+    def test_zero_file(self, layers):
+        """Test zero-filled files, like the status page, are cleared."""
+        index = LayerIndex()
+        for layer in layers:
+            index.apply_layer(layer)
+        index.add_zero_file(".kerf/status", 4096)
+        builder = LayerDaxfsBuilder(index)
+        builder.build()
+
+        size = builder.calculate_total_size()
+        mem = mmap.mmap(-1, size)
+        mem.write(b"\xff" * size)
+        builder.write_image(mem, size)
+        assert _read(builder, mem, ".kerf/status") == b"\x00" * 4096
+        mem.close()
+
+    def test_host_file(self, layers, tmp_path):
+        """Test host files such as /init are added over the layers."""
+        init = tmp_path / "kerf-init"
+        init.write_bytes(b"\x7fELF-init")
+
+        index = LayerIndex()
+        for layer in layers:
+            index.apply_layer(layer)
+        index.add_host_file("init", init)
+        builder = LayerDaxfsBuilder(index)
+        builder.build()
+
+        size = builder.calculate_total_size()
+        mem = mmap.mmap(-1, size)
+        builder.write_image(mem, size)
+        entry = builder.find_by_path("init")
+        assert stat.S_IMODE(entry.stat.st_mode) == 0o755
+        assert _read(builder, mem, "init") == b"\x7fELF-init"
+        mem.close()
+
+
+class TestLayerImageCache:
+    """Test reusing daxfs images built from the same layers."""
+
+    @staticmethod
+    def _create(layers, cache_dir, images, **kwargs):
+        """Build through a heap stand-in, keeping each image's bytes."""
+        def allocate_and_mount(instance_name, heap_path, required_size, size, timer, write,
+                               save_to=None):
+            alloc_size = size or required_size
+            mem = mmap.mmap(-1, alloc_size)
+            mem.write(b"\xff" * alloc_size)
+            written = write(mem, -1, alloc_size)
+            if save_to is not None:
+                mkdaxfs._save_image(mem, required_size, save_to)  # pylint: disable=protected-access
+            images.append(mem[:])
+            mem.close()
+            return mkdaxfs.DaxfsImage(phys_addr=0x1000, size=alloc_size, bytes_written=written)
+
+        with patch.object(daxfs_layers, "_allocate_and_mount", allocate_and_mount):
+            return daxfs_layers.create_daxfs_image_from_layers(
+                layers, "web", inject_init=False, cache_dir=cache_dir, **kwargs
+            )
+
+    def test_second_build_reads_cache(self, layers, tmp_path):
+        """Test the same layers are read back instead of decompressed again."""
+        cache_dir = tmp_path / "daxfs"
+        images = []
+        self._create(layers, cache_dir, images, size=1 << 20)
+        assert len(list(cache_dir.iterdir())) == 1
+
+        with patch.object(daxfs_layers, "build_layer_index",
+                          side_effect=AssertionError("layers decompressed")):
+            self._create(layers, cache_dir, images, size=1 << 20)
+        assert images[1] == images[0]
+
+    def test_options_change_key(self, layers, tmp_path):
+        """Test a different extent alignment or layer set is built afresh."""
+        cache_dir = tmp_path / "daxfs"
+        images = []
+        self._create(layers, cache_dir, images)
+        self._create(layers, cache_dir, images, huge_align=2 << 20)
+        self._create(layers[:1], cache_dir, images)
+        assert len(list(cache_dir.iterdir())) == 3
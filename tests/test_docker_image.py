@@ -0,0 +1,228 @@
+# Copyright 2026 Multikernel Technologies, Inc.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""
+Tests for OCI image extraction and the host image cache.
+"""
+
+import hashlib
+import io
+import json
+import os
+import shutil
+import tarfile
+from pathlib import Path
+from unittest.mock import patch
+
+import pytest
+
+from kerf.docker import image as docker_image
+
+IMAGE_DIGEST = "sha256:" + "ab" * 32
+
+
+def _layer(files):
+    """Build a gzip'ed layer tarball from a {path: bytes} dict."""
+    buf = io.BytesIO()
+    with tarfile.open(fileobj=buf, mode="w:gz") as tar:
+        for name, data in files.items():
+            info = tarfile.TarInfo(name)
+            info.size = len(data)
+            tar.addfile(info, io.BytesIO(data))
+    return buf.getvalue()
+
+
+class FakeSkopeo:
+    """Stand-in for skopeo that writes a two-layer image into an OCI layout."""
+
+    def __init__(self):
+        self.calls = []
+
+    @staticmethod
+    def _put_blob(layout, data):
+        digest = hashlib.sha256(data).hexdigest()
+        path = layout / "blobs" / "sha256" / digest
+        path.parent.mkdir(parents=True, exist_ok=True)
+        path.write_bytes(data)
+        return {"digest": f"sha256:{digest}", "size": len(data)}
+
+    def __call__(self, args):
+        self.calls.append(args[0])
+        if args[0] == "inspect":
+            return IMAGE_DIGEST + "\n"
+
+        dest = args[2][len("oci:"):]
+        layout, ref_name = dest.rsplit(":", 1)
+        layout = Path(layout)
+        config = self._put_blob(layout, json.dumps(
+            {"config": {"Entrypoint": ["/bin/app"], "Cmd": ["--serve"]}}
+        ).encode())
+        layers = [
+            self._put_blob(layout, _layer({
+                "bin/app": b"v1", "etc/conf": b"base", "etc/old": b"x", "var/cache/a": b"a",
+                "srv": b"file",
+            })),
+            self._put_blob(layout, _layer({
+                "bin/app": b"v2", "etc/.wh.old": b"", "var/cache/.wh..wh..opq": b"",
+                "var/cache/b": b"b",
+                # Directories new to the rootfs, or replacing a file, carrying whiteouts
+                "opt/new/.wh.gone": b"", "opt/new/sub/.wh..wh..opq": b"", "opt/new/sub/f": b"f",
+                "srv/.wh.x": b"", "srv/y": b"y",
+            })),
+        ]
+        manifest = self._put_blob(layout, json.dumps(
+            {"config": config, "layers": layers}
+        ).encode())
+        manifest["annotations"] = {docker_image.OCI_REF_NAME_ANNOTATION: ref_name}
+        (layout / "index.json").write_text(json.dumps({"manifests": [manifest]}))
+        return ""
+
+
+@pytest.fixture
+def fake_skopeo(tmp_path):
+    """Point the image cache at tmp_path and replace skopeo."""
+    skopeo = FakeSkopeo()
+    with patch.object(docker_image, "KERF_ROOTFS_DIR", str(tmp_path / "rootfs")), \
+         patch.object(docker_image, "KERF_IMAGE_CACHE_DIR", str(tmp_path / "images")), \
+         patch.object(docker_image, "_check_tool_available", return_value=True), \
+         patch.object(docker_image, "_run_skopeo", side_effect=skopeo):
+        yield skopeo
+
+
+class TestImageCache:
+    """Test digest-keyed image caching."""
+
+    def test_layers_applied_in_order(self, fake_skopeo):
+        """Test later layers override earlier ones and config is read."""
+        rootfs, cmd = docker_image.extract_image("app:latest", "web-1")
+
+        assert (Path(rootfs) / "bin" / "app").read_bytes() == b"v2"
+        assert (Path(rootfs) / "etc" / "conf").read_bytes() == b"base"
+        assert cmd == ["/bin/app", "--serve"]
+        assert fake_skopeo.calls == ["inspect", "copy"]
+
+    def test_whiteouts_applied(self, fake_skopeo):
+        """Test whiteouts remove lower entries and never land in the rootfs."""
+        rootfs, _ = docker_image.extract_image("app:latest", "web-1", threads=1)
+
+        assert not (Path(rootfs) / "etc" / "old").exists()
+        assert not (Path(rootfs) / "etc" / ".wh.old").exists()
+        assert sorted(os.listdir(Path(rootfs) / "var" / "cache")) == ["b"]
+
+    def test_whiteouts_in_new_directories_dropped(self, fake_skopeo):
+        """Test a directory moved in whole brings no whiteout files along."""
+        rootfs, _ = docker_image.extract_image("app:latest", "web-1")
+
+        assert sorted(os.listdir(Path(rootfs) / "opt" / "new")) == ["sub"]
+        assert sorted(os.listdir(Path(rootfs) / "opt" / "new" / "sub")) == ["f"]
+        assert sorted(os.listdir(Path(rootfs) / "srv")) == ["y"]
+
+    def test_second_load_skips_pull(self, fake_skopeo):
+        """Test a cached digest is cloned without pulling or asking the registry."""
+        first, _ = docker_image.extract_image("app:latest", "web-1")
+        second, cmd = docker_image.extract_image("app:latest", "web-2")
+
+        assert fake_skopeo.calls == ["inspect", "copy"]
+        assert cmd == ["/bin/app", "--serve"]
+        first_app = os.stat(os.path.join(first, "bin", "app"))
+        second_app = os.stat(os.path.join(second, "bin", "app"))
+        assert first_app.st_ino == second_app.st_ino
+
+    def test_clone_keeps_owners(self, fake_skopeo):  # pylint: disable=unused-argument
+        """Test directories and symlinks of a clone keep their non-root owners."""
+        if os.geteuid() != 0:
+            pytest.skip("changing owners needs root")
+        docker_image.extract_image("app:latest", "web-1")
+        cached = Path(docker_image.KERF_IMAGE_CACHE_DIR) / "rootfs" / IMAGE_DIGEST.split(":")[1]
+        os.chown(cached / "var" / "cache", 999, 998)
+        os.chmod(cached / "var" / "cache", 0o2750)
+        os.symlink("cache/b", cached / "var" / "link")
+        os.lchown(cached / "var" / "link", 997, 996)
+
+        rootfs, _ = docker_image.extract_image("app:latest", "web-2")
+        cache_st = os.stat(Path(rootfs) / "var" / "cache")
+        assert (cache_st.st_uid, cache_st.st_gid) == (999, 998)
+        assert cache_st.st_mode & 0o7777 == 0o2750
+        link_st = os.lstat(Path(rootfs) / "var" / "link")
+        assert (link_st.st_uid, link_st.st_gid) == (997, 996)
+
+    def test_reload_replaces_instance_rootfs(self, fake_skopeo):
+        """Test stale files in an instance rootfs do not survive a reload."""
+        rootfs, _ = docker_image.extract_image("app:latest", "web-1")
+        (Path(rootfs) / "stale").write_text("x")
+
+        rootfs, _ = docker_image.extract_image("app:latest", "web-1")
+        assert not (Path(rootfs) / "stale").exists()
+        assert fake_skopeo.calls.count("copy") == 1
+
+
+class TestTagIndex:
+    """Test resolving tags offline through the local tag index."""
+
+    def test_pull_asks_registry(self, fake_skopeo):
+        """Test pull=True resolves the tag again but reuses the cached layers."""
+        docker_image.extract_image("app:latest", "web-1")
+        docker_image.extract_image("app:latest", "web-2", pull=True)
+        assert fake_skopeo.calls == ["inspect", "copy", "inspect"]
+
+    def test_stale_entry_refreshed(self, fake_skopeo):
+        """Test an entry older than TAG_TTL goes back to the registry."""
+        docker_image.extract_image("app:latest", "web-1")
+        with patch.object(docker_image, "TAG_TTL", 0):
+            docker_image.extract_image("app:latest", "web-2")
+        assert fake_skopeo.calls == ["inspect", "copy", "inspect"]
+
+    def test_stale_entry_used_offline(self, fake_skopeo):
+        """Test a stale entry still resolves when the registry is unreachable."""
+        docker_image.extract_image("app:latest", "web-1")
+        with patch.object(docker_image, "TAG_TTL", 0), \
+             patch.object(docker_image, "_run_skopeo",
+                          side_effect=docker_image.DockerError("no route to host")):
+            _, cmd = docker_image.extract_image("app:latest", "web-2")
+        assert cmd == ["/bin/app", "--serve"]
+
+    def test_uncached_digest_needs_registry(self, fake_skopeo):
+        """Test an entry whose image was removed is not trusted."""
+        docker_image.pull_image_layers("app:latest")
+        shutil.rmtree(Path(docker_image.KERF_IMAGE_CACHE_DIR) / "oci")
+        docker_image.pull_image_layers("app:latest")
+        assert fake_skopeo.calls == ["inspect", "copy", "inspect", "copy"]
+
+    def test_pinned_digest_skips_inspect(self, fake_skopeo):
+        """Test a digest-pinned reference never asks the registry."""
+        docker_image.extract_image(f"app@{IMAGE_DIGEST}", "web-1")
+        assert fake_skopeo.calls == ["copy"]
+
+
+class TestPinDigest:
+    """Test pinning references to the inspected digest."""
+
+    def test_tag_replaced(self):
+        """Test the tag is swapped for the digest."""
+        assert docker_image._pin_digest(  # pylint: disable=protected-access
+            "docker://docker.io/library/nginx:latest", IMAGE_DIGEST
+        ) == f"docker://docker.io/library/nginx@{IMAGE_DIGEST}"
+
+    def test_registry_port_kept(self):
+        """Test a registry port is not mistaken for a tag."""
+        assert docker_image._pin_digest(  # pylint: disable=protected-access
+            "docker://registry:5000/app", IMAGE_DIGEST
+        ) == f"docker://registry:5000/app@{IMAGE_DIGEST}"
+
+    def test_other_transport_untouched(self):
+        """Test non-registry transports are left alone."""
+        ref = "oci-archive:/tmp/app.tar"
+        assert docker_image._pin_digest(  # pylint: disable=protected-access
+            ref, IMAGE_DIGEST
+        ) == ref
@@ -0,0 +1,126 @@
+# Copyright 2026 Multikernel Technologies, Inc.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""
+Tests for booting many instances with `kerf exec --all/--ids`.
+"""
+
+import errno
+import os
+from unittest.mock import patch
+
+import pytest
+
+from kerf import timing
+from kerf.exec import fanout
+
+INSTANCES = [("web-1", 1), ("web-2", 2), ("web-3", 3)]
+
+
+class FakeConsoles:
+    """Consoles that replay a kerf-init log, one pipe per instance."""
+
+    def __init__(self, silent=()):
+        self.silent = silent
+        self.opened = []
+        self.read_fds = []
+        self.quiet_fds = []
+
+    def __call__(self, instance_id):
+        self.opened.append(instance_id)
+        rfd, wfd = os.pipe()
+        self.read_fds.append(rfd)
+        if instance_id not in self.silent:
+            os.write(wfd, (
+                f"kerf-init: timing phase=start tsc={instance_id * 1000}\n"
+                f"kerf-init: timing phase=exec tsc={instance_id * 1000 + 500}\n"
+            ).encode())
+            os.close(wfd)
+        else:
+            # Keep the console open and quiet until the watch times out
+            self.quiet_fds.append(wfd)
+        return rfd
+
+    def all_closed(self):
+        """Whether every console handed out has been closed again."""
+        for fd in self.read_fds:
+            try:
+                os.fstat(fd)
+            except OSError:
+                continue
+            return False
+        return True
+
+
+class TestParseIdList:
+    """Test --ids parsing."""
+
+    def test_ranges(self):
+        """Test ranges and single IDs merge into sorted IDs."""
+        assert fanout.parse_id_list("4-6,1,5") == [1, 4, 5, 6]
+
+    def test_invalid(self):
+        """Test malformed and out-of-range lists are rejected."""
+        for spec in ("a", "3-1", "0-2", "510-512", "1,,2"):
+            with pytest.raises(ValueError):
+                fanout.parse_id_list(spec)
+
+
+class TestBootInstances:
+    """Test wave booting and entrypoint latency."""
+
+    def test_waves(self, timing_dir):  # pylint: disable=unused-argument
+        """Test waves are booted in order and entrypoints are read per instance."""
+        booted = []
+        consoles = FakeConsoles()
+
+        def boot(mk_id):
+            # Attached before the syscall, so early console output is not lost
+            assert mk_id in consoles.opened
+            booted.append(mk_id)
+
+        with patch.object(fanout, "_open_console", side_effect=consoles):
+            results = fanout.boot_instances(INSTANCES, boot, wave_size=2, timeout=5)
+
+        # Each wave's syscalls are issued concurrently, waves in order
+        assert sorted(booted[:2]) == [1, 2]
+        assert booted[2] == 3
+        assert [r.wave for r in results] == [1, 1, 2]
+        assert [r.entry_tsc for r in results] == [1500, 2500, 3500]
+        assert timing.load_boot_timing("web-3")["phases"] == {"start": 3000, "exec": 3500}
+        assert timing.load_boot_timing("web-3")["exec_tsc"] == results[2].call_tsc
+
+    def test_failed_boot_and_timeout(self, timing_dir):  # pylint: disable=unused-argument
+        """Test a failed syscall is not watched and a silent console times out."""
+        def boot(mk_id):
+            if mk_id == 1:
+                raise OSError(errno.ESRCH, os.strerror(errno.ESRCH))
+            return 0
+
+        consoles = FakeConsoles(silent=(3,))
+        with patch.object(fanout, "_open_console", side_effect=consoles):
+            results = fanout.boot_instances(INSTANCES, boot, timeout=0.2)
+        for fd in consoles.quiet_fds:
+            os.close(fd)
+
+        assert "reboot syscall failed" in results[0].error
+        # The failed instance's console was attached up front and is closed again
+        assert sorted(consoles.opened) == [1, 2, 3]
+        assert consoles.all_closed()
+        assert results[1].entry_tsc == 2500
+        assert results[2].entry_tsc is None
+
+        lines = fanout.format_fanout(results, 1000.0)
+        assert "no record" in lines[3]
+        assert lines[-1].startswith("wave 1: 2 booted")
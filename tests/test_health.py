@@ -0,0 +1,67 @@
+# Copyright 2026 Multikernel Technologies, Inc.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""
+Tests for reading kerf-init's host-visible status record.
+"""
+
+import struct
+
+from kerf import health
+
+
+def _record(seq=2, services=((2, 0, 42, 0),), magic=health.STATUS_MAGIC):
+    """Pack a status record the way kerf-init lays it out."""
+    data = struct.pack('<IIIIQQQQ', magic, health.STATUS_VERSION, seq, len(services),
+                       1000, 5000, 3, 0)
+    for svc in services:
+        data += struct.pack('<IiII', *svc)
+    return data.ljust(4096, b"\x00")
+
+
+class TestStatusRecord:
+    """Test decoding status records."""
+
+    def test_parse(self):
+        """Test services and heartbeat are decoded."""
+        status = health.parse_status(_record(services=((2, 0, 42, 0), (4, 1, 0, 3))))
+
+        assert status.heartbeats == 3
+        assert status.services[0] == health.ServiceStatus("running", 0, 42, 0)
+        assert status.services[1] == health.ServiceStatus("restarting", 1, 0, 3)
+        assert status.state == "restarting"
+        # 1 MHz TSC: 4000 cycles after the last update is 4 ms
+        assert status.age_seconds(9000, 1000.0) == 0.004
+
+    def test_unwritten_page(self):
+        """Test a page kerf-init never wrote is not mistaken for a record."""
+        assert health.parse_status(b"\x00" * 4096) is None
+        assert health.parse_status(_record(magic=0x12345678)) is None
+
+    def test_read_file(self, tmp_path):
+        """Test a settled record is read back from the status file."""
+        path = tmp_path / "status"
+        path.write_bytes(_record(services=((3, 137, 0, 0),)))
+
+        status = health.read_status_file(path)
+        assert status.state == "exited"
+        assert status.services[0].exit_status == 137
+
+    def test_read_mid_update(self, tmp_path):
+        """Test a record whose writer never finished is not returned."""
+        path = tmp_path / "status"
+        path.write_bytes(_record(seq=3))
+
+        assert health.read_status_file(path) is None
+        assert health.read_status_file(tmp_path / "missing") is None
@@ -0,0 +1,127 @@
+# Copyright 2026 Multikernel Technologies, Inc.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""
+Tests for loading many instances from one manifest.
+"""
+
+from unittest.mock import patch
+
+import pytest
+
+from kerf.load import batch
+from kerf.load.main import KEXEC_FILE_NO_INITRAMFS, KEXEC_MK_ID, KEXEC_MULTIKERNEL
+
+INSTANCE_IDS = {"web-1": 3, "web-2": 4}
+
+MANIFEST = """
+kernel: /boot/vmlinuz
+cmdline: quiet
+defaults:
+  mounts: proc, dev
+  services: /bin/app
+instances:
+  - name: web-1
+    ip: 10.0.0.11
+  - name: web-2
+    services: ["/bin/api --port=80", /bin/worker]
+    huge-align: 2M
+"""
+
+
+@pytest.fixture
+def fake_kexec():
+    """Record kexec_file_load calls instead of loading anything."""
+    calls = []
+
+    def kexec(kernel_fd, initrd_fd, cmdline, flags, debug=False):  # pylint: disable=unused-argument
+        calls.append((kernel_fd, initrd_fd, cmdline, flags))
+        return 0
+
+    with patch.object(batch, "kexec_file_load", side_effect=kexec), \
+         patch.object(batch, "write_load_record"), \
+         patch.object(batch, "get_instance_id_from_name", side_effect=INSTANCE_IDS.get):
+        yield calls
+
+
+class TestManifest:
+    """Test manifest parsing and validation."""
+
+    def test_defaults_and_keys(self, tmp_path):
+        """Test defaults apply, entries override them and option spellings map."""
+        path = tmp_path / "fleet.yaml"
+        path.write_text(MANIFEST)
+        fleet = batch.load_manifest(str(path))
+
+        assert fleet.kernel == "/boot/vmlinuz"
+        web1, web2 = fleet.instances
+        assert web1.ip_addr == "10.0.0.11"
+        assert web1.services == ("/bin/app",)
+        assert web1.mounts == "proc,dev"
+        assert web2.services == ("/bin/api --port=80", "/bin/worker")
+        assert web2.huge_align == "2M"
+
+    def test_invalid_entries(self):
+        """Test entries `kerf load` would reject are rejected."""
+        for entry in (
+            {"name": "a", "bogus": 1},
+            {"image": "nginx:latest"},
+            {"name": "a", "image": "x", "rootfs-dir": "/r"},
+            {"name": "a", "rootfs-dir": "/r"},
+            {"name": "a", "mounts": "proc,nfs"},
+            {"name": "a", "restart": "sometimes"},
+            {"name": "a", "id": 512},
+        ):
+            with pytest.raises(batch.LoadError):
+                batch.parse_manifest({"instances": [entry]})
+
+    def test_duplicate_instance(self):
+        """Test an instance cannot be loaded twice in one batch."""
+        with pytest.raises(batch.LoadError, match="more than once"):
+            batch.parse_manifest({"instances": [{"name": "a"}, {"name": "a"}]})
+
+
+class TestLoadInstances:
+    """Test batch kexec loading."""
+
+    def test_one_kernel_fd(self, tmp_path, fake_kexec):
+        """Test every instance is loaded from the same kernel fd, in order."""
+        kernel = tmp_path / "vmlinuz"
+        kernel.write_bytes(b"kernel")
+        specs = [batch.make_spec({"name": "web-1", "console": "mktty0"}),
+                 batch.make_spec({"name": "web-2"})]
+
+        loads = batch.load_instances(str(kernel), specs, cmdline="quiet", jobs=2)
+
+        assert [inst.error for inst in loads] == [None, None]
+        assert len({call[0] for call in fake_kexec}) == 1
+        assert [call[2] for call in fake_kexec] == ["quiet console=mktty0", "quiet"]
+        assert fake_kexec[1][3] == KEXEC_MULTIKERNEL | KEXEC_MK_ID(4) | KEXEC_FILE_NO_INITRAMFS
+
+    def test_failure_does_not_stop_batch(self, tmp_path, fake_kexec):
+        """Test an unknown instance is reported while the others still load."""
+        kernel = tmp_path / "vmlinuz"
+        kernel.write_bytes(b"kernel")
+        specs = [batch.make_spec({"name": "missing"}), batch.make_spec({"name": "web-2"})]
+
+        loads = batch.load_instances(str(kernel), specs)
+
+        assert "not found" in loads[0].error
+        assert loads[1].error is None
+        assert len(fake_kexec) == 1
+
+    def test_missing_kernel(self, tmp_path):
+        """Test an unreadable kernel fails the whole batch up front."""
+        with pytest.raises(batch.LoadError, match="kernel"):
+            batch.load_instances(str(tmp_path / "none"), [batch.make_spec({"name": "a"})])
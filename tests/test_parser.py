@@ -17,8 +17,10 @@ Tests for kerf device tree parser.
 """
 
 import pytest
+from kerf.dtc import decoder
 from kerf.dtc.parser import DeviceTreeParser
 from kerf.dtc.extractor import InstanceExtractor
+from kerf.dtc.overlay import OverlayGenerator
 from kerf.exceptions import ParseError
 
 
@@ -109,6 +111,49 @@ class TestDeviceTreeParser:
         assert device.sriov_vfs == 8
 
 
+class TestDecoder:
+    """Test the single-pass decoder against the libfdt reference parser."""
+
+    def test_matches_reference(self, sample_tree):
+        """Test a root tree decodes to the same models as the reference."""
+        sample_tree.device_references = {"eth0_vf1": {"parent": "eth0", "vf_id": 1}}
+        dtb_data = InstanceExtractor().generate_global_dtb(sample_tree)
+
+        reference = DeviceTreeParser(fast=False).parse_dtb_from_bytes(dtb_data)
+        assert decoder.decode_dtb(dtb_data) == reference
+        assert DeviceTreeParser().parse_dtb_from_bytes(dtb_data) == reference
+        assert reference.device_references == sample_tree.device_references
+
+    def test_overlay_falls_back(self):
+        """Test overlays are left to the reference parser."""
+        dtbo = OverlayGenerator().generate_removal_overlay("web-server")
+        with pytest.raises(decoder.Unsupported):
+            decoder.decode_dtb(dtbo)
+
+        parser = DeviceTreeParser()
+        parser.parse_dtb_from_bytes(dtbo)
+        assert parser.get_last_overlay_data().removals == {"web-server"}
+
+    def test_bad_property_falls_back(self):
+        """Test a property of the wrong size gets the reference parser's error."""
+        import libfdt
+
+        fdt_sw = libfdt.FdtSw()
+        fdt_sw.finish_reservemap()
+        fdt_sw.begin_node("")
+        fdt_sw.begin_node("resources")
+        fdt_sw.property_u32("memory-base", 0x80000000)
+        fdt_sw.property_u64("memory-bytes", 1024**3)
+        fdt_sw.end_node()
+        fdt_sw.end_node()
+        dtb_data = bytes(fdt_sw.as_fdt().as_bytearray())
+
+        with pytest.raises(decoder.Unsupported):
+            decoder.decode_dtb(dtb_data)
+        with pytest.raises(ParseError, match="Invalid 'memory-base' property size"):
+            DeviceTreeParser().parse_dtb_from_bytes(dtb_data)
+
+
 class TestInstanceExtractor:
     """Test instance extraction."""
 
@@ -160,3 +205,74 @@ class TestInstanceExtractor:
 
         assert len(parsed_tree.instances) == 3
         assert "test" in parsed_tree.instances
+
+
+class TestCompactEncoding:
+    """Test the compact root tree encoding against the standard one."""
+
+    def test_cpu_set_encodings(self):
+        """Test each CPU set takes its smallest form and decodes back."""
+        from kerf.dtc.cpuset import decode_cpu_set, encode_cpu_set
+        import struct
+
+        cases = {
+            "cpu-ranges": list(range(4, 32)),
+            "cpu-bitmap": list(range(64, 128, 2)),
+            "cpus": [9, 3, 5],
+        }
+        for expected, cpus in cases.items():
+            name, value = encode_cpu_set(cpus)
+            assert name == expected
+            cells = struct.unpack(f">{len(value) // 4}I", value)
+            assert decode_cpu_set(name, cells) == cpus
+
+        with pytest.raises(ValueError):
+            decode_cpu_set("cpu-bitmap", [3, 1])
+
+    def test_matches_standard(self, sample_tree):
+        """Test a compact tree parses to the same models as the standard tree."""
+        sample_tree.device_references = {
+            "eth0_vf1": {"parent": "eth0", "vf_id": 1},
+            "eth0_vf2": {"parent": "eth0", "vf_id": 2},
+        }
+        standard = InstanceExtractor().generate_global_dtb(sample_tree)
+        compact = InstanceExtractor(compact=True).generate_global_dtb(sample_tree)
+
+        assert b"device-handles" in compact and b"device-names" not in compact
+        assert b"parent-handle" in compact
+        expected = DeviceTreeParser(fast=False).parse_dtb_from_bytes(standard)
+        assert DeviceTreeParser(fast=False).parse_dtb_from_bytes(compact) == expected
+        assert decoder.decode_dtb(compact) == expected
+
+    def test_unresolved_devices_keep_names(self, sample_tree):
+        """Test devices without a node to point at are still written by name."""
+        compact = InstanceExtractor(compact=True).generate_global_dtb(sample_tree)
+
+        assert b"device-names" in compact
+        parsed = DeviceTreeParser(fast=False).parse_dtb_from_bytes(compact)
+        assert parsed.instances["web-server"].resources.devices == ["eth0_vf1"]
+        assert decoder.decode_dtb(compact) == parsed
+
+    def test_smaller_on_large_host(self, sample_tree):
+        """Test the compact tree is smaller for a host with many instances."""
+        from kerf.models import Instance, InstanceResources
+
+        sample_tree.hardware.cpus.available = list(range(4, 512))
+        sample_tree.instances = {
+            f"vm{i}": Instance(
+                name=f"vm{i}",
+                id=i + 1,
+                resources=InstanceResources(
+                    cpus=list(range(4 + 8 * i, 12 + 8 * i)),
+                    memory_base=0x80000000 + i * 1024**3,
+                    memory_bytes=1024**3,
+                    devices=[],
+                ),
+            )
+            for i in range(60)
+        }
+
+        standard = InstanceExtractor().generate_global_dtb(sample_tree)
+        compact = InstanceExtractor(compact=True).generate_global_dtb(sample_tree)
+        assert len(compact) < len(standard) * 3 // 4
+        assert decoder.decode_dtb(compact) == decoder.decode_dtb(standard)
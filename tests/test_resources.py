@@ -25,9 +25,33 @@ from kerf.resources import (
     validate_cpu_allocation,
     validate_memory_allocation,
     find_next_instance_id,
+    memory_fragmentation,
+    MemoryPool,
+    HUGEPAGE_1G,
+    HUGEPAGE_2M,
 )
 from kerf.exceptions import ResourceError
 
+GB = 1024**3
+
+
+@pytest.fixture
+def numa_tree(sample_hardware):
+    """Two NUMA nodes splitting the 14 GB pool at 0x200000000."""
+    from kerf.models import GlobalDeviceTree, NUMANode, TopologySection
+
+    def node(node_id, base, size, cpus):
+        return NUMANode(
+            node_id=node_id, memory_base=base, memory_size=size, cpus=cpus,
+            distance_matrix={}, memory_type="dram",
+        )
+
+    sample_hardware.topology = TopologySection(numa_nodes={
+        0: node(0, 0x80000000, 6 * GB, list(range(4, 18))),
+        1: node(1, 0x200000000, 8 * GB, list(range(18, 32))),
+    })
+    return GlobalDeviceTree(hardware=sample_hardware, instances={}, device_references={})
+
 
 class TestCPUAllocation:
     """Test CPU allocation utilities."""
@@ -179,6 +203,78 @@ class TestMemoryAllocation:
         )
 
 
+class TestMemoryPool:
+    """Test the free-extent index and best-fit placement."""
+
+    def test_reserve_splits_extents(self):
+        """Test reserving regions leaves the right free extents."""
+        pool = MemoryPool(0, 10 * GB, [(2 * GB, GB), (6 * GB, 2 * GB)])
+        assert pool.free_extents() == [(0, 2 * GB), (3 * GB, 6 * GB), (8 * GB, 10 * GB)]
+        assert pool.free_extents(GB, 4 * GB) == [(GB, 2 * GB), (3 * GB, 4 * GB)]
+        assert pool.largest_free() == 3 * GB
+
+        # Overlapping and already-reserved space is handled
+        pool.reserve(GB, 3 * GB)
+        assert pool.free_extents() == [(0, GB), (4 * GB, 6 * GB), (8 * GB, 10 * GB)]
+
+    def test_best_fit(self):
+        """Test the tightest gap is used instead of the first one."""
+        pool = MemoryPool(0, 10 * GB, [(3 * GB, GB), (6 * GB, 2 * GB)])
+        # Gaps: 3 GB at 0, 2 GB at 4 GB, 2 GB at 8 GB
+        assert pool.best_fit(2 * GB) == 4 * GB
+        assert pool.best_fit(3 * GB) == 0
+        assert pool.best_fit(4 * GB) is None
+
+        # Alignment is applied inside the extent
+        pool = MemoryPool(0x1000, 4 * GB)
+        assert pool.best_fit(GB, HUGEPAGE_1G) == GB
+        assert pool.best_fit(GB, HUGEPAGE_2M) == HUGEPAGE_2M
+
+
+class TestNUMAPlacement:
+    """Test memory placement follows the instance's NUMA node."""
+
+    def test_local_node_preferred(self, numa_tree):
+        """Test memory lands on the node of the CPUs, with 1 GB alignment."""
+        base = find_available_memory_base(numa_tree, 2 * GB, use_iomem=False, cpus=[20, 21])
+        assert base == 0x200000000
+
+        base = find_available_memory_base(numa_tree, 2 * GB, use_iomem=False, cpus=[4, 5])
+        assert base == 0x80000000
+
+        # Explicit NUMA nodes win over the CPUs' node
+        base = find_available_memory_base(
+            numa_tree, 2 * GB, use_iomem=False, cpus=[4, 5], numa_nodes=[1]
+        )
+        assert base == 0x200000000
+
+    def test_remote_fallback(self, numa_tree):
+        """Test a full local node falls back to a remote node, then to the whole pool."""
+        base = find_available_memory_base(numa_tree, 7 * GB, use_iomem=False, cpus=[4])
+        assert base == 0x200000000
+
+        base = find_available_memory_base(numa_tree, 10 * GB, use_iomem=False, cpus=[4])
+        assert base == 0x80000000
+
+    def test_fragmentation(self, numa_tree):
+        """Test free memory and largest extent are reported per node."""
+        from kerf.models import Instance, InstanceResources
+
+        numa_tree.instances["a"] = Instance(
+            name="a", id=1,
+            resources=InstanceResources(
+                cpus=[4], memory_base=0x80000000 + 2 * GB, memory_bytes=GB, devices=[]
+            ),
+        )
+        rows = memory_fragmentation(numa_tree, use_iomem=False)
+        assert rows == [
+            (0, 5 * GB, 3 * GB, 2),
+            (1, 8 * GB, 8 * GB, 1),
+            # Node 0's last extent and node 1 are contiguous in the pool
+            (None, 13 * GB, 11 * GB, 2),
+        ]
+
+
 class TestInstanceID:
     """Test instance ID allocation."""
 
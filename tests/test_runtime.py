@@ -16,10 +16,16 @@
 Tests for kerf runtime manager.
 """
 
+import copy
+import fcntl
+import os
 import tempfile
+import threading
+import time
 from pathlib import Path
 from unittest.mock import patch
 
+import libfdt
 import pytest
 
 from kerf.exceptions import KernelInterfaceError, ValidationError
@@ -64,6 +70,85 @@ class TestDeviceTreeManager:
 
             assert read_tree.hardware.cpus.available == sample_hardware.cpus.available
 
+    def test_read_baseline_cached(self, sample_hardware):
+        """Test the root device tree is parsed again only when a transaction appears."""
+        from kerf.models import GlobalDeviceTree
+        from kerf.baseline import BaselineManager
+
+        with tempfile.TemporaryDirectory() as tmpdir:
+            baseline_path = Path(tmpdir) / "device_tree"
+            overlays_dir = Path(tmpdir) / "overlays"
+            overlays_dir.mkdir()
+            tree = GlobalDeviceTree(hardware=sample_hardware, instances={}, device_references={})
+            BaselineManager(baseline_path=str(baseline_path)).write_baseline(tree)
+
+            manager = DeviceTreeManager(
+                baseline_path=str(baseline_path), overlays_dir=str(overlays_dir)
+            )
+            with patch.object(manager.baseline_mgr, "read_baseline",
+                              wraps=manager.baseline_mgr.read_baseline) as parse:
+                first = manager.read_baseline()
+                first.hardware.cpus.available.clear()
+                second = manager.read_baseline()
+                assert parse.call_count == 1
+                # Each caller gets its own copy
+                assert second.hardware.cpus.available == sample_hardware.cpus.available
+
+                (overlays_dir / "tx_1").mkdir()
+                manager.read_baseline()
+                assert parse.call_count == 2
+
+    def test_read_baseline_cache_shared(self, sample_hardware):
+        """Test managers in one process share the parsed tree, as commands in kerfd do."""
+        from kerf.models import GlobalDeviceTree
+        from kerf.baseline import BaselineManager
+
+        with tempfile.TemporaryDirectory() as tmpdir:
+            baseline_path = Path(tmpdir) / "device_tree"
+            overlays_dir = Path(tmpdir) / "overlays"
+            overlays_dir.mkdir()
+            tree = GlobalDeviceTree(hardware=sample_hardware, instances={}, device_references={})
+            BaselineManager(baseline_path=str(baseline_path)).write_baseline(tree)
+
+            first = DeviceTreeManager(
+                baseline_path=str(baseline_path), overlays_dir=str(overlays_dir)
+            )
+            first.read_baseline()
+            second = DeviceTreeManager(
+                baseline_path=str(baseline_path), overlays_dir=str(overlays_dir)
+            )
+            with patch.object(second.baseline_mgr, "read_baseline") as parse:
+                second.read_baseline()
+                assert parse.call_count == 0
+                second.invalidate_cache()
+                second.read_baseline()
+                assert parse.call_count == 1
+
+    def test_allocations_cached_with_tree(self, sample_tree):
+        """Test the allocation index is rebuilt only when the state changes."""
+        from kerf.models import GlobalDeviceTree
+        from kerf.baseline import BaselineManager
+
+        with tempfile.TemporaryDirectory() as tmpdir:
+            baseline_path = Path(tmpdir) / "device_tree"
+            overlays_dir = Path(tmpdir) / "overlays"
+            overlays_dir.mkdir()
+            tree = GlobalDeviceTree(
+                hardware=sample_tree.hardware, instances={}, device_references={}
+            )
+            BaselineManager(baseline_path=str(baseline_path)).write_baseline(tree)
+
+            manager = DeviceTreeManager(
+                baseline_path=str(baseline_path), overlays_dir=str(overlays_dir)
+            )
+            # pylint: disable=protected-access
+            first = manager._allocations(sample_tree)
+            assert manager._allocations(sample_tree) is first
+            assert first.cpus_allocated == 12
+
+            (overlays_dir / "tx_1").mkdir()
+            assert manager._allocations(sample_tree) is not first
+
     def test_get_instance_names_empty(self, sample_hardware):
         """Test getting instance names with empty tree."""
         from kerf.models import GlobalDeviceTree
@@ -174,38 +259,162 @@ class TestDeviceTreeManager:
 class TestLocking:
     """Test locking mechanism."""
 
+    @staticmethod
+    def _try_flock(path):
+        """Try the lock from another open file description."""
+        fd = os.open(path, os.O_RDWR | os.O_CREAT)
+        try:
+            fcntl.flock(fd, fcntl.LOCK_EX | fcntl.LOCK_NB)
+            return True
+        except BlockingIOError:
+            return False
+        finally:
+            os.close(fd)
+
     def test_lock_acquisition(self):
-        """Test that lock is acquired and released."""
+        """Test that lock is held inside the block and released after it."""
         with tempfile.TemporaryDirectory() as tmpdir:
             manager = DeviceTreeManager()
             manager.lock_file = Path(tmpdir) / "test.lock"
 
-            # Lock should not exist initially
-            assert not manager.lock_file.exists()
-
-            # Acquire lock
             with manager._acquire_lock():  # pylint: disable=protected-access
-                # Lock should exist
-                assert manager.lock_file.exists()
+                assert not self._try_flock(manager.lock_file)
+                assert manager.lock_file.read_text().strip() == str(os.getpid())
+
+                # Nested use does not deadlock on itself
+                with manager._acquire_lock():  # pylint: disable=protected-access
+                    pass
+                assert not self._try_flock(manager.lock_file)
 
-            # Lock should be released
-            assert not manager.lock_file.exists()
+            assert self._try_flock(manager.lock_file)
+
+    def test_stale_lock_file(self):
+        """Test a lock file left behind by a crashed kerf does not block."""
+        with tempfile.TemporaryDirectory() as tmpdir:
+            manager = DeviceTreeManager()
+            manager.lock_file = Path(tmpdir) / "test.lock"
+            manager.lock_file.write_text("99999\n")
+            manager.lock_timeout = 0
+
+            with manager._acquire_lock():  # pylint: disable=protected-access
+                pass
 
     def test_lock_timeout(self):
         """Test lock timeout when lock is held."""
         with tempfile.TemporaryDirectory() as tmpdir:
             manager = DeviceTreeManager()
             manager.lock_file = Path(tmpdir) / "test.lock"
+            manager.lock_timeout = 0.2
 
-            # Create lock file
-            manager.lock_file.touch()
-
+            holder = os.open(manager.lock_file, os.O_RDWR | os.O_CREAT)
             try:
-                # Try to acquire lock (should timeout)
+                fcntl.flock(holder, fcntl.LOCK_EX)
+                start = time.monotonic()
                 with pytest.raises(KernelInterfaceError, match="Could not acquire lock"):
                     with manager._acquire_lock():  # pylint: disable=protected-access
                         pass
+                assert time.monotonic() - start >= 0.2
             finally:
-                # Cleanup
-                if manager.lock_file.exists():
-                    manager.lock_file.unlink()
+                os.close(holder)
+
+    def test_lock_waits_for_holder(self):
+        """Test a waiter gets the lock as soon as the holder releases it."""
+        with tempfile.TemporaryDirectory() as tmpdir:
+            manager = DeviceTreeManager()
+            manager.lock_file = Path(tmpdir) / "test.lock"
+
+            holder = os.open(manager.lock_file, os.O_RDWR | os.O_CREAT)
+            fcntl.flock(holder, fcntl.LOCK_EX)
+            threading.Timer(0.1, os.close, (holder,)).start()
+
+            start = time.monotonic()
+            with manager._acquire_lock():  # pylint: disable=protected-access
+                assert time.monotonic() - start < manager.lock_timeout
+
+
+def _fragments(dtbo):
+    """Return the operation node names of each overlay fragment, in order."""
+    fdt = libfdt.Fdt(bytes(dtbo))
+    names = []
+    frag = fdt.first_subnode(0, libfdt.QUIET_NOTFOUND)
+    while frag >= 0:
+        overlay = fdt.subnode_offset(frag, "__overlay__")
+        ops = []
+        op = fdt.first_subnode(overlay, libfdt.QUIET_NOTFOUND)
+        while op >= 0:
+            ops.append(fdt.get_name(op))
+            op = fdt.next_subnode(op, libfdt.QUIET_NOTFOUND)
+        names.append(ops)
+        frag = fdt.next_subnode(frag, libfdt.QUIET_NOTFOUND)
+    return names
+
+
+class TestTransaction:
+    """Test applying several operations as one overlay."""
+
+    def _manager(self, tmpdir, tree):
+        manager = DeviceTreeManager()
+        manager.lock_file = Path(tmpdir) / "test.lock"
+        manager.read_baseline = lambda: tree
+        return manager
+
+    def test_single_overlay(self, sample_tree):
+        """Test removes, updates and creates are validated and written once."""
+        from kerf.models import Instance, InstanceResources
+
+        with tempfile.TemporaryDirectory() as tmpdir:
+            manager = self._manager(tmpdir, sample_tree)
+            written = []
+            with patch.object(manager, "_write_overlay", side_effect=lambda d: written.append(d) or "7"), \
+                 patch.object(manager.validator, "validate_delta",
+                              wraps=manager.validator.validate_delta) as validate:
+                with manager.transaction() as tx:
+                    tx.remove_instance("web-server")
+                    db = copy.deepcopy(tx.state.instances["database"])
+                    db.resources.cpus = [8, 9, 10, 11]
+                    tx.update_instance(db)
+                    tx.create_instance(Instance(
+                        name="cache", id=3,
+                        resources=InstanceResources(
+                            cpus=[4, 5], memory_base=0x80000000,
+                            memory_bytes=1024**3, devices=[],
+                        ),
+                    ))
+
+            assert tx.tx_id == "7"
+            assert validate.call_count == 1
+            assert len(written) == 1
+            assert _fragments(written[0]) == [["instance-remove"], ["cpu-remove"], ["instance-create"]]
+
+    def test_apply_operation_stages(self, sample_tree):
+        """Test apply_operation() times each stage into the caller's timer."""
+        from kerf.timing import StageTimer
+
+        with tempfile.TemporaryDirectory() as tmpdir:
+            manager = self._manager(tmpdir, sample_tree)
+            timer = StageTimer()
+
+            def remove(current):
+                modified = copy.deepcopy(current)
+                del modified.instances["web-server"]
+                return modified
+
+            with patch.object(manager, "_write_overlay", return_value="8"):
+                assert manager.apply_operation(remove, timer) == "8"
+            assert list(timer.stages) == ["read", "operation", "validate", "generate", "write"]
+
+    def test_error_applies_nothing(self, sample_tree):
+        """Test an operation failing discards the whole transaction."""
+        with tempfile.TemporaryDirectory() as tmpdir:
+            manager = self._manager(tmpdir, sample_tree)
+            with patch.object(manager, "_write_overlay") as write:
+                with pytest.raises(ValidationError, match="does not exist"):
+                    with manager.transaction() as tx:
+                        tx.remove_instance("web-server")
+                        tx.remove_instance("web-server")
+                assert not write.called
+
+                with manager.transaction() as tx:
+                    pass
+                assert not write.called
+                assert tx.tx_id is None
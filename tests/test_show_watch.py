@@ -0,0 +1,152 @@
+# Copyright 2026 Multikernel Technologies, Inc.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""
+Tests for `kerf show --json` snapshots and `--watch` deltas.
+"""
+
+import json
+from types import SimpleNamespace
+from unittest.mock import patch
+
+import pytest
+
+from kerf.health import InstanceHealth, ServiceStatus
+from kerf.show import snapshot
+
+KIMAGE = """MK_ID  Type        Start Address   Segments  Mode  Cmdline
+-----  ----------  --------------  --------  ----  -------
+1      KEXEC_FILE  0x1000000       4         fast  console=ttyS0
+"""
+
+
+class FakeManager:
+    """Stands in for DeviceTreeManager, counting root device tree reads."""
+
+    def __init__(self, tree):
+        self.tree = tree
+        self.key = (1, 1, 0, 0)
+        self.reads = 0
+        self.baseline_mgr = SimpleNamespace(read_baseline=self._read)
+
+    def _read(self):
+        self.reads += 1
+        return self.tree
+
+    def state_key(self):
+        return self.key
+
+
+@pytest.fixture
+def host(sample_tree):
+    """Patched sysfs readers over sample_tree, with mutable instance state."""
+    state = {
+        "ids": {"web-server": 1, "database": 2},
+        "status": {"web-server": "active", "database": "loaded"},
+        "heartbeats": 1,
+    }
+
+    def health(name):
+        if name != "web-server":
+            return None
+        return InstanceHealth(
+            boot_tsc=0, update_tsc=state["heartbeats"] * 1000,
+            heartbeats=state["heartbeats"],
+            services=[ServiceStatus(state="running", exit_status=0, pid=1, restarts=0)],
+        )
+
+    with patch.object(snapshot, "read_proc_kimage", return_value=KIMAGE), \
+         patch.object(snapshot, "get_all_instance_names",
+                      side_effect=lambda: sorted(state["ids"])), \
+         patch.object(snapshot, "get_instance_id_from_name", side_effect=state["ids"].get), \
+         patch.object(snapshot, "get_instance_status", side_effect=state["status"].get), \
+         patch.object(snapshot, "read_instance_health", side_effect=health):
+        yield state, FakeManager(sample_tree)
+
+
+class TestSnapshot:
+    """Test snapshot collection and diffing."""
+
+    def test_collect(self, host):
+        """Test a snapshot carries status, kimage, allocation, health and free resources."""
+        _, manager = host
+        snap = snapshot.Snapshotter(manager).collect()
+
+        web = snap["instances"]["web-server"]
+        assert web["id"] == 1 and web["status"] == "active"
+        assert web["kimage"]["mode"] == "fast"
+        assert web["resources"]["cpus"] == [4, 5, 6, 7]
+        assert web["health"] == {
+            "state": "running",
+            "services": [{"state": "running", "pid": 1, "exit_status": 0, "restarts": 0}],
+        }
+        assert snap["instances"]["database"]["kimage"] is None
+        assert snap["resources"]["cpus_free"] == list(range(16, 32))
+        assert snap["resources"]["memory_free_bytes"] == 4 * 1024**3
+        json.dumps(snap)
+
+    def test_tree_read_once_per_key(self, host):
+        """Test the root device tree is only re-read after its key changes."""
+        _, manager = host
+        snapshotter = snapshot.Snapshotter(manager)
+        snapshotter.collect()
+        snapshotter.collect()
+        assert manager.reads == 1
+        manager.key = (2, 2, 0, 0)
+        snapshotter.collect()
+        assert manager.reads == 2
+
+    def test_heartbeats_are_not_changes(self, host):
+        """Test snapshots are equal while only heartbeats advance."""
+        state, manager = host
+        snapshotter = snapshot.Snapshotter(manager)
+        first = snapshotter.collect()
+        state["heartbeats"] += 5
+        assert snapshot.diff_snapshots(first, snapshotter.collect()) is None
+
+    def test_delta(self, host):
+        """Test a delta lists added, removed and only the changed fields."""
+        state, manager = host
+        snapshotter = snapshot.Snapshotter(manager)
+        first = snapshotter.collect(["web-server", "database"])
+        state["status"]["web-server"] = "failed"
+        del state["ids"]["database"]
+
+        delta = snapshot.diff_snapshots(first, snapshotter.collect(["web-server", "database"]))
+        assert delta == {"added": {}, "removed": ["database"],
+                         "changed": {"web-server": {"status": "failed"}}}
+
+
+class TestWatch:
+    """Test the --watch stream."""
+
+    def test_emits_only_changes(self, host):
+        """Test a snapshot line comes first, then one delta line per change."""
+        state, manager = host
+        lines = []
+        rounds = iter(range(3))
+
+        def stop():
+            step = next(rounds, None)
+            if step == 1:
+                state["status"]["database"] = "active"
+            return step is None
+
+        with patch.object(snapshot.time, "sleep"):
+            snapshot.watch(lines.append, interval=0, stop=stop,
+                           snapshotter=snapshot.Snapshotter(manager))
+
+        events = [json.loads(line) for line in lines]
+        assert [e["type"] for e in events] == ["snapshot", "delta"]
+        assert events[1]["changed"] == {"database": {"status": "active"}}
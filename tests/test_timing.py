@@ -0,0 +1,100 @@
+# Copyright 2026 Multikernel Technologies, Inc.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""
+Tests for spawn boot timelines.
+"""
+
+from kerf import timing
+
+CONSOLE_LOG = (
+    "[    0.412001] kerf-init: timing phase=start tsc=1003000\n"
+    "[    0.412100] kerf-init: entrypoint: '/bin/app'\n"
+    "[    0.412200] kerf-init: timing phase=cmdline tsc=1005000\n"
+    "[    0.412300] kerf-init: timing phase=mounted tsc=1006000\n"
+    "[    0.412400] kerf-init: timing phase=exec tsc=1010000\n"
+    "[    9.000000] kerf-init: timing phase=child_exit tsc=9000000\n"
+    "[    9.000001] kerf-init: timing phase=start tsc=99999999\n"
+)
+
+
+class TestInitTiming:
+    """Test parsing kerf-init timing records."""
+
+    def test_parse_keeps_first_boot(self):
+        """Test every phase is parsed and later boots do not override."""
+        records = timing.parse_init_timing(CONSOLE_LOG)
+        assert records == {
+            "start": 1003000, "cmdline": 1005000, "mounted": 1006000,
+            "exec": 1010000, "child_exit": 9000000,
+        }
+
+    def test_scanner_split_reads(self):
+        """Test records split across console reads are reassembled."""
+        data = CONSOLE_LOG.replace("\n", "\r\n").encode()
+        scanner = timing.InitTimingScanner()
+        found = [scanner.feed(data[i:i + 7]) for i in range(0, len(data), 7)]
+
+        assert any(found)
+        assert scanner.records == timing.parse_init_timing(CONSOLE_LOG)
+
+    def test_timeline_from_exec(self, timing_dir):  # pylint: disable=unused-argument
+        """Test phases are reported relative to the exec TSC."""
+        timing.record_exec_tsc("web", 1000000)
+        timing.record_init_timing("web", timing.parse_init_timing(CONSOLE_LOG))
+
+        # 1000 kHz: one cycle per microsecond
+        lines = timing.format_boot_timing(timing.load_boot_timing("web"), 1000.0)
+        assert lines[0].split()[:2] == ["kexec", "0.000"]
+        assert lines[1].split()[:2] == ["start", "3.000"]
+        assert lines[-1].split()[-2:] == ["10.000", "ms"]
+        assert "kexec to entrypoint" in lines[-1]
+
+    def test_exec_starts_new_timeline(self, timing_dir):  # pylint: disable=unused-argument
+        """Test a new `kerf exec` drops the previous boot's records."""
+        timing.record_init_timing("web", {"start": 5})
+        timing.record_exec_tsc("web", 1)
+
+        assert timing.load_boot_timing("web") == {"exec_tsc": 1, "phases": {}}
+        assert not timing.format_boot_timing(timing.load_boot_timing("web"), 1000.0)
+
+
+class TestStageSummary:
+    """Test reducing repeated stage timings to percentiles."""
+
+    def test_percentile(self):
+        """Test nearest-rank percentiles."""
+        samples = [float(v) for v in range(1, 101)]
+        assert timing.percentile(samples, 50) == 50.0
+        assert timing.percentile(samples, 99) == 99.0
+        assert timing.percentile([3.0], 90) == 3.0
+
+    def test_summarize_stages(self):
+        """Test per-stage statistics in ms, with stages missing from some rounds."""
+        rounds = []
+        for scan, write in ((0.001, 0.004), (0.003, None), (0.002, 0.002)):
+            timer = timing.StageTimer()
+            timer.stages["scan"] = scan
+            if write is not None:
+                timer.stages["write"] = write
+            rounds.append(timer)
+
+        summary = timing.summarize_stages(rounds)
+        assert list(summary) == ["scan", "write", "total"]
+        assert summary["scan"] == {
+            "n": 3, "min": 1.0, "p50": 2.0, "p90": 3.0, "p99": 3.0, "max": 3.0, "mean": 2.0,
+        }
+        assert summary["write"]["n"] == 2 and summary["write"]["max"] == 4.0
+        assert summary["total"]["max"] == 5.0
+        assert timing.summarize_stages([]) == {}
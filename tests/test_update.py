@@ -0,0 +1,128 @@
+# Copyright 2026 Multikernel Technologies, Inc.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""
+Tests for the kerf update --add-cpus/--remove-cpus fast path.
+"""
+
+import copy
+
+import libfdt
+import pytest
+
+from kerf.exceptions import ResourceError
+from kerf.models import GlobalDeviceTree
+from kerf.runtime import DeviceTreeManager
+from kerf.update.main import apply_cpu_delta, select_cpu_delta
+
+
+@pytest.fixture
+def kernel(tmp_path, sample_tree):
+    """
+    A manager whose root tree is sample_tree and whose overlay writes
+    create transaction directories as the kernel would, recording the DTBOs.
+    """
+    baseline_path = tmp_path / "device_tree"
+    baseline_path.write_bytes(b"")
+    overlays_dir = tmp_path / "overlays"
+    overlays_dir.mkdir()
+
+    manager = DeviceTreeManager(baseline_path=str(baseline_path), overlays_dir=str(overlays_dir))
+    manager.lock_file = tmp_path / "kerf.lock"
+    written = []
+
+    def write_overlay(dtbo_data):
+        written.append(bytes(dtbo_data))
+        tx_id = str(len(written))
+        (overlays_dir / f"tx_{tx_id}").mkdir()
+        return tx_id
+
+    manager._write_overlay = write_overlay  # pylint: disable=protected-access
+    # Stands in for parsing the root tree, instances included
+    parses = []
+    manager.baseline_mgr.read_baseline = (
+        lambda: parses.append(1) or copy.deepcopy(sample_tree)
+    )
+    yield manager, written, parses
+    manager.invalidate_cache()
+
+
+def _cpu_ops(dtbo):
+    """The operation and cpu@ nodes of a single-fragment overlay."""
+    fdt = libfdt.Fdt(dtbo)
+    op = fdt.first_subnode(fdt.path_offset("/fragment@0/__overlay__"))
+    cpus = []
+    node = fdt.first_subnode(op, libfdt.QUIET_NOTFOUND)
+    while node >= 0:
+        cpus.append(fdt.get_name(node))
+        node = fdt.next_subnode(node, libfdt.QUIET_NOTFOUND)
+    return fdt.get_name(op), fdt.getprop(op, "mk,instance").as_str(), cpus
+
+
+class TestSelectCpuDelta:
+    """Test choosing the CPUs that change."""
+
+    def test_add_from_free_cpus(self, sample_tree):
+        """Test added CPUs are free ones and nothing is removed."""
+        added, removed = select_cpu_delta(sample_tree, "web-server", add=2)
+        assert removed == [] and len(added) == 2
+        assert not set(added) & set(range(4, 16))
+
+    def test_remove_keeps_one(self, sample_tree):
+        """Test CPUs are removed from the top and the last one cannot be."""
+        assert select_cpu_delta(sample_tree, "web-server", remove=3) == ([], [5, 6, 7])
+        with pytest.raises(ResourceError, match="at least one must remain"):
+            select_cpu_delta(sample_tree, "web-server", remove=4)
+
+    def test_pool_exhausted(self, sample_tree):
+        """Test asking for more CPUs than are free fails."""
+        with pytest.raises(ResourceError):
+            select_cpu_delta(sample_tree, "web-server", add=17)
+        with pytest.raises(ResourceError, match="does not exist"):
+            select_cpu_delta(sample_tree, "nosuch", add=1)
+
+
+class TestApplyCpuDelta:
+    """Test applying CPU deltas against the cached tree."""
+
+    def test_single_fragment(self, kernel):
+        """Test each delta writes one cpu-add or cpu-remove fragment of the changed CPUs."""
+        manager, written, _ = kernel
+        tx_id, added, instance = apply_cpu_delta(manager, "web-server", add=2)
+        assert tx_id == "1"
+        assert instance.resources.cpus == sorted([4, 5, 6, 7] + added)
+        assert _cpu_ops(written[0]) == ("cpu-add", "web-server", [f"cpu@{c}" for c in added])
+
+        _, removed, instance = apply_cpu_delta(manager, "web-server", remove=1)
+        assert removed == [max(added)]
+        assert _cpu_ops(written[1]) == ("cpu-remove", "web-server", [f"cpu@{max(added)}"])
+
+    def test_no_reparse(self, kernel):
+        """Test consecutive deltas see each other's CPUs without parsing the tree again."""
+        manager, _, parses = kernel
+        _, first, _ = apply_cpu_delta(manager, "web-server", add=2)
+        _, second, _ = apply_cpu_delta(manager, "database", add=2)
+        assert len(parses) == 1
+        assert not set(first) & set(second)
+
+        tree = manager.read_baseline()
+        assert isinstance(tree, GlobalDeviceTree) and len(parses) == 1
+        assert set(first) <= set(tree.instances["web-server"].resources.cpus)
+
+    def test_dry_run(self, kernel):
+        """Test a dry run writes nothing and leaves the cache as it was."""
+        manager, written, _ = kernel
+        tx_id, added, _ = apply_cpu_delta(manager, "web-server", add=1, dry_run=True)
+        assert tx_id is None and len(added) == 1 and not written
+        assert manager.read_baseline().instances["web-server"].resources.cpus == [4, 5, 6, 7]
@@ -16,7 +16,9 @@
 Tests for kerf validator.
 """
 
-from kerf.dtc.validator import MultikernelValidator
+from unittest.mock import patch
+
+from kerf.dtc.validator import AllocationIndex, MultikernelValidator
 
 
 class TestMultikernelValidator:
@@ -386,3 +388,122 @@ class TestNUMAValidation:
         assert any(
             "Spread" in warning and "single NUMA node" in warning for warning in result.warnings
         )
+
+
+class TestDeltaValidation:
+    """Test validating only the instances a change touches."""
+
+    def _with(self, tree, *instances):
+        import copy
+
+        modified = copy.deepcopy(tree)
+        for instance in instances:
+            modified.instances[instance.name] = instance
+        return modified
+
+    def test_matches_full_validation(self, sample_tree):
+        """Test a new instance is checked against untouched ones like the full pass."""
+        from kerf.models import Instance, InstanceResources
+
+        validator = MultikernelValidator()
+        clean = self._with(sample_tree, Instance(
+            name="cache", id=3,
+            resources=InstanceResources(
+                cpus=[16, 17], memory_base=0x300000000, memory_bytes=1024**3, devices=[]
+            ),
+        ))
+        assert validator.validate_delta(sample_tree, clean).is_valid
+
+        clash = self._with(sample_tree, Instance(
+            name="cache", id=2,
+            resources=InstanceResources(
+                cpus=[7, 8, 2], memory_base=0x180000000, memory_bytes=1024**3, devices=[]
+            ),
+        ))
+        result = validator.validate_delta(sample_tree, clash)
+        full = validator.validate(clash)
+
+        assert not result.is_valid
+        assert sum("Duplicate instance ID: 2" in e for e in result.errors) == 1
+        assert any("reserved for host kernel" in e for e in result.errors)
+        for other in ("web-server", "database"):
+            assert any(f"CPU overlap with instance '{other}'" in e for e in result.errors)
+        assert any("cache and database: Memory region overlap" in e for e in result.errors)
+        # Everything found is also what the full pass reports for this instance
+        assert set(result.errors) <= set(full.errors)
+
+    def test_touched_instances_checked_together(self, sample_tree):
+        """Test two changed instances are checked against each other."""
+        from kerf.models import Instance, InstanceResources
+
+        def instance(name, instance_id, memory_base):
+            return Instance(
+                name=name, id=instance_id,
+                resources=InstanceResources(
+                    cpus=[20, 21], memory_base=memory_base, memory_bytes=1024**3, devices=[]
+                ),
+            )
+
+        modified = self._with(
+            sample_tree, instance("a", 3, 0x300000000), instance("b", 4, 0x340000000)
+        )
+        result = MultikernelValidator().validate_delta(sample_tree, modified)
+
+        assert any("CPU overlap with instance 'b'" in e for e in result.errors)
+        assert any("CPU overlap with instance 'a'" in e for e in result.errors)
+        assert not any("Memory region overlap" in e for e in result.errors)
+
+    def test_untouched_conflicts_not_rechecked(self, sample_tree):
+        """Test conflicts between unchanged instances are left to the full pass."""
+        import copy
+
+        current = copy.deepcopy(sample_tree)
+        current.instances["database"].resources.cpus = [6, 7, 8]
+
+        assert not MultikernelValidator().validate(current).is_valid
+        assert MultikernelValidator().validate_delta(current, copy.deepcopy(current)).is_valid
+
+    def test_index_reused_across_changes(self, sample_tree):
+        """Test one index of current serves changes that move and remove its instances."""
+        import copy
+
+        from kerf.models import Instance, InstanceResources
+
+        index = AllocationIndex(sample_tree.instances.values())
+        validator = MultikernelValidator()
+
+        # database is replaced by cache on the same CPUs, memory and ID
+        replaced = copy.deepcopy(sample_tree)
+        database = replaced.instances.pop("database")
+        replaced.instances["cache"] = Instance(
+            name="cache", id=2, resources=copy.deepcopy(database.resources)
+        )
+        with patch.object(validator, "_validate_resource_allocations",
+                          side_effect=AssertionError("walked the tree")), \
+             patch.object(validator, "_calculate_resource_usage",
+                          side_effect=AssertionError("walked the tree")), \
+             patch.object(validator, "_validate_device_references",
+                          side_effect=AssertionError("walked the tree")):
+            result = validator.validate_delta(sample_tree, replaced, index)
+        assert result.is_valid
+
+        def utilization(warnings):
+            return [w for w in warnings if w.startswith("Resource utilization")]
+
+        assert utilization(result.warnings) == utilization(validator.validate(replaced).warnings)
+
+        # web-server moved onto database's CPUs still clashes with database
+        moved = copy.deepcopy(sample_tree)
+        moved.instances["web-server"].resources.cpus = [8, 9]
+        result = validator.validate_delta(sample_tree, moved, index)
+        assert any("CPU overlap with instance 'database'" in e for e in result.errors)
+
+    def test_hardware_change_falls_back(self, sample_tree):
+        """Test a hardware change gets the full pass."""
+        import copy
+
+        modified = copy.deepcopy(sample_tree)
+        modified.hardware.cpus.available = []
+        result = MultikernelValidator().validate_delta(sample_tree, modified)
+
+        assert "Hardware inventory: No CPUs available for spawn kernels" in result.errors